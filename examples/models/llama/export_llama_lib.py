@@ -66,6 +66,7 @@ from .source_transformation.quantize import (
     get_quant_embedding_transform,
     get_quant_weight_transform,
 )
+from .source_transformation.rms_norm import replace_rms_norm_with_custom_op
 from .source_transformation.rope import materialze_broadcast_of_rope_freq_cis
 from .source_transformation.sdpa import (
     replace_causal_mask,
@@ -309,6 +310,12 @@ def build_args_parser() -> argparse.ArgumentParser:
         action="store_true",
         help="Whether to use sdpa_with_kv_cache update op when using kv cache",
     )
+    parser.add_argument(
+        "--use_custom_rms_norm",
+        default=False,
+        action="store_true",
+        help="Replace each RMSNorm with the fused llama::rms_norm custom op. Only for the XNNPACK / portable CPU flow, since other backends don't support the op.",
+    )
     parser.add_argument(
         "--disable_dynamic_shape",
         dest="enable_dynamic_shape",
@@ -745,6 +752,7 @@ def _prepare_for_llama_export(llm_config: LlmConfig) -> LLMEdgeManager:
                 llm_config.model, "use_custom_sdpa_with_attention_mask", False
             ),
             use_sdpa_with_kv_cache=llm_config.model.use_sdpa_with_kv_cache,
+            use_custom_rms_norm=llm_config.model.use_custom_rms_norm,
             quantize_kv_cache=llm_config.model.quantize_kv_cache,
             use_kv_cache=llm_config.model.use_kv_cache,
             qnn=llm_config.backend.qnn.enabled,
@@ -1259,6 +1267,11 @@ def _load_llama_model_metadata(
         "use_sdpa_with_kv_cache": use_sdpa_with_kv_cache,
         "enable_dynamic_shape": enable_dynamic_shape,
     }
+    if use_kv_cache and use_sdpa_with_kv_cache:
+        # The custom KV cache is laid out as [batch, seq, heads, head_dim].
+        # Other layouts depend on the backend, so they have to be given with
+        # --metadata for the runner to save sessions.
+        metadata["get_kv_cache_seq_dim"] = 1
     if metadata_str:
         try:
             extra = json.loads(metadata_str)
@@ -1359,6 +1372,7 @@ def _get_source_transforms(  # noqa
     expand_rope_table: bool = False,
     use_custom_sdpa_with_attention_mask: bool = False,
     use_sdpa_with_kv_cache: bool = False,
+    use_custom_rms_norm: bool = False,
     quantize_kv_cache: bool = False,
     use_kv_cache: bool = False,
     qnn: bool = False,
@@ -1395,6 +1409,7 @@ def _get_source_transforms(  # noqa
         expand_rope_table: Whether to expand rope table.
         use_custom_sdpa_with_attention_mask: Whether to use custom SDPA with attention mask.
         use_sdpa_with_kv_cache: Whether to use SDPA with KV cache.
+        use_custom_rms_norm: Whether to replace RMSNorm with the fused custom op.
         quantize_kv_cache: Whether to quantize KV cache.
         use_kv_cache: Whether to use KV cache.
         qnn: Whether to use QNN.
@@ -1501,6 +1516,14 @@ def _get_source_transforms(  # noqa
         else:
             transforms.append(replace_sdpa_with_custom_op)
 
+    if use_custom_rms_norm:
+        # llama::rms_norm only has a CPU kernel, so delegates would have to
+        # leave every RMSNorm out of their partitions.
+        assert not (
+            qnn or mps or coreml or vulkan
+        ), "use_custom_rms_norm is only supported by the XNNPACK / portable CPU flow"
+        transforms.append(replace_rms_norm_with_custom_op)
+
     if quantize_kv_cache:
         assert use_kv_cache, "quantize_kv_cache requires use_kv_cache=True"
         transforms.append(replace_kv_cache_with_quantized_kv_cache)
@@ -21,3 +21,30 @@ def replace_rms_norm_with_native_rms_norm(module: torch.nn.Module):
         else:
             replace_rms_norm_with_native_rms_norm(child)
     return module
+
+
+class RMSNormCustom(torch.nn.Module):
+    """RMSNorm that runs as the single fused llama::rms_norm custom op."""
+
+    def __init__(self, weight: torch.nn.Parameter, eps: float):
+        super().__init__()
+        self.weight = weight
+        self.eps = eps
+
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        return torch.ops.llama.rms_norm(x, self.weight, self.eps)
+
+
+def _replace_rms_norm_with_custom_op(module: torch.nn.Module):
+    for name, child in module.named_children():
+        if isinstance(child, RMSNorm):
+            setattr(module, name, RMSNormCustom(child.weight, child.eps))
+        else:
+            _replace_rms_norm_with_custom_op(child)
+
+
+def replace_rms_norm_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import custom_ops  # noqa
+
+    _replace_rms_norm_with_custom_op(module)
+    return module
@@ -9,8 +9,13 @@ import unittest
 from executorch.devtools.backend_debug import get_delegation_info
 from executorch.examples.models.llama.export_llama_lib import (
     _export_llama,
+    _get_source_transforms,
     build_args_parser,
 )
+from executorch.examples.models.llama.source_transformation.rms_norm import (
+    replace_rms_norm_with_custom_op,
+)
+from executorch.extension.llm.export.builder import DType
 from executorch.extension.llm.export.config.llm_config import LlmConfig
 
 UNWANTED_OPS = [
@@ -48,3 +53,36 @@ class ExportLlamaLibTest(unittest.TestCase):
 
         for op, _op_info in delegation_info.delegation_by_operator.items():
             self.assertTrue(op not in UNWANTED_OPS)
+
+    def test_custom_rms_norm_is_opt_in(self):
+        # use_sdpa_with_kv_cache is also used by delegates that can't run
+        # llama::rms_norm, so it must not swap in the custom RMSNorm by itself.
+        transforms = _get_source_transforms(
+            DType.fp32, use_sdpa_with_kv_cache=True, use_kv_cache=True
+        )
+        self.assertNotIn(replace_rms_norm_with_custom_op, transforms)
+
+        transforms = _get_source_transforms(
+            DType.fp32,
+            use_sdpa_with_kv_cache=True,
+            use_kv_cache=True,
+            use_custom_rms_norm=True,
+        )
+        self.assertIn(replace_rms_norm_with_custom_op, transforms)
+
+    def test_custom_rms_norm_rejects_delegates(self):
+        with self.assertRaises(AssertionError):
+            _get_source_transforms(
+                DType.fp32,
+                use_sdpa_with_kv_cache=True,
+                use_custom_rms_norm=True,
+                vulkan=True,
+            )
+
+    def test_custom_rms_norm_config_from_args(self):
+        parser = build_args_parser()
+        args = parser.parse_args(["--use_sdpa_with_kv_cache"])
+        self.assertFalse(LlmConfig.from_args(args).model.use_custom_rms_norm)
+
+        args = parser.parse_args(["--use_custom_rms_norm"])
+        self.assertTrue(LlmConfig.from_args(args).model.use_custom_rms_norm)
@@ -0,0 +1,225 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+"""Compression of data segments.
+
+Implements the LZ4_BLOCKS segment format described in schema/program.fbs: the
+data is split into fixed-size blocks that are compressed independently with
+the LZ4 block format, preceded by a table of little-endian uint64 block end
+offsets. Blocks that don't get smaller are stored raw.
+
+Uses the `lz4` package when it is installed. Otherwise it falls back to a
+pure-Python encoder, which is far too slow for large weights, and warns about
+it first.
+"""
+
+import struct
+import warnings
+from dataclasses import dataclass
+from typing import List, Optional, Tuple
+
+# Uncompressed bytes per block. Large enough to compress well, small enough to
+# spread a segment across threads when loading.
+DEFAULT_BLOCK_SIZE: int = 1 << 20
+
+# Decompressed segments are placed in buffers with this alignment at runtime;
+# segments that need more can't be compressed. Keep in sync with
+# kDecompressedSegmentAlignment in runtime/executor/segment_compression.h.
+MAX_COMPRESSED_SEGMENT_ALIGNMENT: int = 64
+
+_MIN_MATCH: int = 4
+# The LZ4 block format requires the last match to start at least this many
+# bytes before the end of the block...
+_MATCH_FIND_LIMIT: int = 12
+# ...and the block to end with at least this many literals.
+_LAST_LITERALS: int = 5
+_MAX_OFFSET: int = 65535
+
+try:
+    # pyre-ignore[21]: Optional dependency.
+    import lz4.block as _lz4_block
+except ImportError:
+    _lz4_block = None
+
+
+@dataclass
+class CompressedSegment:
+    """A segment in the LZ4_BLOCKS format."""
+
+    data: bytes
+    uncompressed_size: int
+    block_size: int
+
+
+def _append_length(out: bytearray, length: int) -> None:
+    """Appends the bytes that follow a length nibble of 15."""
+    length -= 15
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def _append_sequence(
+    out: bytearray, literals: memoryview, offset: int, match_length: int
+) -> None:
+    literal_length = len(literals)
+    token = min(literal_length, 15) << 4
+    if match_length > 0:
+        token |= min(match_length - _MIN_MATCH, 15)
+    out.append(token)
+    if literal_length >= 15:
+        _append_length(out, literal_length)
+    out += literals
+    if match_length > 0:
+        out += struct.pack("<H", offset)
+        if match_length - _MIN_MATCH >= 15:
+            _append_length(out, match_length - _MIN_MATCH)
+
+
+def _lz4_compress_block_py(data: bytes) -> bytes:
+    """Greedy LZ4 block encoder with a single-entry hash table."""
+    size = len(data)
+    view = memoryview(data)
+    out = bytearray()
+    anchor = 0
+    match_limit = size - _LAST_LITERALS
+    last_match_start = size - _MATCH_FIND_LIMIT
+    table = {}
+    pos = 0
+    while pos < last_match_start:
+        key = data[pos : pos + _MIN_MATCH]
+        candidate = table.get(key)
+        table[key] = pos
+        if candidate is None or pos - candidate > _MAX_OFFSET:
+            pos += 1
+            continue
+        # Extend the match, comparing a chunk at a time.
+        end = pos + _MIN_MATCH
+        source = candidate + _MIN_MATCH
+        chunk = 64
+        while end < match_limit:
+            n = min(chunk, match_limit - end)
+            if data[end : end + n] == data[source : source + n]:
+                end += n
+                source += n
+                continue
+            while end < match_limit and data[end] == data[source]:
+                end += 1
+                source += 1
+            break
+        _append_sequence(out, view[anchor:pos], pos - candidate, end - pos)
+        pos = end
+        anchor = end
+    _append_sequence(out, view[anchor:], 0, 0)
+    return bytes(out)
+
+
+def _lz4_compress_block(data: bytes) -> bytes:
+    if _lz4_block is not None:
+        return _lz4_block.compress(data, store_size=False)
+    return _lz4_compress_block_py(data)
+
+
+def _copy_length(data: bytes, pos: int, length: int) -> Tuple[int, int]:
+    if length == 15:
+        while True:
+            byte = data[pos]
+            pos += 1
+            length += byte
+            if byte != 255:
+                break
+    return pos, length
+
+
+def _lz4_decompress_block(data: bytes, uncompressed_size: int) -> bytes:
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        token = data[pos]
+        pos += 1
+        pos, literal_length = _copy_length(data, pos, token >> 4)
+        out += data[pos : pos + literal_length]
+        pos += literal_length
+        if pos == len(data):
+            break
+        (offset,) = struct.unpack_from("<H", data, pos)
+        pos += 2
+        pos, match_length = _copy_length(data, pos, token & 15)
+        match_length += _MIN_MATCH
+        start = len(out) - offset
+        if offset <= 0 or start < 0:
+            raise ValueError(f"Invalid match offset {offset}")
+        for i in range(match_length):
+            out.append(out[start + i])
+    if len(out) != uncompressed_size:
+        raise ValueError(
+            f"Block decompressed to {len(out)} bytes, expected {uncompressed_size}"
+        )
+    return bytes(out)
+
+
+def compress_segment(
+    data: bytes, block_size: int = DEFAULT_BLOCK_SIZE
+) -> Optional[CompressedSegment]:
+    """Compresses `data` in the LZ4_BLOCKS format.
+
+    Returns None if that doesn't make the data smaller, in which case it should
+    be stored uncompressed.
+    """
+    if block_size <= 0:
+        raise ValueError(f"Invalid block size {block_size}")
+    if _lz4_block is None and len(data) > 0:
+        warnings.warn(
+            f"The lz4 package is not installed, so compressing this "
+            f"{len(data)} byte segment uses a pure-Python LZ4 encoder, which "
+            "can take hours for LLM-sized weights. Run `pip install lz4` to "
+            "compress segments at native speed.",
+            stacklevel=2,
+        )
+    blocks: List[bytes] = []
+    for start in range(0, len(data), block_size):
+        block = bytes(data[start : start + block_size])
+        compressed = _lz4_compress_block(block)
+        # A block of the same size as its data is read as raw, so raw must
+        # also be used when compression doesn't save anything.
+        blocks.append(compressed if len(compressed) < len(block) else block)
+
+    table = bytearray()
+    end = 0
+    for block in blocks:
+        end += len(block)
+        table += struct.pack("<Q", end)
+    if len(table) + end >= len(data):
+        return None
+    return CompressedSegment(
+        data=bytes(table) + b"".join(blocks),
+        uncompressed_size=len(data),
+        block_size=block_size,
+    )
+
+
+def decompress_segment(segment: CompressedSegment) -> bytes:
+    """Inverse of compress_segment()."""
+    size = segment.uncompressed_size
+    block_size = segment.block_size
+    num_blocks = (size + block_size - 1) // block_size
+    table_size = num_blocks * 8
+    blocks = segment.data[table_size:]
+    out = bytearray()
+    begin = 0
+    for i in range(num_blocks):
+        (end,) = struct.unpack_from("<Q", segment.data, i * 8)
+        block_uncompressed_size = min(block_size, size - i * block_size)
+        block = blocks[begin:end]
+        if len(block) == block_uncompressed_size:
+            out += block
+        else:
+            out += _lz4_decompress_block(block, block_uncompressed_size)
+        begin = end
+    return bytes(out)
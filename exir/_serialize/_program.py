@@ -14,6 +14,13 @@ import re
 from dataclasses import dataclass
 from typing import ClassVar, Dict, List, Literal, Optional, Tuple
 
+from executorch.exir._serialize._compression import (
+    compress_segment,
+    CompressedSegment,
+    decompress_segment,
+    DEFAULT_BLOCK_SIZE,
+    MAX_COMPRESSED_SEGMENT_ALIGNMENT,
+)
 from executorch.exir._serialize._cord import Cord
 from executorch.exir._serialize._dataclass import _DataclassEncoder, _json_to_dataclass
 from executorch.exir._serialize._flatbuffer import (
@@ -36,6 +43,7 @@ from executorch.exir.schema import (
     DataSegment,
     NamedData,
     Program,
+    SegmentCompression,
     SubsegmentOffsets,
 )
 from executorch.exir.tensor import ALIGNMENT
@@ -55,14 +63,23 @@ class AlignedData:
     Attributes:
         data: The data to serialize, as a cord.
         alignment: The alignment required for the data.
+        compressible: Whether the runtime can read the data from a compressed
+            segment.
     """
 
     data: Cord
     alignment: int
-
-    def __init__(self, data: Cord, alignment: Optional[int] = None) -> None:
+    compressible: bool
+
+    def __init__(
+        self,
+        data: Cord,
+        alignment: Optional[int] = None,
+        compressible: bool = False,
+    ) -> None:
         self.data = data
         self.alignment = alignment or 1
+        self.compressible = compressible
 
 
 def _program_to_json(program: Program) -> str:
@@ -365,6 +382,38 @@ def _extract_constant_segment(
     return constant_segment_data, constant_segment_offsets
 
 
+def _maybe_compress_segment(
+    segment: AlignedData,
+    compress: bool,
+    block_size: int,
+) -> Tuple[DataSegment, Cord]:
+    """Compresses the segment data if allowed and worthwhile.
+
+    Returns:
+        The DataSegment describing the data, with offset 0, and the data to
+        write.
+    """
+    if (
+        compress
+        and segment.compressible
+        and segment.alignment <= MAX_COMPRESSED_SEGMENT_ALIGNMENT
+        and len(segment.data) > 0
+    ):
+        compressed = compress_segment(bytes(segment.data), block_size)
+        if compressed is not None:
+            return (
+                DataSegment(
+                    offset=0,
+                    size=len(compressed.data),
+                    compression=SegmentCompression.LZ4_BLOCKS,
+                    uncompressed_size=compressed.uncompressed_size,
+                    compression_block_size=compressed.block_size,
+                ),
+                Cord(compressed.data),
+            )
+    return DataSegment(offset=0, size=len(segment.data)), segment.data
+
+
 def _extract_named_data(
     program: Program,
     segments: List[AlignedData],
@@ -396,11 +445,15 @@ def _extract_named_data(
             segment_index_map[buffer_idx] = segment_index
             segments.append(
                 AlignedData(
-                    Cord(buffers[buffer_idx].buffer), buffers[buffer_idx].alignment
+                    Cord(buffers[buffer_idx].buffer),
+                    buffers[buffer_idx].alignment,
+                    compressible=True,
                 )
             )
         named_data.append(NamedData(key=name, segment_index=segment_index))
-    program.named_data = named_data
+    # Sorted keys let the runtime binary search named data. Python orders str
+    # by code point, which matches the byte order of their UTF-8 encoding.
+    program.named_data = sorted(named_data, key=lambda entry: entry.key)
 
 
 def serialize_pte_binary(
@@ -412,6 +465,8 @@ def serialize_pte_binary(
     constant_tensor_alignment: Optional[int] = None,
     delegate_alignment: Optional[int] = None,
     named_data: Optional[NamedDataStoreOutput] = None,
+    compress_segments: bool = False,
+    compression_block_size: int = DEFAULT_BLOCK_SIZE,
 ) -> Cord:
     """Returns the runtime binary representation of the given Program.
 
@@ -433,6 +488,11 @@ def serialize_pte_binary(
             value in the schema file.
         named_data: If provided, named blobs to be stored in segments
             after the PTE file.
+        compress_segments: Whether to LZ4-compress the constant and named data
+            segments that get smaller that way. Segments that require an
+            alignment above MAX_COMPRESSED_SEGMENT_ALIGNMENT stay uncompressed.
+        compression_block_size: The uncompressed size of the independently
+            compressed blocks of a segment.
     Returns:
         The serialized form of the Program, ready for execution by the runtime.
     """
@@ -464,8 +524,15 @@ def serialize_pte_binary(
         )
         # Clear the constant buffer, as constant data will be stored in segments.
         program.constant_buffer = []
-        # Add to the aggregate segments cord.
-        segments.append(AlignedData(constant_segment_data))
+        # Add to the aggregate segments cord. The tensors in it are aligned
+        # relative to the start of the segment.
+        segments.append(
+            AlignedData(
+                constant_segment_data,
+                compressible=constant_tensor_alignment
+                <= MAX_COMPRESSED_SEGMENT_ALIGNMENT,
+            )
+        )
 
     if mutable_data is not None:
         mutable_segment_data, mutable_segment_offsets = _extract_constant_segment(
@@ -498,16 +565,18 @@ def serialize_pte_binary(
             else 0
         )
         alignment = math.lcm(segment_alignment, segment.alignment)
-        program.segments.append(
-            DataSegment(
-                offset=aligned_size(prev_end, alignment), size=len(segment.data)
-            )
+        data_segment, data = _maybe_compress_segment(
+            segment,
+            compress_segments,
+            compression_block_size,
         )
+        data_segment.offset = aligned_size(prev_end, alignment)
+        program.segments.append(data_segment)
         # Add to aggregate segments cord with padding.
         padding_length = padding_required(len(segments_data), alignment)
         if padding_length > 0:
             segments_data.append(b"\x00" * padding_length)
-        segments_data.append(segment.data)
+        segments_data.append(data)
 
     # Convert to a standard flatbuffer binary.
     result: _FlatbufferResult = _program_json_to_flatbuffer(
@@ -599,7 +668,20 @@ def _restore_segments(program: Program, segment_data: bytes) -> Program:
             raise ValueError(
                 f"Segment {i} {segment} overflows data length {len(segment_data)}"
             )
-        segments.append(segment_data[segment.offset : segment.offset + segment.size])
+        data = segment_data[segment.offset : segment.offset + segment.size]
+        if segment.compression == SegmentCompression.LZ4_BLOCKS:
+            data = decompress_segment(
+                CompressedSegment(
+                    data=data,
+                    uncompressed_size=segment.uncompressed_size,
+                    block_size=segment.compression_block_size,
+                )
+            )
+        elif segment.compression != SegmentCompression.NONE:
+            raise ValueError(
+                f"Segment {i} has unknown compression {segment.compression}"
+            )
+        segments.append(data)
 
     # Find and replace the Program's references to these segments, inlining the
     # data.
@@ -0,0 +1,81 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import random
+import struct
+import unittest
+import warnings
+from unittest import mock
+
+from executorch.exir._serialize import _compression
+from executorch.exir._serialize._compression import (
+    _lz4_compress_block_py,
+    _lz4_decompress_block,
+    compress_segment,
+    decompress_segment,
+)
+
+
+class TestCompression(unittest.TestCase):
+    def test_block_round_trip(self) -> None:
+        rng = random.Random(0)
+        cases = [
+            b"",
+            b"a",
+            b"abcdefghijkl",
+            b"abc" * 1000,
+            bytes(70000),
+            bytes(rng.getrandbits(8) for _ in range(5000)),
+            b"hello world " * 2000 + bytes(rng.getrandbits(8) for _ in range(300)),
+        ]
+        for data in cases:
+            compressed = _lz4_compress_block_py(data)
+            self.assertEqual(_lz4_decompress_block(compressed, len(data)), data)
+
+    def test_segment_round_trip(self) -> None:
+        rng = random.Random(0)
+        # Few distinct values, like quantized weights.
+        data = bytes(rng.choice(b"\x00\x01\x02\xff") for _ in range(10000))
+        for block_size in (1000, 4096, 1 << 20):
+            segment = compress_segment(data, block_size)
+            self.assertIsNotNone(segment)
+            assert segment is not None
+            self.assertLess(len(segment.data), len(data))
+            self.assertEqual(segment.uncompressed_size, len(data))
+            self.assertEqual(segment.block_size, block_size)
+            self.assertEqual(decompress_segment(segment), data)
+
+    def test_block_table(self) -> None:
+        data = b"\x00" * 2500
+        segment = compress_segment(data, 1000)
+        assert segment is not None
+        ends = struct.unpack_from("<3Q", segment.data)
+        self.assertEqual(ends[-1], len(segment.data) - 3 * 8)
+        self.assertLess(ends[0], ends[1])
+
+    def test_incompressible_data_is_not_compressed(self) -> None:
+        rng = random.Random(0)
+        data = bytes(rng.getrandbits(8) for _ in range(4096))
+        self.assertIsNone(compress_segment(data, 1024))
+        self.assertIsNone(compress_segment(b"", 1024))
+
+    def test_invalid_block_size_fails(self) -> None:
+        with self.assertRaises(ValueError):
+            compress_segment(b"abc", 0)
+
+    def test_warns_without_lz4_package(self) -> None:
+        data = b"abc" * 1000
+        with mock.patch.object(_compression, "_lz4_block", None):
+            with self.assertWarnsRegex(UserWarning, "pip install lz4"):
+                segment = compress_segment(data, 1024)
+            assert segment is not None
+            self.assertEqual(decompress_segment(segment), data)
+            # Nothing to compress, nothing to warn about.
+            with warnings.catch_warnings():
+                warnings.simplefilter("error")
+                self.assertIsNone(compress_segment(b"", 1024))
@@ -15,6 +15,10 @@ import unittest
 
 from typing import List, Sequence
 
+from executorch.exir._serialize._compression import (
+    CompressedSegment,
+    decompress_segment,
+)
 from executorch.exir._serialize._flatbuffer import _program_flatbuffer_to_json
 from executorch.exir._serialize._named_data_store import (
     BufferEntry,
@@ -40,6 +44,7 @@ from executorch.exir.schema import (
     DataSegment,
     ExecutionPlan,
     Program,
+    SegmentCompression,
     SubsegmentOffsets,
 )
 from executorch.exir.tests.common import get_test_program
@@ -997,6 +1002,66 @@ class TestProgram(unittest.TestCase):
             buffers[2].buffer,
         )
 
+    def test_compressed_named_data_segments(self) -> None:
+        program = get_test_program()
+        buffers = [
+            # Compresses well.
+            BufferEntry(buffer=b"\x01\x02\x03\x04" * 1000, alignment=16),
+            # Needs more alignment than decompressed buffers provide.
+            BufferEntry(buffer=b"\x05\x06\x07\x08" * 1000, alignment=128),
+            # Doesn't get smaller.
+            BufferEntry(buffer=bytes(range(256)), alignment=16),
+        ]
+        named_data = NamedDataStoreOutput(
+            buffers=buffers,
+            pte_data={"key0": 0, "key1": 1, "key2": 2},
+            external_data={},
+        )
+        pte_data = bytes(
+            serialize_pte_binary(
+                program,
+                extract_delegate_segments=True,
+                segment_alignment=SEGMENT_ALIGNMENT,
+                constant_tensor_alignment=CONSTANT_TENSOR_ALIGNMENT,
+                named_data=named_data,
+                compress_segments=True,
+                compression_block_size=1024,
+            )
+        )
+
+        eh = self.get_and_validate_extended_header(pte_data)
+        program_with_segments = _json_to_program(_program_flatbuffer_to_json(pte_data))
+        segment_table: List[DataSegment] = program_with_segments.segments
+        self.assertEqual(len(segment_table), 3)
+        segment_data: bytes = pte_data[eh.segment_base_offset :]
+
+        compressed = segment_table[0]
+        self.assertEqual(compressed.compression, SegmentCompression.LZ4_BLOCKS)
+        self.assertEqual(compressed.uncompressed_size, len(buffers[0].buffer))
+        self.assertEqual(compressed.compression_block_size, 1024)
+        self.assertLess(compressed.size, len(buffers[0].buffer))
+        self.assertEqual(compressed.offset % SEGMENT_ALIGNMENT, 0)
+        self.assertEqual(
+            decompress_segment(
+                CompressedSegment(
+                    data=segment_data[
+                        compressed.offset : compressed.offset + compressed.size
+                    ],
+                    uncompressed_size=compressed.uncompressed_size,
+                    block_size=compressed.compression_block_size,
+                )
+            ),
+            buffers[0].buffer,
+        )
+
+        for i in (1, 2):
+            segment = segment_table[i]
+            self.assertEqual(segment.compression, SegmentCompression.NONE)
+            self.assertEqual(
+                segment_data[segment.offset : segment.offset + segment.size],
+                buffers[i].buffer,
+            )
+
 
 # Common data for extended header tests. The two example values should produce
 # the example data.
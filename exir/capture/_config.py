@@ -98,6 +98,11 @@ class ExecutorchBackendConfig:
     # external to the PTE file.
     external_constants: bool = False
 
+    # If set to true, constant and named data segments of the PTE file and of
+    # PTD files are LZ4-compressed when that makes them smaller. The runtime
+    # decompresses them at load time, trading load time for file size.
+    compress_segments: bool = False
+
     # If set to true, all trainable weights will be stored in a separate file,
     # external to the PTE file.
     external_mutable_weights: bool = False
@@ -17,8 +17,13 @@
 #include <executorch/runtime/core/freeable_buffer.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/core/span.h>
+#include <executorch/runtime/executor/segment_compression.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <executorch/runtime/platform/compiler.h>
 
+#include <atomic>
+#include <new>
+
 using executorch::runtime::Error;
 using executorch::runtime::FreeableBuffer;
 using executorch::runtime::Result;
@@ -27,6 +32,9 @@ using executorch::runtime::Span;
 using executorch::aten::ScalarType;
 using executorch::ET_RUNTIME_NAMESPACE::TensorLayout;
 using executorch::runtime::DataLoader;
+using executorch::runtime::internal::CompressedSegment;
+using executorch::runtime::internal::decompress_segment_blocks;
+using executorch::runtime::internal::kDecompressedSegmentAlignment;
 
 namespace executorch {
 namespace extension {
@@ -46,46 +54,124 @@ bool is_aligned(const void* data) {
 
 Result<const flat_tensor_flatbuffer::NamedData*> get_named_data(
     executorch::aten::string_view key,
+    const std::unordered_map<std::string_view, uint32_t>& key_index,
     const flatbuffers::Vector<
         flatbuffers::Offset<flat_tensor_flatbuffer::NamedData>>* named_data,
     const flatbuffers::Vector<
         flatbuffers::Offset<flat_tensor_flatbuffer::DataSegment>>* segments,
     size_t segment_end_offset) {
-  // Linear search by name.
-  if (named_data == nullptr) {
+  auto it = key_index.find(std::string_view(key.data(), key.size()));
+  if (it == key_index.end()) {
     return Error::NotFound;
   }
-  for (flatbuffers::uoffset_t i = 0; i < named_data->size(); ++i) {
-    if (key.size() == named_data->Get(i)->key()->size() &&
-        std::strncmp(
-            named_data->Get(i)->key()->c_str(),
-            key.data(),
-            named_data->Get(i)->key()->size()) == 0) {
-      const auto* found = named_data->Get(i);
-      // Validate the named_data.
-      size_t segment_index = found->segment_index();
-      ET_CHECK_OR_RETURN_ERROR(
-          segment_index >= 0 && segment_index < segments->size(),
-          InvalidExternalData,
-          "Segment index %zu for key %.*s is out of bounds for segment size %d. Malformed PTD file.",
-          segment_index,
-          static_cast<int>(key.size()),
-          key.data(),
-          segments->size());
-      // Validate the segment.
-      ET_CHECK_OR_RETURN_ERROR(
-          (segments->Get(segment_index)->offset() +
-           segments->Get(segment_index)->size()) <= segment_end_offset,
-          InvalidExternalData,
-          "Invalid segment offset %" PRIu64
-          " is larger than the segment_base_offset + segment_data_size %" PRIu64
-          "; malformed PTD file.",
-          segments->Get(segment_index)->offset(),
-          static_cast<uint64_t>(segment_end_offset));
-      return found;
-    }
+  const auto* found = named_data->Get(it->second);
+  // Validate the named_data.
+  size_t segment_index = found->segment_index();
+  ET_CHECK_OR_RETURN_ERROR(
+      segment_index >= 0 && segment_index < segments->size(),
+      InvalidExternalData,
+      "Segment index %zu for key %.*s is out of bounds for segment size %d. Malformed PTD file.",
+      segment_index,
+      static_cast<int>(key.size()),
+      key.data(),
+      segments->size());
+  // Validate the segment.
+  ET_CHECK_OR_RETURN_ERROR(
+      (segments->Get(segment_index)->offset() +
+       segments->Get(segment_index)->size()) <= segment_end_offset,
+      InvalidExternalData,
+      "Invalid segment offset %" PRIu64
+      " is larger than the segment_base_offset + segment_data_size %" PRIu64
+      "; malformed PTD file.",
+      segments->Get(segment_index)->offset(),
+      static_cast<uint64_t>(segment_end_offset));
+  return found;
+}
+
+bool is_compressed(const flat_tensor_flatbuffer::DataSegment* segment) {
+  return segment->compression() !=
+      flat_tensor_flatbuffer::SegmentCompression::NONE;
+}
+
+/**
+ * Loads a compressed segment and decompresses its blocks in parallel into
+ * `out`, which must hold `segment->uncompressed_size()` bytes.
+ */
+Error load_compressed_segment_into(
+    DataLoader* loader,
+    size_t segment_base_offset,
+    const flat_tensor_flatbuffer::DataSegment* segment,
+    void* out) {
+  ET_CHECK_OR_RETURN_ERROR(
+      segment->compression() ==
+          flat_tensor_flatbuffer::SegmentCompression::LZ4_BLOCKS,
+      NotSupported,
+      "Unsupported segment compression %d",
+      static_cast<int>(segment->compression()));
+  ET_CHECK_OR_RETURN_ERROR(
+      segment->compression_block_size() > 0 ||
+          segment->uncompressed_size() == 0,
+      InvalidExternalData,
+      "Compressed segment has no block size; malformed PTD file.");
+  Result<FreeableBuffer> compressed = loader->load(
+      segment_base_offset + segment->offset(),
+      segment->size(),
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant));
+  if (!compressed.ok()) {
+    return compressed.error();
   }
-  return Error::NotFound;
+  const CompressedSegment compressed_segment{
+      compressed->data(),
+      compressed->size(),
+      segment->uncompressed_size(),
+      segment->compression_block_size()};
+  std::atomic<bool> failed{false};
+  const bool completed = executorch::extension::parallel_for(
+      0,
+      compressed_segment.num_blocks(),
+      /*grain_size=*/1,
+      [&](int64_t begin, int64_t end) {
+        if (decompress_segment_blocks(compressed_segment, out, begin, end) !=
+            Error::Ok) {
+          failed = true;
+        }
+      });
+  ET_CHECK_OR_RETURN_ERROR(
+      completed && !failed,
+      InvalidExternalData,
+      "Failed to decompress segment; malformed PTD file.");
+  return Error::Ok;
+}
+
+void free_decompressed_segment(void*, void* data, size_t) {
+  ::operator delete(data, std::align_val_t(kDecompressedSegmentAlignment));
+}
+
+Result<FreeableBuffer> load_segment(
+    DataLoader* loader,
+    size_t segment_base_offset,
+    const flat_tensor_flatbuffer::DataSegment* segment) {
+  if (!is_compressed(segment)) {
+    return loader->load(
+        /*offset=*/segment_base_offset + segment->offset(),
+        segment->size(),
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant));
+  }
+  const size_t size = segment->uncompressed_size();
+  void* data = ::operator new(
+      size, std::align_val_t(kDecompressedSegmentAlignment), std::nothrow);
+  ET_CHECK_OR_RETURN_ERROR(
+      data != nullptr,
+      MemoryAllocationFailed,
+      "Failed to allocate %zu bytes for a decompressed segment",
+      size);
+  Error err =
+      load_compressed_segment_into(loader, segment_base_offset, segment, data);
+  if (err != Error::Ok) {
+    free_decompressed_segment(nullptr, data, size);
+    return err;
+  }
+  return FreeableBuffer(data, size, free_decompressed_segment);
 }
 
 Result<const TensorLayout> create_tensor_layout(
@@ -107,6 +193,7 @@ ET_NODISCARD Result<const TensorLayout> FlatTensorDataMap::get_tensor_layout(
     executorch::aten::string_view key) const {
   Result<const flat_tensor_flatbuffer::NamedData*> named_data = get_named_data(
       key,
+      key_index_,
       flat_tensor_->named_data(),
       flat_tensor_->segments(),
       header_.segment_base_offset + header_.segment_data_size);
@@ -120,6 +207,7 @@ ET_NODISCARD Result<FreeableBuffer> FlatTensorDataMap::get_data(
     executorch::aten::string_view key) const {
   Result<const flat_tensor_flatbuffer::NamedData*> named_data = get_named_data(
       key,
+      key_index_,
       flat_tensor_->named_data(),
       flat_tensor_->segments(),
       header_.segment_base_offset + header_.segment_data_size);
@@ -128,14 +216,10 @@ ET_NODISCARD Result<FreeableBuffer> FlatTensorDataMap::get_data(
   }
 
   uint32_t segment_index = named_data.get()->segment_index();
-  uint64_t segment_offset =
-      flat_tensor_->segments()->Get(segment_index)->offset();
-  uint64_t segment_size = flat_tensor_->segments()->Get(segment_index)->size();
-
-  return loader_->load(
-      /*offset=*/header_.segment_base_offset + segment_offset,
-      segment_size,
-      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant));
+  return load_segment(
+      loader_,
+      header_.segment_base_offset,
+      flat_tensor_->segments()->Get(segment_index));
 }
 
 ET_NODISCARD Error FlatTensorDataMap::load_data_into(
@@ -144,6 +228,7 @@ ET_NODISCARD Error FlatTensorDataMap::load_data_into(
     ET_UNUSED size_t size) const {
   Result<const flat_tensor_flatbuffer::NamedData*> named_data = get_named_data(
       key,
+      key_index_,
       flat_tensor_->named_data(),
       flat_tensor_->segments(),
       header_.segment_base_offset + header_.segment_data_size);
@@ -152,8 +237,8 @@ ET_NODISCARD Error FlatTensorDataMap::load_data_into(
   }
 
   uint32_t segment_index = named_data.get()->segment_index();
-  uint64_t segment_offset =
-      flat_tensor_->segments()->Get(segment_index)->offset();
+  const auto* segment = flat_tensor_->segments()->Get(segment_index);
+  uint64_t segment_offset = segment->offset();
 
   Result<const TensorLayout> tensor_layout =
       create_tensor_layout(named_data.get()->tensor_layout());
@@ -169,6 +254,21 @@ ET_NODISCARD Error FlatTensorDataMap::load_data_into(
       size,
       tensor_layout.get().nbytes());
 
+  if (is_compressed(segment)) {
+    // Decompress straight into the destination.
+    ET_CHECK_OR_RETURN_ERROR(
+        segment->uncompressed_size() == tensor_layout.get().nbytes(),
+        InvalidExternalData,
+        "Segment for key %.*s decompresses to %" PRIu64
+        " bytes, expected %zu; malformed PTD file.",
+        static_cast<int>(key.size()),
+        key.data(),
+        segment->uncompressed_size(),
+        tensor_layout.get().nbytes());
+    return load_compressed_segment_into(
+        loader_, header_.segment_base_offset, segment, buffer);
+  }
+
   // Load mutable data.
   DataLoader::SegmentInfo info = DataLoader::SegmentInfo(
       DataLoader::SegmentInfo::Type::Mutable, 0, nullptr);
@@ -269,8 +369,27 @@ ET_NODISCARD Result<const char*> FlatTensorDataMap::get_key(
       InvalidExternalData,
       "FlatTensor segments is nullptr, malformed PTD file.");
 
+  // Index the keys once, so that lookups don't have to scan named_data. The
+  // first entry wins if a key is repeated.
+  const auto* named_data = flat_tensor->named_data();
+  std::unordered_map<std::string_view, uint32_t> key_index;
+  key_index.reserve(named_data->size());
+  for (flatbuffers::uoffset_t i = 0; i < named_data->size(); ++i) {
+    const auto* key = named_data->Get(i)->key();
+    ET_CHECK_OR_RETURN_ERROR(
+        key != nullptr,
+        InvalidExternalData,
+        "FlatTensor key %u is nullptr, malformed PTD file.",
+        i);
+    key_index.emplace(std::string_view(key->c_str(), key->size()), i);
+  }
+
   return FlatTensorDataMap(
-      fh.get(), std::move(flat_tensor_data.get()), flat_tensor, loader);
+      fh.get(),
+      std::move(flat_tensor_data.get()),
+      flat_tensor,
+      std::move(key_index),
+      loader);
 }
 
 } // namespace extension
@@ -18,6 +18,8 @@
 #include <executorch/runtime/core/tensor_layout.h>
 #include <executorch/runtime/platform/compiler.h>
 
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 
 // Forward declare flatbuffer types. This is a public header and must not
@@ -103,10 +105,12 @@ class FlatTensorDataMap final
       const FlatTensorHeader& header,
       executorch::runtime::FreeableBuffer&& flat_tensor_data,
       const flat_tensor_flatbuffer::FlatTensor* flat_tensor,
+      std::unordered_map<std::string_view, uint32_t>&& key_index,
       executorch::runtime::DataLoader* loader)
       : header_(header),
         flat_tensor_data_(std::move(flat_tensor_data)),
         flat_tensor_(flat_tensor),
+        key_index_(std::move(key_index)),
         loader_(loader) {}
 
   // Not copyable or assignable.
@@ -123,6 +127,10 @@ class FlatTensorDataMap final
   // Flatbuffer representation of the flat_tensor.
   const flat_tensor_flatbuffer::FlatTensor* flat_tensor_;
 
+  // Index into named_data for every key. The keys point into
+  // flat_tensor_data_.
+  std::unordered_map<std::string_view, uint32_t> key_index_;
+
   // Data loader, used to load segment data.
   executorch::runtime::DataLoader* loader_;
 };
@@ -9,6 +9,7 @@
 from dataclasses import dataclass
 from typing import List, Optional
 
+from executorch.exir.schema import SegmentCompression
 from executorch.exir.tensor_layout import TensorLayout
 
 # Note: check executorch/extension/data_format/flat_tensor.fbs for explanations of these fields.
@@ -18,6 +19,9 @@ from executorch.exir.tensor_layout import TensorLayout
 class DataSegment:
     offset: int
     size: int
+    compression: SegmentCompression = SegmentCompression.NONE
+    uncompressed_size: int = 0
+    compression_block_size: int = 0
 
 
 @dataclass
@@ -17,6 +17,13 @@ from typing import ClassVar, Dict, List, Literal, Optional
 
 import executorch.extension.flat_tensor.serialize as serialize_package
 
+from executorch.exir._serialize._compression import (
+    compress_segment,
+    CompressedSegment,
+    decompress_segment,
+    DEFAULT_BLOCK_SIZE,
+    MAX_COMPRESSED_SEGMENT_ALIGNMENT,
+)
 from executorch.exir._serialize._cord import Cord
 from executorch.exir._serialize._dataclass import _DataclassEncoder, _json_to_dataclass
 from executorch.exir._serialize._flatbuffer import _flatc_compile, _flatc_decompile
@@ -31,6 +38,7 @@ from executorch.extension.flat_tensor.serialize.flat_tensor_schema import (
     DataSegment,
     FlatTensor,
     NamedData,
+    SegmentCompression,
 )
 
 # Byte order of numbers written to flat tensor headers. Always little-endian
@@ -96,6 +104,9 @@ def _deserialize_to_flat_tensor(flatbuffer: bytes) -> FlatTensor:
 class FlatTensorConfig:
     tensor_alignment: int = 16
     segment_alignment: int = 16
+    # Whether to LZ4-compress the segments that get smaller that way.
+    compress_segments: bool = False
+    compression_block_size: int = DEFAULT_BLOCK_SIZE
 
 
 @dataclass
@@ -310,19 +321,33 @@ class FlatTensorSerializer(DataSerializer):
                 else 0
             )
             alignment = math.lcm(self.config.segment_alignment, segment.alignment)
-            data_segments.append(
-                DataSegment(
-                    offset=aligned_size(prev_end, alignment),
-                    size=len(segment.data),
-                )
+            segment_data = segment.data
+            data_segment = DataSegment(
+                offset=aligned_size(prev_end, alignment),
+                size=len(segment_data),
             )
+            if (
+                self.config.compress_segments
+                and segment.alignment <= MAX_COMPRESSED_SEGMENT_ALIGNMENT
+                and len(segment_data) > 0
+            ):
+                compressed = compress_segment(
+                    bytes(segment_data), self.config.compression_block_size
+                )
+                if compressed is not None:
+                    segment_data = Cord(compressed.data)
+                    data_segment.size = len(compressed.data)
+                    data_segment.compression = SegmentCompression.LZ4_BLOCKS
+                    data_segment.uncompressed_size = compressed.uncompressed_size
+                    data_segment.compression_block_size = compressed.block_size
+            data_segments.append(data_segment)
             # Pad aggregated_segment_data to segment alignment.
             segment_pad_length = padding_required(
                 len(aggregated_segment_data), alignment
             )
             if segment_pad_length > 0:
                 aggregated_segment_data.append(b"\x00" * segment_pad_length)
-            aggregated_segment_data.append(segment.data)
+            aggregated_segment_data.append(segment_data)
 
         # Create FlatTensor, which describes of the contents of the file and
         # points to all the data segments. It will be serialized to flatbuffer.
@@ -411,15 +436,19 @@ class FlatTensorSerializer(DataSerializer):
             )
 
         # Extract the buffers.
-        buffers = [
-            data[
-                header.segment_base_offset
-                + segment.offset : header.segment_base_offset
-                + segment.offset
-                + segment.size
-            ]
-            for segment in flat_tensor.segments
-        ]
+        buffers = []
+        for segment in flat_tensor.segments:
+            start = header.segment_base_offset + segment.offset
+            buffer = data[start : start + segment.size]
+            if segment.compression == SegmentCompression.LZ4_BLOCKS:
+                buffer = decompress_segment(
+                    CompressedSegment(
+                        data=buffer,
+                        uncompressed_size=segment.uncompressed_size,
+                        block_size=segment.compression_block_size,
+                    )
+                )
+            buffers.append(buffer)
 
         payload = DataPayload(
             buffers=buffers,
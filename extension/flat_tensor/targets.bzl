@@ -10,11 +10,13 @@ def define_common_targets():
             ],
             exported_headers = ["flat_tensor_data_map.h"],
             deps = [
+                "//executorch/extension/threadpool:threadpool",
                 "//executorch/runtime/core:core",
                 "//executorch/runtime/core:evalue",
                 "//executorch/runtime/core:named_data_map" + aten_suffix,
                 "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
                 "//executorch/runtime/core/exec_aten/util:tensor_util",
+                "//executorch/runtime/executor:segment_compression",
             ],
             exported_deps = [
                 "//executorch/extension/flat_tensor/serialize:flat_tensor_header",
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Measures how long it takes to load a .ptd and to resolve every tensor in it
+ * by name, which is what Method::init does for external weights, as the
+ * number of tensors grows.
+ *
+ * Usage: flat_tensor_data_map_benchmark [max tensor count]
+ */
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
+#include <executorch/extension/flat_tensor/serialize/serialize.h>
+#include <executorch/extension/tensor/tensor_ptr_maker.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using executorch::extension::BufferDataLoader;
+using executorch::extension::FlatTensorDataMap;
+using executorch::extension::TensorPtr;
+using executorch::runtime::Error;
+
+int main(int argc, char** argv) {
+  executorch::runtime::runtime_init();
+  const size_t max_count = argc > 1 ? std::atoi(argv[1]) : 16384;
+
+  std::printf(
+      "%10s %12s %14s %14s\n", "tensors", "load us", "resolve us", "ns/key");
+  for (size_t count = 64; count <= max_count; count *= 4) {
+    std::vector<TensorPtr> tensors;
+    std::vector<std::string> keys;
+    std::map<std::string, executorch::aten::Tensor> tensor_map;
+    tensors.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      keys.push_back("model.layers." + std::to_string(i) + ".weight");
+      tensors.push_back(executorch::extension::zeros({4}));
+      tensor_map.emplace(keys.back(), *tensors.back());
+    }
+    std::ostringstream out;
+    if (executorch::extension::flat_tensor::save_ptd(out, tensor_map, 16) !=
+        Error::Ok) {
+      std::printf("failed to serialize %zu tensors\n", count);
+      return 1;
+    }
+    const std::string ptd = out.str();
+    BufferDataLoader loader(ptd.data(), ptd.size());
+
+    const auto start = std::chrono::steady_clock::now();
+    auto data_map = FlatTensorDataMap::load(&loader);
+    const auto loaded = std::chrono::steady_clock::now();
+    if (!data_map.ok()) {
+      std::printf("failed to load %zu tensors\n", count);
+      return 1;
+    }
+    for (const auto& key : keys) {
+      auto layout = data_map->get_tensor_layout(key.c_str());
+      auto data = data_map->get_data(key.c_str());
+      if (!layout.ok() || !data.ok()) {
+        std::printf("failed to resolve %s\n", key.c_str());
+        return 1;
+      }
+    }
+    const auto resolved = std::chrono::steady_clock::now();
+
+    const double load_us =
+        std::chrono::duration<double, std::micro>(loaded - start).count();
+    const double resolve_us =
+        std::chrono::duration<double, std::micro>(resolved - loaded).count();
+    std::printf(
+        "%10zu %12.1f %14.1f %14.1f\n",
+        count,
+        load_us,
+        resolve_us,
+        resolve_us * 1000 / count);
+  }
+  return 0;
+}
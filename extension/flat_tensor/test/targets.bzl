@@ -53,3 +53,16 @@ def define_common_targets(is_fbcode=False):
             ],
             env = modules_env,
         )
+
+    runtime.cxx_binary(
+        name = "flat_tensor_data_map_benchmark",
+        srcs = [
+            "flat_tensor_data_map_benchmark.cpp",
+        ],
+        deps = [
+            "//executorch/extension/data_loader:buffer_data_loader",
+            "//executorch/extension/flat_tensor:flat_tensor_data_map",
+            "//executorch/extension/flat_tensor/serialize:serialize_cpp",
+            "//executorch/extension/tensor:tensor",
+        ],
+    )
@@ -151,6 +151,17 @@ def fast_hadamard_transform_meta(mat):
     return torch.empty_like(mat)
 
 
+@impl(custom_ops_lib, "rms_norm", "Meta")
+def rms_norm_meta(input, weight, eps):
+    assert weight.dim() == 1 and weight.size(0) == input.size(
+        -1
+    ), f"Expected weight of shape ({input.size(-1)},) but got {tuple(weight.shape)}"
+    assert (
+        input.dtype == weight.dtype
+    ), f"Expected input and weight to have the same dtype but got {input.dtype} and {weight.dtype}"
+    return torch.empty_like(input)
+
+
 @impl(custom_ops_lib, "custom_sdpa", "Meta")
 def custom_sdpa(
     query,
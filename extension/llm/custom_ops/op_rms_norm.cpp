@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+void rms_norm_row(
+    const float* in,
+    const float* weight,
+    float* out,
+    int64_t size,
+    float eps) {
+  using Vec = at::vec::Vectorized<float>;
+  constexpr int64_t kVecSize = Vec::size();
+
+  Vec sum_sq_vec(0.0f);
+  int64_t i = 0;
+  for (; i + kVecSize <= size; i += kVecSize) {
+    const Vec x = Vec::loadu(in + i);
+    sum_sq_vec = at::vec::fmadd(x, x, sum_sq_vec);
+  }
+  float sum_sq = at::vec::vec_reduce_all<float>(
+      [](Vec& a, Vec& b) { return a + b; }, sum_sq_vec);
+  for (; i < size; ++i) {
+    sum_sq += in[i] * in[i];
+  }
+
+  const float rstd = 1.0f / std::sqrt(sum_sq / size + eps);
+  at::vec::map2(
+      [rstd](Vec x, Vec w) { return x * Vec(rstd) * w; },
+      out,
+      in,
+      weight,
+      size);
+}
+
+// Half and bfloat16 rows accumulate in float, and round the normalized value
+// back to CTYPE before scaling it, as `.type_as(x) * weight` does in eager.
+template <typename CTYPE>
+void rms_norm_row(
+    const CTYPE* in,
+    const CTYPE* weight,
+    CTYPE* out,
+    int64_t size,
+    float eps) {
+  float sum_sq = 0;
+  for (int64_t i = 0; i < size; ++i) {
+    const float x = static_cast<float>(in[i]);
+    sum_sq += x * x;
+  }
+  const float rstd = 1.0f / std::sqrt(sum_sq / size + eps);
+  for (int64_t i = 0; i < size; ++i) {
+    const CTYPE normed = static_cast<CTYPE>(static_cast<float>(in[i]) * rstd);
+    out[i] = static_cast<CTYPE>(
+        static_cast<float>(normed) * static_cast<float>(weight[i]));
+  }
+}
+
+bool check_rms_norm_args(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& out) {
+  ET_CHECK_OR_RETURN_FALSE(
+      input.dim() >= 1, "input must have at least one dimension");
+  ET_CHECK_OR_RETURN_FALSE(weight.dim() == 1, "weight must be 1-D");
+  ET_CHECK_OR_RETURN_FALSE(
+      weight.size(0) == input.size(input.dim() - 1),
+      "weight has %zd elements but the last dim of input has %zd",
+      static_cast<ssize_t>(weight.size(0)),
+      static_cast<ssize_t>(input.size(input.dim() - 1)));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, weight, out));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(input));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(out));
+  return true;
+}
+
+} // namespace
+
+Tensor& rms_norm_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const double eps,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, check_rms_norm_args(input, weight, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  const int64_t size = input.size(input.dim() - 1);
+  if (input.numel() == 0 || size == 0) {
+    return out;
+  }
+  const int64_t num_rows = input.numel() / size;
+
+  ET_SWITCH_FLOATHBF16_TYPES(
+      input.scalar_type(), ctx, "rms_norm.out", CTYPE, [&]() {
+        const CTYPE* const in_data = input.const_data_ptr<CTYPE>();
+        const CTYPE* const weight_data = weight.const_data_ptr<CTYPE>();
+        CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+        ::executorch::extension::parallel_for(
+            0,
+            num_rows,
+            std::max<int64_t>(
+                1, ::executorch::extension::internal::GRAIN_SIZE / size),
+            [&](const auto begin, const auto end) {
+              for (int64_t r = begin; r < end; ++r) {
+                rms_norm_row(
+                    in_data + r * size,
+                    weight_data,
+                    out_data + r * size,
+                    size,
+                    static_cast<float>(eps));
+              }
+            });
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "rms_norm.out",
+    torch::executor::native::rms_norm_out);
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch::executor::native {
+
+// Fused RMSNorm over the last dimension of `input`, matching
+// examples/models/llama/norm.py:
+//
+//   out = (input * rsqrt(mean(input^2, -1) + eps)) * weight
+//
+// `weight` must be 1-D with input.size(-1) elements. `input`, `weight` and
+// `out` must share a floating-point dtype and be contiguous. The
+// mean is accumulated in float.
+Tensor& rms_norm_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const double eps,
+    Tensor& out);
+} // namespace torch::executor::native
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/aten_util/make_aten_functor_from_et_functor.h>
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+
+#include <torch/library.h>
+
+namespace torch::executor::native {
+namespace {
+Tensor& rms_norm_out_no_context(
+    const Tensor& input,
+    const Tensor& weight,
+    const double eps,
+    Tensor& out) {
+  executorch::aten::RuntimeContext context;
+  return rms_norm_out(context, input, weight, eps, out);
+}
+at::Tensor rms_norm_aten(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const double eps) {
+  auto out = at::empty_like(input);
+  WRAP_TO_ATEN(rms_norm_out_no_context, 3)
+  (input, weight, eps, out);
+  return out;
+}
+} // namespace
+} // namespace torch::executor::native
+
+TORCH_LIBRARY_FRAGMENT(llama, m) {
+  m.def("rms_norm(Tensor input, Tensor weight, float eps) -> Tensor");
+  m.def(
+      "rms_norm.out(Tensor input, Tensor weight, float eps, *, Tensor(a!) out) -> Tensor(a!)");
+}
+
+TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
+  m.impl("rms_norm", torch::executor::native::rms_norm_aten);
+  m.impl(
+      "rms_norm.out",
+      WRAP_TO_ATEN(torch::executor::native::rms_norm_out_no_context, 3));
+}
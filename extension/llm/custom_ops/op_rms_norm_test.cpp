@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+
+class OpRmsNormOutTest : public OperatorTest {
+ protected:
+  Tensor& op_rms_norm_out(
+      const Tensor& input,
+      const Tensor& weight,
+      double eps,
+      Tensor& out) {
+    return torch::executor::native::rms_norm_out(
+        context_, input, weight, eps, out);
+  }
+};
+
+TEST_F(OpRmsNormOutTest, MatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // A row length that is not a multiple of the vector width.
+  constexpr int32_t kRows = 3;
+  constexpr int32_t kCols = 37;
+  constexpr double kEps = 1e-5;
+  std::vector<float> input(kRows * kCols);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = std::sin(static_cast<float>(i)) * 3;
+  }
+  std::vector<float> weight(kCols);
+  for (size_t i = 0; i < weight.size(); ++i) {
+    weight[i] = 0.5f + 0.01f * i;
+  }
+  std::vector<float> expected(input.size());
+  for (int32_t r = 0; r < kRows; ++r) {
+    double sum_sq = 0;
+    for (int32_t c = 0; c < kCols; ++c) {
+      sum_sq += input[r * kCols + c] * input[r * kCols + c];
+    }
+    const double rstd = 1 / std::sqrt(sum_sq / kCols + kEps);
+    for (int32_t c = 0; c < kCols; ++c) {
+      expected[r * kCols + c] = input[r * kCols + c] * rstd * weight[c];
+    }
+  }
+
+  Tensor out = tf.zeros({kRows, kCols});
+  op_rms_norm_out(
+      tf.make({kRows, kCols}, input), tf.make({kCols}, weight), kEps, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({kRows, kCols}, expected));
+}
+
+TEST_F(OpRmsNormOutTest, Half) {
+  TensorFactory<ScalarType::Half> tf;
+
+  Tensor out = tf.zeros({2, 2});
+  op_rms_norm_out(
+      tf.make({2, 2}, {3, 4, 0, 2}), tf.make({2}, {1, 2}), 0, out);
+  // rms of [3, 4] is sqrt(12.5) and of [0, 2] is sqrt(2).
+  EXPECT_TENSOR_CLOSE(
+      out, tf.make({2, 2}, {0.8485281f, 2.2627417f, 0, 2.8284271f}));
+}
+
+TEST_F(OpRmsNormOutTest, MismatchedWeightDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor out = tf.zeros({2, 3});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_rms_norm_out(tf.ones({2, 3}), tf.ones({2}), 1e-6, out));
+}
@@ -147,6 +147,9 @@ class ModelConfig:
         use_sdpa_with_kv_cache: Whether to use flash attention by substituting
             for our custom SDPA op. Note that the naming is poor and this
             doesn't actually have anything to do with the kv_cache at the moment.
+        use_custom_rms_norm: Whether to replace each RMSNorm with the fused
+            llama::rms_norm custom op. Only supported by the XNNPACK / portable
+            CPU flow; other backends can't delegate the op.
         expand_rope_table: Temporary workaround to expand sin/cos table in head
             dim to take vectorized path in optimized kernels.
         use_attention_sink: Whether to use attention sink to support multi-round
@@ -167,6 +170,7 @@ class ModelConfig:
     enable_dynamic_shape: bool = True
     use_shared_embedding: bool = False
     use_sdpa_with_kv_cache: bool = False
+    use_custom_rms_norm: bool = False
     expand_rope_table: bool = False
     use_attention_sink: Optional[str] = None
     output_prune_map: Optional[str] = None
@@ -559,6 +563,8 @@ class LlmConfig:
             llm_config.model.use_shared_embedding = args.use_shared_embedding
         if hasattr(args, "use_sdpa_with_kv_cache"):
             llm_config.model.use_sdpa_with_kv_cache = args.use_sdpa_with_kv_cache
+        if hasattr(args, "use_custom_rms_norm"):
+            llm_config.model.use_custom_rms_norm = args.use_custom_rms_norm
         if hasattr(args, "expand_rope_table"):
             llm_config.model.expand_rope_table = args.expand_rope_table
         if hasattr(args, "use_attention_sink"):
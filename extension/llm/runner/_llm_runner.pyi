@@ -32,6 +32,9 @@ class GenerationConfig:
     num_eos: int
     """Number of EOS tokens to add to the prompt."""
 
+    callback_queue_size: int
+    """Tokens that may wait for the token callback, which then runs on a separate thread (0 to run it inline)."""
+
     def __init__(
         self,
         *,
@@ -42,6 +45,7 @@ class GenerationConfig:
         temperature: float = 0.8,
         num_bos: int = 0,
         num_eos: int = 0,
+        callback_queue_size: int = 0,
     ) -> None:
         """Initialize GenerationConfig with optional keyword arguments for all fields."""
         ...
@@ -105,6 +109,15 @@ class Stats:
     num_generated_tokens: int
     """Number of tokens generated."""
 
+    num_cached_prompt_tokens: int
+    """Number of prompt tokens reused from the KV cache instead of prefilled."""
+
+    num_draft_tokens: int
+    """Number of tokens proposed by the draft model in speculative decoding."""
+
+    num_accepted_draft_tokens: int
+    """Number of draft tokens accepted by the target model."""
+
     def on_sampling_begin(self) -> None:
         """Mark the beginning of a sampling operation."""
         ...
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/batched_decoder_runner.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+BatchedDecoderRunner::BatchedDecoderRunner(
+    Module* module,
+    std::string method_name)
+    : module_(module), method_name_(std::move(method_name)) {}
+
+Result<executorch::aten::Tensor> BatchedDecoderRunner::step(
+    std::vector<uint64_t>& tokens,
+    int64_t num_rows,
+    std::vector<int64_t>& cache_slots,
+    std::vector<int64_t>& start_pos) {
+  ET_CHECK_OR_RETURN_ERROR(
+      num_rows > 0 && tokens.size() % num_rows == 0,
+      InvalidArgument,
+      "%zu tokens cannot be split into %" PRId64 " rows",
+      tokens.size(),
+      num_rows);
+  ET_CHECK_OR_RETURN_ERROR(
+      cache_slots.size() == static_cast<size_t>(num_rows) &&
+          start_pos.size() == static_cast<size_t>(num_rows),
+      InvalidArgument,
+      "Expected %" PRId64 " cache slots and start positions, got %zu and %zu",
+      num_rows,
+      cache_slots.size(),
+      start_pos.size());
+  const auto seq_len = static_cast<int64_t>(tokens.size()) / num_rows;
+
+  auto tokens_tensor = from_blob(
+      tokens.data(),
+      {static_cast<executorch::aten::SizesType>(num_rows),
+       static_cast<executorch::aten::SizesType>(seq_len)},
+      executorch::aten::ScalarType::Long);
+  auto slots_tensor = from_blob(
+      cache_slots.data(),
+      {static_cast<executorch::aten::SizesType>(num_rows)},
+      executorch::aten::ScalarType::Long);
+  auto start_pos_tensor = from_blob(
+      start_pos.data(),
+      {static_cast<executorch::aten::SizesType>(num_rows)},
+      executorch::aten::ScalarType::Long);
+
+  auto outputs_res = module_->execute(
+      method_name_,
+      std::vector<runtime::EValue>{
+          tokens_tensor, slots_tensor, start_pos_tensor});
+  ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
+  ET_CHECK_OR_RETURN_ERROR(
+      outputs_res.get().size() == 1 && outputs_res.get()[0].isTensor(),
+      InvalidState,
+      "Expected a single logits tensor output from the batched decoder");
+
+  auto logits = outputs_res.get()[0].toTensor();
+  ET_CHECK_OR_RETURN_ERROR(
+      logits.dim() >= 2 && logits.size(0) == num_rows,
+      InvalidState,
+      "Expected logits with %" PRId64 " rows",
+      num_rows);
+  return logits;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Run a text decoder over a batch of independent sequences, each of which owns
+// one row ("slot") of the model's KV cache.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Runs a text decoder that was exported with a batch dimension and a KV cache
+ * with one row per concurrent sequence.
+ *
+ * The method is expected to take three inputs:
+ *   - tokens: Long tensor of shape [num_rows, seq_len].
+ *   - cache_slots: Long tensor of shape [num_rows], the KV cache row each
+ *     input row reads from and writes to.
+ *   - input_pos: Long tensor of shape [num_rows], the position in its own
+ *     sequence of the first token of each row.
+ * and to return logits of shape [num_rows, vocab_size] or
+ * [num_rows, seq_len, vocab_size].
+ *
+ * num_rows may be smaller than the number of cache slots, so the batch
+ * dimension of the inputs must be dynamic.
+ */
+class ET_EXPERIMENTAL BatchedDecoderRunner {
+ public:
+  explicit BatchedDecoderRunner(
+      Module* module,
+      std::string method_name = "forward");
+
+  virtual ~BatchedDecoderRunner() = default;
+
+  /**
+   * Run the decoder on a batch of rows.
+   * @param tokens Row-major token ids of shape [num_rows, seq_len].
+   * @param num_rows Number of rows in the batch.
+   * @param cache_slots KV cache slot of every row.
+   * @param start_pos Start position of every row in its sequence.
+   * @return The logits tensor. It is only valid until the next call.
+   */
+  virtual ::executorch::runtime::Result<executorch::aten::Tensor> step(
+      std::vector<uint64_t>& tokens,
+      int64_t num_rows,
+      std::vector<int64_t>& cache_slots,
+      std::vector<int64_t>& start_pos);
+
+  /**
+   * Load the decoder method.
+   * @return The error code.
+   */
+  virtual ::executorch::runtime::Error load() {
+    return module_->load_method(method_name_);
+  }
+
+  /**
+   * Check if the decoder method is loaded.
+   * @return True if the method is loaded, false otherwise.
+   */
+  virtual bool is_method_loaded() {
+    return module_->is_method_loaded(method_name_);
+  }
+
+ protected:
+  /**
+   * Note: BatchedDecoderRunner does not own the Module. The caller is
+   * responsible for keeping it alive for as long as this object is used.
+   */
+  Module* module_;
+  std::string method_name_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/continuous_batching_runner.h>
+
+#include <algorithm>
+
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+ContinuousBatchingRunner::ContinuousBatchingRunner(
+    ::tokenizers::Tokenizer* tokenizer,
+    BatchedDecoderRunner* decoder_runner,
+    std::unique_ptr<std::unordered_set<uint64_t>> eos_ids,
+    int64_t max_batch_size,
+    int64_t max_context_len,
+    int64_t prefill_chunk_size)
+    : tokenizer_(tokenizer),
+      decoder_runner_(decoder_runner),
+      eos_ids_(std::move(eos_ids)),
+      max_batch_size_(max_batch_size > 0 ? max_batch_size : 1),
+      max_context_len_(max_context_len),
+      prefill_chunk_size_(prefill_chunk_size > 0 ? prefill_chunk_size : 128) {
+  // Hand out low slots first.
+  free_slots_.reserve(max_batch_size_);
+  for (int64_t slot = max_batch_size_ - 1; slot >= 0; --slot) {
+    free_slots_.push_back(slot);
+  }
+  active_.reserve(max_batch_size_);
+  batch_tokens_.reserve(max_batch_size_);
+  batch_slots_.reserve(max_batch_size_);
+  batch_pos_.reserve(max_batch_size_);
+}
+
+Error ContinuousBatchingRunner::load() {
+  if (is_loaded()) {
+    return Error::Ok;
+  }
+  return decoder_runner_->load();
+}
+
+bool ContinuousBatchingRunner::is_loaded() const {
+  return tokenizer_->is_loaded() && decoder_runner_->is_method_loaded();
+}
+
+Result<uint64_t> ContinuousBatchingRunner::submit(
+    const std::string& prompt,
+    const GenerationConfig& config,
+    std::function<void(const std::string&)> token_callback,
+    std::function<void(const Stats&)> stats_callback) {
+  ET_CHECK_OR_RETURN_ERROR(
+      !prompt.empty(), InvalidArgument, "Prompt cannot be empty");
+
+  auto seq = std::make_unique<Sequence>();
+  seq->stats.reset(/*all_stats=*/true);
+  seq->stats.inference_start_ms = time_in_ms();
+
+  auto encode_res = tokenizer_->encode(prompt, config.num_bos, config.num_eos);
+  if (!encode_res.ok()) {
+    ET_LOG(
+        Error,
+        "Failed to encode prompt %s. Tokenizers error code %d",
+        prompt.c_str(),
+        static_cast<uint32_t>(encode_res.error()));
+    return Error::InvalidArgument;
+  }
+  seq->prompt_tokens = std::move(*encode_res);
+  const auto num_prompt_tokens =
+      static_cast<int32_t>(seq->prompt_tokens.size());
+  ET_CHECK_OR_RETURN_ERROR(
+      num_prompt_tokens >= 1,
+      InvalidArgument,
+      "Expected at least 1 prompt token");
+  ET_CHECK_OR_RETURN_ERROR(
+      num_prompt_tokens < max_context_len_,
+      InvalidArgument,
+      "num_prompt_tokens %d >= max_context_len %" PRId64,
+      num_prompt_tokens,
+      max_context_len_);
+
+  seq->max_new_tokens = config.resolve_max_new_tokens(
+      static_cast<int32_t>(max_context_len_), num_prompt_tokens);
+  ET_CHECK_OR_RETURN_ERROR(
+      seq->max_new_tokens > 0,
+      InvalidArgument,
+      "Max new tokens %" PRId64 " is less than or equal to 0",
+      seq->max_new_tokens);
+
+  seq->stats.num_prompt_tokens = num_prompt_tokens;
+  seq->stats.token_encode_end_ms = time_in_ms();
+  seq->sampler = std::make_unique<Sampler>(
+      static_cast<int32_t>(tokenizer_->vocab_size()), config.temperature);
+  seq->token_callback = std::move(token_callback);
+  seq->stats_callback = std::move(stats_callback);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  seq->id = next_request_id_++;
+  const auto id = seq->id;
+  live_ids_.insert(id);
+  pending_.push_back(std::move(seq));
+  return id;
+}
+
+void ContinuousBatchingRunner::cancel(uint64_t request_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (live_ids_.find(request_id) != live_ids_.end()) {
+    cancelled_.insert(request_id);
+  }
+}
+
+size_t ContinuousBatchingRunner::num_active() const {
+  return active_.size();
+}
+
+size_t ContinuousBatchingRunner::num_pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.size();
+}
+
+size_t ContinuousBatchingRunner::num_cancelled() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cancelled_.size();
+}
+
+Result<bool> ContinuousBatchingRunner::step() {
+  if (!is_loaded()) {
+    ET_CHECK_OK_OR_RETURN_ERROR(load());
+  }
+  retire_finished();
+  ET_CHECK_OK_OR_RETURN_ERROR(admit_pending());
+  // Prefill is chunked and interleaved with decode so that a long prompt
+  // delays the running sequences by at most one chunk per step.
+  ET_CHECK_OK_OR_RETURN_ERROR(prefill_one_chunk());
+  ET_CHECK_OK_OR_RETURN_ERROR(decode_active());
+  retire_finished();
+  return !active_.empty() || num_pending() > 0;
+}
+
+Error ContinuousBatchingRunner::run_until_idle() {
+  while (true) {
+    auto res = step();
+    ET_CHECK_OK_OR_RETURN_ERROR(res.error());
+    if (!res.get()) {
+      return Error::Ok;
+    }
+  }
+}
+
+Error ContinuousBatchingRunner::admit_pending() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    if (cancelled_.erase((*it)->id) > 0) {
+      live_ids_.erase((*it)->id);
+      it = pending_.erase(it);
+      continue;
+    }
+    if (free_slots_.empty()) {
+      break;
+    }
+    (*it)->slot = free_slots_.back();
+    free_slots_.pop_back();
+    active_.push_back(std::move(*it));
+    it = pending_.erase(it);
+  }
+  return Error::Ok;
+}
+
+Error ContinuousBatchingRunner::prefill_one_chunk() {
+  auto it = std::find_if(active_.begin(), active_.end(), [](const auto& seq) {
+    return seq->state == SequenceState::Prefilling;
+  });
+  if (it == active_.end()) {
+    return Error::Ok;
+  }
+  Sequence& seq = **it;
+  const auto num_prompt_tokens =
+      static_cast<int64_t>(seq.prompt_tokens.size());
+  const auto chunk_len =
+      std::min(num_prompt_tokens - seq.num_prefilled, prefill_chunk_size_);
+
+  batch_tokens_.assign(
+      seq.prompt_tokens.begin() + seq.num_prefilled,
+      seq.prompt_tokens.begin() + seq.num_prefilled + chunk_len);
+  batch_slots_.assign(1, seq.slot);
+  batch_pos_.assign(1, seq.pos);
+
+  auto logits_res =
+      decoder_runner_->step(batch_tokens_, 1, batch_slots_, batch_pos_);
+  ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+  seq.num_prefilled += chunk_len;
+  seq.pos += chunk_len;
+
+  if (seq.num_prefilled < num_prompt_tokens) {
+    return Error::Ok;
+  }
+  // The whole prompt is in the cache, the logits of its last token give the
+  // first generated token.
+  seq.stats.prompt_eval_end_ms = time_in_ms();
+  auto token_res = sample_row(seq, logits_res.get(), 0);
+  ET_CHECK_OK_OR_RETURN_ERROR(token_res.error());
+  seq.cur_token = token_res.get();
+  seq.stats.first_token_ms = time_in_ms();
+  seq.state = SequenceState::Decoding;
+  return emit_token(seq, seq.prompt_tokens.back());
+}
+
+Error ContinuousBatchingRunner::decode_active() {
+  batch_tokens_.clear();
+  batch_slots_.clear();
+  batch_pos_.clear();
+  std::vector<Sequence*> rows;
+  rows.reserve(active_.size());
+  for (auto& seq : active_) {
+    if (seq->state != SequenceState::Decoding) {
+      continue;
+    }
+    batch_tokens_.push_back(seq->cur_token);
+    batch_slots_.push_back(seq->slot);
+    batch_pos_.push_back(seq->pos);
+    rows.push_back(seq.get());
+  }
+  if (rows.empty()) {
+    return Error::Ok;
+  }
+
+  auto logits_res = decoder_runner_->step(
+      batch_tokens_,
+      static_cast<int64_t>(rows.size()),
+      batch_slots_,
+      batch_pos_);
+  ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+
+  for (size_t row = 0; row < rows.size(); ++row) {
+    Sequence& seq = *rows[row];
+    seq.pos++;
+    const auto prev_token = seq.cur_token;
+    auto token_res = sample_row(seq, logits_res.get(), row);
+    ET_CHECK_OK_OR_RETURN_ERROR(token_res.error());
+    seq.cur_token = token_res.get();
+    ET_CHECK_OK_OR_RETURN_ERROR(emit_token(seq, prev_token));
+  }
+  return Error::Ok;
+}
+
+Error ContinuousBatchingRunner::emit_token(Sequence& seq, uint64_t prev_token) {
+  seq.num_generated++;
+  auto decode_res = tokenizer_->decode(prev_token, seq.cur_token);
+  if (!decode_res.ok()) {
+    ET_LOG(
+        Error,
+        "Tokenizers error code %d",
+        static_cast<uint32_t>(decode_res.error()));
+    return Error::InvalidArgument;
+  }
+  if (seq.token_callback) {
+    seq.token_callback(*decode_res);
+  }
+
+  bool cancelled;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled = cancelled_.erase(seq.id) > 0;
+  }
+  if (cancelled || seq.num_generated >= seq.max_new_tokens ||
+      seq.pos >= max_context_len_ ||
+      eos_ids_->find(seq.cur_token) != eos_ids_->end()) {
+    seq.state = SequenceState::Finished;
+  }
+  return Error::Ok;
+}
+
+void ContinuousBatchingRunner::retire_finished() {
+  std::vector<uint64_t> cancelled_ids;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ids.assign(cancelled_.begin(), cancelled_.end());
+  }
+  for (auto& seq : active_) {
+    if (std::find(cancelled_ids.begin(), cancelled_ids.end(), seq->id) !=
+        cancelled_ids.end()) {
+      seq->state = SequenceState::Finished;
+      std::lock_guard<std::mutex> lock(mutex_);
+      cancelled_.erase(seq->id);
+    }
+  }
+
+  auto first_finished = std::stable_partition(
+      active_.begin(), active_.end(), [](const auto& seq) {
+        return seq->state != SequenceState::Finished;
+      });
+  for (auto it = first_finished; it != active_.end(); ++it) {
+    Sequence& seq = **it;
+    {
+      // A cancel() that raced with the sequence finishing on its own is moot.
+      std::lock_guard<std::mutex> lock(mutex_);
+      cancelled_.erase(seq.id);
+      live_ids_.erase(seq.id);
+    }
+    free_slots_.push_back(seq.slot);
+    seq.stats.inference_end_ms = time_in_ms();
+    seq.stats.num_generated_tokens = seq.num_generated;
+    if (seq.stats_callback) {
+      seq.stats_callback(seq.stats);
+    }
+  }
+  active_.erase(first_finished, active_.end());
+}
+
+Result<uint64_t> ContinuousBatchingRunner::sample_row(
+    Sequence& seq,
+    const executorch::aten::Tensor& logits,
+    int64_t row) {
+  const ssize_t vocab_size = logits.size(logits.dim() - 1);
+  // Logits are either [rows, vocab] or [rows, seq_len, vocab]; in the latter
+  // case only the last position of the row is sampled.
+  ssize_t offset = row * vocab_size;
+  if (logits.dim() == 3) {
+    const ssize_t seq_len = logits.size(1);
+    offset = (row * seq_len + seq_len - 1) * vocab_size;
+  }
+
+  uint64_t token = 0;
+  bool supported = true;
+  switch (logits.scalar_type()) {
+    case executorch::aten::ScalarType::Float:
+      token = seq.sampler->sample(logits.mutable_data_ptr<float>() + offset);
+      break;
+    case executorch::aten::ScalarType::Half:
+      token = seq.sampler->sample(
+          logits.mutable_data_ptr<executorch::aten::Half>() + offset);
+      break;
+    case executorch::aten::ScalarType::BFloat16:
+      token = seq.sampler->sample(
+          logits.mutable_data_ptr<executorch::aten::BFloat16>() + offset);
+      break;
+    case executorch::aten::ScalarType::UInt16:
+      token = seq.sampler->sample(logits.mutable_data_ptr<uint16_t>() + offset);
+      break;
+    default:
+      supported = false;
+      break;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      supported,
+      InvalidArgument,
+      "Unsupported logits dtype %s",
+      executorch::runtime::toString(logits.scalar_type()));
+  return token;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Serve many concurrent generation requests with one batched text decoder.
+// Sequences are admitted and retired on every step, and the decode tokens of
+// all active sequences are packed into a single forward.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <executorch/extension/llm/runner/batched_decoder_runner.h>
+#include <executorch/extension/llm/runner/irunner.h>
+#include <executorch/extension/llm/runner/stats.h>
+#include <executorch/extension/llm/sampler/sampler.h>
+#include <pytorch/tokenizers/tokenizer.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+class ET_EXPERIMENTAL ContinuousBatchingRunner {
+ public:
+  /**
+   * @param tokenizer Tokenizer shared by all requests. Not owned.
+   * @param decoder_runner Batched decoder. Not owned.
+   * @param eos_ids Token ids that terminate a sequence.
+   * @param max_batch_size Number of KV cache slots, i.e. the maximum number of
+   * sequences that are active at the same time.
+   * @param max_context_len Maximum number of tokens per KV cache slot.
+   * @param prefill_chunk_size Maximum number of prompt tokens prefilled per
+   * step. Long prompts are split so that they don't stall the decode of the
+   * sequences that are already running.
+   */
+  ContinuousBatchingRunner(
+      ::tokenizers::Tokenizer* tokenizer,
+      BatchedDecoderRunner* decoder_runner,
+      std::unique_ptr<std::unordered_set<uint64_t>> eos_ids,
+      int64_t max_batch_size,
+      int64_t max_context_len,
+      int64_t prefill_chunk_size = 128);
+
+  /**
+   * Load the decoder if it isn't loaded yet.
+   */
+  ::executorch::runtime::Error load();
+
+  bool is_loaded() const;
+
+  /**
+   * Queue a new request. Thread-safe; may be called while another thread is
+   * inside step().
+   *
+   * The prompt is tokenized immediately so invalid prompts are rejected here.
+   * The request is admitted on a later step() once a KV cache slot is free.
+   *
+   * @param prompt The input text.
+   * @param config Generation parameters for this request only.
+   * @param token_callback Called with every decoded piece, in order, from the
+   * thread that drives step().
+   * @param stats_callback Called once when the request retires.
+   * @return An id that can be passed to cancel().
+   */
+  ::executorch::runtime::Result<uint64_t> submit(
+      const std::string& prompt,
+      const GenerationConfig& config,
+      std::function<void(const std::string&)> token_callback = {},
+      std::function<void(const Stats&)> stats_callback = {});
+
+  /**
+   * Ask for a request to stop. Thread-safe. A pending request is dropped
+   * without being admitted; an active one retires at the end of the next
+   * step(). Ids that were never issued or whose request already retired are
+   * ignored.
+   */
+  void cancel(uint64_t request_id);
+
+  /**
+   * Run one scheduling iteration: retire finished sequences, admit pending
+   * ones into free slots, prefill one chunk of the oldest sequence that is
+   * still prefilling, and run a single batched decode forward for all
+   * sequences that are decoding.
+   *
+   * @return True if there is still work left, false when idle.
+   */
+  ::executorch::runtime::Result<bool> step();
+
+  /**
+   * Call step() until all submitted requests have retired.
+   */
+  ::executorch::runtime::Error run_until_idle();
+
+  /**
+   * Number of requests that occupy a KV cache slot. Must be called from the
+   * thread that drives step().
+   */
+  size_t num_active() const;
+
+  /**
+   * Number of requests waiting for a KV cache slot.
+   */
+  size_t num_pending() const;
+
+  /**
+   * Number of cancel() calls that haven't taken effect yet.
+   */
+  size_t num_cancelled() const;
+
+ private:
+  enum class SequenceState {
+    Prefilling,
+    Decoding,
+    Finished,
+  };
+
+  struct Sequence {
+    uint64_t id;
+    int64_t slot = -1;
+    SequenceState state = SequenceState::Prefilling;
+    std::vector<uint64_t> prompt_tokens;
+    // Number of prompt tokens already in the KV cache.
+    int64_t num_prefilled = 0;
+    // Next position to write in this sequence's KV cache slot.
+    int64_t pos = 0;
+    uint64_t cur_token = 0;
+    int64_t num_generated = 0;
+    int64_t max_new_tokens = 0;
+    std::unique_ptr<Sampler> sampler;
+    std::function<void(const std::string&)> token_callback;
+    std::function<void(const Stats&)> stats_callback;
+    Stats stats;
+  };
+
+  ::executorch::runtime::Error admit_pending();
+  ::executorch::runtime::Error prefill_one_chunk();
+  ::executorch::runtime::Error decode_active();
+  void retire_finished();
+  ::executorch::runtime::Result<uint64_t> sample_row(
+      Sequence& seq,
+      const executorch::aten::Tensor& logits,
+      int64_t row);
+  ::executorch::runtime::Error emit_token(Sequence& seq, uint64_t prev_token);
+
+  ::tokenizers::Tokenizer* tokenizer_;
+  BatchedDecoderRunner* decoder_runner_;
+  std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
+  int64_t max_batch_size_;
+  int64_t max_context_len_;
+  int64_t prefill_chunk_size_;
+
+  // Guards pending_, live_ids_, cancelled_ and next_request_id_, which are
+  // touched by submit() and cancel() from arbitrary threads.
+  mutable std::mutex mutex_;
+  std::deque<std::unique_ptr<Sequence>> pending_;
+  // Ids of the requests that are pending or active. cancelled_ is always a
+  // subset, so it can't grow past the number of live requests.
+  std::unordered_set<uint64_t> live_ids_;
+  std::unordered_set<uint64_t> cancelled_;
+  uint64_t next_request_id_ = 0;
+
+  // Only touched by the thread that drives step().
+  std::vector<std::unique_ptr<Sequence>> active_;
+  std::vector<int64_t> free_slots_;
+
+  // Scratch buffers reused across decode steps.
+  std::vector<uint64_t> batch_tokens_;
+  std::vector<int64_t> batch_slots_;
+  std::vector<int64_t> batch_pos_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
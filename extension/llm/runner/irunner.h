@@ -53,6 +53,11 @@ struct GenerationConfig {
   int32_t num_bos = 0;
   int32_t num_eos = 0;
 
+  // Maximum number of generated tokens waiting to be detokenized and passed to
+  // the token callback. If greater than 0, that happens on a separate thread
+  // while the next token is being generated. 0 runs the callback inline.
+  int32_t callback_queue_size = 0;
+
   /**
    * Resolve the maximum number of new tokens to generate based on constraints.
    *
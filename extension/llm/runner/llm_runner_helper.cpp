@@ -96,6 +96,8 @@ get_llm_metadata(tokenizers::Tokenizer* tokenizer, Module* module) {
       {llm::kMaxContextLen, 128},
       {llm::kUseKVCache, true},
       {llm::kUseSDPAWithKVCache, false},
+      // Unknown unless the model says, only needed to save sessions.
+      {llm::kKVCacheSeqDim, -1},
   });
 
   // Read metadata from the model
@@ -15,6 +15,8 @@
 #include <pytorch/tokenizers/hf_tokenizer.h>
 #include <pytorch/tokenizers/sentencepiece.h>
 
+#include <algorithm>
+
 namespace executorch::extension::llm {
 
 using ::executorch::extension::Module;
@@ -175,6 +177,8 @@ Error MultimodalRunner::generate(
 
   // Generate tokens using the text token generator
   std::vector<uint64_t> prompt_tokens = {prefill_next_token};
+  text_token_generator_->set_callback_queue_size(
+      std::max(config.callback_queue_size, 0));
   auto generate_result = text_token_generator_->generate(
       /*tokens=*/prompt_tokens,
       /*start_pos=*/pos_,
@@ -172,7 +172,8 @@ PYBIND11_MODULE(_llm_runner, m) {
                       int32_t seq_len,
                       float temperature,
                       int32_t num_bos,
-                      int32_t num_eos) {
+                      int32_t num_eos,
+                      int32_t callback_queue_size) {
             GenerationConfig cfg;
             cfg.echo = echo;
             cfg.max_new_tokens = max_new_tokens;
@@ -181,6 +182,7 @@ PYBIND11_MODULE(_llm_runner, m) {
             cfg.temperature = temperature;
             cfg.num_bos = num_bos;
             cfg.num_eos = num_eos;
+            cfg.callback_queue_size = callback_queue_size;
             return cfg;
           }),
           py::arg("echo") = true,
@@ -189,7 +191,8 @@ PYBIND11_MODULE(_llm_runner, m) {
           py::arg("seq_len") = -1,
           py::arg("temperature") = 0.8f,
           py::arg("num_bos") = 0,
-          py::arg("num_eos") = 0)
+          py::arg("num_eos") = 0,
+          py::arg("callback_queue_size") = 0)
       .def_readwrite("echo", &GenerationConfig::echo)
       .def_readwrite("max_new_tokens", &GenerationConfig::max_new_tokens)
       .def_readwrite("warming", &GenerationConfig::warming)
@@ -197,6 +200,8 @@ PYBIND11_MODULE(_llm_runner, m) {
       .def_readwrite("temperature", &GenerationConfig::temperature)
       .def_readwrite("num_bos", &GenerationConfig::num_bos)
       .def_readwrite("num_eos", &GenerationConfig::num_eos)
+      .def_readwrite(
+          "callback_queue_size", &GenerationConfig::callback_queue_size)
       .def(
           "resolve_max_new_tokens",
           &GenerationConfig::resolve_max_new_tokens,
@@ -231,6 +236,11 @@ PYBIND11_MODULE(_llm_runner, m) {
           "aggregate_sampling_time_ms", &Stats::aggregate_sampling_time_ms)
       .def_readonly("num_prompt_tokens", &Stats::num_prompt_tokens)
       .def_readonly("num_generated_tokens", &Stats::num_generated_tokens)
+      .def_readonly(
+          "num_cached_prompt_tokens", &Stats::num_cached_prompt_tokens)
+      .def_readonly("num_draft_tokens", &Stats::num_draft_tokens)
+      .def_readonly(
+          "num_accepted_draft_tokens", &Stats::num_accepted_draft_tokens)
       .def("on_sampling_begin", &Stats::on_sampling_begin)
       .def("on_sampling_end", &Stats::on_sampling_end)
       .def(
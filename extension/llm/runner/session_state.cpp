@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/session_state.h>
+
+#include <executorch/extension/data_loader/mmap_data_loader.h>
+#include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
+#include <executorch/extension/flat_tensor/serialize/serialize.h>
+#include <executorch/extension/tensor/tensor.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+
+#include <cstring>
+#include <map>
+
+namespace executorch::extension::llm {
+
+using ::executorch::extension::FlatTensorDataMap;
+using ::executorch::extension::MmapDataLoader;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace {
+
+constexpr const char* kPosKey = "session/pos";
+constexpr const char* kTokensKey = "session/tokens";
+constexpr size_t kSessionTensorAlignment = 16;
+
+// A cache buffer viewed as [outer, seq_len, inner].
+struct CacheView {
+  int64_t seq_dim = 0;
+  int64_t outer = 1;
+  int64_t seq_len = 0;
+  size_t inner_bytes = 0;
+};
+
+// Whether the last component of a buffer's name starts with k_cache or
+// v_cache, which also covers companions such as k_cache_scales.
+bool is_cache_buffer_name(const std::string& name) {
+  const auto dot = name.rfind('.');
+  const auto leaf = dot == std::string::npos ? name : name.substr(dot + 1);
+  return leaf.rfind("k_cache", 0) == 0 || leaf.rfind("v_cache", 0) == 0;
+}
+
+Result<CacheView> make_cache_view(
+    const std::string& name,
+    const executorch::aten::Tensor& tensor,
+    int64_t max_context_len,
+    int64_t kv_cache_seq_dim) {
+  ET_CHECK_OR_RETURN_ERROR(
+      is_cache_buffer_name(name),
+      NotSupported,
+      "Buffer %s is not a KV cache, only k_cache / v_cache buffers can be "
+      "saved",
+      name.c_str());
+  ET_CHECK_OR_RETURN_ERROR(
+      kv_cache_seq_dim >= 0 && kv_cache_seq_dim < tensor.dim(),
+      NotSupported,
+      "Sequence dim %" PRId64 " is not valid for buffer %s of rank %zd",
+      kv_cache_seq_dim,
+      name.c_str(),
+      static_cast<ssize_t>(tensor.dim()));
+  ET_CHECK_OR_RETURN_ERROR(
+      executorch::runtime::is_contiguous_dim_order(
+          tensor.dim_order().data(), tensor.dim()),
+      NotSupported,
+      "Buffer %s is not contiguous",
+      name.c_str());
+  // A ring buffer (sliding window) cache is sized by its window and stores
+  // position p at p % size, so its first `pos` entries aren't the session.
+  ET_CHECK_OR_RETURN_ERROR(
+      tensor.size(kv_cache_seq_dim) == max_context_len,
+      NotSupported,
+      "Buffer %s has %zd entries in dim %" PRId64 ", expected %" PRId64
+      ". Ring buffer caches can't be saved",
+      name.c_str(),
+      static_cast<ssize_t>(tensor.size(kv_cache_seq_dim)),
+      kv_cache_seq_dim,
+      max_context_len);
+  CacheView view;
+  view.seq_dim = kv_cache_seq_dim;
+  view.seq_len = max_context_len;
+  view.inner_bytes = tensor.element_size();
+  for (ssize_t d = 0; d < tensor.dim(); ++d) {
+    if (d < kv_cache_seq_dim) {
+      view.outer *= tensor.size(d);
+    } else if (d > kv_cache_seq_dim) {
+      view.inner_bytes *= tensor.size(d);
+    }
+  }
+  return view;
+}
+
+// Copies `len` sequence entries of every outer row between buffers whose
+// sequence dimensions have src_seq_len and dst_seq_len entries.
+void copy_rows(
+    const CacheView& view,
+    const uint8_t* src,
+    int64_t src_seq_len,
+    uint8_t* dst,
+    int64_t dst_seq_len,
+    int64_t len) {
+  const size_t row_bytes = len * view.inner_bytes;
+  for (int64_t i = 0; i < view.outer; ++i) {
+    std::memcpy(
+        dst + i * dst_seq_len * view.inner_bytes,
+        src + i * src_seq_len * view.inner_bytes,
+        row_bytes);
+  }
+}
+
+} // namespace
+
+Error save_session_state(
+    const std::string& path,
+    const std::vector<std::pair<std::string, executorch::aten::Tensor>>&
+        buffers,
+    int64_t pos,
+    const std::vector<uint64_t>& tokens,
+    int64_t max_context_len,
+    int64_t kv_cache_seq_dim) {
+  ET_CHECK_OR_RETURN_ERROR(
+      pos > 0 && pos <= max_context_len,
+      InvalidArgument,
+      "Invalid position %" PRId64 " for context length %" PRId64,
+      pos,
+      max_context_len);
+  ET_CHECK_OR_RETURN_ERROR(
+      tokens.empty() || static_cast<int64_t>(tokens.size()) == pos,
+      InvalidArgument,
+      "Got %zu tokens for position %" PRId64,
+      tokens.size(),
+      pos);
+
+  // Compact copies of the filled part of every buffer, and the tensors that
+  // view them.
+  std::vector<std::vector<uint8_t>> data;
+  std::vector<TensorPtr> tensors;
+  data.reserve(buffers.size());
+  tensors.reserve(buffers.size() + 2);
+  std::map<std::string, executorch::aten::Tensor> tensor_map;
+
+  for (const auto& [name, tensor] : buffers) {
+    auto view_res =
+        make_cache_view(name, tensor, max_context_len, kv_cache_seq_dim);
+    ET_CHECK_OK_OR_RETURN_ERROR(view_res.error());
+    const auto& view = view_res.get();
+    std::vector<executorch::aten::SizesType> sizes(
+        tensor.sizes().begin(), tensor.sizes().end());
+    sizes[view.seq_dim] = pos;
+    data.emplace_back(view.outer * pos * view.inner_bytes);
+    copy_rows(
+        view,
+        static_cast<const uint8_t*>(tensor.const_data_ptr()),
+        view.seq_len,
+        data.back().data(),
+        pos,
+        pos);
+    tensors.push_back(
+        from_blob(data.back().data(), std::move(sizes), tensor.scalar_type()));
+    tensor_map.emplace(name, *tensors.back());
+  }
+
+  int64_t pos_value = pos;
+  tensors.push_back(
+      from_blob(&pos_value, {1}, executorch::aten::ScalarType::Long));
+  tensor_map.emplace(kPosKey, *tensors.back());
+  std::vector<int64_t> token_values(tokens.begin(), tokens.end());
+  if (!token_values.empty()) {
+    tensors.push_back(from_blob(
+        token_values.data(),
+        {static_cast<executorch::aten::SizesType>(token_values.size())},
+        executorch::aten::ScalarType::Long));
+    tensor_map.emplace(kTokensKey, *tensors.back());
+  }
+  return flat_tensor::save_ptd(path, tensor_map, kSessionTensorAlignment);
+}
+
+Result<SessionState> load_session_state(
+    const std::string& path,
+    const std::vector<std::pair<std::string, executorch::aten::Tensor>>&
+        buffers,
+    int64_t max_context_len,
+    int64_t kv_cache_seq_dim) {
+  auto loader = MmapDataLoader::from(
+      path.c_str(), MmapDataLoader::MlockConfig::NoMlock);
+  ET_CHECK_OK_OR_RETURN_ERROR(loader.error());
+  auto data_map = FlatTensorDataMap::load(&loader.get());
+  ET_CHECK_OK_OR_RETURN_ERROR(data_map.error());
+
+  SessionState state;
+  {
+    auto pos_data = data_map->get_data(kPosKey);
+    ET_CHECK_OK_OR_RETURN_ERROR(pos_data.error());
+    ET_CHECK_OR_RETURN_ERROR(
+        pos_data->size() == sizeof(int64_t),
+        InvalidProgram,
+        "Malformed session position");
+    std::memcpy(&state.pos, pos_data->data(), sizeof(int64_t));
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      state.pos > 0 && state.pos <= max_context_len,
+      InvalidArgument,
+      "Saved position %" PRId64 " doesn't fit context length %" PRId64,
+      state.pos,
+      max_context_len);
+
+  auto tokens_data = data_map->get_data(kTokensKey);
+  if (tokens_data.ok()) {
+    ET_CHECK_OR_RETURN_ERROR(
+        tokens_data->size() == state.pos * sizeof(int64_t),
+        InvalidProgram,
+        "Malformed session tokens");
+    const auto* values = static_cast<const int64_t*>(tokens_data->data());
+    state.tokens.assign(values, values + state.pos);
+  } else if (tokens_data.error() != Error::NotFound) {
+    return tokens_data.error();
+  }
+
+  // Validate everything before touching the caches, so that a mismatching
+  // file leaves the session intact.
+  std::vector<CacheView> views;
+  views.reserve(buffers.size());
+  for (const auto& [name, tensor] : buffers) {
+    auto view_res =
+        make_cache_view(name, tensor, max_context_len, kv_cache_seq_dim);
+    ET_CHECK_OK_OR_RETURN_ERROR(view_res.error());
+    const auto& view = view_res.get();
+    auto layout = data_map->get_tensor_layout(name.c_str());
+    ET_CHECK_OK_OR_RETURN_ERROR(layout.error(), "No buffer %s", name.c_str());
+    ET_CHECK_OR_RETURN_ERROR(
+        layout->scalar_type() == tensor.scalar_type() &&
+            layout->sizes().size() == static_cast<size_t>(tensor.dim()),
+        InvalidArgument,
+        "Saved buffer %s doesn't match the model",
+        name.c_str());
+    for (ssize_t d = 0; d < tensor.dim(); ++d) {
+      const int64_t expected = d == view.seq_dim ? state.pos : tensor.size(d);
+      ET_CHECK_OR_RETURN_ERROR(
+          layout->sizes()[d] == expected,
+          InvalidArgument,
+          "Saved buffer %s has size %d in dim %zd, expected %" PRId64,
+          name.c_str(),
+          layout->sizes()[d],
+          d,
+          expected);
+    }
+    views.push_back(view);
+  }
+
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    const auto& [name, tensor] = buffers[i];
+    const auto& view = views[i];
+    auto saved = data_map->get_data(name.c_str());
+    ET_CHECK_OK_OR_RETURN_ERROR(saved.error());
+    copy_rows(
+        view,
+        static_cast<const uint8_t*>(saved->data()),
+        state.pos,
+        static_cast<uint8_t*>(tensor.mutable_data_ptr()),
+        view.seq_len,
+        state.pos);
+  }
+  return state;
+}
+
+} // namespace executorch::extension::llm
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Save and restore the KV cache of an LLM session to a .ptd file.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch::extension::llm {
+
+/**
+ * @brief Position and tokens of a saved session
+ */
+struct ET_EXPERIMENTAL SessionState {
+  // Number of positions filled in the KV cache.
+  int64_t pos = 0;
+  // Tokens in the KV cache by position, if they were tracked when saving.
+  std::vector<uint64_t> tokens;
+};
+
+/**
+ * @brief Writes the filled part of the KV cache buffers to a .ptd file
+ *
+ * Each buffer is stored under its name, and only the first `pos` entries of
+ * its sequence dimension are written, so the file size grows with the
+ * session rather than with the context length.
+ *
+ * Every buffer must be a linear KV cache: the last component of its name
+ * starts with k_cache or v_cache (e.g. "layers.0.attention.kv_cache.k_cache"
+ * or "k_cache_scales"), and its sequence dimension has max_context_len
+ * entries. Any other buffer, including ring buffer (sliding window) caches
+ * and their bookkeeping, fails with NotSupported rather than being guessed
+ * at.
+ *
+ * @param path File to write
+ * @param buffers The model's mutable buffers by name. Must be contiguous
+ * @param pos Number of filled positions in the KV cache
+ * @param tokens Tokens in the KV cache by position, may be empty
+ * @param max_context_len Size of the sequence dimension of the caches
+ * @param kv_cache_seq_dim Index of the sequence dimension in the caches, as
+ * given by the model's get_kv_cache_seq_dim metadata
+ * @return ::executorch::runtime::Error Success or error status
+ */
+ET_EXPERIMENTAL ::executorch::runtime::Error save_session_state(
+    const std::string& path,
+    const std::vector<std::pair<std::string, executorch::aten::Tensor>>&
+        buffers,
+    int64_t pos,
+    const std::vector<uint64_t>& tokens,
+    int64_t max_context_len,
+    int64_t kv_cache_seq_dim);
+
+/**
+ * @brief Restores KV cache buffers from a file written by save_session_state
+ *
+ * The file is memory-mapped and each saved slice is copied into the
+ * corresponding buffer. Cache entries past the saved position are left as
+ * they are; they are overwritten before being attended to.
+ *
+ * @param path File to read
+ * @param buffers The model's mutable buffers by name, with the same names,
+ * dtypes and shapes as when the file was saved. The same rules as in
+ * save_session_state() apply
+ * @param max_context_len Size of the sequence dimension of the caches
+ * @param kv_cache_seq_dim Index of the sequence dimension in the caches
+ * @return ::executorch::runtime::Result<SessionState> The saved position and
+ * tokens on success
+ */
+ET_EXPERIMENTAL ::executorch::runtime::Result<SessionState> load_session_state(
+    const std::string& path,
+    const std::vector<std::pair<std::string, executorch::aten::Tensor>>&
+        buffers,
+    int64_t max_context_len,
+    int64_t kv_cache_seq_dim);
+
+} // namespace executorch::extension::llm
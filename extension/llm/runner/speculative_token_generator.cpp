@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/speculative_token_generator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace {
+
+template <typename CTYPE>
+void copy_as_float(const CTYPE* src, int64_t n, float* dst) {
+  for (int64_t i = 0; i < n; ++i) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+} // namespace
+
+SpeculativeTokenGenerator::SpeculativeTokenGenerator(
+    ::tokenizers::Tokenizer* tokenizer,
+    TextDecoderRunner* target_decoder_runner,
+    std::unique_ptr<Module> draft_module,
+    std::unique_ptr<IOManager> draft_io_manager,
+    std::unique_ptr<TextDecoderRunner> draft_decoder_runner,
+    std::unique_ptr<TextPrefiller> draft_prefiller,
+    int32_t num_draft_tokens,
+    std::unique_ptr<std::unordered_set<uint64_t>> eos_ids,
+    Stats* stats)
+    : tokenizer_(tokenizer),
+      target_decoder_runner_(target_decoder_runner),
+      draft_module_(std::move(draft_module)),
+      draft_io_manager_(std::move(draft_io_manager)),
+      draft_decoder_runner_(std::move(draft_decoder_runner)),
+      draft_prefiller_(std::move(draft_prefiller)),
+      num_draft_tokens_(num_draft_tokens > 0 ? num_draft_tokens : 1),
+      eos_ids_(std::move(eos_ids)),
+      stats_(stats),
+      rng_(static_cast<unsigned int>(std::time(nullptr))) {}
+
+Error SpeculativeTokenGenerator::prefill_draft(
+    std::vector<uint64_t>& prompt_tokens,
+    int64_t start_pos) {
+  if (!draft_prefiller_->is_loaded()) {
+    ET_CHECK_OK_OR_RETURN_ERROR(draft_prefiller_->load());
+  }
+  // The draft's prediction is discarded, the first token always comes from
+  // the target.
+  auto res = draft_prefiller_->prefill(prompt_tokens, start_pos);
+  return res.error();
+}
+
+Result<int64_t> SpeculativeTokenGenerator::generate(
+    std::vector<uint64_t> tokens,
+    int64_t start_pos,
+    int32_t max_new_tokens,
+    float temperature,
+    const std::function<void(const std::string&)>& token_callback,
+    std::vector<uint64_t>* generated_tokens) {
+  ET_CHECK_MSG(
+      !tokens.empty(), "Token generation loop shouldn't take empty tokens");
+  should_stop_ = false;
+
+  int64_t pos = start_pos;
+  uint64_t cur_token = tokens.back();
+  int64_t num_generated = 0;
+
+  // Tokens that are in the target's KV cache but not yet in the draft's,
+  // starting at draft_pos.
+  std::vector<uint64_t> draft_backlog;
+  int64_t draft_pos = start_pos;
+
+  uint64_t draft_input_token = 0;
+  auto draft_input = from_blob(
+      &draft_input_token, {1, 1}, executorch::aten::ScalarType::Long);
+  std::vector<uint64_t> verify_tokens;
+  std::vector<std::vector<float>> draft_probs(num_draft_tokens_);
+  std::vector<float> target_probs;
+
+  // Feeds the backlog to the draft until its KV cache reaches end_pos.
+  auto catch_up_draft = [&](int64_t end_pos) -> Error {
+    size_t i = 0;
+    for (; i < draft_backlog.size() && draft_pos < end_pos; ++i) {
+      draft_input_token = draft_backlog[i];
+      auto res = draft_decoder_runner_->step(draft_input, draft_pos);
+      ET_CHECK_OK_OR_RETURN_ERROR(res.error());
+      draft_pos++;
+    }
+    draft_backlog.erase(draft_backlog.begin(), draft_backlog.begin() + i);
+    return Error::Ok;
+  };
+
+  bool done = false;
+  while (!done && num_generated < max_new_tokens) {
+    // Never propose past max_new_tokens; the last token always comes from
+    // the target.
+    const int32_t num_draft = static_cast<int32_t>(std::min<int64_t>(
+        num_draft_tokens_, max_new_tokens - num_generated - 1));
+
+    // Bring the draft's KV cache up to pos.
+    ET_CHECK_OK_OR_RETURN_ERROR(catch_up_draft(pos));
+
+    // Propose num_draft tokens with the draft.
+    verify_tokens.assign(1, cur_token);
+    for (int32_t i = 0; i < num_draft; ++i) {
+      draft_input_token = verify_tokens.back();
+      auto logits_res = draft_decoder_runner_->step(draft_input, pos + i);
+      ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+      const auto& logits = logits_res.get();
+      const int64_t last = logits.dim() == 3 ? logits.size(1) - 1 : 0;
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          logits_to_probs(logits, last, temperature, draft_probs[i]));
+      verify_tokens.push_back(sample_from(draft_probs[i]));
+    }
+
+    // Score cur_token and all proposals with one target forward.
+    auto verify_input = from_blob(
+        verify_tokens.data(),
+        {1, static_cast<int>(verify_tokens.size())},
+        executorch::aten::ScalarType::Long);
+    auto logits_res = target_decoder_runner_->step(verify_input, pos);
+    ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+    const auto& logits = logits_res.get();
+    const int64_t num_logits = logits.dim() == 3 ? logits.size(1) : 1;
+    ET_CHECK_OR_RETURN_ERROR(
+        num_draft == 0 || num_logits == num_draft + 1,
+        NotSupported,
+        "Speculative decoding needs logits for every input token, got "
+        "%" PRId64 " for %d tokens. Export the target model with full logits.",
+        num_logits,
+        num_draft + 1);
+
+    stats_->on_sampling_begin();
+    int32_t num_accepted = 0;
+    uint64_t next_token = 0;
+    bool rejected = false;
+    for (; num_accepted < num_draft; ++num_accepted) {
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          logits_to_probs(logits, num_accepted, temperature, target_probs));
+      const auto& q = draft_probs[num_accepted];
+      const auto proposed = verify_tokens[num_accepted + 1];
+      const float p_d = target_probs[proposed];
+      const float q_d = q[proposed];
+      const float coin =
+          std::uniform_real_distribution<float>(0.0f, 1.0f)(rng_);
+      if (q_d > 0.0f && coin < p_d / q_d) {
+        continue;
+      }
+      // Rejected: sample the replacement from the residual max(0, p - q).
+      float residual_sum = 0.0f;
+      for (size_t v = 0; v < target_probs.size(); ++v) {
+        const float r = std::max(0.0f, target_probs[v] - q[v]);
+        residual_sum += r;
+        target_probs[v] = r;
+      }
+      if (residual_sum > 0.0f) {
+        for (auto& r : target_probs) {
+          r /= residual_sum;
+        }
+      } else {
+        ET_CHECK_OK_OR_RETURN_ERROR(
+            logits_to_probs(logits, num_accepted, temperature, target_probs));
+      }
+      next_token = sample_from(target_probs);
+      rejected = true;
+      break;
+    }
+    if (!rejected) {
+      // Every proposal was accepted, take a bonus token from the target.
+      ET_CHECK_OK_OR_RETURN_ERROR(logits_to_probs(
+          logits,
+          num_draft == 0 ? num_logits - 1 : num_draft,
+          temperature,
+          target_probs));
+      next_token = sample_from(target_probs);
+    }
+    stats_->on_sampling_end();
+    stats_->num_draft_tokens += num_draft;
+    stats_->num_accepted_draft_tokens += num_accepted;
+
+    // The draft consumed verify_tokens[0, num_draft) and the target now
+    // holds verify_tokens[0, num_accepted]. Anything the draft is missing is
+    // replayed at the start of the next iteration; everything past the
+    // accepted prefix is overwritten, which rolls both caches back.
+    const int64_t draft_end = std::min(num_draft, num_accepted + 1);
+    draft_pos = pos + draft_end;
+    draft_backlog.assign(
+        verify_tokens.begin() + draft_end,
+        verify_tokens.begin() + num_accepted + 1);
+
+    // Emit the accepted proposals followed by the target's token.
+    for (int32_t i = 0; i <= num_accepted; ++i) {
+      const uint64_t prev_token = cur_token;
+      cur_token = i < num_accepted ? verify_tokens[i + 1] : next_token;
+      pos++;
+      num_generated++;
+      if (generated_tokens != nullptr) {
+        generated_tokens->push_back(cur_token);
+      }
+
+      auto decode_result = tokenizer_->decode(prev_token, cur_token);
+      if (!decode_result.ok()) {
+        ET_LOG(
+            Error,
+            "Tokenizers error code %d",
+            static_cast<uint32_t>(decode_result.error()));
+        return Error::InvalidArgument;
+      }
+      token_callback(std::move(*decode_result));
+
+      if (should_stop_ || num_generated >= max_new_tokens) {
+        done = true;
+        break;
+      }
+      if (eos_ids_->find(cur_token) != eos_ids_->end()) {
+        printf("\n");
+        ET_LOG(Info, "\nReached to the end of generation");
+        done = true;
+        break;
+      }
+    }
+  }
+
+  // The target's KV cache holds everything before pos. Leave the draft's in
+  // the same state, so the next prefill and generate() pick up both caches
+  // at the same position.
+  ET_CHECK_OK_OR_RETURN_ERROR(catch_up_draft(pos));
+  return num_generated;
+}
+
+Error SpeculativeTokenGenerator::logits_to_probs(
+    const executorch::aten::Tensor& logits,
+    int64_t index,
+    float temperature,
+    std::vector<float>& probs) {
+  const int64_t vocab_size = logits.size(logits.dim() - 1);
+  const int64_t offset = index * vocab_size;
+  probs.resize(vocab_size);
+  switch (logits.scalar_type()) {
+    case executorch::aten::ScalarType::Float:
+      copy_as_float(
+          logits.const_data_ptr<float>() + offset, vocab_size, probs.data());
+      break;
+    case executorch::aten::ScalarType::Half:
+      copy_as_float(
+          logits.const_data_ptr<executorch::aten::Half>() + offset,
+          vocab_size,
+          probs.data());
+      break;
+    case executorch::aten::ScalarType::BFloat16:
+      copy_as_float(
+          logits.const_data_ptr<executorch::aten::BFloat16>() + offset,
+          vocab_size,
+          probs.data());
+      break;
+    default:
+      ET_LOG(
+          Error,
+          "Unsupported logits dtype %s",
+          executorch::runtime::toString(logits.scalar_type()));
+      return Error::NotSupported;
+  }
+
+  const auto max_it = std::max_element(probs.begin(), probs.end());
+  if (temperature <= 0.0f) {
+    const auto argmax = std::distance(probs.begin(), max_it);
+    std::fill(probs.begin(), probs.end(), 0.0f);
+    probs[argmax] = 1.0f;
+    return Error::Ok;
+  }
+  const float max_logit = *max_it;
+  float sum = 0.0f;
+  for (auto& p : probs) {
+    p = std::exp((p - max_logit) / temperature);
+    sum += p;
+  }
+  for (auto& p : probs) {
+    p /= sum;
+  }
+  return Error::Ok;
+}
+
+uint64_t SpeculativeTokenGenerator::sample_from(
+    const std::vector<float>& probs) {
+  const float coin = std::uniform_real_distribution<float>(0.0f, 1.0f)(rng_);
+  float cdf = 0.0f;
+  for (size_t i = 0; i < probs.size(); ++i) {
+    cdf += probs[i];
+    if (coin < cdf) {
+      return i;
+    }
+  }
+  // In case of rounding errors, return the last token with nonzero mass.
+  for (size_t i = probs.size(); i > 0; --i) {
+    if (probs[i - 1] > 0.0f) {
+      return i - 1;
+    }
+  }
+  return 0;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
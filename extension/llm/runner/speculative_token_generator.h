@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Generate tokens with speculative decoding: a small draft model proposes a
+// few tokens, and the target model verifies all of them in one forward.
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <executorch/extension/llm/runner/io_manager/io_manager.h>
+#include <executorch/extension/llm/runner/stats.h>
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/runner/text_prefiller.h>
+#include <executorch/extension/module/module.h>
+#include <pytorch/tokenizers/tokenizer.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+class ET_EXPERIMENTAL SpeculativeTokenGenerator {
+ public:
+  /**
+   * @param tokenizer Tokenizer shared with the target model. Not owned.
+   * @param target_decoder_runner Decoder of the target model. Not owned. Its
+   * forward must accept several tokens at once and return logits for every
+   * input token, i.e. of shape [1, seq_len, vocab_size].
+   * @param draft_module Module of the draft model. The draft must use the same
+   * tokenizer and a KV cache indexed like the target's.
+   * @param draft_io_manager IOManager bound to draft_module.
+   * @param draft_decoder_runner Decoder bound to draft_module.
+   * @param draft_prefiller Prefiller bound to draft_decoder_runner.
+   * @param num_draft_tokens Number of tokens proposed per verification step.
+   * @param eos_ids Token ids that end the generation.
+   * @param stats Stats shared with the runner. Not owned.
+   */
+  SpeculativeTokenGenerator(
+      ::tokenizers::Tokenizer* tokenizer,
+      TextDecoderRunner* target_decoder_runner,
+      std::unique_ptr<Module> draft_module,
+      std::unique_ptr<IOManager> draft_io_manager,
+      std::unique_ptr<TextDecoderRunner> draft_decoder_runner,
+      std::unique_ptr<TextPrefiller> draft_prefiller,
+      int32_t num_draft_tokens,
+      std::unique_ptr<std::unordered_set<uint64_t>> eos_ids,
+      Stats* stats);
+
+  virtual ~SpeculativeTokenGenerator() = default;
+
+  /**
+   * Prefill the draft model's KV cache with the same tokens that were
+   * prefilled into the target model.
+   * @param prompt_tokens The prompt tokens.
+   * @param start_pos The position of the first prompt token.
+   * @return The error code.
+   */
+  ::executorch::runtime::Error prefill_draft(
+      std::vector<uint64_t>& prompt_tokens,
+      int64_t start_pos);
+
+  /**
+   * Token generation loop.
+   *
+   * Every iteration the draft model proposes up to num_draft_tokens tokens,
+   * which the target model scores in a single forward. The longest prefix of
+   * the proposal that the target agrees with is accepted, followed by one
+   * token from the target itself. Rejected positions are rolled back by
+   * resuming from the first rejected position, so both KV caches must be
+   * indexed by absolute position.
+   *
+   * With temperature 0 a draft token is accepted if it equals the target's
+   * argmax. Otherwise standard speculative sampling is used: a draft token d
+   * is accepted with probability min(1, p(d) / q(d)), and on rejection the
+   * replacement is sampled from max(0, p - q), which preserves the target
+   * distribution.
+   *
+   * @param tokens The prompt tokens followed by the first token generated by
+   * prefill.
+   * @param start_pos The position of the first token generated by prefill.
+   * @param max_new_tokens Maximum number of new tokens to generate.
+   * @param temperature Sampling temperature.
+   * @param token_callback Called with every decoded token.
+   * @param generated_tokens If not null, every generated token id is appended
+   * to it.
+   * @return How many tokens are generated. All of them but the last are in
+   * both the target's and the draft's KV cache.
+   */
+  ::executorch::runtime::Result<int64_t> generate(
+      std::vector<uint64_t> tokens,
+      int64_t start_pos,
+      int32_t max_new_tokens,
+      float temperature = 0.0f,
+      const std::function<void(const std::string&)>& token_callback = {},
+      std::vector<uint64_t>* generated_tokens = nullptr);
+
+  /**
+   * Stop the generation loop.
+   */
+  inline void stop() {
+    should_stop_ = true;
+  }
+
+  /**
+   * Load the draft model. The target model is loaded by the runner.
+   */
+  ::executorch::runtime::Error load() {
+    return draft_prefiller_->load();
+  }
+
+  bool is_loaded() const {
+    return draft_prefiller_->is_loaded();
+  }
+
+ private:
+  // Converts the logits of the index'th token to probabilities at the given
+  // temperature. With temperature 0 the result is one-hot at the argmax.
+  ::executorch::runtime::Error logits_to_probs(
+      const executorch::aten::Tensor& logits,
+      int64_t index,
+      float temperature,
+      std::vector<float>& probs);
+
+  // Samples an index from a probability vector.
+  uint64_t sample_from(const std::vector<float>& probs);
+
+  ::tokenizers::Tokenizer* tokenizer_;
+  TextDecoderRunner* target_decoder_runner_;
+  // Declaration order matters: the draft components hold raw pointers to the
+  // ones declared before them.
+  std::unique_ptr<Module> draft_module_;
+  std::unique_ptr<IOManager> draft_io_manager_;
+  std::unique_ptr<TextDecoderRunner> draft_decoder_runner_;
+  std::unique_ptr<TextPrefiller> draft_prefiller_;
+  int32_t num_draft_tokens_;
+  std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
+  Stats* stats_;
+
+  std::mt19937 rng_;
+  bool should_stop_ = false;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
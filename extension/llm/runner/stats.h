@@ -49,6 +49,12 @@ struct ET_EXPERIMENTAL Stats {
   int64_t num_prompt_tokens;
   // Token count from generated (total - prompt)
   int64_t num_generated_tokens;
+  // Prompt tokens that were already in the KV cache and skipped during prefill
+  int64_t num_cached_prompt_tokens = 0;
+  // Speculative decoding: tokens proposed by the draft model, and how many of
+  // them the target model accepted.
+  int64_t num_draft_tokens = 0;
+  int64_t num_accepted_draft_tokens = 0;
   inline void on_sampling_begin() {
     aggregate_sampling_timer_start_timestamp = time_in_ms();
   }
@@ -75,6 +81,9 @@ struct ET_EXPERIMENTAL Stats {
     aggregate_sampling_time_ms = 0;
     num_prompt_tokens = 0;
     num_generated_tokens = 0;
+    num_cached_prompt_tokens = 0;
+    num_draft_tokens = 0;
+    num_accepted_draft_tokens = 0;
     aggregate_sampling_timer_start_timestamp = 0;
   }
 
@@ -86,6 +95,9 @@ inline std::string stats_to_json_string(const Stats& stats) {
   std::stringstream ss;
   ss << "{\"prompt_tokens\":" << stats.num_prompt_tokens << ","
      << "\"generated_tokens\":" << stats.num_generated_tokens << ","
+     << "\"cached_prompt_tokens\":" << stats.num_cached_prompt_tokens << ","
+     << "\"draft_tokens\":" << stats.num_draft_tokens << ","
+     << "\"accepted_draft_tokens\":" << stats.num_accepted_draft_tokens << ","
      << "\"model_load_start_ms\":" << stats.model_load_start_ms << ","
      << "\"model_load_end_ms\":" << stats.model_load_end_ms << ","
      << "\"inference_start_ms\":" << stats.inference_start_ms << ","
@@ -107,6 +119,13 @@ inline void print_report(const Stats& stats) {
       stats.num_prompt_tokens,
       stats.num_generated_tokens);
 
+  if (stats.num_cached_prompt_tokens > 0) {
+    ET_LOG(
+        Info,
+        "\tPrompt Tokens Reused From KV Cache: %" PRIu64,
+        stats.num_cached_prompt_tokens);
+  }
+
   ET_LOG(
       Info,
       "\tModel Load Time:\t\t%f (seconds)",
@@ -142,6 +161,16 @@ inline void print_report(const Stats& stats) {
       stats.num_generated_tokens / eval_time *
           stats.SCALING_FACTOR_UNITS_PER_SECOND);
 
+  if (stats.num_draft_tokens > 0) {
+    ET_LOG(
+        Info,
+        "\tSpeculative decoding accepted %" PRIu64 " of %" PRIu64
+        " draft tokens:\t%f (acceptance rate)",
+        stats.num_accepted_draft_tokens,
+        stats.num_draft_tokens,
+        (double)stats.num_accepted_draft_tokens / stats.num_draft_tokens);
+  }
+
   // Time to first token is measured from the start of inference, excluding
   // model load time.
   ET_LOG(
@@ -74,7 +74,10 @@ def define_common_targets():
 
         runtime.cxx_library(
             name = "text_token_generator" + aten_suffix,
-            exported_headers = ["text_token_generator.h"],
+            exported_headers = [
+                "text_token_generator.h",
+                "token_callback_pipeline.h",
+            ],
             visibility = [
                 "@EXECUTORCH_CLIENTS",
             ],
@@ -86,6 +89,64 @@ def define_common_targets():
             ],
         )
 
+        runtime.cxx_library(
+            name = "continuous_batching_runner" + aten_suffix,
+            exported_headers = [
+                "batched_decoder_runner.h",
+                "continuous_batching_runner.h",
+            ],
+            srcs = [
+                "batched_decoder_runner.cpp",
+                "continuous_batching_runner.cpp",
+            ],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":irunner",
+                ":stats" + aten_suffix,
+                "//pytorch/tokenizers:headers",
+                "//executorch/extension/llm/sampler:sampler" + aten_suffix,
+                "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "session_state" + aten_suffix,
+            exported_headers = ["session_state.h"],
+            srcs = ["session_state.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            deps = [
+                "//executorch/extension/data_loader:mmap_data_loader",
+                "//executorch/extension/flat_tensor:flat_tensor_data_map" + aten_suffix,
+                "//executorch/extension/flat_tensor/serialize:serialize_cpp",
+                "//executorch/runtime/core/exec_aten/util:dim_order_util" + aten_suffix,
+            ],
+            exported_deps = [
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "speculative_token_generator" + aten_suffix,
+            exported_headers = ["speculative_token_generator.h"],
+            srcs = ["speculative_token_generator.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":text_decoder_runner" + aten_suffix,
+                ":text_prefiller" + aten_suffix,
+                "//pytorch/tokenizers:headers",
+                "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
         runtime.cxx_library(
             name = "image_prefiller" + aten_suffix,
             exported_headers = ["image_prefiller.h", "image.h"],
@@ -144,6 +205,8 @@ def define_common_targets():
                 ":image_prefiller" + aten_suffix,
                 ":irunner",
                 ":multimodal_runner_lib" + aten_suffix,
+                ":session_state" + aten_suffix,
+                ":speculative_token_generator" + aten_suffix,
                 ":text_decoder_runner" + aten_suffix,
                 ":text_prefiller" + aten_suffix,
                 ":text_token_generator" + aten_suffix,
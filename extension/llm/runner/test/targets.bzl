@@ -37,6 +37,33 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "test_continuous_batching_runner",
+        srcs = ["test_continuous_batching_runner.cpp"],
+        deps = [
+            "//executorch/extension/llm/runner:continuous_batching_runner",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_speculative_token_generator",
+        srcs = ["test_speculative_token_generator.cpp"],
+        deps = [
+            "//executorch/extension/llm/runner:speculative_token_generator",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_session_state",
+        srcs = ["test_session_state.cpp"],
+        deps = [
+            "//executorch/extension/llm/runner:session_state",
+            "//executorch/extension/testing_util:temp_file",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
     runtime.cxx_test(
         name = "test_multimodal_input",
         srcs = ["test_multimodal_input.cpp"],
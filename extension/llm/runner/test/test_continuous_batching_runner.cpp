@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ * @lint-ignore-every CLANGTIDY facebook-hte-Deprecated
+ */
+
+#include <algorithm>
+
+#include <executorch/extension/llm/runner/continuous_batching_runner.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::TensorPtr;
+using executorch::extension::llm::BatchedDecoderRunner;
+using executorch::extension::llm::ContinuousBatchingRunner;
+using executorch::extension::llm::GenerationConfig;
+using executorch::extension::llm::Stats;
+using executorch::runtime::Error;
+using executorch::runtime::Result;
+
+namespace {
+
+constexpr int32_t kVocabSize = 8;
+constexpr uint64_t kEosId = 7;
+
+class MockTokenizer : public ::tokenizers::Tokenizer {
+ public:
+  MOCK_METHOD(::tokenizers::Error, load, (const std::string&), ());
+  MOCK_METHOD(bool, is_loaded, (), (const));
+  MOCK_METHOD(
+      ::tokenizers::Result<std::vector<uint64_t>>,
+      encode,
+      (const std::string&, int8_t, int8_t),
+      (const));
+  MOCK_METHOD(
+      ::tokenizers::Result<std::string>,
+      decode,
+      (uint64_t, uint64_t),
+      (const));
+  MOCK_METHOD(uint64_t, bos_tok, (), (const));
+  MOCK_METHOD(uint64_t, eos_tok, (), (const));
+  MOCK_METHOD(uint64_t, vocab_size, (), (const));
+};
+
+// Produces logits whose argmax is the row's last input token plus one, and
+// records the shape of every call.
+class FakeBatchedDecoderRunner : public BatchedDecoderRunner {
+ public:
+  FakeBatchedDecoderRunner() : BatchedDecoderRunner(nullptr) {}
+
+  Result<executorch::aten::Tensor> step(
+      std::vector<uint64_t>& tokens,
+      int64_t num_rows,
+      std::vector<int64_t>& cache_slots,
+      std::vector<int64_t>& start_pos) override {
+    const int64_t seq_len = tokens.size() / num_rows;
+    calls.push_back({num_rows, seq_len, cache_slots, start_pos});
+    logits_data_.assign(num_rows * kVocabSize, 0.0f);
+    for (int64_t row = 0; row < num_rows; ++row) {
+      const auto last = tokens[row * seq_len + seq_len - 1];
+      const auto next = std::min<uint64_t>(last + 1, kVocabSize - 1);
+      logits_data_[row * kVocabSize + next] = 1.0f;
+    }
+    logits_ = executorch::extension::make_tensor_ptr(
+        {static_cast<executorch::aten::SizesType>(num_rows), kVocabSize},
+        logits_data_);
+    return *logits_;
+  }
+
+  Error load() override {
+    return Error::Ok;
+  }
+
+  bool is_method_loaded() override {
+    return true;
+  }
+
+  struct Call {
+    int64_t num_rows;
+    int64_t seq_len;
+    std::vector<int64_t> cache_slots;
+    std::vector<int64_t> start_pos;
+  };
+  std::vector<Call> calls;
+
+ private:
+  std::vector<float> logits_data_;
+  TensorPtr logits_;
+};
+
+class ContinuousBatchingRunnerTest : public Test {
+ protected:
+  void SetUp() override {
+    ON_CALL(tokenizer_, is_loaded).WillByDefault(Return(true));
+    ON_CALL(tokenizer_, vocab_size).WillByDefault(Return(kVocabSize));
+    // One token per character, with the character's digit value as id.
+    ON_CALL(tokenizer_, encode)
+        .WillByDefault([](const std::string& prompt, int8_t, int8_t) {
+          std::vector<uint64_t> tokens;
+          for (char c : prompt) {
+            tokens.push_back(static_cast<uint64_t>(c - '0'));
+          }
+          return ::tokenizers::Result<std::vector<uint64_t>>(tokens);
+        });
+    ON_CALL(tokenizer_, decode).WillByDefault([](uint64_t, uint64_t token) {
+      return ::tokenizers::Result<std::string>(std::to_string(token));
+    });
+  }
+
+  std::unique_ptr<ContinuousBatchingRunner> createRunner(
+      int64_t max_batch_size,
+      int64_t prefill_chunk_size = 128) {
+    return std::make_unique<ContinuousBatchingRunner>(
+        &tokenizer_,
+        &decoder_,
+        std::make_unique<std::unordered_set<uint64_t>>(
+            std::unordered_set<uint64_t>{kEosId}),
+        max_batch_size,
+        /*max_context_len=*/64,
+        prefill_chunk_size);
+  }
+
+  GenerationConfig config(int32_t max_new_tokens) {
+    GenerationConfig config;
+    config.max_new_tokens = max_new_tokens;
+    config.temperature = 0.0f;
+    return config;
+  }
+
+  NiceMock<MockTokenizer> tokenizer_;
+  FakeBatchedDecoderRunner decoder_;
+};
+
+TEST_F(ContinuousBatchingRunnerTest, PacksDecodeOfActiveSequences) {
+  auto runner = createRunner(/*max_batch_size=*/2);
+  std::vector<std::string> out_a, out_b;
+  ASSERT_TRUE(runner
+                  ->submit(
+                      "0",
+                      config(3),
+                      [&](const std::string& piece) { out_a.push_back(piece); })
+                  .ok());
+  ASSERT_TRUE(runner
+                  ->submit(
+                      "3",
+                      config(3),
+                      [&](const std::string& piece) { out_b.push_back(piece); })
+                  .ok());
+
+  EXPECT_EQ(runner->run_until_idle(), Error::Ok);
+  EXPECT_EQ(out_a, (std::vector<std::string>{"1", "2", "3"}));
+  EXPECT_EQ(out_b, (std::vector<std::string>{"4", "5", "6"}));
+
+  int64_t max_rows = 0;
+  for (const auto& call : decoder_.calls) {
+    max_rows = std::max(max_rows, call.num_rows);
+  }
+  EXPECT_EQ(max_rows, 2);
+  EXPECT_EQ(runner->num_active(), 0);
+  EXPECT_EQ(runner->num_pending(), 0);
+}
+
+TEST_F(ContinuousBatchingRunnerTest, AdmitsPendingWhenSlotFrees) {
+  auto runner = createRunner(/*max_batch_size=*/1);
+  int count_a = 0, count_b = 0;
+  ASSERT_TRUE(
+      runner->submit("0", config(3), [&](const std::string&) { count_a++; })
+          .ok());
+  ASSERT_TRUE(
+      runner->submit("2", config(2), [&](const std::string&) { count_b++; })
+          .ok());
+
+  auto res = runner->step();
+  ASSERT_TRUE(res.ok());
+  EXPECT_TRUE(res.get());
+  EXPECT_EQ(runner->num_active(), 1);
+  EXPECT_EQ(runner->num_pending(), 1);
+
+  EXPECT_EQ(runner->run_until_idle(), Error::Ok);
+  EXPECT_EQ(count_a, 3);
+  EXPECT_EQ(count_b, 2);
+  for (const auto& call : decoder_.calls) {
+    EXPECT_EQ(call.num_rows, 1);
+    EXPECT_EQ(call.cache_slots[0], 0);
+  }
+}
+
+TEST_F(ContinuousBatchingRunnerTest, ChunksPrefillAndTracksPositions) {
+  auto runner = createRunner(/*max_batch_size=*/1, /*prefill_chunk_size=*/2);
+  Stats stats;
+  ASSERT_TRUE(runner
+                  ->submit(
+                      "01234",
+                      config(2),
+                      {},
+                      [&](const Stats& s) {
+                        stats.num_prompt_tokens = s.num_prompt_tokens;
+                        stats.num_generated_tokens = s.num_generated_tokens;
+                      })
+                  .ok());
+  EXPECT_EQ(runner->run_until_idle(), Error::Ok);
+
+  // Three prefill chunks of 2, 2 and 1 tokens, then one decode step.
+  ASSERT_EQ(decoder_.calls.size(), 4);
+  EXPECT_EQ(decoder_.calls[0].seq_len, 2);
+  EXPECT_EQ(decoder_.calls[0].start_pos[0], 0);
+  EXPECT_EQ(decoder_.calls[1].seq_len, 2);
+  EXPECT_EQ(decoder_.calls[1].start_pos[0], 2);
+  EXPECT_EQ(decoder_.calls[2].seq_len, 1);
+  EXPECT_EQ(decoder_.calls[2].start_pos[0], 4);
+  EXPECT_EQ(decoder_.calls[3].seq_len, 1);
+  EXPECT_EQ(decoder_.calls[3].start_pos[0], 5);
+  EXPECT_EQ(stats.num_prompt_tokens, 5);
+  EXPECT_EQ(stats.num_generated_tokens, 2);
+}
+
+TEST_F(ContinuousBatchingRunnerTest, RetiresOnEos) {
+  auto runner = createRunner(/*max_batch_size=*/2);
+  std::vector<std::string> out;
+  ASSERT_TRUE(runner
+                  ->submit(
+                      "5",
+                      config(10),
+                      [&](const std::string& piece) { out.push_back(piece); })
+                  .ok());
+  EXPECT_EQ(runner->run_until_idle(), Error::Ok);
+  EXPECT_EQ(out, (std::vector<std::string>{"6", "7"}));
+}
+
+TEST_F(ContinuousBatchingRunnerTest, DecodesFromPreviousToken) {
+  ON_CALL(tokenizer_, decode).WillByDefault([](uint64_t prev, uint64_t token) {
+    return ::tokenizers::Result<std::string>(
+        std::to_string(prev) + ">" + std::to_string(token));
+  });
+  auto runner = createRunner(/*max_batch_size=*/1);
+  std::vector<std::string> out;
+  ASSERT_TRUE(runner
+                  ->submit(
+                      "34",
+                      config(2),
+                      [&](const std::string& piece) { out.push_back(piece); })
+                  .ok());
+  EXPECT_EQ(runner->run_until_idle(), Error::Ok);
+  // The first generated token follows the last prompt token.
+  EXPECT_EQ(out, (std::vector<std::string>{"4>5", "5>6"}));
+}
+
+TEST_F(ContinuousBatchingRunnerTest, CancelDropsPendingAndActive) {
+  auto runner = createRunner(/*max_batch_size=*/1);
+  int count_a = 0, count_b = 0;
+  auto id_a =
+      runner->submit("0", config(5), [&](const std::string&) { count_a++; });
+  auto id_b =
+      runner->submit("0", config(5), [&](const std::string&) { count_b++; });
+  ASSERT_TRUE(id_a.ok());
+  ASSERT_TRUE(id_b.ok());
+
+  ASSERT_TRUE(runner->step().ok());
+  runner->cancel(id_a.get());
+  runner->cancel(id_b.get());
+  EXPECT_EQ(runner->run_until_idle(), Error::Ok);
+
+  EXPECT_LT(count_a, 5);
+  EXPECT_EQ(count_b, 0);
+  EXPECT_EQ(runner->num_cancelled(), 0);
+}
+
+TEST_F(ContinuousBatchingRunnerTest, CancelIgnoresRetiredAndUnknownIds) {
+  auto runner = createRunner(/*max_batch_size=*/1);
+  auto id = runner->submit("0", config(2));
+  ASSERT_TRUE(id.ok());
+  EXPECT_EQ(runner->run_until_idle(), Error::Ok);
+
+  runner->cancel(id.get());
+  runner->cancel(id.get() + 100);
+  EXPECT_EQ(runner->num_cancelled(), 0);
+
+  // Cancelling a pending request is only remembered until it's dropped.
+  auto id_b = runner->submit("0", config(2));
+  ASSERT_TRUE(id_b.ok());
+  runner->cancel(id_b.get());
+  EXPECT_EQ(runner->num_cancelled(), 1);
+  EXPECT_EQ(runner->run_until_idle(), Error::Ok);
+  EXPECT_EQ(runner->num_cancelled(), 0);
+}
+
+TEST_F(ContinuousBatchingRunnerTest, RejectsPromptLongerThanContext) {
+  auto runner = createRunner(/*max_batch_size=*/1);
+  auto res = runner->submit(std::string(64, '1'), config(1));
+  EXPECT_EQ(res.error(), Error::InvalidArgument);
+  EXPECT_EQ(runner->num_pending(), 0);
+}
+
+} // namespace
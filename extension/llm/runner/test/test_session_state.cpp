@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ * @lint-ignore-every CLANGTIDY facebook-hte-Deprecated
+ */
+
+#include <executorch/extension/llm/runner/session_state.h>
+
+#include <executorch/extension/tensor/tensor.h>
+#include <executorch/extension/testing_util/temp_file.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+using executorch::extension::from_blob;
+using executorch::extension::TensorPtr;
+using executorch::extension::llm::load_session_state;
+using executorch::extension::llm::save_session_state;
+using executorch::extension::testing::TempFile;
+using executorch::runtime::Error;
+
+namespace {
+
+constexpr int64_t kMaxContextLen = 8;
+constexpr int64_t kSeqDim = 2;
+
+class SessionStateTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    // A [batch, heads, seq, head_dim] cache and its per-entry scales.
+    k_cache_data_.resize(2 * kMaxContextLen * 3);
+    std::iota(k_cache_data_.begin(), k_cache_data_.end(), 0.0f);
+    k_cache_ = from_blob(k_cache_data_.data(), {1, 2, kMaxContextLen, 3});
+    scales_data_.resize(2 * kMaxContextLen);
+    std::iota(scales_data_.begin(), scales_data_.end(), 100.0f);
+    scales_ = from_blob(scales_data_.data(), {1, 2, kMaxContextLen, 1});
+    // The file is written by save_session_state, the TempFile only owns the
+    // path.
+    file_ = std::make_unique<TempFile>("");
+  }
+
+  std::vector<std::pair<std::string, executorch::aten::Tensor>> buffers() {
+    return {
+        {"layers.0.attention.kv_cache.k_cache", *k_cache_},
+        {"layers.0.attention.kv_cache.k_cache_scales", *scales_}};
+  }
+
+  std::vector<float> k_cache_data_;
+  std::vector<float> scales_data_;
+  TensorPtr k_cache_;
+  TensorPtr scales_;
+  std::unique_ptr<TempFile> file_;
+};
+
+TEST_F(SessionStateTest, RoundTripsFilledPositions) {
+  const int64_t pos = 5;
+  std::vector<uint64_t> tokens = {1, 2, 3, 4, 5};
+  ASSERT_EQ(
+      save_session_state(
+          file_->path(), buffers(), pos, tokens, kMaxContextLen, kSeqDim),
+      Error::Ok);
+
+  const auto saved = k_cache_data_;
+  const auto saved_scales = scales_data_;
+  std::fill(k_cache_data_.begin(), k_cache_data_.end(), -1.0f);
+  std::fill(scales_data_.begin(), scales_data_.end(), -1.0f);
+
+  auto state = load_session_state(
+      file_->path(), buffers(), kMaxContextLen, kSeqDim);
+  ASSERT_TRUE(state.ok());
+  EXPECT_EQ(state->pos, pos);
+  EXPECT_EQ(state->tokens, tokens);
+  // Only the first pos entries of every head are restored.
+  for (int64_t head = 0; head < 2; ++head) {
+    for (int64_t p = 0; p < kMaxContextLen; ++p) {
+      const size_t row = head * kMaxContextLen + p;
+      EXPECT_EQ(scales_data_[row], p < pos ? saved_scales[row] : -1.0f);
+      for (int64_t d = 0; d < 3; ++d) {
+        const size_t i = row * 3 + d;
+        EXPECT_EQ(k_cache_data_[i], p < pos ? saved[i] : -1.0f);
+      }
+    }
+  }
+}
+
+TEST_F(SessionStateTest, UsesDeclaredSeqDim) {
+  // [batch, seq, heads, head_dim] with as many heads as positions, so the
+  // sequence dim can't be told from the shape alone.
+  std::vector<float> data(kMaxContextLen * kMaxContextLen * 3);
+  std::iota(data.begin(), data.end(), 0.0f);
+  auto cache = from_blob(data.data(), {1, kMaxContextLen, kMaxContextLen, 3});
+  std::vector<std::pair<std::string, executorch::aten::Tensor>> caches = {
+      {"v_cache", *cache}};
+  const int64_t pos = 2;
+  ASSERT_EQ(
+      save_session_state(
+          file_->path(), caches, pos, {}, kMaxContextLen, /*seq_dim=*/1),
+      Error::Ok);
+
+  const auto saved = data;
+  std::fill(data.begin(), data.end(), -1.0f);
+  ASSERT_TRUE(
+      load_session_state(file_->path(), caches, kMaxContextLen, 1).ok());
+  const size_t filled = pos * kMaxContextLen * 3;
+  for (size_t i = 0; i < data.size(); ++i) {
+    EXPECT_EQ(data[i], i < filled ? saved[i] : -1.0f);
+  }
+}
+
+TEST_F(SessionStateTest, TokensAreOptional) {
+  ASSERT_EQ(
+      save_session_state(
+          file_->path(), buffers(), 3, {}, kMaxContextLen, kSeqDim),
+      Error::Ok);
+  auto state = load_session_state(
+      file_->path(), buffers(), kMaxContextLen, kSeqDim);
+  ASSERT_TRUE(state.ok());
+  EXPECT_EQ(state->pos, 3);
+  EXPECT_TRUE(state->tokens.empty());
+}
+
+TEST_F(SessionStateTest, RejectsMismatchingBuffers) {
+  ASSERT_EQ(
+      save_session_state(
+          file_->path(), buffers(), 3, {}, kMaxContextLen, kSeqDim),
+      Error::Ok);
+
+  std::vector<float> other_data(4 * kMaxContextLen * 3, -1.0f);
+  auto other = from_blob(other_data.data(), {1, 4, kMaxContextLen, 3});
+  std::vector<std::pair<std::string, executorch::aten::Tensor>> mismatched = {
+      {"layers.0.attention.kv_cache.k_cache", *other},
+      {"layers.0.attention.kv_cache.k_cache_scales", *scales_}};
+  auto state = load_session_state(
+      file_->path(), mismatched, kMaxContextLen, kSeqDim);
+  EXPECT_EQ(state.error(), Error::InvalidArgument);
+  for (auto value : other_data) {
+    EXPECT_EQ(value, -1.0f);
+  }
+
+  std::vector<std::pair<std::string, executorch::aten::Tensor>> missing = {
+      {"layers.0.attention.kv_cache.v_cache", *k_cache_}};
+  EXPECT_EQ(
+      load_session_state(file_->path(), missing, kMaxContextLen, kSeqDim)
+          .error(),
+      Error::NotFound);
+}
+
+TEST_F(SessionStateTest, RejectsBuffersThatAreNotLinearCaches) {
+  ASSERT_EQ(
+      save_session_state(
+          file_->path(), buffers(), 3, {}, kMaxContextLen, kSeqDim),
+      Error::Ok);
+
+  // Not named like a cache.
+  std::vector<int64_t> counter_data = {42, 7};
+  auto counter =
+      from_blob(counter_data.data(), {2}, executorch::aten::ScalarType::Long);
+  auto with_counter = buffers();
+  with_counter.emplace_back("counter", *counter);
+  EXPECT_EQ(
+      save_session_state(
+          file_->path(), with_counter, 3, {}, kMaxContextLen, kSeqDim),
+      Error::NotSupported);
+
+  // A ring buffer cache, sized by its window rather than the context.
+  std::vector<float> ring_data(2 * 4 * 3);
+  auto ring = from_blob(ring_data.data(), {1, 2, 4, 3});
+  std::vector<int64_t> positions_data(4);
+  auto positions = from_blob(
+      positions_data.data(), {4}, executorch::aten::ScalarType::Long);
+  std::vector<std::pair<std::string, executorch::aten::Tensor>> ring_cache = {
+      {"layers.0.attention.kv_cache.k_cache", *ring}};
+  EXPECT_EQ(
+      save_session_state(
+          file_->path(), ring_cache, 3, {}, kMaxContextLen, kSeqDim),
+      Error::NotSupported);
+  ring_cache.emplace_back(
+      "layers.0.attention.kv_cache.cache_positions_manager.cache_positions",
+      *positions);
+  EXPECT_EQ(
+      load_session_state(file_->path(), ring_cache, kMaxContextLen, kSeqDim)
+          .error(),
+      Error::NotSupported);
+
+  // Unknown or out of range sequence dim.
+  EXPECT_EQ(
+      save_session_state(file_->path(), buffers(), 3, {}, kMaxContextLen, -1),
+      Error::NotSupported);
+  EXPECT_EQ(
+      save_session_state(file_->path(), buffers(), 3, {}, kMaxContextLen, 4),
+      Error::NotSupported);
+}
+
+TEST_F(SessionStateTest, RejectsInvalidPosition) {
+  EXPECT_EQ(
+      save_session_state(
+          file_->path(), buffers(), 0, {}, kMaxContextLen, kSeqDim),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      save_session_state(
+          file_->path(),
+          buffers(),
+          kMaxContextLen + 1,
+          {},
+          kMaxContextLen,
+          kSeqDim),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      save_session_state(
+          file_->path(), buffers(), 2, {1}, kMaxContextLen, kSeqDim),
+      Error::InvalidArgument);
+}
+
+} // namespace
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ * @lint-ignore-every CLANGTIDY facebook-hte-Deprecated
+ */
+
+#include <algorithm>
+
+#include <executorch/extension/llm/runner/speculative_token_generator.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::TensorPtr;
+using executorch::extension::llm::SpeculativeTokenGenerator;
+using executorch::extension::llm::Stats;
+using executorch::extension::llm::TextDecoderRunner;
+using executorch::extension::llm::TextPrefiller;
+using executorch::runtime::Error;
+using executorch::runtime::Result;
+
+namespace {
+
+constexpr int64_t kVocabSize = 8;
+
+class MockTokenizer : public ::tokenizers::Tokenizer {
+ public:
+  MOCK_METHOD(::tokenizers::Error, load, (const std::string&), ());
+  MOCK_METHOD(bool, is_loaded, (), (const));
+  MOCK_METHOD(
+      ::tokenizers::Result<std::vector<uint64_t>>,
+      encode,
+      (const std::string&, int8_t, int8_t),
+      (const));
+  MOCK_METHOD(
+      ::tokenizers::Result<std::string>,
+      decode,
+      (uint64_t, uint64_t),
+      (const));
+  MOCK_METHOD(uint64_t, bos_tok, (), (const));
+  MOCK_METHOD(uint64_t, eos_tok, (), (const));
+  MOCK_METHOD(uint64_t, vocab_size, (), (const));
+};
+
+// Predicts `token + offset` after every input token and returns logits for
+// all of them, shaped [1, seq_len, vocab_size].
+class FakeTextDecoderRunner : public TextDecoderRunner {
+ public:
+  explicit FakeTextDecoderRunner(uint64_t offset)
+      : TextDecoderRunner(nullptr, nullptr), offset_(offset) {}
+
+  Result<executorch::aten::Tensor> step(
+      executorch::extension::TensorPtr& input,
+      int64_t start_pos) override {
+    const auto seq_len = input->numel();
+    const auto* tokens = input->const_data_ptr<int64_t>();
+    positions.push_back(start_pos);
+    seq_lens.push_back(seq_len);
+    std::vector<float> logits(seq_len * kVocabSize, 0.0f);
+    for (ssize_t i = 0; i < seq_len; ++i) {
+      const auto next =
+          std::min<uint64_t>(tokens[i] + offset_, kVocabSize - 1);
+      logits[i * kVocabSize + next] = 1.0f;
+    }
+    logits_ = executorch::extension::make_tensor_ptr(
+        {1,
+         static_cast<executorch::aten::SizesType>(seq_len),
+         static_cast<executorch::aten::SizesType>(kVocabSize)},
+        std::move(logits));
+    return *logits_;
+  }
+
+  Error load() override {
+    return Error::Ok;
+  }
+
+  bool is_method_loaded() override {
+    return true;
+  }
+
+  // Returns the position right after the last one written to the KV cache,
+  // or -1 if the forwards didn't write it contiguously.
+  int64_t cache_end() const {
+    int64_t end = positions.empty() ? -1 : positions.front();
+    for (size_t i = 0; i < positions.size(); ++i) {
+      if (positions[i] > end) {
+        return -1;
+      }
+      end = positions[i] + seq_lens[i];
+    }
+    return end;
+  }
+
+  std::vector<int64_t> positions;
+  std::vector<int64_t> seq_lens;
+
+ private:
+  uint64_t offset_;
+  TensorPtr logits_;
+};
+
+class SpeculativeTokenGeneratorTest : public Test {
+ protected:
+  void SetUp() override {
+    ON_CALL(tokenizer_, decode).WillByDefault([](uint64_t, uint64_t token) {
+      return ::tokenizers::Result<std::string>(std::to_string(token));
+    });
+    stats_.reset(/*all_stats=*/true);
+  }
+
+  std::unique_ptr<SpeculativeTokenGenerator> createGenerator(
+      uint64_t draft_offset,
+      int32_t num_draft_tokens) {
+    auto draft = std::make_unique<FakeTextDecoderRunner>(draft_offset);
+    draft_ = draft.get();
+    auto draft_prefiller = std::make_unique<TextPrefiller>(
+        draft.get(),
+        /*use_kv_cache=*/true,
+        /*enable_parallel_prefill=*/true);
+    return std::make_unique<SpeculativeTokenGenerator>(
+        &tokenizer_,
+        &target_,
+        /*draft_module=*/nullptr,
+        /*draft_io_manager=*/nullptr,
+        std::move(draft),
+        std::move(draft_prefiller),
+        num_draft_tokens,
+        std::make_unique<std::unordered_set<uint64_t>>(
+            std::unordered_set<uint64_t>{100}),
+        &stats_);
+  }
+
+  NiceMock<MockTokenizer> tokenizer_;
+  FakeTextDecoderRunner target_{1};
+  FakeTextDecoderRunner* draft_ = nullptr;
+  Stats stats_;
+};
+
+TEST_F(SpeculativeTokenGeneratorTest, AcceptsMatchingDraftTokens) {
+  auto generator = createGenerator(/*draft_offset=*/1, /*num_draft_tokens=*/3);
+  std::vector<std::string> out;
+  std::vector<uint64_t> generated;
+  auto res = generator->generate(
+      {0, 0, 0, 1},
+      /*start_pos=*/3,
+      /*max_new_tokens=*/6,
+      /*temperature=*/0.0f,
+      [&](const std::string& piece) { out.push_back(piece); },
+      &generated);
+
+  ASSERT_TRUE(res.ok());
+  EXPECT_EQ(res.get(), 6);
+  EXPECT_EQ(out, (std::vector<std::string>{"2", "3", "4", "5", "6", "7"}));
+  EXPECT_EQ(generated, (std::vector<uint64_t>{2, 3, 4, 5, 6, 7}));
+  // Two target forwards: one verifying 3 proposals, one verifying 1.
+  EXPECT_EQ(target_.seq_lens, (std::vector<int64_t>{4, 2}));
+  EXPECT_EQ(target_.positions, (std::vector<int64_t>{3, 7}));
+  EXPECT_EQ(stats_.num_draft_tokens, 4);
+  EXPECT_EQ(stats_.num_accepted_draft_tokens, 4);
+}
+
+TEST_F(SpeculativeTokenGeneratorTest, RejectedDraftMatchesTargetOutput) {
+  auto generator = createGenerator(/*draft_offset=*/2, /*num_draft_tokens=*/3);
+  std::vector<uint64_t> generated;
+  auto res = generator->generate(
+      {0, 0, 0, 1},
+      /*start_pos=*/3,
+      /*max_new_tokens=*/6,
+      /*temperature=*/0.0f,
+      [](const std::string&) {},
+      &generated);
+
+  ASSERT_TRUE(res.ok());
+  EXPECT_EQ(generated, (std::vector<uint64_t>{2, 3, 4, 5, 6, 7}));
+  EXPECT_GT(stats_.num_draft_tokens, 0);
+  EXPECT_EQ(stats_.num_accepted_draft_tokens, 0);
+  // Every target forward starts right after the last emitted token.
+  for (size_t i = 0; i < target_.positions.size(); ++i) {
+    EXPECT_EQ(target_.positions[i], 3 + static_cast<int64_t>(i));
+  }
+}
+
+TEST_F(SpeculativeTokenGeneratorTest, DraftCacheFollowsTarget) {
+  auto generator = createGenerator(/*draft_offset=*/1, /*num_draft_tokens=*/2);
+  auto res = generator->generate(
+      {0, 0, 0, 1},
+      /*start_pos=*/3,
+      /*max_new_tokens=*/7,
+      /*temperature=*/0.0f,
+      [](const std::string&) {});
+  ASSERT_TRUE(res.ok());
+
+  // With everything accepted, the last proposal of a round is replayed into
+  // the draft before the next round, so the draft sees every position once.
+  std::vector<int64_t> expected(draft_->positions.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = 3 + static_cast<int64_t>(i);
+  }
+  EXPECT_EQ(draft_->positions, expected);
+}
+
+TEST_F(SpeculativeTokenGeneratorTest, DraftCacheFollowsTargetAcrossTurns) {
+  auto generator = createGenerator(/*draft_offset=*/1, /*num_draft_tokens=*/3);
+  std::vector<uint64_t> prompt = {0, 0, 0};
+  ASSERT_EQ(generator->prefill_draft(prompt, /*start_pos=*/0), Error::Ok);
+
+  // The last round accepts its proposal and then stops, which leaves the
+  // accepted proposal in the target's KV cache but not yet in the draft's.
+  auto res = generator->generate(
+      {0, 0, 0, 1},
+      /*start_pos=*/3,
+      /*max_new_tokens=*/6,
+      /*temperature=*/0.0f,
+      [](const std::string&) {});
+  ASSERT_TRUE(res.ok());
+  int64_t pos = 3 + res.get();
+  EXPECT_EQ(target_.cache_end(), pos);
+  EXPECT_EQ(draft_->cache_end(), pos);
+
+  // Next turn, as the runner does it: prefill both models at pos.
+  prompt = {1, 2};
+  ASSERT_EQ(generator->prefill_draft(prompt, pos), Error::Ok);
+  target_.positions.push_back(pos);
+  target_.seq_lens.push_back(prompt.size());
+  pos += prompt.size();
+  auto next_res = generator->generate(
+      {1, 2, 3},
+      pos,
+      /*max_new_tokens=*/4,
+      /*temperature=*/0.0f,
+      [](const std::string&) {});
+  ASSERT_TRUE(next_res.ok());
+  pos += next_res.get();
+  EXPECT_EQ(target_.cache_end(), pos);
+  EXPECT_EQ(draft_->cache_end(), pos);
+}
+
+} // namespace
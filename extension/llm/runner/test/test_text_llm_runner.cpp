@@ -346,4 +346,115 @@ TEST_F(RunnerTest, IsLoadedReturnsTrueWhenComponentsInitialized) {
   EXPECT_TRUE(runner.is_loaded());
 }
 
+// Test that with prefix caching, a prompt already in the KV cache is only
+// prefilled from its first uncached token.
+TEST_F(RunnerTest, PrefixCachingSkipsCachedPromptTokens) {
+  auto tokenizer = createMockTokenizer();
+  auto text_decoder_runner = createMockTextDecoderRunner();
+  auto text_prefiller = createMockTextPrefiller(text_decoder_runner.get());
+
+  std::vector<std::vector<uint64_t>> prefilled;
+  ON_CALL(*text_prefiller, prefill(_, _))
+      .WillByDefault([&](std::vector<uint64_t>& tokens, int64_t& start_pos) {
+        prefilled.push_back(tokens);
+        start_pos += tokens.size();
+        return Result<uint64_t>(4);
+      });
+
+  auto stats = std::make_unique<executorch::llm::Stats>();
+  auto text_token_generator = createTextTokenGenerator(
+      tokenizer.get(), text_decoder_runner.get(), stats.get());
+  auto module = std::make_unique<MockModule>();
+  auto io_manager =
+      std::make_unique<executorch::extension::llm::IOManager>(*module);
+  TextLLMRunner runner(
+      createDefaultMetadata(),
+      std::move(tokenizer),
+      std::move(module),
+      std::move(text_decoder_runner),
+      std::unique_ptr<::executorch::extension::llm::TextPrefiller>(
+          text_prefiller.release()),
+      std::move(io_manager),
+      std::move(text_token_generator),
+      std::move(stats));
+  runner.load();
+  runner.set_prefix_caching(true);
+
+  GenerationConfig config;
+  config.max_new_tokens = 3;
+  config.echo = false;
+  int64_t num_cached_prompt_tokens = -1;
+  auto stats_callback = [&](const Stats& s) {
+    num_cached_prompt_tokens = s.num_cached_prompt_tokens;
+  };
+
+  EXPECT_EQ(
+      runner.generate("test prompt", config, {}, stats_callback), Error::Ok);
+  EXPECT_EQ(num_cached_prompt_tokens, 0);
+
+  // The same prompt from position 0 only needs its last token prefilled.
+  runner.reset();
+  EXPECT_EQ(
+      runner.generate("test prompt", config, {}, stats_callback), Error::Ok);
+  EXPECT_EQ(num_cached_prompt_tokens, 2);
+
+  ASSERT_EQ(prefilled.size(), 2);
+  EXPECT_EQ(prefilled[0], (std::vector<uint64_t>{1, 2, 3}));
+  EXPECT_EQ(prefilled[1], (std::vector<uint64_t>{3}));
+}
+
+// Test that with a callback queue, tokens are delivered in order and stop()
+// from the callback drops the tokens generated after it.
+TEST_F(RunnerTest, CallbackQueuePreservesOrderAndStop) {
+  auto tokenizer = createMockTokenizer();
+  ON_CALL(*tokenizer, decode).WillByDefault([](uint64_t, uint64_t token) {
+    return ::tokenizers::Result<std::string>(std::to_string(token));
+  });
+  // The token sampled at position p is p % 4.
+  std::vector<executorch::aten::Tensor> logits = {
+      tf.make({1, 4}, {1, 0, 0, 0}),
+      tf.make({1, 4}, {0, 1, 0, 0}),
+      tf.make({1, 4}, {0, 0, 1, 0}),
+      tf.make({1, 4}, {0, 0, 0, 1})};
+  auto text_decoder_runner = createMockTextDecoderRunner();
+  ON_CALL(*text_decoder_runner, step)
+      .WillByDefault([&](executorch::extension::TensorPtr&, int64_t pos) {
+        return Result<executorch::aten::Tensor>(logits[pos % 4]);
+      });
+  Stats stats;
+  auto generator = createTextTokenGenerator(
+      tokenizer.get(), text_decoder_runner.get(), &stats);
+  generator->set_callback_queue_size(2);
+
+  std::vector<std::string> pieces;
+  auto res = generator->generate(
+      {4}, 0, 8, 0.0f, [&](const std::string& piece) {
+        pieces.push_back(piece);
+      });
+  ASSERT_TRUE(res.ok());
+  EXPECT_EQ(res.get(), 8);
+  EXPECT_EQ(
+      pieces,
+      (std::vector<std::string>{"0", "1", "2", "3", "0", "1", "2", "3"}));
+
+  pieces.clear();
+  std::vector<uint64_t> generated;
+  res = generator->generate(
+      {4},
+      0,
+      8,
+      0.0f,
+      [&](const std::string& piece) {
+        pieces.push_back(piece);
+        if (pieces.size() == 3) {
+          generator->stop();
+        }
+      },
+      &generated);
+  ASSERT_TRUE(res.ok());
+  EXPECT_EQ(res.get(), 3);
+  EXPECT_EQ(pieces, (std::vector<std::string>{"0", "1", "2"}));
+  EXPECT_EQ(generated, (std::vector<uint64_t>{0, 1, 2}));
+}
+
 } // namespace
@@ -11,6 +11,7 @@
 // The module takes in a string as input and emits a string as output.
 
 #include <executorch/extension/llm/runner/io_manager/io_manager.h>
+#include <executorch/extension/llm/runner/session_state.h>
 #include <executorch/extension/llm/runner/text_llm_runner.h>
 #include <executorch/extension/llm/runner/util.h>
 #include <executorch/runtime/platform/runtime.h>
@@ -19,12 +20,46 @@
 #include <pytorch/tokenizers/sentencepiece.h>
 #include <pytorch/tokenizers/tiktoken.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace executorch::extension::llm {
 
 using ::executorch::extension::Module;
 using ::executorch::runtime::Error;
 using ::executorch::runtime::Result;
 
+namespace {
+
+// The model's KV cache buffers, by name.
+Result<std::vector<std::pair<std::string, executorch::aten::Tensor>>>
+get_cache_buffers(Module& module) {
+  auto names = module.mutable_buffer_names("forward");
+  ET_CHECK_OK_OR_RETURN_ERROR(names.error());
+  std::vector<std::pair<std::string, executorch::aten::Tensor>> buffers;
+  buffers.reserve(names->size());
+  for (auto& name : *names) {
+    auto tensor = module.get_attribute("forward", name);
+    ET_CHECK_OK_OR_RETURN_ERROR(tensor.error());
+    buffers.emplace_back(std::move(name), tensor.get());
+  }
+  return buffers;
+}
+
+// The sequence dim of the model's KV caches, which sessions are cut along.
+Result<int64_t> get_kv_cache_seq_dim(
+    const std::unordered_map<std::string, int64_t>& metadata) {
+  auto it = metadata.find(kKVCacheSeqDim);
+  ET_CHECK_OR_RETURN_ERROR(
+      it != metadata.end() && it->second >= 0,
+      NotSupported,
+      "Sessions need the model's %s metadata",
+      kKVCacheSeqDim);
+  return it->second;
+}
+
+} // namespace
+
 TextLLMRunner::TextLLMRunner(
     std::unordered_map<std::string, int64_t> metadata,
     std::unique_ptr<::tokenizers::Tokenizer> tokenizer,
@@ -50,7 +85,9 @@ TextLLMRunner::TextLLMRunner(
 }
 
 bool TextLLMRunner::is_loaded() const {
-  return text_prefiller_->is_loaded() && text_token_generator_->is_loaded();
+  return text_prefiller_->is_loaded() && text_token_generator_->is_loaded() &&
+      (!speculative_token_generator_ ||
+       speculative_token_generator_->is_loaded());
 }
 
 Error TextLLMRunner::load() {
@@ -60,6 +97,9 @@ Error TextLLMRunner::load() {
   ET_CHECK_OK_OR_RETURN_ERROR(text_prefiller_->load());
   ET_CHECK_OK_OR_RETURN_ERROR(io_manager_->load());
   ET_CHECK_OK_OR_RETURN_ERROR(text_token_generator_->load());
+  if (speculative_token_generator_) {
+    ET_CHECK_OK_OR_RETURN_ERROR(speculative_token_generator_->load());
+  }
   return Error::Ok;
 }
 
@@ -169,9 +209,53 @@ Error TextLLMRunner::generate(
   if (config.echo) {
     wrapped_callback(prompt);
   }
-  auto prefill_res = text_prefiller_->prefill(prompt_tokens, pos_);
-  ET_CHECK_OK_OR_RETURN_ERROR(prefill_res.error());
+
+  // With prefix caching, skip the leading prompt tokens that are already in
+  // the KV cache at their positions. At least one token is always prefilled
+  // to get the logits for the next token.
+  const bool track_cache =
+      prefix_caching_ && static_cast<int64_t>(cached_tokens_.size()) >= pos_;
+  int64_t num_cached_tokens = 0;
+  if (track_cache) {
+    while (num_cached_tokens < num_prompt_tokens - 1 &&
+           pos_ + num_cached_tokens <
+               static_cast<int64_t>(cached_tokens_.size()) &&
+           cached_tokens_[pos_ + num_cached_tokens] ==
+               prompt_tokens[num_cached_tokens]) {
+      num_cached_tokens++;
+    }
+    if (num_cached_tokens > 0) {
+      RUNNER_ET_LOG(
+          config.warming,
+          "Reusing %" PRId64 " prompt tokens from the KV cache",
+          num_cached_tokens);
+    }
+    cached_tokens_.resize(pos_ + num_cached_tokens);
+  } else {
+    cached_tokens_.clear();
+  }
+  pos_ += num_cached_tokens;
+  std::vector<uint64_t> prefill_tokens(
+      prompt_tokens.begin() + num_cached_tokens, prompt_tokens.end());
+
+  if (speculative_token_generator_) {
+    auto err =
+        speculative_token_generator_->prefill_draft(prefill_tokens, pos_);
+    if (err != Error::Ok) {
+      cached_tokens_.clear();
+      return err;
+    }
+  }
+  auto prefill_res = text_prefiller_->prefill(prefill_tokens, pos_);
+  if (!prefill_res.ok()) {
+    cached_tokens_.clear();
+    return prefill_res.error();
+  }
   uint64_t cur_token = prefill_res.get();
+  if (track_cache) {
+    cached_tokens_.insert(
+        cached_tokens_.end(), prefill_tokens.begin(), prefill_tokens.end());
+  }
   stats_->first_token_ms = time_in_ms();
   stats_->prompt_eval_end_ms = time_in_ms();
 
@@ -194,18 +278,41 @@ Error TextLLMRunner::generate(
   prompt_tokens.push_back(cur_token);
 
   // Generate max_new_tokens - 1 because prefill already generated 1 token.
-  auto generate_result = text_token_generator_->generate(
-      prompt_tokens,
-      pos_,
-      max_new_tokens - 1,
-      temperature_ == -1.0f ? config.temperature : temperature_,
-      wrapped_callback);
+  text_token_generator_->set_callback_queue_size(
+      std::max(config.callback_queue_size, 0));
+  std::vector<uint64_t> generated_tokens;
+  const float temperature =
+      temperature_ == -1.0f ? config.temperature : temperature_;
+  auto generate_result = speculative_token_generator_
+      ? speculative_token_generator_->generate(
+            prompt_tokens,
+            pos_,
+            max_new_tokens - 1,
+            temperature,
+            wrapped_callback,
+            track_cache ? &generated_tokens : nullptr)
+      : text_token_generator_->generate(
+            prompt_tokens,
+            pos_,
+            max_new_tokens - 1,
+            temperature,
+            wrapped_callback,
+            track_cache ? &generated_tokens : nullptr);
   if (!generate_result.ok()) {
+    cached_tokens_.clear();
     return generate_result.error();
   }
   int64_t num_generated_tokens = generate_result.get();
 
   pos_ += num_generated_tokens;
+  if (track_cache && num_generated_tokens > 0) {
+    // Every generated token except the last one has been fed to the model.
+    cached_tokens_.push_back(cur_token);
+    cached_tokens_.insert(
+        cached_tokens_.end(),
+        generated_tokens.begin(),
+        generated_tokens.begin() + num_generated_tokens - 1);
+  }
 
   stats_->inference_end_ms = time_in_ms();
   if (!config.warming) {
@@ -222,6 +329,7 @@ Error TextLLMRunner::generate(
 
   stats_->num_prompt_tokens = num_prompt_tokens;
   stats_->num_generated_tokens = num_generated_tokens;
+  stats_->num_cached_prompt_tokens = num_cached_tokens;
 
   if (config.warming) {
     ET_LOG(Info, "Warmup run finished!");
@@ -254,6 +362,9 @@ Error TextLLMRunner::warmup(const std::string& prompt, int32_t max_new_tokens) {
 void TextLLMRunner::stop() {
   if (is_loaded()) {
     text_token_generator_->stop();
+    if (speculative_token_generator_) {
+      speculative_token_generator_->stop();
+    }
   } else {
     ET_LOG(Error, "Token generator is not loaded, cannot stop");
   }
@@ -264,4 +375,168 @@ void TextLLMRunner::reset() {
   pos_ = 0;
 }
 
+void TextLLMRunner::set_speculative_token_generator(
+    std::unique_ptr<SpeculativeTokenGenerator> speculative_token_generator) {
+  speculative_token_generator_ = std::move(speculative_token_generator);
+  // The draft's KV cache doesn't hold the tokens cached so far.
+  cached_tokens_.clear();
+}
+
+Error TextLLMRunner::set_draft_model(
+    std::unique_ptr<Module> draft_module,
+    int32_t num_draft_tokens) {
+  ET_CHECK_OR_RETURN_ERROR(
+      draft_module != nullptr, InvalidArgument, "Draft module is null");
+  auto metadata_res = get_llm_metadata(tokenizer_.get(), draft_module.get());
+  ET_CHECK_OK_OR_RETURN_ERROR(metadata_res.error());
+  const auto& draft_metadata = metadata_res.get();
+  ET_CHECK_OR_RETURN_ERROR(
+      draft_metadata.at(kUseKVCache) && metadata_.at(kUseKVCache),
+      NotSupported,
+      "Speculative decoding requires KV cache in both models");
+
+  auto eos_ids = std::make_unique<std::unordered_set<uint64_t>>(
+      get_eos_ids(tokenizer_.get(), module_.get()));
+  auto draft_io_manager = std::make_unique<IOManager>(*draft_module);
+  auto draft_decoder_runner = std::make_unique<TextDecoderRunner>(
+      draft_module.get(), draft_io_manager.get());
+  auto draft_prefiller = std::make_unique<TextPrefiller>(
+      draft_decoder_runner.get(),
+      draft_metadata.at(kUseKVCache),
+      draft_metadata.at(kEnableDynamicShape),
+      draft_metadata.at(kMaxSeqLen));
+  set_speculative_token_generator(std::make_unique<SpeculativeTokenGenerator>(
+      tokenizer_.get(),
+      text_decoder_runner_.get(),
+      std::move(draft_module),
+      std::move(draft_io_manager),
+      std::move(draft_decoder_runner),
+      std::move(draft_prefiller),
+      num_draft_tokens,
+      std::move(eos_ids),
+      stats_.get()));
+  return Error::Ok;
+}
+
+void TextLLMRunner::set_prefix_caching(bool enabled) {
+  prefix_caching_ = enabled;
+  if (!enabled) {
+    cached_tokens_.clear();
+    prefix_caches_.clear();
+  }
+}
+
+Error TextLLMRunner::save_prefix_cache(const std::string& name) {
+  ET_CHECK_OR_RETURN_ERROR(
+      prefix_caching_, InvalidState, "Prefix caching is not enabled");
+  ET_CHECK_OR_RETURN_ERROR(
+      pos_ > 0 && static_cast<int64_t>(cached_tokens_.size()) >= pos_,
+      InvalidState,
+      "No tokens in the KV cache to snapshot");
+  auto names = module_->mutable_buffer_names("forward");
+  ET_CHECK_OK_OR_RETURN_ERROR(names.error());
+
+  PrefixCache cache;
+  cache.tokens.assign(cached_tokens_.begin(), cached_tokens_.begin() + pos_);
+  cache.buffers.reserve(names->size());
+  for (const auto& buffer_name : *names) {
+    auto tensor = module_->get_attribute("forward", buffer_name);
+    ET_CHECK_OK_OR_RETURN_ERROR(tensor.error());
+    const auto* data =
+        static_cast<const uint8_t*>(tensor->const_data_ptr());
+    cache.buffers.emplace_back(data, data + tensor->nbytes());
+  }
+  prefix_caches_[name] = std::move(cache);
+  return Error::Ok;
+}
+
+Error TextLLMRunner::load_prefix_cache(const std::string& name) {
+  ET_CHECK_OR_RETURN_ERROR(
+      prefix_caching_, InvalidState, "Prefix caching is not enabled");
+  ET_CHECK_OR_RETURN_ERROR(
+      !speculative_token_generator_,
+      NotSupported,
+      "Prefix cache snapshots don't cover the draft model");
+  auto it = prefix_caches_.find(name);
+  ET_CHECK_OR_RETURN_ERROR(
+      it != prefix_caches_.end(),
+      NotFound,
+      "No prefix cache named %s",
+      name.c_str());
+  auto names = module_->mutable_buffer_names("forward");
+  ET_CHECK_OK_OR_RETURN_ERROR(names.error());
+  ET_CHECK_OR_RETURN_ERROR(
+      names->size() == it->second.buffers.size(),
+      InvalidState,
+      "Prefix cache %s has %zu buffers, model has %zu",
+      name.c_str(),
+      it->second.buffers.size(),
+      names->size());
+
+  for (size_t i = 0; i < names->size(); ++i) {
+    auto tensor = module_->get_attribute("forward", (*names)[i]);
+    ET_CHECK_OK_OR_RETURN_ERROR(tensor.error());
+    const auto& buffer = it->second.buffers[i];
+    ET_CHECK_OR_RETURN_ERROR(
+        tensor->nbytes() == buffer.size(),
+        InvalidState,
+        "Size mismatch restoring %s",
+        (*names)[i].c_str());
+    std::memcpy(
+        tensor->mutable_data_ptr(), buffer.data(), buffer.size());
+  }
+  cached_tokens_ = it->second.tokens;
+  reset();
+  return Error::Ok;
+}
+
+void TextLLMRunner::drop_prefix_cache(const std::string& name) {
+  prefix_caches_.erase(name);
+}
+
+Error TextLLMRunner::save_session(const std::string& path) {
+  ET_CHECK_OR_RETURN_ERROR(
+      pos_ > 0, InvalidState, "No tokens in the KV cache to save");
+  auto seq_dim = get_kv_cache_seq_dim(metadata_);
+  ET_CHECK_OK_OR_RETURN_ERROR(seq_dim.error());
+  auto buffers = get_cache_buffers(*module_);
+  ET_CHECK_OK_OR_RETURN_ERROR(buffers.error());
+  std::vector<uint64_t> tokens;
+  if (prefix_caching_ &&
+      static_cast<int64_t>(cached_tokens_.size()) >= pos_) {
+    tokens.assign(cached_tokens_.begin(), cached_tokens_.begin() + pos_);
+  }
+  return save_session_state(
+      path,
+      buffers.get(),
+      pos_,
+      tokens,
+      metadata_.at(kMaxContextLen),
+      seq_dim.get());
+}
+
+Error TextLLMRunner::load_session(const std::string& path) {
+  ET_CHECK_OR_RETURN_ERROR(
+      !speculative_token_generator_,
+      NotSupported,
+      "Sessions don't cover the draft model");
+  auto seq_dim = get_kv_cache_seq_dim(metadata_);
+  ET_CHECK_OK_OR_RETURN_ERROR(seq_dim.error());
+  if (!is_loaded()) {
+    ET_CHECK_OK_OR_RETURN_ERROR(load());
+  }
+  auto buffers = get_cache_buffers(*module_);
+  ET_CHECK_OK_OR_RETURN_ERROR(buffers.error());
+  auto state = load_session_state(
+      path, buffers.get(), metadata_.at(kMaxContextLen), seq_dim.get());
+  if (!state.ok()) {
+    cached_tokens_.clear();
+    return state.error();
+  }
+  stats_->reset();
+  pos_ = state->pos;
+  cached_tokens_ = std::move(state->tokens);
+  return Error::Ok;
+}
+
 } // namespace executorch::extension::llm
@@ -16,8 +16,10 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <executorch/extension/llm/runner/irunner.h>
+#include <executorch/extension/llm/runner/speculative_token_generator.h>
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
 #include <executorch/extension/llm/runner/text_prefiller.h>
@@ -119,10 +121,113 @@ class ET_EXPERIMENTAL TextLLMRunner : public IRunner {
    * @brief Remove prefilled tokens and reset start position, and stats.
    *
    * This method removes the prefilled tokens from the KV cache and resets the
-   * start position to 0. It also clears the stats for previous runs.
+   * start position to 0. It also clears the stats for previous runs. With
+   * prefix caching enabled the cache contents are kept, so that the next
+   * prompt only prefills from its first token that differs from them.
    */
   void reset() override;
 
+  /**
+   * @brief Enables or disables reuse of the KV cache across generate() calls
+   *
+   * When enabled, the runner tracks the tokens that are currently in the KV
+   * cache. generate() compares the new prompt against the cached tokens
+   * starting at the current position and prefills only from the first token
+   * that differs. The number of skipped tokens is reported in
+   * Stats::num_cached_prompt_tokens.
+   *
+   * Only enable this for models whose KV cache is indexed by absolute
+   * position, e.g. not for ring-buffer (sliding window) caches.
+   *
+   * @param enabled Whether prefix caching is enabled
+   */
+  void set_prefix_caching(bool enabled);
+
+  /**
+   * @brief Snapshots the KV cache and its tokens under the given name
+   *
+   * The snapshot is held in memory until it is dropped or the runner is
+   * destroyed. Requires prefix caching to be enabled.
+   *
+   * @param name Name of the snapshot, overwritten if it already exists
+   * @return ::executorch::runtime::Error Success or error status
+   */
+  ::executorch::runtime::Error save_prefix_cache(const std::string& name);
+
+  /**
+   * @brief Restores a named KV cache snapshot
+   *
+   * Copies the snapshot back into the KV cache and rewinds the start position
+   * like reset(), so a following generate() whose prompt starts with the
+   * snapshot's tokens only prefills the rest.
+   *
+   * @param name Name of the snapshot
+   * @return ::executorch::runtime::Error Success or error status
+   */
+  ::executorch::runtime::Error load_prefix_cache(const std::string& name);
+
+  /**
+   * @brief Switches generation to speculative decoding with a draft model
+   *
+   * The draft model is prefilled with every prompt the target model is
+   * prefilled with and proposes tokens that the target verifies in batches.
+   * Acceptance is reported in Stats::num_draft_tokens and
+   * Stats::num_accepted_draft_tokens. Pass nullptr to go back to regular
+   * decoding.
+   *
+   * @param speculative_token_generator Generator holding the draft model
+   */
+  void set_speculative_token_generator(
+      std::unique_ptr<SpeculativeTokenGenerator> speculative_token_generator);
+
+  /**
+   * @brief Switches generation to speculative decoding with a draft model
+   *
+   * Convenience wrapper around set_speculative_token_generator() that builds
+   * the draft's decoder and prefiller from its metadata.
+   *
+   * @param draft_module Module of the draft model, which must share the
+   * tokenizer with the target model
+   * @param num_draft_tokens Number of tokens the draft proposes per step
+   * @return ::executorch::runtime::Error Success or error status
+   */
+  ::executorch::runtime::Error set_draft_model(
+      std::unique_ptr<::executorch::extension::Module> draft_module,
+      int32_t num_draft_tokens);
+
+  /**
+   * @brief Frees a named KV cache snapshot
+   *
+   * @param name Name of the snapshot
+   */
+  void drop_prefix_cache(const std::string& name);
+
+  /**
+   * @brief Saves the session to a file so it can be resumed later
+   *
+   * Writes the filled part of the KV cache, the current position and, with
+   * prefix caching enabled, the tokens in the cache to a .ptd file. The model
+   * must declare the sequence dim of its caches with get_kv_cache_seq_dim,
+   * and its mutable buffers must all be linear caches as described in
+   * save_session_state().
+   *
+   * @param path File to write
+   * @return ::executorch::runtime::Error Success or error status
+   */
+  ::executorch::runtime::Error save_session(const std::string& path);
+
+  /**
+   * @brief Resumes a session saved with save_session()
+   *
+   * Memory-maps the file and restores the KV cache and position, so the next
+   * generate() continues the saved conversation without prefilling it again.
+   * The model must be the one the session was saved with.
+   *
+   * @param path File to read
+   * @return ::executorch::runtime::Error Success or error status
+   */
+  ::executorch::runtime::Error load_session(const std::string& path);
+
   /**
    * @brief Stops the ongoing text generation process
    *
@@ -147,6 +252,7 @@ class ET_EXPERIMENTAL TextLLMRunner : public IRunner {
   std::unique_ptr<TextPrefiller> text_prefiller_;
   std::unique_ptr<IOManager> io_manager_;
   std::unique_ptr<TextTokenGenerator> text_token_generator_;
+  std::unique_ptr<SpeculativeTokenGenerator> speculative_token_generator_;
 
   // Stats
   std::unique_ptr<Stats> stats_;
@@ -157,6 +263,17 @@ class ET_EXPERIMENTAL TextLLMRunner : public IRunner {
 
   // The position in KV cache of the input, starting from 0.
   int64_t pos_ = 0;
+
+  // Prefix caching.
+  struct PrefixCache {
+    std::vector<uint64_t> tokens;
+    std::vector<std::vector<uint8_t>> buffers;
+  };
+  bool prefix_caching_ = false;
+  // Tokens currently materialized in the KV cache, by position. May extend
+  // past pos_ after reset().
+  std::vector<uint64_t> cached_tokens_;
+  std::unordered_map<std::string, PrefixCache> prefix_caches_;
 };
 
 } // namespace executorch::extension::llm
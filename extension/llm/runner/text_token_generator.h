@@ -9,8 +9,12 @@
 // Generate tokens in a loop.
 #pragma once
 
+#include <atomic>
+#include <optional>
+
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/runner/token_callback_pipeline.h>
 #include <executorch/extension/tensor/tensor.h>
 #include <pytorch/tokenizers/tokenizer.h>
 
@@ -46,14 +50,19 @@ class ET_EXPERIMENTAL TextTokenGenerator {
    * random predictions, while a lower temperature results in more deterministic
    * predictions.
    * @param token_callback what to do after a token is generated.
-   * @return how many tokens are generated.
+   * @param generated_tokens if not null, every sampled token id is appended to
+   * it.
+   * @return how many tokens are generated. When pipelining callbacks and
+   * stopped through stop(), this is the number of tokens delivered to
+   * token_callback.
    */
   inline ::executorch::runtime::Result<int64_t> generate(
       std::vector<uint64_t> tokens,
       int64_t start_pos,
       int32_t max_new_tokens,
       float temperature = 0.0f,
-      const std::function<void(const std::string&)>& token_callback = {}) {
+      const std::function<void(const std::string&)>& token_callback = {},
+      std::vector<uint64_t>* generated_tokens = nullptr) {
     ET_CHECK_MSG(
         !tokens.empty(), "Token generation loop shouldn't take empty tokens");
     int64_t pos = start_pos; // position in the sequence
@@ -81,6 +90,15 @@ class ET_EXPERIMENTAL TextTokenGenerator {
 
     should_stop_ = false;
 
+    // Decode and deliver tokens on another thread while the next step runs.
+    std::optional<TokenCallbackPipeline> pipeline;
+    if (callback_queue_size_ > 0 && token_callback) {
+      pipeline.emplace(
+          tokenizer_, token_callback, should_stop_, callback_queue_size_);
+    }
+    const size_t num_prior_tokens =
+        generated_tokens != nullptr ? generated_tokens->size() : 0;
+
     // Generate our tokens
     while (pos < start_pos + max_new_tokens) {
       // Run the model
@@ -95,6 +113,9 @@ class ET_EXPERIMENTAL TextTokenGenerator {
       cur_token =
           text_decoder_runner_->logits_to_token(logits_tensor, temperature);
       stats_->on_sampling_end();
+      if (generated_tokens != nullptr) {
+        generated_tokens->push_back(cur_token);
+      }
 
       pos++;
 
@@ -109,16 +130,22 @@ class ET_EXPERIMENTAL TextTokenGenerator {
             tokens_managed, {1, static_cast<int>(token_data.size())}));
       }
 
-      // print the token as string, decode it with the Tokenizer object
-      auto decode_result = tokenizer_->decode(prev_token, cur_token);
-      if (!decode_result.ok()) {
-        ET_LOG(
-            Error,
-            "Tokenizers error code %d",
-            static_cast<uint32_t>(decode_result.error()));
-        return ::executorch::runtime::Error::InvalidArgument;
+      if (pipeline) {
+        if (!pipeline->push(prev_token, cur_token)) {
+          break;
+        }
+      } else {
+        // print the token as string, decode it with the Tokenizer object
+        auto decode_result = tokenizer_->decode(prev_token, cur_token);
+        if (!decode_result.ok()) {
+          ET_LOG(
+              Error,
+              "Tokenizers error code %d",
+              static_cast<uint32_t>(decode_result.error()));
+          return ::executorch::runtime::Error::InvalidArgument;
+        }
+        token_callback(std::move(*decode_result));
       }
-      token_callback(std::move(*decode_result));
 
       if (should_stop_) {
         break;
@@ -131,9 +158,31 @@ class ET_EXPERIMENTAL TextTokenGenerator {
         break;
       }
     }
+    if (pipeline) {
+      ET_CHECK_OK_OR_RETURN_ERROR(pipeline->finish());
+      if (should_stop_) {
+        // Tokens generated after the one that stopped generation were
+        // dropped, don't report them.
+        const int64_t num_delivered = pipeline->num_delivered();
+        if (generated_tokens != nullptr) {
+          generated_tokens->resize(num_prior_tokens + num_delivered);
+        }
+        return num_delivered;
+      }
+    }
     return pos - start_pos;
   }
 
+  /**
+   * Run detokenization and token_callback on a separate thread, so that they
+   * overlap with the next decode step. Tokens are delivered in order.
+   * @param queue_size Maximum number of generated tokens waiting to be
+   * delivered before generation blocks. 0 runs them inline (the default).
+   */
+  inline void set_callback_queue_size(size_t queue_size) {
+    callback_queue_size_ = queue_size;
+  }
+
   /**
    * Stop the generation loop.
    */
@@ -171,7 +220,10 @@ class ET_EXPERIMENTAL TextTokenGenerator {
   bool use_kv_cache_;
 
   // state machine
-  bool should_stop_ = false;
+  std::atomic<bool> should_stop_{false};
+
+  // 0 delivers tokens inline.
+  size_t callback_queue_size_ = 0;
 
   // stats
   Stats* stats_;
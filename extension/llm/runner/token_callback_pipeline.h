@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Decode tokens and deliver them to a callback on a separate thread.
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/log.h>
+#include <pytorch/tokenizers/tokenizer.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Moves detokenization and the token callback off the decode loop.
+ *
+ * The producer pushes (prev_token, cur_token) pairs in generation order and
+ * keeps running the model; a worker thread decodes them and calls the
+ * callback in the same order. At most `capacity` tokens are pending, after
+ * which push() blocks, so a slow consumer throttles generation instead of
+ * buffering without bound.
+ *
+ * Once `should_stop` is set (e.g. by the callback calling stop()), pending
+ * tokens are dropped, so the callback never sees a token after the one during
+ * which generation was stopped.
+ */
+class ET_EXPERIMENTAL TokenCallbackPipeline {
+ public:
+  TokenCallbackPipeline(
+      ::tokenizers::Tokenizer* tokenizer,
+      const std::function<void(const std::string&)>& token_callback,
+      const std::atomic<bool>& should_stop,
+      size_t capacity)
+      : tokenizer_(tokenizer),
+        token_callback_(token_callback),
+        should_stop_(should_stop),
+        capacity_(capacity > 0 ? capacity : 1),
+        worker_([this] { run(); }) {}
+
+  ~TokenCallbackPipeline() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+      queue_.clear();
+    }
+    not_empty_.notify_one();
+    worker_.join();
+  }
+
+  /**
+   * Queues a token for decoding and delivery. Blocks while the queue is full.
+   * @return false if the worker has failed or stopped, in which case the
+   * token is dropped.
+   */
+  bool push(uint64_t prev_token, uint64_t cur_token) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] {
+      return queue_.size() < capacity_ || !error_ok() || stopped_;
+    });
+    if (!error_ok() || stopped_) {
+      return false;
+    }
+    queue_.emplace_back(prev_token, cur_token);
+    lock.unlock();
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /**
+   * Waits until every queued token is delivered or dropped.
+   * @return The first decode error, if any.
+   */
+  ::executorch::runtime::Error finish() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return queue_.empty() && !busy_; });
+    return error_;
+  }
+
+  /**
+   * @return Number of tokens handed to the callback so far.
+   */
+  int64_t num_delivered() const {
+    return num_delivered_.load();
+  }
+
+ private:
+  bool error_ok() const {
+    return error_ == ::executorch::runtime::Error::Ok;
+  }
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      not_empty_.wait(lock, [this] { return !queue_.empty() || closed_; });
+      if (queue_.empty()) {
+        return;
+      }
+      const auto [prev_token, cur_token] = queue_.front();
+      queue_.pop_front();
+      busy_ = true;
+      lock.unlock();
+      not_full_.notify_one();
+
+      bool delivered = false;
+      auto decode_result = tokenizer_->decode(prev_token, cur_token);
+      if (decode_result.ok()) {
+        token_callback_(std::move(*decode_result));
+        delivered = true;
+      } else {
+        ET_LOG(
+            Error,
+            "Tokenizers error code %d",
+            static_cast<uint32_t>(decode_result.error()));
+      }
+
+      lock.lock();
+      busy_ = false;
+      if (delivered) {
+        num_delivered_++;
+      } else {
+        error_ = ::executorch::runtime::Error::InvalidArgument;
+      }
+      if (!delivered || should_stop_.load()) {
+        stopped_ = true;
+        queue_.clear();
+        not_full_.notify_one();
+      }
+      if (queue_.empty()) {
+        idle_.notify_all();
+      }
+    }
+  }
+
+  ::tokenizers::Tokenizer* tokenizer_;
+  const std::function<void(const std::string&)>& token_callback_;
+  const std::atomic<bool>& should_stop_;
+  const size_t capacity_;
+
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::condition_variable idle_;
+  std::deque<std::pair<uint64_t, uint64_t>> queue_;
+  bool busy_ = false;
+  bool closed_ = false;
+  bool stopped_ = false;
+  ::executorch::runtime::Error error_ = ::executorch::runtime::Error::Ok;
+  std::atomic<int64_t> num_delivered_{0};
+
+  // Declared last so that it starts after everything it uses is initialized.
+  std::thread worker_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
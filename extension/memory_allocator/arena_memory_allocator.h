@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#include <executorch/runtime/core/memory_allocator.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A growable bump allocator that keeps its memory across reset() calls.
+ *
+ * Memory is taken from malloc()ed chunks. When the current chunk is full a
+ * larger one is added. reset() only rewinds the bump pointer, so a workload
+ * that allocates the same amount every cycle (e.g. kernel scratch between
+ * instructions) stops calling malloc() after the first one. If a cycle
+ * needed more than one chunk, reset() replaces them with a single chunk the
+ * size of the largest cycle seen so far.
+ *
+ * allocate() and reset() are thread-safe, so kernels can allocate from
+ * parallel workers. As with any temp allocator, memory is only valid until
+ * the next reset().
+ */
+class ArenaMemoryAllocator : public executorch::runtime::MemoryAllocator {
+ public:
+  /// Size of the first chunk if none is given at construction.
+  static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+  /// Alignment of the start of every chunk.
+  static constexpr size_t kChunkAlignment = 64;
+
+  /**
+   * Construct a new arena allocator.
+   *
+   * @param[in] initial_size Size of the first chunk, allocated up front. If 0,
+   * the first chunk is allocated on first use.
+   */
+  explicit ArenaMemoryAllocator(size_t initial_size = 0)
+      : MemoryAllocator(0, nullptr) {
+    if (initial_size > 0) {
+      add_chunk(initial_size);
+    }
+  }
+
+  ~ArenaMemoryAllocator() override {
+    release_chunks();
+  }
+
+  ArenaMemoryAllocator(const ArenaMemoryAllocator&) = delete;
+  ArenaMemoryAllocator& operator=(const ArenaMemoryAllocator&) = delete;
+  ArenaMemoryAllocator(ArenaMemoryAllocator&&) = delete;
+  ArenaMemoryAllocator& operator=(ArenaMemoryAllocator&&) = delete;
+
+  /**
+   * Allocates 'size' bytes of memory, returning a pointer to the allocated
+   * region, or nullptr upon failure.
+   */
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    EXECUTORCH_TRACK_ALLOCATION(prof_id(), size);
+
+    if (!isPowerOf2(alignment)) {
+      ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
+      return nullptr;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (; current_ < chunks_.size(); ++current_, offset_ = 0) {
+      void* ptr = bump(size, alignment);
+      if (ptr != nullptr) {
+        return ptr;
+      }
+      // Whatever is left in this chunk counts as used, so that the coalesced
+      // chunk is large enough to hold this cycle.
+      used_ += chunks_[current_].size - offset_;
+    }
+
+    // Grow geometrically so that the number of chunks stays logarithmic.
+    size_t chunk_size = std::max(kDefaultChunkSize, size + alignment);
+    if (!chunks_.empty()) {
+      chunk_size = std::max(chunk_size, 2 * chunks_.back().size);
+    }
+    if (!add_chunk(chunk_size)) {
+      return nullptr;
+    }
+    current_ = chunks_.size() - 1;
+    offset_ = 0;
+    return bump(size, alignment);
+  }
+
+  /**
+   * Rewinds to the start of the arena without freeing its memory. If the
+   * last cycle spilled over into several chunks, they are merged into one.
+   */
+  void reset() override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    high_water_ = std::max(high_water_, used_);
+    if (chunks_.size() > 1) {
+      release_chunks();
+      add_chunk(high_water_);
+    }
+    current_ = 0;
+    offset_ = 0;
+    used_ = 0;
+  }
+
+  /// Total size of the chunks currently held.
+  size_t capacity() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    size_t total = 0;
+    for (const auto& chunk : chunks_) {
+      total += chunk.size;
+    }
+    return total;
+  }
+
+  /// Number of chunks currently held.
+  size_t num_chunks() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return chunks_.size();
+  }
+
+ private:
+  struct Chunk {
+    void* raw;
+    uint8_t* begin;
+    size_t size;
+  };
+
+  // Bumps the current chunk. Must hold mutex_.
+  void* bump(size_t size, size_t alignment) {
+    const auto& chunk = chunks_[current_];
+    uint8_t* cur = chunk.begin + offset_;
+    uint8_t* start = alignPointer(cur, alignment);
+    const size_t padding = start - cur;
+    if (padding > chunk.size - offset_ ||
+        size > chunk.size - offset_ - padding) {
+      return nullptr;
+    }
+    offset_ += padding + size;
+    used_ += padding + size;
+    return start;
+  }
+
+  // Must hold mutex_, or be called from a constructor.
+  bool add_chunk(size_t size) {
+    void* raw = std::malloc(size + kChunkAlignment);
+    if (raw == nullptr) {
+      ET_LOG(Error, "Failed to allocate a %zu byte arena chunk", size);
+      return false;
+    }
+    chunks_.push_back(
+        {raw,
+         alignPointer(static_cast<uint8_t*>(raw), kChunkAlignment),
+         size});
+    return true;
+  }
+
+  // Must hold mutex_, or be called from the destructor.
+  void release_chunks() {
+    for (const auto& chunk : chunks_) {
+      std::free(chunk.raw);
+    }
+    chunks_.clear();
+  }
+
+  mutable std::mutex mutex_;
+  std::vector<Chunk> chunks_;
+  // Chunk and offset in it that the next allocation starts from.
+  size_t current_ = 0;
+  size_t offset_ = 0;
+  // Bytes consumed since the last reset(), and the maximum over all cycles.
+  size_t used_ = 0;
+  size_t high_water_ = 0;
+};
+
+} // namespace extension
+} // namespace executorch
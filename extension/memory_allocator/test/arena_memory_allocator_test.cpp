@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/arena_memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace ::testing;
+using executorch::extension::ArenaMemoryAllocator;
+
+constexpr auto kDefaultAlignment = ArenaMemoryAllocator::kDefaultAlignment;
+
+class ArenaMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+bool is_aligned(const void* ptr, size_t alignment) {
+  uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+  return addr % alignment == 0;
+}
+
+#define EXPECT_ALIGNED(ptr, alignment)        \
+  EXPECT_TRUE(is_aligned((ptr), (alignment))) \
+      << "Pointer " << (ptr) << " is not aligned to " << (alignment)
+
+TEST_F(ArenaMemoryAllocatorTest, SimpleAllocateSucceeds) {
+  ArenaMemoryAllocator allocator;
+
+  auto p = allocator.allocate(16);
+  EXPECT_NE(p, nullptr);
+  EXPECT_ALIGNED(p, kDefaultAlignment);
+
+  auto p2 = allocator.allocate(16);
+  EXPECT_NE(p2, nullptr);
+  EXPECT_NE(p2, p);
+  EXPECT_ALIGNED(p2, kDefaultAlignment);
+
+  // Allocations don't overlap.
+  std::memset(p, 0x11, 16);
+  std::memset(p2, 0x22, 16);
+  EXPECT_EQ(static_cast<uint8_t*>(p)[15], 0x11);
+}
+
+TEST_F(ArenaMemoryAllocatorTest, AlignmentSmokeTest) {
+  ArenaMemoryAllocator allocator;
+  for (size_t alignment : {1, 2, 16, 64, 128, 256, 4096}) {
+    auto p = allocator.allocate(3, alignment);
+    EXPECT_NE(p, nullptr);
+    EXPECT_ALIGNED(p, alignment);
+  }
+}
+
+TEST_F(ArenaMemoryAllocatorTest, BadAlignmentFails) {
+  ArenaMemoryAllocator allocator;
+  EXPECT_EQ(allocator.allocate(16, 0), nullptr);
+  EXPECT_EQ(allocator.allocate(16, 3), nullptr);
+}
+
+TEST_F(ArenaMemoryAllocatorTest, ResetReusesMemory) {
+  ArenaMemoryAllocator allocator(1024);
+  auto p = allocator.allocate(100);
+  allocator.allocate(200);
+  allocator.reset();
+  EXPECT_EQ(allocator.allocate(100), p);
+  EXPECT_EQ(allocator.num_chunks(), 1);
+  EXPECT_EQ(allocator.capacity(), 1024);
+}
+
+TEST_F(ArenaMemoryAllocatorTest, ResetCoalescesToHighWaterMark) {
+  ArenaMemoryAllocator allocator(1024);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_NE(allocator.allocate(1000), nullptr);
+  }
+  EXPECT_GT(allocator.num_chunks(), 1);
+
+  allocator.reset();
+  EXPECT_EQ(allocator.num_chunks(), 1);
+  const size_t capacity = allocator.capacity();
+  EXPECT_GE(capacity, 4000);
+
+  // The same workload now fits in the single chunk.
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_NE(allocator.allocate(1000), nullptr);
+  }
+  EXPECT_EQ(allocator.num_chunks(), 1);
+  allocator.reset();
+  EXPECT_EQ(allocator.capacity(), capacity);
+}
+
+TEST_F(ArenaMemoryAllocatorTest, LargeAllocationGetsOwnChunk) {
+  ArenaMemoryAllocator allocator(64);
+  auto p = allocator.allocate(1 << 20, 256);
+  ASSERT_NE(p, nullptr);
+  EXPECT_ALIGNED(p, 256);
+  std::memset(p, 0, 1 << 20);
+}
+
+TEST_F(ArenaMemoryAllocatorTest, ConcurrentAllocationsDontOverlap) {
+  ArenaMemoryAllocator allocator(256);
+  constexpr int kThreads = 4;
+  constexpr int kAllocsPerThread = 200;
+  std::vector<std::vector<uint8_t*>> ptrs(kThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kAllocsPerThread; ++i) {
+        auto* p = static_cast<uint8_t*>(allocator.allocate(32));
+        ASSERT_NE(p, nullptr);
+        std::memset(p, t, 32);
+        ptrs[t].push_back(p);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < kThreads; ++t) {
+    for (auto* p : ptrs[t]) {
+      for (int i = 0; i < 32; ++i) {
+        ASSERT_EQ(p[i], t);
+      }
+    }
+  }
+}
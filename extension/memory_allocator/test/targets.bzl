@@ -6,6 +6,16 @@ def define_common_targets():
     The directory containing this targets.bzl file should also contain both
     TARGETS and BUCK files that call this function.
     """
+    runtime.cxx_test(
+        name = "arena_memory_allocator_test",
+        srcs = [
+            "arena_memory_allocator_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/memory_allocator:arena_memory_allocator",
+        ],
+    )
+
     runtime.cxx_test(
         name = "malloc_memory_allocator_test",
         srcs = [
@@ -11,10 +11,20 @@
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/data_loader/mmap_data_loader.h>
 #include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
+#include <executorch/extension/memory_allocator/arena_memory_allocator.h>
 #include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
 #include <executorch/extension/named_data_map/merged_data_map.h>
 #include <executorch/runtime/platform/runtime.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 namespace executorch {
 namespace extension {
 namespace ET_MODULE_NAMESPACE {
@@ -73,8 +83,76 @@ runtime::Result<std::unique_ptr<runtime::DataLoader>> make_data_loader(
   }
   return data_loader;
 }
+
+// Alignment of shared planned buffers, and of huge page backed ones.
+constexpr size_t kPlannedBufferAlignment = 64;
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+// Allocates a buffer without initializing it. Returns a null pointer on
+// failure.
+std::unique_ptr<void, void (*)(void*)>
+allocate_planned_buffer(size_t size, bool use_huge_pages, uint8_t** begin) {
+  const size_t alignment =
+      use_huge_pages ? kHugePageSize : kPlannedBufferAlignment;
+  if (use_huge_pages) {
+    size = (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+  }
+  std::unique_ptr<void, void (*)(void*)> buffer(
+      std::malloc(size + alignment), std::free);
+  if (!buffer) {
+    return buffer;
+  }
+  const auto address = reinterpret_cast<uintptr_t>(buffer.get());
+  *begin = reinterpret_cast<uint8_t*>(
+      (address + alignment - 1) & ~(uintptr_t(alignment) - 1));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (use_huge_pages && madvise(*begin, size, MADV_HUGEPAGE) != 0) {
+    ET_LOG(Info, "Huge pages are unavailable for a planned buffer");
+  }
+#endif
+  return buffer;
+}
+
+// Marks planned buffers that stay owned by their method.
+constexpr size_t kNotInArena = std::numeric_limits<size_t>::max();
+
+// Lays the planned buffers of a method that hold no state out consecutively,
+// and returns the size of the arena they need.
+runtime::Result<size_t> layout_in_arena(
+    const MethodMeta& method_meta,
+    std::vector<size_t>& offsets) {
+  const auto planned_buffers_count = method_meta.num_memory_planned_buffers();
+  offsets.assign(planned_buffers_count, kNotInArena);
+  size_t size = 0;
+  for (size_t index = 0; index < planned_buffers_count; ++index) {
+    auto holds_state = method_meta.memory_planned_buffer_holds_state(index);
+    ET_CHECK_OK_OR_RETURN_ERROR(holds_state.error());
+    if (*holds_state) {
+      continue;
+    }
+    size = (size + kPlannedBufferAlignment - 1) / kPlannedBufferAlignment *
+        kPlannedBufferAlignment;
+    offsets[index] = size;
+    size += method_meta.memory_planned_buffer_size(index).get();
+  }
+  return size;
+}
+
 } // namespace
 
+runtime::Result<std::shared_ptr<PlannedMemoryArena>>
+PlannedMemoryArena::create(size_t capacity, bool use_huge_pages) {
+  uint8_t* begin = nullptr;
+  auto buffer = allocate_planned_buffer(capacity, use_huge_pages, &begin);
+  ET_CHECK_OR_RETURN_ERROR(
+      buffer != nullptr,
+      MemoryAllocationFailed,
+      "Failed to allocate a %zu byte planned memory arena",
+      capacity);
+  return std::shared_ptr<PlannedMemoryArena>(
+      new PlannedMemoryArena(std::move(buffer), begin, capacity));
+}
+
 Module::Module(
     const std::string& file_path,
     const LoadMode load_mode,
@@ -82,7 +160,7 @@ Module::Module(
     : file_path_(file_path),
       load_mode_(load_mode),
       memory_allocator_(std::make_unique<MallocMemoryAllocator>()),
-      temp_allocator_(std::make_unique<MallocMemoryAllocator>()),
+      temp_allocator_(std::make_unique<ArenaMemoryAllocator>()),
       event_tracer_(std::move(event_tracer)) {
   runtime::runtime_init();
 }
@@ -95,7 +173,7 @@ Module::Module(
     : file_path_(file_path),
       load_mode_(load_mode),
       memory_allocator_(std::make_unique<MallocMemoryAllocator>()),
-      temp_allocator_(std::make_unique<MallocMemoryAllocator>()),
+      temp_allocator_(std::make_unique<ArenaMemoryAllocator>()),
       event_tracer_(std::move(event_tracer)) {
   if (!data_map_path.empty()) {
     data_files_.push_back(data_map_path);
@@ -112,7 +190,7 @@ Module::Module(
       data_files_(std::move(data_files)),
       load_mode_(load_mode),
       memory_allocator_(std::make_unique<MallocMemoryAllocator>()),
-      temp_allocator_(std::make_unique<MallocMemoryAllocator>()),
+      temp_allocator_(std::make_unique<ArenaMemoryAllocator>()),
       event_tracer_(std::move(event_tracer)) {
   runtime::runtime_init();
 }
@@ -129,7 +207,7 @@ Module::Module(
                            : std::make_unique<MallocMemoryAllocator>()),
       temp_allocator_(
           temp_allocator ? std::move(temp_allocator)
-                         : std::make_unique<MallocMemoryAllocator>()),
+                         : std::make_unique<ArenaMemoryAllocator>()),
       event_tracer_(std::move(event_tracer)) {
   if (data_map_loader) {
     data_map_loaders_.push_back(std::move(data_map_loader));
@@ -149,7 +227,7 @@ Module::Module(
                            : std::make_unique<MallocMemoryAllocator>()),
       temp_allocator_(
           temp_allocator ? std::move(temp_allocator)
-                         : std::make_unique<MallocMemoryAllocator>()),
+                         : std::make_unique<ArenaMemoryAllocator>()),
       event_tracer_(std::move(event_tracer)) {
   if (data_map_loader) {
     data_map_loaders_.push_back(std::move(data_map_loader));
@@ -235,6 +313,133 @@ runtime::Result<std::unordered_set<std::string>> Module::method_names() {
   return result;
 }
 
+runtime::Error Module::share_planned_memory(
+    const std::vector<std::string>& method_names,
+    bool use_huge_pages) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load());
+  ET_CHECK_OR_RETURN_ERROR(
+      !method_names.empty(), InvalidArgument, "No methods to share memory");
+
+  // What each planned buffer index holds across the methods that have it.
+  enum class BufferUse { Scratch, SharedState, PerMethod };
+  std::vector<size_t> sizes;
+  std::vector<BufferUse> uses;
+  std::vector<bool> seen;
+  for (const auto& method_name : method_names) {
+    ET_CHECK_OR_RETURN_ERROR(
+        !is_method_loaded(method_name) &&
+            !shared_planned_memory_.count(method_name) &&
+            !planned_memory_arenas_.count(method_name),
+        InvalidState,
+        "Method %s is already loaded or has its planned memory set up",
+        method_name.c_str());
+    auto method_metadata = program_->method_meta(method_name.c_str());
+    ET_CHECK_OK_OR_RETURN_ERROR(method_metadata.error());
+    const auto planned_buffers_count =
+        method_metadata->num_memory_planned_buffers();
+    if (planned_buffers_count > sizes.size()) {
+      sizes.resize(planned_buffers_count, 0);
+      uses.resize(planned_buffers_count, BufferUse::Scratch);
+      seen.resize(planned_buffers_count, false);
+    }
+    for (size_t index = 0; index < planned_buffers_count; ++index) {
+      const auto buffer_size = static_cast<size_t>(
+          method_metadata->memory_planned_buffer_size(index).get());
+      auto holds_only_state =
+          method_metadata->memory_planned_buffer_holds_only_state(index);
+      ET_CHECK_OK_OR_RETURN_ERROR(holds_only_state.error());
+      auto use = BufferUse::SharedState;
+      if (!*holds_only_state) {
+        auto holds_state =
+            method_metadata->memory_planned_buffer_holds_state(index);
+        ET_CHECK_OK_OR_RETURN_ERROR(holds_state.error());
+        use = *holds_state ? BufferUse::PerMethod : BufferUse::Scratch;
+      }
+      // State is only shared if every method keeps it, and only it, in a
+      // buffer of the same size.
+      if (!seen[index]) {
+        uses[index] = use;
+        seen[index] = true;
+      } else if (
+          use != uses[index] ||
+          (use == BufferUse::SharedState && buffer_size != sizes[index])) {
+        uses[index] = BufferUse::PerMethod;
+      }
+      sizes[index] = std::max(sizes[index], buffer_size);
+    }
+  }
+
+  auto shared = std::make_shared<SharedPlannedMemory>();
+  shared->spans.resize(sizes.size());
+  for (size_t index = 0; index < sizes.size(); ++index) {
+    if (uses[index] == BufferUse::PerMethod || sizes[index] == 0) {
+      continue;
+    }
+    uint8_t* begin = nullptr;
+    auto buffer = allocate_planned_buffer(sizes[index], use_huge_pages, &begin);
+    ET_CHECK_OR_RETURN_ERROR(
+        buffer != nullptr,
+        MemoryAllocationFailed,
+        "Failed to allocate %zu bytes of planned memory",
+        sizes[index]);
+    if (uses[index] == BufferUse::SharedState) {
+      // Start from the same state as a buffer owned by one method.
+      std::memset(begin, 0, sizes[index]);
+    }
+    shared->buffers.push_back(std::move(buffer));
+    shared->spans[index] = runtime::Span<uint8_t>(begin, sizes[index]);
+  }
+  for (const auto& method_name : method_names) {
+    shared_planned_memory_[method_name] = shared;
+  }
+  return runtime::Error::Ok;
+}
+
+runtime::Error Module::use_planned_memory_arena(
+    std::shared_ptr<PlannedMemoryArena> arena,
+    const std::vector<std::string>& method_names) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load());
+  ET_CHECK_OR_RETURN_ERROR(
+      arena != nullptr, InvalidArgument, "No planned memory arena");
+  for (const auto& method_name : method_names) {
+    ET_CHECK_OR_RETURN_ERROR(
+        !is_method_loaded(method_name) &&
+            !shared_planned_memory_.count(method_name) &&
+            !planned_memory_arenas_.count(method_name),
+        InvalidState,
+        "Method %s is already loaded or has its planned memory set up",
+        method_name.c_str());
+    auto size = planned_memory_arena_size(method_name);
+    ET_CHECK_OK_OR_RETURN_ERROR(size.error());
+    ET_CHECK_OR_RETURN_ERROR(
+        *size <= arena->capacity(),
+        MemoryAllocationFailed,
+        "Method %s needs %zu bytes of the %zu byte planned memory arena",
+        method_name.c_str(),
+        *size,
+        arena->capacity());
+  }
+  for (const auto& method_name : method_names) {
+    planned_memory_arenas_[method_name] = arena;
+  }
+  return runtime::Error::Ok;
+}
+
+runtime::Result<size_t> Module::planned_memory_arena_size(
+    const std::string& method_name) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load());
+  auto method_metadata = program_->method_meta(method_name.c_str());
+  ET_CHECK_OK_OR_RETURN_ERROR(method_metadata.error());
+  std::vector<size_t> offsets;
+  return layout_in_arena(*method_metadata, offsets);
+}
+
+void Module::acquire_planned_memory_arena(const MethodHolder& holder) {
+  if (holder.planned_memory_arena) {
+    holder.planned_memory_arena->owner_ = holder.planned_memory_arena_user_id;
+  }
+}
+
 runtime::Error Module::load_method(
     const std::string& method_name,
     runtime::HierarchicalAllocator* planned_memory,
@@ -254,10 +459,39 @@ runtime::Error Module::load_method(
           method_metadata.num_memory_planned_buffers();
       method_holder.planned_buffers.reserve(planned_buffers_count);
       method_holder.planned_spans.reserve(planned_buffers_count);
+      if (shared_planned_memory_.count(method_name)) {
+        method_holder.shared_planned_memory =
+            shared_planned_memory_.at(method_name);
+      }
+      std::vector<size_t> arena_offsets;
+      if (planned_memory_arenas_.count(method_name)) {
+        method_holder.planned_memory_arena =
+            planned_memory_arenas_.at(method_name);
+        auto arena_size = layout_in_arena(method_metadata, arena_offsets);
+        ET_CHECK_OK_OR_RETURN_ERROR(arena_size.error());
+        auto& arena = *method_holder.planned_memory_arena;
+        arena.used_ = std::max(arena.used_, *arena_size);
+        method_holder.planned_memory_arena_user_id = arena.next_user_id_++;
+      }
 
       for (auto index = 0; index < planned_buffers_count; ++index) {
         const auto buffer_size =
             method_metadata.memory_planned_buffer_size(index).get();
+        if (method_holder.planned_memory_arena &&
+            arena_offsets[index] != kNotInArena) {
+          method_holder.planned_spans.emplace_back(
+              method_holder.planned_memory_arena->begin_ +
+                  arena_offsets[index],
+              buffer_size);
+          continue;
+        }
+        if (method_holder.shared_planned_memory &&
+            method_holder.shared_planned_memory->spans[index].size() > 0) {
+          method_holder.planned_spans.emplace_back(
+              method_holder.shared_planned_memory->spans[index].data(),
+              buffer_size);
+          continue;
+        }
         method_holder.planned_buffers.emplace_back(buffer_size);
         method_holder.planned_spans.emplace_back(
             method_holder.planned_buffers.back().data(), buffer_size);
@@ -302,7 +536,19 @@ runtime::Result<std::vector<runtime::EValue>> Module::execute(
     const std::string& method_name,
     const std::vector<runtime::EValue>& input_values) {
   ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
-  auto& method = methods_.at(method_name).method;
+  const auto& holder = methods_.at(method_name);
+  auto& method = holder.method;
+  if (holder.planned_memory_arena) {
+    if (input_values.size() >= method->inputs_size()) {
+      acquire_planned_memory_arena(holder);
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        holder.planned_memory_arena->owner_ ==
+            holder.planned_memory_arena_user_id,
+        InvalidState,
+        "Inputs of method %s were overwritten by another user of its planned memory arena; set them again",
+        method_name.c_str());
+  }
   for (auto index = 0; index < input_values.size(); ++index) {
     ET_CHECK_OK_OR_RETURN_ERROR(method->set_input(input_values[index], index));
   }
@@ -321,6 +567,7 @@ runtime::Error Module::set_input(
     size_t input_index) {
   ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
   auto& method = methods_.at(method_name).method;
+  acquire_planned_memory_arena(methods_.at(method_name));
   return method->set_input(input_value, input_index);
 }
 
@@ -329,6 +576,7 @@ runtime::Error Module::set_inputs(
     const std::vector<runtime::EValue>& input_values) {
   ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
   auto& method = methods_.at(method_name).method;
+  acquire_planned_memory_arena(methods_.at(method_name));
   return method->set_inputs(executorch::aten::ArrayRef<runtime::EValue>(
       input_values.data(), input_values.size()));
 }
@@ -392,6 +640,24 @@ runtime::Result<runtime::EValue> Module::get_output(
   return method->get_output(output_index);
 }
 
+runtime::Result<std::vector<std::string>> Module::mutable_buffer_names(
+    const std::string& method_name) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& method = methods_.at(method_name).method;
+  std::vector<const char*> raw_names(method->mutable_buffers_size());
+  ET_CHECK_OK_OR_RETURN_ERROR(
+      method->get_mutable_buffer_names(raw_names.data(), raw_names.size()));
+  return std::vector<std::string>(raw_names.begin(), raw_names.end());
+}
+
+runtime::Result<executorch::aten::Tensor> Module::get_attribute(
+    const std::string& method_name,
+    const std::string& name) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& method = methods_.at(method_name).method;
+  return method->get_attribute(name);
+}
+
 } // namespace ET_MODULE_NAMESPACE
 } // namespace extension
 } // namespace executorch
@@ -33,6 +33,65 @@ using ET_RUNTIME_NAMESPACE::Program;
 class ExecuTorchJni;
 
 namespace ET_MODULE_NAMESPACE {
+
+class Module;
+
+/**
+ * A buffer of planned memory that methods of several Modules borrow, so that
+ * models invoked one at a time on a worker thread share one activation arena
+ * instead of each holding their own.
+ *
+ * Every method bound to an arena lays its shareable planned buffers out from
+ * the start of the arena, and uses it only between setting its inputs and
+ * reading its outputs: running any other method bound to the arena
+ * overwrites them. An arena is not thread-safe; give each worker thread its
+ * own.
+ */
+class PlannedMemoryArena final {
+ public:
+  /**
+   * Allocates an arena. The memory is not zero-filled, so on most platforms
+   * pages that no method touches never become resident.
+   *
+   * @param[in] capacity The size of the arena in bytes. See
+   * Module::planned_memory_arena_size().
+   * @param[in] use_huge_pages Whether to ask the OS to back the arena with huge
+   * pages. Only has an effect on Linux.
+   *
+   * @returns The arena, or an error if it could not be allocated.
+   */
+  static runtime::Result<std::shared_ptr<PlannedMemoryArena>> create(
+      size_t capacity,
+      bool use_huge_pages = false);
+
+  /// The size of the arena in bytes.
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  /// The largest number of bytes any method bound to the arena needs.
+  size_t used() const {
+    return used_;
+  }
+
+ private:
+  PlannedMemoryArena(
+      std::unique_ptr<void, void (*)(void*)> buffer,
+      uint8_t* begin,
+      size_t capacity)
+      : buffer_(std::move(buffer)), begin_(begin), capacity_(capacity) {}
+
+  std::unique_ptr<void, void (*)(void*)> buffer_;
+  uint8_t* begin_;
+  size_t capacity_;
+  size_t used_ = 0;
+  // Identifies the method whose inputs are in the arena; 0 if none.
+  uint64_t owner_ = 0;
+  uint64_t next_user_id_ = 1;
+
+  friend class Module;
+};
+
 /**
  * A facade class for loading programs and executing methods within them.
  */
@@ -101,7 +160,8 @@ class Module {
    * @param[in] data_loader A DataLoader used for loading program data.
    * @param[in] memory_allocator A MemoryAllocator used for memory management.
    * @param[in] temp_allocator A MemoryAllocator to use when allocating
-   * temporary data during kernel or delegate execution.
+   * temporary data during kernel or delegate execution. Defaults to an
+   * ArenaMemoryAllocator.
    * @param[in] event_tracer A EventTracer used for tracking and logging events.
    * @param[in] data_map_loader A DataLoader used for loading external weights.
    */
@@ -119,7 +179,7 @@ class Module {
    * the program uses is valid for the lifetime of the program.
    * @param[in] memory_allocator A MemoryAllocator used for memory management.
    * @param[in] temp_allocator A MemoryAllocator to use when allocating
-   * temporary data.
+   * temporary data. Defaults to an ArenaMemoryAllocator.
    * @param[in] event_tracer A EventTracer used for tracking and logging events.
    * @param[in] data_map_loader A DataLoader used for loading external weights.
    */
@@ -209,6 +269,72 @@ class Module {
     return load_method(method_name, nullptr, event_tracer);
   }
 
+  /**
+   * Let a group of methods that never run concurrently share one set of
+   * memory-planned buffers, each sized to the largest need in the group.
+   * Buffers that hold state, such as mutable buffers, in any of the methods
+   * are not shared and stay owned by each method, so state persists. See
+   * MethodMeta::memory_planned_buffer_holds_state().
+   *
+   * The exception is a buffer that holds state and nothing else in every
+   * method that has it, with the same size in each, like the one that
+   * programs exported with share_mutable_buffers keep the state of all
+   * methods in. It is shared and zero-filled, so the methods share that
+   * state. See MethodMeta::memory_planned_buffer_holds_only_state().
+   * Programs exported without share_mutable_buffers keep their state next to
+   * activations, so each method keeps its own state even if the methods
+   * were meant to share it. Other shared buffers are not zero-filled. Must
+   * be called before any of the methods is loaded.
+   *
+   * Running one method of the group overwrites the planned memory of the
+   * others, including any of their outputs that live in it.
+   *
+   * @param[in] method_names The names of the methods to group.
+   * @param[in] use_huge_pages Whether to ask the OS to back the shared buffers
+   * with huge pages. Only has an effect on Linux.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD runtime::Error share_planned_memory(
+      const std::vector<std::string>& method_names,
+      bool use_huge_pages = false);
+
+  /**
+   * Lay the planned buffers of some methods out in a PlannedMemoryArena that
+   * may be shared with other Modules, instead of allocating them per method.
+   * Buffers that hold state, such as mutable buffers, are not placed in the
+   * arena and stay owned by each method, so state persists. See
+   * MethodMeta::memory_planned_buffer_holds_state(). Must be
+   * called before any of the methods is loaded, and not for methods that
+   * share_planned_memory().
+   *
+   * A method owns the arena from setting its inputs, either through
+   * execute() with all of its inputs or through set_input(s)(), until another
+   * method bound to the arena does the same. Executing a method without
+   * inputs after losing the arena fails with Error::InvalidState, since its
+   * inputs were overwritten. Outputs that live in planned memory are only
+   * valid until the arena changes owner; copy them out to keep them.
+   *
+   * @param[in] arena The arena to borrow planned memory from.
+   * @param[in] method_names The names of the methods to bind to the arena.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD runtime::Error use_planned_memory_arena(
+      std::shared_ptr<PlannedMemoryArena> arena,
+      const std::vector<std::string>& method_names);
+
+  /**
+   * The capacity a PlannedMemoryArena needs for a method to be bound to it.
+   * Loads the program if needed.
+   *
+   * @param[in] method_name The name of the method.
+   *
+   * @returns The size in bytes, or an error.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD runtime::Result<size_t>
+  planned_memory_arena_size(const std::string& method_name);
+
   /**
    * Unload a specific method from the program.
    *
@@ -605,6 +731,33 @@ class Module {
     return get_output("forward", output_index);
   }
 
+  /**
+   * Retrieve the names of the mutable buffers of a specific method, e.g. its
+   * KV caches. Loads the program and method if needed.
+   *
+   * @param[in] method_name The name of the method.
+   *
+   * @returns A Result containing the buffer names, or an error.
+   */
+  ET_NODISCARD
+  runtime::Result<std::vector<std::string>> mutable_buffer_names(
+      const std::string& method_name);
+
+  /**
+   * Retrieve a named attribute tensor, such as a mutable buffer, of a specific
+   * method. The returned tensor aliases the method's memory, so writing into
+   * it changes the method's state. Loads the program and method if needed.
+   *
+   * @param[in] method_name The name of the method.
+   * @param[in] name The fully qualified name of the tensor.
+   *
+   * @returns A Result containing the tensor, or an error.
+   */
+  ET_NODISCARD
+  runtime::Result<executorch::aten::Tensor> get_attribute(
+      const std::string& method_name,
+      const std::string& name);
+
   /**
    * Retrieves the EventTracer instance being used by the Module.
    * EventTracer is used for tracking and logging events during the execution
@@ -624,7 +777,17 @@ class Module {
   }
 
  private:
+  struct SharedPlannedMemory {
+    std::vector<std::unique_ptr<void, void (*)(void*)>> buffers;
+    // One span per planned buffer index, empty where each method owns its
+    // own buffer.
+    std::vector<runtime::Span<uint8_t>> spans;
+  };
+
   struct MethodHolder {
+    std::shared_ptr<SharedPlannedMemory> shared_planned_memory;
+    std::shared_ptr<PlannedMemoryArena> planned_memory_arena;
+    uint64_t planned_memory_arena_user_id = 0;
     std::vector<std::vector<uint8_t>> planned_buffers;
     std::vector<runtime::Span<uint8_t>> planned_spans;
     std::unique_ptr<runtime::HierarchicalAllocator> planned_memory;
@@ -644,6 +807,13 @@ class Module {
   std::vector<std::unique_ptr<NamedDataMap>> named_data_maps_;
   std::unique_ptr<NamedDataMap> merged_data_map_;
   ET_DEPRECATED std::vector<uint8_t> debug_buffer_;
+  std::unordered_map<std::string, std::shared_ptr<SharedPlannedMemory>>
+      shared_planned_memory_;
+  std::unordered_map<std::string, std::shared_ptr<PlannedMemoryArena>>
+      planned_memory_arenas_;
+
+  // Makes `holder` the owner of its planned memory arena, if it has one.
+  void acquire_planned_memory_arena(const MethodHolder& holder);
 
  protected:
   std::unordered_map<std::string, MethodHolder> methods_;
@@ -667,5 +837,6 @@ namespace executorch {
 namespace extension {
 // backward compatible namespace alias
 using ::executorch::extension::ET_MODULE_NAMESPACE::Module;
+using ::executorch::extension::ET_MODULE_NAMESPACE::PlannedMemoryArena;
 } // namespace extension
 } // namespace executorch
@@ -8,6 +8,7 @@
 
 #include <executorch/extension/module/module.h>
 
+#include <algorithm>
 #include <array>
 #include <thread>
 
@@ -28,6 +29,10 @@ class ModuleTest : public ::testing::Test {
     add_mul_data_path_ = std::getenv("ET_MODULE_ADD_MUL_DATA_PATH");
     linear_path_ = std::getenv("ET_MODULE_LINEAR_PROGRAM_PATH");
     linear_data_path_ = std::getenv("ET_MODULE_LINEAR_DATA_PATH");
+    shared_state_path_ = std::getenv("ET_MODULE_SHARED_STATE");
+    shared_state_named_path_ = std::getenv("ET_MODULE_SHARED_STATE_NAMED");
+    method_state_path_ = std::getenv("ET_MODULE_METHOD_STATE");
+    method_state_named_path_ = std::getenv("ET_MODULE_METHOD_STATE_NAMED");
   }
 
   static inline std::string model_path_;
@@ -35,6 +40,10 @@ class ModuleTest : public ::testing::Test {
   static inline std::string add_mul_data_path_;
   static inline std::string linear_path_;
   static inline std::string linear_data_path_;
+  static inline std::string shared_state_path_;
+  static inline std::string shared_state_named_path_;
+  static inline std::string method_state_path_;
+  static inline std::string method_state_named_path_;
 };
 
 TEST_F(ModuleTest, TestLoad) {
@@ -554,3 +563,151 @@ TEST_F(ModuleTest, TestPTD_Multiple) {
   auto tensor2 = make_tensor_ptr({3}, {2.f, 3.f, 4.f});
   ASSERT_EQ(module_linear.forward(tensor2).error(), Error::Ok);
 }
+
+TEST_F(ModuleTest, TestSharePlannedMemory) {
+  // With and without the names of the mutable buffers.
+  for (const auto& path : {shared_state_path_, shared_state_named_path_}) {
+    Module module(path);
+
+    ASSERT_EQ(
+        module.share_planned_memory({"forward", "get_state", "set_state"}),
+        Error::Ok);
+    // Methods can only be grouped once, and must exist.
+    EXPECT_EQ(module.share_planned_memory({"forward"}), Error::InvalidState);
+    EXPECT_NE(module.share_planned_memory({"not_a_method"}), Error::Ok);
+
+    // The methods keep sharing their state.
+    ASSERT_EQ(
+        module.execute("set_state", make_tensor_ptr({1}, {5.f})).error(),
+        Error::Ok);
+    const auto result = module.forward(make_tensor_ptr({1}, {1.f}));
+    ASSERT_EQ(result.error(), Error::Ok);
+    EXPECT_TENSOR_CLOSE(result->at(0).toTensor(), *make_tensor_ptr({1}, {7.f}));
+    const auto state = module.execute("get_state");
+    ASSERT_EQ(state.error(), Error::Ok);
+    EXPECT_TENSOR_CLOSE(state->at(0).toTensor(), *make_tensor_ptr({1}, {6.f}));
+  }
+}
+
+TEST_F(ModuleTest, TestSharePlannedMemoryKeepsMethodState) {
+  // With and without the names of the mutable buffers.
+  for (const auto& path : {method_state_path_, method_state_named_path_}) {
+    Module module(path);
+
+    ASSERT_EQ(module.share_planned_memory({"forward", "scale"}), Error::Ok);
+
+    const auto result1 = module.forward(make_tensor_ptr({1}, {1.f}));
+    ASSERT_EQ(result1.error(), Error::Ok);
+    EXPECT_TENSOR_CLOSE(
+        result1->at(0).toTensor(), *make_tensor_ptr({1}, {2.f}));
+
+    // Running the other method does not overwrite the state of forward.
+    const auto scaled = module.execute(
+        "scale", make_tensor_ptr({16}, std::vector<float>(16, 8.f)));
+    ASSERT_EQ(scaled.error(), Error::Ok);
+    EXPECT_TENSOR_CLOSE(
+        scaled->at(0).toTensor(),
+        *make_tensor_ptr({16}, std::vector<float>(16, 17.f)));
+
+    const auto result2 = module.forward(make_tensor_ptr({1}, {1.f}));
+    ASSERT_EQ(result2.error(), Error::Ok);
+    EXPECT_TENSOR_CLOSE(
+        result2->at(0).toTensor(), *make_tensor_ptr({1}, {3.f}));
+  }
+}
+
+TEST_F(ModuleTest, TestSharePlannedMemoryAfterLoadFails) {
+  Module module(model_path_);
+
+  ASSERT_EQ(module.load_method("forward"), Error::Ok);
+  EXPECT_EQ(module.share_planned_memory({"forward"}), Error::InvalidState);
+}
+
+TEST_F(ModuleTest, TestPlannedMemoryArena) {
+  Module module1(model_path_);
+  Module module2(model_path_);
+  const auto size = module1.planned_memory_arena_size("forward");
+  ASSERT_EQ(size.error(), Error::Ok);
+
+  auto too_small = PlannedMemoryArena::create(*size / 2);
+  ASSERT_EQ(too_small.error(), Error::Ok);
+  EXPECT_EQ(
+      module1.use_planned_memory_arena(*too_small, {"forward"}),
+      Error::MemoryAllocationFailed);
+
+  auto arena = PlannedMemoryArena::create(*size);
+  ASSERT_EQ(arena.error(), Error::Ok);
+  ASSERT_EQ(module1.use_planned_memory_arena(*arena, {"forward"}), Error::Ok);
+  ASSERT_EQ(module2.use_planned_memory_arena(*arena, {"forward"}), Error::Ok);
+  EXPECT_EQ(
+      module1.use_planned_memory_arena(*arena, {"forward"}),
+      Error::InvalidState);
+  EXPECT_EQ(module1.share_planned_memory({"forward"}), Error::InvalidState);
+
+  auto tensor1 = make_tensor_ptr({2, 2}, {1.f, 2.f, 3.f, 4.f});
+  auto tensor2 = make_tensor_ptr({2, 2}, {2.f, 2.f, 2.f, 2.f});
+  const auto result1 = module1.execute("forward", {tensor1, tensor1, 1.0});
+  ASSERT_EQ(result1.error(), Error::Ok);
+  EXPECT_TENSOR_CLOSE(
+      result1->at(0).toTensor(),
+      *make_tensor_ptr({2, 2}, {2.f, 4.f, 6.f, 8.f}));
+  const auto result2 = module2.execute("forward", {tensor2, tensor2, 1.0});
+  ASSERT_EQ(result2.error(), Error::Ok);
+  EXPECT_TENSOR_CLOSE(
+      result2->at(0).toTensor(),
+      *make_tensor_ptr({2, 2}, {4.f, 4.f, 4.f, 4.f}));
+  EXPECT_EQ((*arena)->used(), *size);
+
+  // Module 2 took over the arena, so the inputs of module 1 are gone...
+  EXPECT_EQ(module1.execute("forward").error(), Error::InvalidState);
+  // ...until they are set again.
+  ASSERT_EQ(module1.set_inputs({tensor1, tensor1, 1.0}), Error::Ok);
+  const auto result3 = module1.execute("forward");
+  ASSERT_EQ(result3.error(), Error::Ok);
+  EXPECT_TENSOR_CLOSE(
+      result3->at(0).toTensor(),
+      *make_tensor_ptr({2, 2}, {2.f, 4.f, 6.f, 8.f}));
+}
+
+TEST_F(ModuleTest, TestPlannedMemoryArenaKeepsMethodState) {
+  // With and without the names of the mutable buffers.
+  for (const auto& path : {method_state_path_, method_state_named_path_}) {
+    Module module1(path);
+    Module module2(model_path_);
+    size_t capacity = 0;
+    for (const auto* method_name : {"forward", "scale"}) {
+      const auto size = module1.planned_memory_arena_size(method_name);
+      ASSERT_EQ(size.error(), Error::Ok);
+      capacity = std::max(capacity, *size);
+    }
+    const auto size = module2.planned_memory_arena_size("forward");
+    ASSERT_EQ(size.error(), Error::Ok);
+    capacity = std::max(capacity, *size);
+
+    auto arena = PlannedMemoryArena::create(capacity);
+    ASSERT_EQ(arena.error(), Error::Ok);
+    ASSERT_EQ(
+        module1.use_planned_memory_arena(*arena, {"forward", "scale"}),
+        Error::Ok);
+    ASSERT_EQ(module2.use_planned_memory_arena(*arena, {"forward"}), Error::Ok);
+
+    const auto result1 = module1.forward(make_tensor_ptr({1}, {1.f}));
+    ASSERT_EQ(result1.error(), Error::Ok);
+    EXPECT_TENSOR_CLOSE(
+        result1->at(0).toTensor(), *make_tensor_ptr({1}, {2.f}));
+
+    // Neither the other method nor the other module overwrite the state of
+    // forward.
+    const auto scaled = module1.execute(
+        "scale", make_tensor_ptr({16}, std::vector<float>(16, 8.f)));
+    ASSERT_EQ(scaled.error(), Error::Ok);
+    auto tensor = make_tensor_ptr({2, 2}, {1.f, 2.f, 3.f, 4.f});
+    ASSERT_EQ(
+        module2.execute("forward", {tensor, tensor, 1.0}).error(), Error::Ok);
+
+    const auto result2 = module1.forward(make_tensor_ptr({1}, {1.f}));
+    ASSERT_EQ(result2.error(), Error::Ok);
+    EXPECT_TENSOR_CLOSE(
+        result2->at(0).toTensor(), *make_tensor_ptr({1}, {3.f}));
+  }
+}
@@ -22,6 +22,9 @@ def define_common_targets(is_fbcode=False):
             "ET_MODULE_LINEAR_PROGRAM_PATH": "$(location fbcode//executorch/test/models:exported_program_and_data[ModuleLinear.pte])",
             "ET_MODULE_LINEAR_DATA_PATH": "$(location fbcode//executorch/test/models:exported_program_and_data[ModuleLinear.ptd])",
             "ET_MODULE_SHARED_STATE": "$(location fbcode//executorch/test/models:exported_programs[ModuleSharedState.pte])",
+            "ET_MODULE_SHARED_STATE_NAMED": "$(location fbcode//executorch/test/models:exported_programs[ModuleSharedStateNamed.pte])",
+            "ET_MODULE_METHOD_STATE": "$(location fbcode//executorch/test/models:exported_programs[ModuleMethodState.pte])",
+            "ET_MODULE_METHOD_STATE_NAMED": "$(location fbcode//executorch/test/models:exported_programs[ModuleMethodStateNamed.pte])",
         }
 
         for aten_mode in get_aten_mode_options():
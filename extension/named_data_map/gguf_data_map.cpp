@@ -0,0 +1,560 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/named_data_map/gguf_data_map.h>
+
+#include <c10/util/safe_numerics.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/log.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+
+using executorch::aten::ScalarType;
+using executorch::aten::string_view;
+using executorch::ET_RUNTIME_NAMESPACE::TensorLayout;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+
+namespace executorch::extension {
+namespace ET_GGUF_DATA_MAP_NAMESPACE {
+
+namespace {
+
+constexpr char kMagic[4] = {'G', 'G', 'U', 'F'};
+constexpr uint32_t kMinVersion = 2;
+constexpr uint32_t kMaxVersion = 3;
+constexpr uint64_t kDefaultAlignment = 32;
+constexpr char kAlignmentKey[] = "general.alignment";
+
+// The header is loaded in growing chunks, starting with this many bytes,
+// until the tensor directory fits.
+constexpr size_t kInitialHeaderLoadSize = 1 << 20;
+
+// gguf_type values of metadata entries.
+enum GGUFValueType : uint32_t {
+  kUInt8 = 0,
+  kInt8 = 1,
+  kUInt16 = 2,
+  kInt16 = 3,
+  kUInt32 = 4,
+  kInt32 = 5,
+  kFloat32 = 6,
+  kBool = 7,
+  kString = 8,
+  kArray = 9,
+  kUInt64 = 10,
+  kInt64 = 11,
+  kFloat64 = 12,
+};
+
+/// How the elements of a ggml_type are stored.
+struct GGMLTypeTraits {
+  /// The ExecuTorch type of a tensor of this type; Byte for quantized types.
+  ScalarType scalar_type;
+  /// Elements per block; 1 for non-quantized types.
+  uint32_t block_size;
+  /// Bytes per block.
+  uint32_t type_size;
+};
+
+/// Returns false if `ggml_type` can't be served.
+bool get_ggml_type_traits(uint32_t ggml_type, GGMLTypeTraits& traits) {
+  switch (ggml_type) {
+    case 0: // F32
+      traits = {ScalarType::Float, 1, 4};
+      return true;
+    case 1: // F16
+      traits = {ScalarType::Half, 1, 2};
+      return true;
+    case 2: // Q4_0
+      traits = {ScalarType::Byte, 32, 18};
+      return true;
+    case 3: // Q4_1
+      traits = {ScalarType::Byte, 32, 20};
+      return true;
+    case 6: // Q5_0
+      traits = {ScalarType::Byte, 32, 22};
+      return true;
+    case 7: // Q5_1
+      traits = {ScalarType::Byte, 32, 24};
+      return true;
+    case 8: // Q8_0
+      traits = {ScalarType::Byte, 32, 34};
+      return true;
+    case 9: // Q8_1
+      traits = {ScalarType::Byte, 32, 36};
+      return true;
+    case 10: // Q2_K
+      traits = {ScalarType::Byte, 256, 84};
+      return true;
+    case 11: // Q3_K
+      traits = {ScalarType::Byte, 256, 110};
+      return true;
+    case 12: // Q4_K
+      traits = {ScalarType::Byte, 256, 144};
+      return true;
+    case 13: // Q5_K
+      traits = {ScalarType::Byte, 256, 176};
+      return true;
+    case 14: // Q6_K
+      traits = {ScalarType::Byte, 256, 210};
+      return true;
+    case 15: // Q8_K
+      traits = {ScalarType::Byte, 256, 292};
+      return true;
+    case 24: // I8
+      traits = {ScalarType::Char, 1, 1};
+      return true;
+    case 25: // I16
+      traits = {ScalarType::Short, 1, 2};
+      return true;
+    case 26: // I32
+      traits = {ScalarType::Int, 1, 4};
+      return true;
+    case 27: // I64
+      traits = {ScalarType::Long, 1, 8};
+      return true;
+    case 28: // F64
+      traits = {ScalarType::Double, 1, 8};
+      return true;
+    case 30: // BF16
+      traits = {ScalarType::BFloat16, 1, 2};
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * Reads little-endian values from a prefix of the file. Reading past the end
+ * of the prefix sets `truncated`, after which every read fails.
+ */
+class HeaderReader {
+ public:
+  HeaderReader(const void* data, size_t size)
+      : data_(static_cast<const uint8_t*>(data)), size_(size) {}
+
+  bool read(void* out, size_t n) {
+    if (!skip(n)) {
+      return false;
+    }
+    std::memcpy(out, data_ + pos_ - n, n);
+    return true;
+  }
+
+  bool skip(uint64_t n) {
+    if (truncated_ || n > size_ - pos_) {
+      truncated_ = true;
+      return false;
+    }
+    pos_ += n;
+    return true;
+  }
+
+  bool read_u32(uint32_t& out) {
+    uint8_t b[4];
+    if (!read(b, sizeof(b))) {
+      return false;
+    }
+    out = b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+    return true;
+  }
+
+  bool read_u64(uint64_t& out) {
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+    if (!read_u32(lo) || !read_u32(hi)) {
+      return false;
+    }
+    out = lo | ((uint64_t)hi << 32);
+    return true;
+  }
+
+  bool read_string(std::string_view& out) {
+    uint64_t length = 0;
+    if (!read_u64(length) || !skip(length)) {
+      return false;
+    }
+    out = std::string_view(
+        reinterpret_cast<const char*>(data_ + pos_ - length), length);
+    return true;
+  }
+
+  size_t pos() const {
+    return pos_;
+  }
+
+  bool truncated() const {
+    return truncated_;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t pos_ = 0;
+  bool truncated_ = false;
+};
+
+/// Skips a metadata value; returns false if it is malformed or truncated.
+bool skip_value(HeaderReader& reader, uint32_t type, int depth = 0) {
+  switch (type) {
+    case kUInt8:
+    case kInt8:
+    case kBool:
+      return reader.skip(1);
+    case kUInt16:
+    case kInt16:
+      return reader.skip(2);
+    case kUInt32:
+    case kInt32:
+    case kFloat32:
+      return reader.skip(4);
+    case kUInt64:
+    case kInt64:
+    case kFloat64:
+      return reader.skip(8);
+    case kString: {
+      std::string_view unused;
+      return reader.read_string(unused);
+    }
+    case kArray: {
+      uint32_t element_type = 0;
+      uint64_t count = 0;
+      // Nested arrays are allowed, but only a few levels deep.
+      if (depth > 2 || !reader.read_u32(element_type) ||
+          !reader.read_u64(count)) {
+        return false;
+      }
+      for (uint64_t i = 0; i < count; ++i) {
+        if (!skip_value(reader, element_type, depth + 1)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+      ET_LOG(Error, "Unknown GGUF metadata type %" PRIu32, type);
+      return false;
+  }
+}
+
+/**
+ * Parses the GGUF header from a prefix of the file. Sets `truncated` if the
+ * prefix ends before the tensor directory does.
+ */
+Error parse_header(
+    const void* data,
+    size_t size,
+    std::vector<GGUFDataMap::TensorInfo>& tensors,
+    uint64_t& data_offset,
+    bool& truncated) {
+  HeaderReader reader(data, size);
+  tensors.clear();
+  truncated = false;
+
+  char magic[sizeof(kMagic)];
+  uint32_t version = 0;
+  uint64_t num_tensors = 0;
+  uint64_t num_metadata = 0;
+  if (!reader.read(magic, sizeof(magic)) || !reader.read_u32(version) ||
+      !reader.read_u64(num_tensors) || !reader.read_u64(num_metadata)) {
+    truncated = true;
+    return Error::Ok;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      std::memcmp(magic, kMagic, sizeof(kMagic)) == 0,
+      InvalidExternalData,
+      "GGUF magic '%.4s' != expected '%.4s'",
+      magic,
+      kMagic);
+  ET_CHECK_OR_RETURN_ERROR(
+      version >= kMinVersion && version <= kMaxVersion,
+      NotSupported,
+      "Unsupported GGUF version %" PRIu32,
+      version);
+
+  uint64_t alignment = kDefaultAlignment;
+  for (uint64_t i = 0; i < num_metadata; ++i) {
+    std::string_view key;
+    uint32_t type = 0;
+    if (!reader.read_string(key) || !reader.read_u32(type)) {
+      truncated = true;
+      return Error::Ok;
+    }
+    if (key == kAlignmentKey && type == kUInt32) {
+      uint32_t value = 0;
+      if (!reader.read_u32(value)) {
+        truncated = true;
+        return Error::Ok;
+      }
+      alignment = value;
+      ET_CHECK_OR_RETURN_ERROR(
+          alignment > 0 && (alignment & (alignment - 1)) == 0,
+          InvalidExternalData,
+          "GGUF alignment %" PRIu64 " is not a power of two",
+          alignment);
+      continue;
+    }
+    if (!skip_value(reader, type)) {
+      if (reader.truncated()) {
+        truncated = true;
+        return Error::Ok;
+      }
+      ET_LOG(Error, "Malformed GGUF metadata value %" PRIu64, i);
+      return Error::InvalidExternalData;
+    }
+  }
+
+  // Every tensor info takes at least 24 bytes, which bounds how much to
+  // reserve for a corrupt count.
+  tensors.reserve(std::min<uint64_t>(num_tensors, size / 24));
+  for (uint64_t i = 0; i < num_tensors; ++i) {
+    std::string_view name;
+    uint32_t num_dims = 0;
+    if (!reader.read_string(name) || !reader.read_u32(num_dims)) {
+      truncated = true;
+      return Error::Ok;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        num_dims <= GGUFDataMap::kMaxDims,
+        InvalidExternalData,
+        "GGUF tensor %.*s has %" PRIu32 " dims",
+        static_cast<int>(name.size()),
+        name.data(),
+        num_dims);
+    uint64_t ne[GGUFDataMap::kMaxDims];
+    for (uint32_t d = 0; d < num_dims; ++d) {
+      if (!reader.read_u64(ne[d])) {
+        truncated = true;
+        return Error::Ok;
+      }
+    }
+    GGUFDataMap::TensorInfo info{};
+    if (!reader.read_u32(info.ggml_type) || !reader.read_u64(info.offset)) {
+      truncated = true;
+      return Error::Ok;
+    }
+    info.name = std::string(name);
+    ET_CHECK_OR_RETURN_ERROR(
+        info.offset % alignment == 0,
+        InvalidExternalData,
+        "GGUF tensor %s offset %" PRIu64 " not aligned to %" PRIu64,
+        info.name.c_str(),
+        info.offset,
+        alignment);
+
+    GGMLTypeTraits traits;
+    if (!get_ggml_type_traits(info.ggml_type, traits)) {
+      // Still listed, so callers get NotSupported rather than NotFound.
+      tensors.push_back(std::move(info));
+      continue;
+    }
+    uint64_t numel = 1;
+    for (uint32_t d = 0; d < num_dims; ++d) {
+      ET_CHECK_OR_RETURN_ERROR(
+          ne[d] <= static_cast<uint64_t>(std::numeric_limits<int32_t>::max()) &&
+              !c10::mul_overflows(numel, ne[d], &numel),
+          InvalidExternalData,
+          "GGUF tensor %s dim %" PRIu32 " of %" PRIu64 " is too large",
+          info.name.c_str(),
+          d,
+          ne[d]);
+    }
+    const uint64_t row_size = num_dims > 0 ? ne[0] : 1;
+    ET_CHECK_OR_RETURN_ERROR(
+        row_size % traits.block_size == 0,
+        InvalidExternalData,
+        "GGUF tensor %s row of %" PRIu64 " is not a multiple of %" PRIu32,
+        info.name.c_str(),
+        row_size,
+        traits.block_size);
+    const uint64_t num_blocks = numel / traits.block_size;
+    const uint64_t type_size = traits.type_size;
+    ET_CHECK_OR_RETURN_ERROR(
+        num_blocks <=
+                static_cast<uint64_t>(std::numeric_limits<int32_t>::max()) &&
+            !c10::mul_overflows(num_blocks, type_size, &info.nbytes),
+        InvalidExternalData,
+        "GGUF tensor %s is too large",
+        info.name.c_str());
+
+    info.scalar_type = traits.scalar_type;
+    if (traits.block_size > 1) {
+      info.dim = 2;
+      info.sizes[0] = static_cast<int32_t>(num_blocks);
+      info.sizes[1] = static_cast<int32_t>(traits.type_size);
+    } else {
+      // GGUF lists the innermost dim first.
+      info.dim = static_cast<uint8_t>(num_dims);
+      for (uint32_t d = 0; d < num_dims; ++d) {
+        info.sizes[d] = static_cast<int32_t>(ne[num_dims - 1 - d]);
+      }
+    }
+    for (uint8_t d = 0; d < info.dim; ++d) {
+      info.dim_order[d] = d;
+    }
+    info.supported = true;
+    tensors.push_back(std::move(info));
+  }
+
+  data_offset = (reader.pos() + alignment - 1) / alignment * alignment;
+  return Error::Ok;
+}
+
+} // namespace
+
+/* static */ Result<GGUFDataMap> GGUFDataMap::load(DataLoader* loader) {
+  Result<size_t> file_size = loader->size();
+  if (!file_size.ok()) {
+    return file_size.error();
+  }
+
+  std::vector<TensorInfo> tensors;
+  uint64_t data_offset = 0;
+  size_t load_size = std::min(kInitialHeaderLoadSize, file_size.get());
+  while (true) {
+    Result<FreeableBuffer> header = loader->load(
+        /*offset=*/0,
+        load_size,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+    if (!header.ok()) {
+      ET_LOG(Error, "Failed to load GGUF header.");
+      return header.error();
+    }
+    bool truncated = false;
+    Error err = parse_header(
+        header->data(), header->size(), tensors, data_offset, truncated);
+    if (err != Error::Ok) {
+      return err;
+    }
+    if (!truncated) {
+      break;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        load_size < file_size.get(),
+        InvalidExternalData,
+        "GGUF header is truncated; file may be corrupt.");
+    load_size = load_size > file_size.get() / 2 ? file_size.get()
+                                                : load_size * 2;
+  }
+
+  std::unordered_map<std::string_view, uint32_t> key_index;
+  key_index.reserve(tensors.size());
+  for (uint32_t i = 0; i < tensors.size(); ++i) {
+    auto& info = tensors[i];
+    ET_CHECK_OR_RETURN_ERROR(
+        data_offset <= file_size.get() &&
+            info.offset <= file_size.get() - data_offset &&
+            info.nbytes <= file_size.get() - data_offset - info.offset,
+        InvalidExternalData,
+        "GGUF tensor %s [%" PRIu64 ", +%" PRIu64
+        ") is out of range of the %zu byte file",
+        info.name.c_str(),
+        info.offset,
+        info.nbytes,
+        file_size.get());
+    info.offset += data_offset;
+    const bool inserted = key_index.emplace(info.name, i).second;
+    ET_CHECK_OR_RETURN_ERROR(
+        inserted,
+        InvalidExternalData,
+        "Duplicate GGUF tensor %s",
+        info.name.c_str());
+  }
+  return GGUFDataMap(std::move(tensors), std::move(key_index), loader);
+}
+
+Result<const GGUFDataMap::TensorInfo*> GGUFDataMap::find(
+    string_view key) const {
+  const auto it = key_index_.find(std::string_view(key.data(), key.size()));
+  if (it == key_index_.end()) {
+    ET_LOG(
+        Debug,
+        "Key %.*s not found in GGUF file.",
+        static_cast<int>(key.size()),
+        key.data());
+    return Error::NotFound;
+  }
+  const TensorInfo& info = tensors_[it->second];
+  ET_CHECK_OR_RETURN_ERROR(
+      info.supported,
+      NotSupported,
+      "GGUF tensor %s has unsupported ggml type %" PRIu32,
+      info.name.c_str(),
+      info.ggml_type);
+  return &info;
+}
+
+ET_NODISCARD Result<const TensorLayout> GGUFDataMap::get_tensor_layout(
+    string_view key) const {
+  Result<const TensorInfo*> info = find(key);
+  if (!info.ok()) {
+    return info.error();
+  }
+  return TensorLayout::create(
+      Span<const int32_t>(info.get()->sizes, info.get()->dim),
+      Span<const uint8_t>(info.get()->dim_order, info.get()->dim),
+      info.get()->scalar_type);
+}
+
+ET_NODISCARD Result<FreeableBuffer> GGUFDataMap::get_data(
+    string_view key) const {
+  Result<const TensorInfo*> info = find(key);
+  if (!info.ok()) {
+    return info.error();
+  }
+  return loader_->load(
+      info.get()->offset,
+      info.get()->nbytes,
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::External));
+}
+
+ET_NODISCARD Error GGUFDataMap::load_data_into(
+    string_view key,
+    void* buffer,
+    size_t size) const {
+  Result<const TensorInfo*> info = find(key);
+  if (!info.ok()) {
+    return info.error();
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      size <= info.get()->nbytes,
+      InvalidArgument,
+      "Buffer size %zu is larger than tensor size %" PRIu64,
+      size,
+      info.get()->nbytes);
+  return loader_->load_into(
+      info.get()->offset,
+      size,
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::External),
+      buffer);
+}
+
+ET_NODISCARD Result<uint32_t> GGUFDataMap::get_num_keys() const {
+  return static_cast<uint32_t>(tensors_.size());
+}
+
+ET_NODISCARD Result<const char*> GGUFDataMap::get_key(uint32_t index) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      index < tensors_.size(),
+      InvalidArgument,
+      "Index %u out of range of size %zu",
+      index,
+      tensors_.size());
+  return tensors_[index].name.c_str();
+}
+
+} // namespace ET_GGUF_DATA_MAP_NAMESPACE
+} // namespace executorch::extension
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/named_data_map.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/tensor_layout.h>
+#include <executorch/runtime/platform/compiler.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifdef USE_ATEN_LIB
+#define ET_GGUF_DATA_MAP_NAMESPACE gguf_data_map::aten
+#else // !USE_ATEN_LIB
+#define ET_GGUF_DATA_MAP_NAMESPACE gguf_data_map
+#endif // USE_ATEN_LIB
+
+namespace executorch::extension {
+
+namespace ET_GGUF_DATA_MAP_NAMESPACE {
+
+/**
+ * A NamedDataMap implementation that serves the tensors of a GGUF file
+ * (https://github.com/ggml-org/ggml/blob/master/docs/gguf.md), keyed by
+ * their GGUF tensor names.
+ *
+ * Only the header and tensor directory are parsed at load time. get_data()
+ * loads a tensor straight from its offset in the file, so with an
+ * MmapDataLoader the tensor data is never copied.
+ *
+ * Tensor layouts:
+ * - Float and integer tensors have their GGUF dims reversed, since GGUF lists
+ *   the innermost dimension first, and a contiguous dim order.
+ * - Block-quantized tensors (Q4_0, Q8_0, Q4_K, ...) are served unchanged as
+ *   Byte tensors of shape [num_blocks, bytes_per_block], the packed layout
+ *   that ExecuTorch's GGML quantized weights use (e.g. [numel / 32, 18] for
+ *   Q4_0). Kernels unpack the per-block scales themselves.
+ * - Other GGML types are listed as keys, but return Error::NotSupported.
+ */
+class GGUFDataMap final
+    : public executorch::ET_RUNTIME_NAMESPACE::NamedDataMap {
+ public:
+  /**
+   * Parses the tensor directory of a GGUF file.
+   *
+   * @param[in] loader The DataLoader that wraps the GGUF file. Must outlive
+   *     the GGUFDataMap.
+   */
+  static executorch::runtime::Result<GGUFDataMap> load(
+      executorch::runtime::DataLoader* loader);
+
+  /**
+   * Retrieve the tensor_layout for the specified key.
+   *
+   * @param[in] key The name of the tensor to get metadata on.
+   *
+   * @return Error::NotFound if the key is not present.
+   */
+  ET_NODISCARD
+  executorch::runtime::Result<
+      const executorch::ET_RUNTIME_NAMESPACE::TensorLayout>
+  get_tensor_layout(executorch::aten::string_view key) const override;
+
+  /**
+   * Retrieve read-only data for the specified key.
+   *
+   * @param[in] key The name of the tensor to get data on.
+   *
+   * @return error if the key is not present or data cannot be loaded.
+   */
+  ET_NODISCARD
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> get_data(
+      executorch::aten::string_view key) const override;
+
+  /**
+   * Loads the data of the specified tensor into the provided buffer.
+   *
+   * @param[in] key The name of the tensor to get the data of.
+   * @param[in] buffer The buffer to load data into. Must point to at least
+   * `size` bytes of memory.
+   * @param[in] size The number of bytes to load.
+   *
+   * @returns an Error indicating if the load was successful.
+   */
+  ET_NODISCARD executorch::runtime::Error load_data_into(
+      executorch::aten::string_view key,
+      void* buffer,
+      size_t size) const override;
+
+  /**
+   * @returns The number of keys in the map.
+   */
+  ET_NODISCARD executorch::runtime::Result<uint32_t> get_num_keys()
+      const override;
+
+  /**
+   * @returns The key at the specified index, error if index out of bounds.
+   */
+  ET_NODISCARD executorch::runtime::Result<const char*> get_key(
+      uint32_t index) const override;
+
+  GGUFDataMap(GGUFDataMap&&) noexcept = default;
+
+  ~GGUFDataMap() override = default;
+
+  /// The maximum number of dimensions of a GGUF tensor.
+  static constexpr size_t kMaxDims = 4;
+
+  /// A tensor of the GGUF tensor directory.
+  struct TensorInfo {
+    /// The GGUF tensor name.
+    std::string name;
+    /// The ggml_type of the tensor data.
+    uint32_t ggml_type;
+    /// The offset of the tensor data in the file.
+    uint64_t offset;
+    /// The size of the tensor data in bytes. Zero if ggml_type is unknown.
+    uint64_t nbytes;
+    /// ExecuTorch sizes and dim order; only valid if `supported`.
+    int32_t sizes[kMaxDims];
+    uint8_t dim_order[kMaxDims];
+    uint8_t dim;
+    executorch::aten::ScalarType scalar_type;
+    bool supported;
+  };
+
+ private:
+  GGUFDataMap(
+      std::vector<TensorInfo>&& tensors,
+      std::unordered_map<std::string_view, uint32_t>&& key_index,
+      executorch::runtime::DataLoader* loader)
+      : tensors_(std::move(tensors)),
+        key_index_(std::move(key_index)),
+        loader_(loader) {}
+
+  // Not copyable or assignable.
+  GGUFDataMap(const GGUFDataMap& rhs) = delete;
+  GGUFDataMap& operator=(GGUFDataMap&& rhs) noexcept = delete;
+  GGUFDataMap& operator=(const GGUFDataMap& rhs) = delete;
+
+  executorch::runtime::Result<const TensorInfo*> find(
+      executorch::aten::string_view key) const;
+
+  // The tensor directory, in file order.
+  std::vector<TensorInfo> tensors_;
+
+  // Index into tensors_ for every key. The keys point into tensors_, whose
+  // elements never move.
+  std::unordered_map<std::string_view, uint32_t> key_index_;
+
+  // Data loader, used to load tensor data.
+  executorch::runtime::DataLoader* loader_;
+};
+
+} // namespace ET_GGUF_DATA_MAP_NAMESPACE
+} // namespace executorch::extension
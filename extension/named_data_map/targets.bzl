@@ -19,3 +19,20 @@ def define_common_targets():
                 "//executorch/runtime/core:core",
             ],
         )
+
+        runtime.cxx_library(
+            name = "gguf_data_map" + aten_suffix,
+            srcs = [
+                "gguf_data_map.cpp",
+            ],
+            exported_headers = [
+                "gguf_data_map.h",
+            ],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            deps = [
+                "//executorch/runtime/core:named_data_map" + aten_suffix,
+                "//executorch/runtime/core:core",
+            ],
+        )
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/extension/named_data_map/gguf_data_map.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::extension::BufferDataLoader;
+using executorch::extension::gguf_data_map::GGUFDataMap;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+using executorch::runtime::TensorLayout;
+
+namespace {
+
+constexpr uint32_t kF32 = 0;
+constexpr uint32_t kQ4_0 = 2;
+constexpr uint32_t kIQ2_XXS = 16;
+
+constexpr uint32_t kTypeUInt32 = 4;
+constexpr uint32_t kTypeString = 8;
+constexpr uint32_t kTypeArray = 9;
+
+/// Writes GGUF files.
+class GGUFBuilder {
+ public:
+  struct Tensor {
+    std::string name;
+    std::vector<uint64_t> ne;
+    uint32_t type;
+    std::vector<uint8_t> data;
+  };
+
+  void add_string_metadata(const std::string& key, const std::string& value) {
+    write_string(metadata_, key);
+    write_u32(metadata_, kTypeString);
+    write_string(metadata_, value);
+    ++num_metadata_;
+  }
+
+  void add_array_metadata(const std::string& key, uint32_t count) {
+    write_string(metadata_, key);
+    write_u32(metadata_, kTypeArray);
+    write_u32(metadata_, kTypeUInt32);
+    write_u64(metadata_, count);
+    for (uint32_t i = 0; i < count; ++i) {
+      write_u32(metadata_, i);
+    }
+    ++num_metadata_;
+  }
+
+  void set_alignment(uint32_t alignment) {
+    alignment_ = alignment;
+    write_string(metadata_, "general.alignment");
+    write_u32(metadata_, kTypeUInt32);
+    write_u32(metadata_, alignment);
+    ++num_metadata_;
+  }
+
+  void add_tensor(Tensor tensor) {
+    tensors_.push_back(std::move(tensor));
+  }
+
+  std::vector<uint8_t> build() const {
+    std::vector<uint8_t> out = {'G', 'G', 'U', 'F'};
+    write_u32(out, 3);
+    write_u64(out, tensors_.size());
+    write_u64(out, num_metadata_);
+    out.insert(out.end(), metadata_.begin(), metadata_.end());
+    uint64_t offset = 0;
+    for (const auto& tensor : tensors_) {
+      write_string(out, tensor.name);
+      write_u32(out, tensor.ne.size());
+      for (uint64_t n : tensor.ne) {
+        write_u64(out, n);
+      }
+      write_u32(out, tensor.type);
+      write_u64(out, offset);
+      offset = align(offset + tensor.data.size());
+    }
+    out.resize(align(out.size()), 0);
+    for (const auto& tensor : tensors_) {
+      out.insert(out.end(), tensor.data.begin(), tensor.data.end());
+      out.resize(align(out.size()), 0);
+    }
+    return out;
+  }
+
+ private:
+  static void write_u32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+      out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+  }
+
+  static void write_u64(std::vector<uint8_t>& out, uint64_t value) {
+    write_u32(out, static_cast<uint32_t>(value));
+    write_u32(out, static_cast<uint32_t>(value >> 32));
+  }
+
+  static void write_string(std::vector<uint8_t>& out, const std::string& s) {
+    write_u64(out, s.size());
+    out.insert(out.end(), s.begin(), s.end());
+  }
+
+  uint64_t align(uint64_t n) const {
+    return (n + alignment_ - 1) / alignment_ * alignment_;
+  }
+
+  std::vector<uint8_t> metadata_;
+  uint64_t num_metadata_ = 0;
+  uint64_t alignment_ = 32;
+  std::vector<Tensor> tensors_;
+};
+
+std::vector<uint8_t> iota_bytes(size_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + 1);
+  }
+  return data;
+}
+
+} // namespace
+
+class GGUFDataMapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+
+    builder_.add_string_metadata("general.architecture", "llama");
+    builder_.add_array_metadata("tokenizer.ggml.token_type", 10);
+    // [3, 2] float tensor.
+    builder_.add_tensor(
+        {"output_norm.weight", {2, 3}, kF32, iota_bytes(24)});
+    // [2, 64] Q4_0 tensor: 4 blocks of 18 bytes.
+    builder_.add_tensor(
+        {"blk.0.attn_q.weight", {64, 2}, kQ4_0, iota_bytes(72)});
+  }
+
+  GGUFBuilder builder_;
+};
+
+TEST_F(GGUFDataMapTest, LoadsTensorDirectory) {
+  const std::vector<uint8_t> file = builder_.build();
+  BufferDataLoader loader(file.data(), file.size());
+  Result<GGUFDataMap> data_map = GGUFDataMap::load(&loader);
+  ASSERT_EQ(data_map.error(), Error::Ok);
+
+  EXPECT_EQ(data_map->get_num_keys().get(), 2);
+  EXPECT_STREQ(data_map->get_key(0).get(), "output_norm.weight");
+  EXPECT_STREQ(data_map->get_key(1).get(), "blk.0.attn_q.weight");
+  EXPECT_EQ(data_map->get_key(2).error(), Error::InvalidArgument);
+
+  Result<const TensorLayout> layout =
+      data_map->get_tensor_layout("output_norm.weight");
+  ASSERT_EQ(layout.error(), Error::Ok);
+  EXPECT_EQ(layout->scalar_type(), ScalarType::Float);
+  ASSERT_EQ(layout->sizes().size(), 2);
+  EXPECT_EQ(layout->sizes()[0], 3);
+  EXPECT_EQ(layout->sizes()[1], 2);
+  EXPECT_EQ(layout->dim_order()[0], 0);
+  EXPECT_EQ(layout->dim_order()[1], 1);
+  EXPECT_EQ(layout->nbytes(), 24);
+
+  // Quantized tensors keep their packed blocks.
+  Result<const TensorLayout> quantized =
+      data_map->get_tensor_layout("blk.0.attn_q.weight");
+  ASSERT_EQ(quantized.error(), Error::Ok);
+  EXPECT_EQ(quantized->scalar_type(), ScalarType::Byte);
+  ASSERT_EQ(quantized->sizes().size(), 2);
+  EXPECT_EQ(quantized->sizes()[0], 4);
+  EXPECT_EQ(quantized->sizes()[1], 18);
+  EXPECT_EQ(quantized->nbytes(), 72);
+
+  EXPECT_EQ(data_map->get_tensor_layout("missing").error(), Error::NotFound);
+}
+
+TEST_F(GGUFDataMapTest, GetDataIsZeroCopy) {
+  const std::vector<uint8_t> file = builder_.build();
+  BufferDataLoader loader(file.data(), file.size());
+  Result<GGUFDataMap> data_map = GGUFDataMap::load(&loader);
+  ASSERT_EQ(data_map.error(), Error::Ok);
+
+  const std::vector<uint8_t> expected = iota_bytes(72);
+  Result<FreeableBuffer> data = data_map->get_data("blk.0.attn_q.weight");
+  ASSERT_EQ(data.error(), Error::Ok);
+  ASSERT_EQ(data->size(), expected.size());
+  EXPECT_EQ(std::memcmp(data->data(), expected.data(), expected.size()), 0);
+  // The data points into the file.
+  const auto* begin = file.data();
+  const auto* ptr = static_cast<const uint8_t*>(data->data());
+  EXPECT_TRUE(ptr >= begin && ptr < begin + file.size());
+  EXPECT_EQ((ptr - begin) % 32, 0);
+
+  std::vector<uint8_t> buffer(24);
+  ASSERT_EQ(
+      data_map->load_data_into(
+          "output_norm.weight", buffer.data(), buffer.size()),
+      Error::Ok);
+  EXPECT_EQ(buffer, iota_bytes(24));
+  EXPECT_EQ(
+      data_map->load_data_into("output_norm.weight", buffer.data(), 25),
+      Error::InvalidArgument);
+  EXPECT_EQ(data_map->get_data("missing").error(), Error::NotFound);
+}
+
+TEST_F(GGUFDataMapTest, CustomAlignmentAndLargeHeader) {
+  GGUFBuilder builder;
+  builder.set_alignment(64);
+  // Larger than the first chunk of the header that is loaded.
+  builder.add_string_metadata(
+      "tokenizer.chat_template", std::string(3 << 20, 'x'));
+  builder.add_tensor({"a", {5}, kF32, iota_bytes(20)});
+  builder.add_tensor({"b", {3}, kF32, iota_bytes(12)});
+  const std::vector<uint8_t> file = builder.build();
+  BufferDataLoader loader(file.data(), file.size());
+  Result<GGUFDataMap> data_map = GGUFDataMap::load(&loader);
+  ASSERT_EQ(data_map.error(), Error::Ok);
+
+  Result<FreeableBuffer> data = data_map->get_data("b");
+  ASSERT_EQ(data.error(), Error::Ok);
+  EXPECT_EQ(
+      (static_cast<const uint8_t*>(data->data()) - file.data()) % 64, 0);
+  EXPECT_EQ(std::memcmp(data->data(), iota_bytes(12).data(), 12), 0);
+}
+
+TEST_F(GGUFDataMapTest, UnsupportedType) {
+  builder_.add_tensor({"blk.0.ffn_up.weight", {256}, kIQ2_XXS, {}});
+  const std::vector<uint8_t> file = builder_.build();
+  BufferDataLoader loader(file.data(), file.size());
+  Result<GGUFDataMap> data_map = GGUFDataMap::load(&loader);
+  ASSERT_EQ(data_map.error(), Error::Ok);
+  EXPECT_EQ(data_map->get_num_keys().get(), 3);
+  EXPECT_EQ(
+      data_map->get_tensor_layout("blk.0.ffn_up.weight").error(),
+      Error::NotSupported);
+  EXPECT_EQ(
+      data_map->get_data("blk.0.ffn_up.weight").error(), Error::NotSupported);
+}
+
+TEST_F(GGUFDataMapTest, RejectsMalformedFiles) {
+  std::vector<uint8_t> file = builder_.build();
+
+  // Bad magic.
+  std::vector<uint8_t> bad = file;
+  bad[0] = 'X';
+  BufferDataLoader bad_magic(bad.data(), bad.size());
+  EXPECT_EQ(
+      GGUFDataMap::load(&bad_magic).error(), Error::InvalidExternalData);
+
+  // Truncated header.
+  BufferDataLoader truncated(file.data(), 100);
+  EXPECT_EQ(
+      GGUFDataMap::load(&truncated).error(), Error::InvalidExternalData);
+
+  // Truncated tensor data.
+  BufferDataLoader short_data(file.data(), file.size() - 40);
+  EXPECT_EQ(
+      GGUFDataMap::load(&short_data).error(), Error::InvalidExternalData);
+
+  // Quantized rows must hold whole blocks.
+  GGUFBuilder partial_block;
+  partial_block.add_tensor({"w", {48, 2}, kQ4_0, iota_bytes(54)});
+  bad = partial_block.build();
+  BufferDataLoader partial_block_loader(bad.data(), bad.size());
+  EXPECT_EQ(
+      GGUFDataMap::load(&partial_block_loader).error(),
+      Error::InvalidExternalData);
+
+  // Duplicate names.
+  GGUFBuilder duplicate;
+  duplicate.add_tensor({"w", {1}, kF32, iota_bytes(4)});
+  duplicate.add_tensor({"w", {1}, kF32, iota_bytes(4)});
+  bad = duplicate.build();
+  BufferDataLoader duplicate_loader(bad.data(), bad.size());
+  EXPECT_EQ(
+      GGUFDataMap::load(&duplicate_loader).error(),
+      Error::InvalidExternalData);
+}
@@ -1,6 +1,18 @@
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
 
 def define_common_targets(is_fbcode=False):
+    runtime.cxx_test(
+        name = "gguf_data_map_test",
+        srcs = [
+            "gguf_data_map_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/data_loader:buffer_data_loader",
+            "//executorch/extension/named_data_map:gguf_data_map",
+            "//executorch/runtime/core:named_data_map",
+        ],
+    )
+
     if not runtime.is_oss and is_fbcode:
         modules_env = {
             # The tests use this var to find the program file to load. This uses
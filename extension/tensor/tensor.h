@@ -12,3 +12,4 @@
 #include <executorch/extension/tensor/tensor_accessor.h>
 #include <executorch/extension/tensor/tensor_ptr.h>
 #include <executorch/extension/tensor/tensor_ptr_maker.h>
+#include <executorch/extension/tensor/tensor_ptr_pool.h>
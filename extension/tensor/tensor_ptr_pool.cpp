@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/tensor/tensor_ptr_pool.h>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <unordered_map>
+
+#include <executorch/extension/tensor/tensor_ptr_maker.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+
+namespace executorch {
+namespace extension {
+namespace {
+#ifndef USE_ATEN_LIB
+// Enough for the shared_ptr control blocks of the common standard libraries.
+constexpr size_t kControlBlockSize = 128;
+
+uint64_t make_key(
+    const executorch::aten::SizesType* sizes,
+    size_t dim,
+    executorch::aten::ScalarType type,
+    executorch::aten::TensorShapeDynamism dynamism) {
+  uint64_t key = 14695981039346656037ull;
+  auto mix = [&key](uint64_t value) {
+    key = (key ^ value) * 1099511628211ull;
+  };
+  mix(static_cast<uint64_t>(type));
+  mix(static_cast<uint64_t>(dynamism));
+  mix(dim);
+  for (size_t i = 0; i < dim; ++i) {
+    mix(static_cast<uint64_t>(sizes[i]));
+  }
+  return key;
+}
+#endif // USE_ATEN_LIB
+} // namespace
+
+#ifndef USE_ATEN_LIB
+/**
+ * A pooled tensor: its metadata, its data, and room for the control block of
+ * the TensorPtr that manages it.
+ */
+struct TensorPtrPool::Block final {
+  const uint64_t key;
+  const executorch::aten::ScalarType type;
+  const executorch::aten::TensorShapeDynamism dynamism;
+  // The shape the block was created for. sizes may differ while the tensor is
+  // resized.
+  const std::vector<executorch::aten::SizesType> shape;
+  std::vector<executorch::aten::SizesType> sizes;
+  std::vector<executorch::aten::DimOrderType> dim_order;
+  std::vector<executorch::aten::StridesType> strides;
+  std::vector<uint8_t> data;
+  executorch::aten::TensorImpl tensor_impl;
+  executorch::aten::Tensor tensor;
+  alignas(std::max_align_t) unsigned char control_block[kControlBlockSize];
+
+  Block(
+      uint64_t key,
+      const executorch::aten::SizesType* sizes,
+      size_t dim,
+      executorch::aten::ScalarType type,
+      executorch::aten::TensorShapeDynamism dynamism)
+      : key(key),
+        type(type),
+        dynamism(dim > 0 ? dynamism
+                         : executorch::aten::TensorShapeDynamism::STATIC),
+        shape(sizes, sizes + dim),
+        sizes(shape),
+        dim_order(dim),
+        strides(dim),
+        data(
+            executorch::aten::compute_numel(sizes, dim) *
+            executorch::aten::elementSize(type)),
+        tensor_impl(
+            type,
+            dim,
+            this->sizes.data(),
+            data.data(),
+            dim_order.data(),
+            strides.data(),
+            this->dynamism),
+        tensor(&tensor_impl) {
+    std::iota(dim_order.begin(), dim_order.end(), 0);
+    auto error = runtime::dim_order_to_stride(
+        this->sizes.data(), dim_order.data(), dim, strides.data());
+    ET_CHECK_MSG(error == runtime::Error::Ok, "Failed to compute strides.");
+  }
+
+  bool matches(
+      const executorch::aten::SizesType* other_sizes,
+      size_t dim,
+      executorch::aten::ScalarType other_type,
+      executorch::aten::TensorShapeDynamism other_dynamism) const {
+    return type == other_type &&
+        dynamism ==
+        (dim > 0 ? other_dynamism
+                 : executorch::aten::TensorShapeDynamism::STATIC) &&
+        shape.size() == dim &&
+        std::equal(shape.begin(), shape.end(), other_sizes);
+  }
+};
+#endif // USE_ATEN_LIB
+
+struct TensorPtrPool::State final {
+  explicit State(size_t max_cached_per_shape)
+      : max_cached_per_shape(max_cached_per_shape) {}
+
+#ifndef USE_ATEN_LIB
+  // Takes a released block of the given shape, or returns nullptr.
+  std::unique_ptr<Block> take(
+      uint64_t key,
+      const executorch::aten::SizesType* sizes,
+      size_t dim,
+      executorch::aten::ScalarType type,
+      executorch::aten::TensorShapeDynamism dynamism) {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = free_lists.find(key);
+    if (it != free_lists.end()) {
+      auto& blocks = it->second;
+      for (auto block = blocks.rbegin(); block != blocks.rend(); ++block) {
+        if ((*block)->matches(sizes, dim, type, dynamism)) {
+          auto result = std::move(*block);
+          blocks.erase(std::next(block).base());
+          --num_cached;
+          return result;
+        }
+      }
+    }
+    ++num_allocations;
+    return nullptr;
+  }
+
+  void release(Block* block) {
+    std::unique_ptr<Block> owned(block);
+    std::lock_guard<std::mutex> guard(mutex);
+    auto& blocks = free_lists[block->key];
+    if (blocks.size() < max_cached_per_shape) {
+      blocks.push_back(std::move(owned));
+      ++num_cached;
+    }
+  }
+
+  std::unordered_map<uint64_t, std::vector<std::unique_ptr<Block>>>
+      free_lists;
+#endif // USE_ATEN_LIB
+
+  mutable std::mutex mutex;
+  const size_t max_cached_per_shape;
+  size_t num_allocations = 0;
+  size_t num_cached = 0;
+};
+
+#ifndef USE_ATEN_LIB
+/**
+ * Places the TensorPtr control block inside the block it manages, and returns
+ * the block to the pool when the control block goes away, i.e. after the last
+ * shared and weak reference.
+ */
+template <typename T>
+struct TensorPtrPool::BlockAllocator final {
+  using value_type = T;
+
+  BlockAllocator(Block* block, std::shared_ptr<State> state)
+      : block(block), state(std::move(state)) {}
+
+  template <typename U>
+  BlockAllocator(const BlockAllocator<U>& other)
+      : block(other.block), state(other.state) {}
+
+  T* allocate(size_t n) {
+    static_assert(alignof(T) <= alignof(std::max_align_t));
+    if (n * sizeof(T) <= sizeof(block->control_block)) {
+      return reinterpret_cast<T*>(block->control_block);
+    }
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* ptr, size_t) {
+    if (reinterpret_cast<unsigned char*>(ptr) != block->control_block) {
+      ::operator delete(ptr);
+    }
+    state->release(block);
+  }
+
+  template <typename U>
+  bool operator==(const BlockAllocator<U>& other) const {
+    return block == other.block;
+  }
+
+  template <typename U>
+  bool operator!=(const BlockAllocator<U>& other) const {
+    return block != other.block;
+  }
+
+  Block* block;
+  std::shared_ptr<State> state;
+};
+#endif // USE_ATEN_LIB
+
+TensorPtrPool::TensorPtrPool(size_t max_cached_per_shape)
+    : state_(std::make_shared<State>(max_cached_per_shape)) {}
+
+// Tensors still in use keep the state alive and release into it.
+TensorPtrPool::~TensorPtrPool() = default;
+
+TensorPtrPool& TensorPtrPool::thread_local_pool() {
+  thread_local TensorPtrPool pool;
+  return pool;
+}
+
+TensorPtr TensorPtrPool::acquire(
+    const executorch::aten::SizesType* sizes,
+    size_t dim,
+    executorch::aten::ScalarType type,
+    executorch::aten::TensorShapeDynamism dynamism) {
+#ifndef USE_ATEN_LIB
+  const auto key = make_key(sizes, dim, type, dynamism);
+  auto block = state_->take(key, sizes, dim, type, dynamism);
+  if (!block) {
+    block = std::make_unique<Block>(key, sizes, dim, type, dynamism);
+  } else if (!std::equal(block->sizes.begin(), block->sizes.end(), sizes)) {
+    // The tensor was resized while in use.
+    ET_CHECK_MSG(
+        runtime::resize_tensor(block->tensor, {sizes, dim}) ==
+            runtime::Error::Ok,
+        "Failed to restore the shape of a pooled tensor.");
+  }
+  auto* tensor = &block->tensor;
+  return TensorPtr(
+      tensor,
+      [](executorch::aten::Tensor*) {},
+      BlockAllocator<executorch::aten::Tensor>(block.release(), state_));
+#else
+  {
+    std::lock_guard<std::mutex> guard(state_->mutex);
+    ++state_->num_allocations;
+  }
+  return extension::empty({sizes, sizes + dim}, type, dynamism);
+#endif // USE_ATEN_LIB
+}
+
+TensorPtr TensorPtrPool::clone(const executorch::aten::Tensor& tensor) {
+  ET_CHECK_MSG(
+      runtime::tensor_is_contiguous(tensor),
+      "Only contiguous tensors can be pooled.");
+  auto dynamism = executorch::aten::TensorShapeDynamism::DYNAMIC_BOUND;
+#ifndef USE_ATEN_LIB
+  dynamism = tensor.shape_dynamism();
+#endif // USE_ATEN_LIB
+  auto tensor_ptr = acquire(
+      tensor.sizes().data(),
+      tensor.sizes().size(),
+      tensor.scalar_type(),
+      dynamism);
+  if (tensor.const_data_ptr() != nullptr && tensor.nbytes() > 0) {
+    std::memcpy(
+        tensor_ptr->mutable_data_ptr(),
+        tensor.const_data_ptr(),
+        tensor.nbytes());
+  }
+  return tensor_ptr;
+}
+
+size_t TensorPtrPool::num_allocations() const {
+  std::lock_guard<std::mutex> guard(state_->mutex);
+  return state_->num_allocations;
+}
+
+size_t TensorPtrPool::num_cached() const {
+  std::lock_guard<std::mutex> guard(state_->mutex);
+  return state_->num_cached;
+}
+
+void TensorPtrPool::clear() {
+#ifndef USE_ATEN_LIB
+  decltype(state_->free_lists) free_lists;
+  {
+    std::lock_guard<std::mutex> guard(state_->mutex);
+    free_lists.swap(state_->free_lists);
+    state_->num_cached = 0;
+  }
+#endif // USE_ATEN_LIB
+}
+
+} // namespace extension
+} // namespace executorch
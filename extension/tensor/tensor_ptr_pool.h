@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include <executorch/extension/tensor/tensor_ptr.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * Recycles tensors of repeated shapes and types, e.g. the per-request inputs
+ * of a serving loop.
+ *
+ * Tensors handed out by a pool own contiguous memory, like the ones created by
+ * empty(). Once the last reference to such a tensor is gone, its data, its
+ * metadata and the TensorPtr control block go back to the pool instead of the
+ * heap, and the next request for the same shape and type reuses them. In
+ * steady state, creating and releasing a pooled tensor doesn't allocate.
+ *
+ * A pool is thread-safe, and tensors may outlive it. thread_local_pool()
+ * gives every thread its own pool, so threads don't contend on free lists.
+ *
+ * In ATen mode tensors aren't pooled, but allocations are still counted.
+ */
+class TensorPtrPool final {
+ public:
+  /// Default number of released tensors kept per shape and type.
+  static constexpr size_t kDefaultMaxCachedPerShape = 4;
+
+  /**
+   * Constructs an empty pool.
+   *
+   * @param max_cached_per_shape How many released tensors of the same shape
+   * and type to keep. Any more are freed.
+   */
+  explicit TensorPtrPool(
+      size_t max_cached_per_shape = kDefaultMaxCachedPerShape);
+  ~TensorPtrPool();
+
+  TensorPtrPool(const TensorPtrPool&) = delete;
+  TensorPtrPool& operator=(const TensorPtrPool&) = delete;
+  TensorPtrPool(TensorPtrPool&&) = delete;
+  TensorPtrPool& operator=(TensorPtrPool&&) = delete;
+
+  /**
+   * Returns a pool for the calling thread.
+   */
+  static TensorPtrPool& thread_local_pool();
+
+  /**
+   * Creates a contiguous tensor with the specified sizes, reusing a released
+   * one if possible. Its elements are not initialized, and a reused tensor
+   * holds the data it was released with.
+   *
+   * @param sizes A vector specifying the size of each dimension.
+   * @param type The scalar type of the tensor elements.
+   * @param dynamism Specifies whether the tensor's shape is static or dynamic.
+   * @return A TensorPtr instance managing the Tensor.
+   */
+  TensorPtr empty(
+      const std::vector<executorch::aten::SizesType>& sizes,
+      executorch::aten::ScalarType type = executorch::aten::ScalarType::Float,
+      executorch::aten::TensorShapeDynamism dynamism =
+          executorch::aten::TensorShapeDynamism::DYNAMIC_BOUND) {
+    return acquire(sizes.data(), sizes.size(), type, dynamism);
+  }
+
+  TensorPtr empty(
+      std::initializer_list<executorch::aten::SizesType> sizes,
+      executorch::aten::ScalarType type = executorch::aten::ScalarType::Float,
+      executorch::aten::TensorShapeDynamism dynamism =
+          executorch::aten::TensorShapeDynamism::DYNAMIC_BOUND) {
+    return acquire(sizes.begin(), sizes.size(), type, dynamism);
+  }
+
+  /**
+   * Creates a pooled copy of a contiguous tensor.
+   *
+   * @param tensor The tensor to copy.
+   * @return A TensorPtr instance managing the copy.
+   */
+  TensorPtr clone(const executorch::aten::Tensor& tensor);
+
+  /**
+   * @return How many tensors the pool had to allocate so far. Stays constant
+   * once every shape in use has been released at least once.
+   */
+  size_t num_allocations() const;
+
+  /**
+   * @return How many released tensors are waiting to be reused.
+   */
+  size_t num_cached() const;
+
+  /**
+   * Frees all released tensors. Tensors in use are not affected.
+   */
+  void clear();
+
+ private:
+  struct Block;
+  struct State;
+  template <typename T>
+  struct BlockAllocator;
+
+  TensorPtr acquire(
+      const executorch::aten::SizesType* sizes,
+      size_t dim,
+      executorch::aten::ScalarType type,
+      executorch::aten::TensorShapeDynamism dynamism);
+
+  std::shared_ptr<State> state_;
+};
+
+} // namespace extension
+} // namespace executorch
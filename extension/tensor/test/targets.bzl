@@ -15,6 +15,7 @@ def define_common_targets():
             srcs = [
                 "tensor_accessor_test.cpp",
                 "tensor_ptr_maker_test.cpp",
+                "tensor_ptr_pool_test.cpp",
                 "tensor_ptr_test.cpp",
             ],
             deps = [
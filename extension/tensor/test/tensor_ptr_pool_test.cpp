@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/tensor/tensor_ptr_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <executorch/extension/tensor/tensor_ptr_maker.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::runtime;
+
+class TensorPtrPoolTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    runtime_init();
+  }
+};
+
+TEST_F(TensorPtrPoolTest, ReusesReleasedTensors) {
+  TensorPtrPool pool;
+
+  auto tensor = pool.empty({2, 3});
+  EXPECT_EQ(tensor->dim(), 2);
+  EXPECT_EQ(tensor->size(0), 2);
+  EXPECT_EQ(tensor->size(1), 3);
+  EXPECT_EQ(tensor->strides()[0], 3);
+  EXPECT_EQ(tensor->strides()[1], 1);
+  EXPECT_EQ(tensor->scalar_type(), executorch::aten::ScalarType::Float);
+  const auto* data = tensor->const_data_ptr();
+  tensor.reset();
+  EXPECT_EQ(pool.num_cached(), 1);
+
+  for (int i = 0; i < 10; ++i) {
+    auto reused = pool.empty({2, 3});
+    EXPECT_EQ(reused->const_data_ptr(), data);
+  }
+  EXPECT_EQ(pool.num_allocations(), 1);
+}
+
+TEST_F(TensorPtrPoolTest, KeysOnShapeAndType) {
+  TensorPtrPool pool;
+
+  pool.empty({2, 3});
+  pool.empty({3, 2});
+  pool.empty({2, 3}, executorch::aten::ScalarType::Int);
+  pool.empty({2, 3}, executorch::aten::ScalarType::Float);
+  EXPECT_EQ(pool.num_allocations(), 3);
+  EXPECT_EQ(pool.num_cached(), 3);
+}
+
+TEST_F(TensorPtrPoolTest, InUseTensorsAreNotShared) {
+  TensorPtrPool pool;
+
+  auto first = pool.empty({4});
+  auto second = pool.empty({4});
+  EXPECT_NE(first->const_data_ptr(), second->const_data_ptr());
+  EXPECT_EQ(pool.num_allocations(), 2);
+
+  // A weak reference keeps the tensor out of the pool.
+  std::weak_ptr<executorch::aten::Tensor> weak = first;
+  first.reset();
+  EXPECT_EQ(pool.num_cached(), 0);
+  weak.reset();
+  EXPECT_EQ(pool.num_cached(), 1);
+}
+
+TEST_F(TensorPtrPoolTest, LimitsCachedTensorsPerShape) {
+  TensorPtrPool pool(2);
+
+  {
+    auto a = pool.empty({8});
+    auto b = pool.empty({8});
+    auto c = pool.empty({8});
+  }
+  EXPECT_EQ(pool.num_cached(), 2);
+  pool.clear();
+  EXPECT_EQ(pool.num_cached(), 0);
+}
+
+TEST_F(TensorPtrPoolTest, RestoresShapeOfResizedTensor) {
+  TensorPtrPool pool;
+
+  auto tensor = pool.empty({4, 4});
+  EXPECT_EQ(resize_tensor_ptr(tensor, {2, 4}), Error::Ok);
+  EXPECT_EQ(tensor->size(0), 2);
+  tensor.reset();
+
+  auto reused = pool.empty({4, 4});
+  EXPECT_EQ(pool.num_allocations(), 1);
+  EXPECT_EQ(reused->size(0), 4);
+  EXPECT_EQ(reused->numel(), 16);
+}
+
+TEST_F(TensorPtrPoolTest, ClonesTensor) {
+  TensorPtrPool pool;
+  auto source = make_tensor_ptr({2, 2}, {1, 2, 3, 4});
+
+  auto copy = pool.clone(*source);
+  EXPECT_NE(copy->const_data_ptr(), source->const_data_ptr());
+  EXPECT_EQ(copy->scalar_type(), executorch::aten::ScalarType::Int);
+  EXPECT_EQ(copy->const_data_ptr<int32_t>()[3], 4);
+}
+
+TEST_F(TensorPtrPoolTest, TensorsOutliveThePool) {
+  TensorPtr tensor;
+  {
+    TensorPtrPool pool;
+    tensor = pool.empty({3});
+  }
+  tensor->mutable_data_ptr<float>()[2] = 1.f;
+  tensor.reset();
+}
+
+TEST_F(TensorPtrPoolTest, ThreadLocalPools) {
+  std::vector<std::thread> threads;
+  std::vector<size_t> allocations(4);
+  for (size_t t = 0; t < allocations.size(); ++t) {
+    threads.emplace_back([&, t] {
+      auto& pool = TensorPtrPool::thread_local_pool();
+      for (int i = 0; i < 100; ++i) {
+        auto tensor = pool.empty({16});
+        tensor->mutable_data_ptr<float>()[0] = i;
+      }
+      allocations[t] = pool.num_allocations();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto count : allocations) {
+    EXPECT_EQ(count, 1);
+  }
+}
@@ -137,8 +137,9 @@ ElementwiseOptimizedPath inline select_optimized_path(
   ScalarType b_type = b.scalar_type();
   ScalarType out_type = out.scalar_type();
 
-  if (a_type != b_type || a_type != out_type || a_type == ScalarType::Half ||
-      a_type == ScalarType::BFloat16) {
+  // Half and BFloat16 are supported too: their vectorized paths compute in
+  // float, see executorch::vec::vec_compute_t.
+  if (a_type != b_type || a_type != out_type) {
     return ElementwiseOptimizedPath::kNone;
   }
   if (a.sizes().equals(b.sizes()) ||
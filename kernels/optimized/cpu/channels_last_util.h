@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Returns true if `t` is a 4-D {N, C, H, W} tensor in channels last dim
+ * order, i.e. laid out in memory as {N, H, W, C}. Unlike
+ * tensor_is_channels_last_dim_order(), this doesn't log when it returns false,
+ * so kernels can use it to pick a code path.
+ */
+inline bool is_channels_last_4d(const executorch::aten::Tensor& t) {
+  return t.dim() == 4 &&
+      is_channels_last_dim_order(t.dim_order().data(), t.dim_order().size());
+}
+
+/**
+ * Returns true if `t` is in the default (contiguous) dim order. Unlike
+ * tensor_is_default_dim_order(), this doesn't log when it returns false, so
+ * kernels can use it to pick a code path.
+ */
+inline bool is_contiguous_tensor(const executorch::aten::Tensor& t) {
+  return is_contiguous_dim_order(t.dim_order().data(), t.dim_order().size());
+}
+
+/**
+ * Returns a parallel_for grain size for kernels that do about `work_per_pixel`
+ * operations for each item they split across threads, such as an {n, h, w}
+ * output position of an NHWC kernel or an {H, W} plane of an NCHW kernel.
+ */
+inline int64_t channels_last_grain_size(const int64_t work_per_pixel) {
+  return std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          std::max<int64_t>(1, work_per_pixel));
+}
+
+/**
+ * For a sliding window along a dim of `in_size` elements, where window `o`
+ * starts at `o * stride - padding`, returns the first of the `out_size`
+ * windows whose element at `offset` from the window start is in bounds, and
+ * sets `*end` past the last such window. Kernels can then sweep one window
+ * position across a whole output row without bounds checks.
+ */
+inline int64_t window_offset_valid_range(
+    const int64_t offset,
+    const int64_t stride,
+    const int64_t padding,
+    const int64_t in_size,
+    const int64_t out_size,
+    int64_t* end) {
+  const int64_t first = offset - padding;
+  const int64_t past = in_size - first;
+  *end = past <= 0 ? 0 : std::min(out_size, (past + stride - 1) / stride);
+  return first >= 0 ? 0 : (-first + stride - 1) / stride;
+}
+
+} // namespace executor
+} // namespace torch
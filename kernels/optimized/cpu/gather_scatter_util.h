@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include <executorch/kernels/optimized/cpu/channels_last_util.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Returns true if `t` has as many dims as `index`, and the same sizes in the
+ * dims after `dim`. For contiguous tensors, this means that an element of
+ * `index` and the elements of `t` it addresses along `dim` are at the same
+ * offset within those trailing dims.
+ */
+inline bool has_index_trailing_sizes(
+    const executorch::aten::Tensor& index,
+    const executorch::aten::Tensor& t,
+    int64_t dim) {
+  if (t.dim() != index.dim()) {
+    return false;
+  }
+  for (int64_t d = dim + 1; d < index.dim(); ++d) {
+    if (t.size(d) != index.size(d)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Returns the offset, in the contiguous tensor `t`, of the slice whose
+ * coordinates in the dims before `dim` are those of the `o`-th slice of
+ * `index` in row-major order.
+ */
+inline int64_t index_leading_offset(
+    const executorch::aten::Tensor& index,
+    const executorch::aten::Tensor& t,
+    int64_t dim,
+    int64_t o) {
+  int64_t offset = 0;
+  for (int64_t d = dim - 1; d >= 0; --d) {
+    const int64_t size = index.size(d);
+    offset += (o % size) * t.strides()[d];
+    o /= size;
+  }
+  return offset;
+}
+
+/**
+ * Views a gather or scatter along some dim as `outer` blocks of `size`
+ * slices of `inner` elements, and calls `fn(o, i_begin, i_end)` in parallel
+ * for disjoint ranges of the `outer * inner` columns, where column {o, i}
+ * holds the `size` elements {o, k, i}. Each column is handled by a single
+ * call, so a kernel whose columns write disjoint output elements can walk
+ * each column in order, matching the sequential kernel element for element,
+ * without any synchronization between threads.
+ */
+template <typename Func>
+void parallel_for_index_columns(
+    const int64_t outer,
+    const int64_t size,
+    const int64_t inner,
+    const Func& fn) {
+  if (outer == 0 || size == 0 || inner == 0) {
+    return;
+  }
+  const int64_t grain_size = std::max<int64_t>(
+      1, ::executorch::extension::internal::GRAIN_SIZE / size);
+  ::executorch::extension::parallel_for(
+      0, outer * inner, grain_size, [&](const auto begin, const auto end) {
+        for (int64_t col = begin; col < end;) {
+          const int64_t o = col / inner;
+          const int64_t i_begin = col % inner;
+          const int64_t i_end =
+              std::min<int64_t>(inner, i_begin + (end - col));
+          fn(o, i_begin, i_end);
+          col += i_end - i_begin;
+        }
+      });
+}
+
+} // namespace executor
+} // namespace torch
@@ -9,21 +9,26 @@
 #pragma once
 
 // Slightly modified version of caffe2/aten/src/ATen/native/cpu/moments_utils.h
-// for use in optimized ExecuTorch ops. Template specializations of BFloat16
-// are excluded.
+// for use in optimized ExecuTorch ops. As in ATen, Half and BFloat16 inputs
+// are accumulated in float.
 
 #include <ATen/cpu/vec/vec.h>
+#include <c10/util/BFloat16-math.h>
 
 #include <executorch/kernels/optimized/utils/math_utils.h>
 #include <executorch/runtime/platform/compiler.h>
 #include <array>
+#include <type_traits>
 
 namespace torch {
 namespace executor {
 namespace native {
 
 template <typename T>
-using acc_t = executorch::utils::compute_dtype<T>;
+using acc_t = std::conditional_t<
+    c10::is_reduced_floating_point_v<T>,
+    float,
+    executorch::utils::compute_dtype<T>>;
 
 constexpr int64_t kChunkSize = 16;
 
@@ -64,7 +69,8 @@ ET_INLINE void AddMomentsVec(
 }
 
 template <typename T>
-inline void UpdateMomentsVec(
+inline std::enable_if_t<!c10::is_reduced_floating_point_v<T>, void>
+UpdateMomentsVec(
     int64_t m0,
     const T* X_ptr,
     const std::array<at::vec::Vectorized<acc_t<T>>, kChunkSize>& c_vecs,
@@ -83,6 +89,35 @@ inline void UpdateMomentsVec(
   AddMomentsVec(m0, m1_vec, m2_vec, m0_stk0, m1_stk0, m2_stk0);
 }
 
+// Each reduced precision vector is converted to two float vectors, which are
+// accumulated separately and then both added to the float stack entry.
+template <typename T>
+inline std::enable_if_t<c10::is_reduced_floating_point_v<T>, void>
+UpdateMomentsVec(
+    int64_t m0,
+    const T* X_ptr,
+    const std::array<at::vec::Vectorized<acc_t<T>>, kChunkSize>& c_vecs,
+    int64_t& m0_stk0,
+    at::vec::Vectorized<acc_t<T>>& m1_stk0,
+    at::vec::Vectorized<acc_t<T>>& m2_stk0) {
+  using Vec = at::vec::Vectorized<T>;
+  using fVec = at::vec::Vectorized<acc_t<T>>;
+  fVec m1_fvec0(0), m1_fvec1(0);
+  fVec m2_fvec0(0), m2_fvec1(0);
+  for (int64_t j = 0; j < m0; ++j) {
+    const Vec x_bvec = Vec::loadu(X_ptr + j * Vec::size());
+    auto [x_fvec0, x_fvec1] = at::vec::convert_to_float<T>(x_bvec);
+    const fVec delta_fvec0 = x_fvec0 - m1_fvec0;
+    const fVec delta_fvec1 = x_fvec1 - m1_fvec1;
+    m1_fvec0 += delta_fvec0 * c_vecs[j];
+    m1_fvec1 += delta_fvec1 * c_vecs[j];
+    m2_fvec0 += delta_fvec0 * (x_fvec0 - m1_fvec0);
+    m2_fvec1 += delta_fvec1 * (x_fvec1 - m1_fvec1);
+  }
+  AddMomentsVec(m0, m1_fvec0, m2_fvec0, m0_stk0, m1_stk0, m2_stk0);
+  AddMomentsVec(m0, m1_fvec1, m2_fvec1, m0_stk0, m1_stk0, m2_stk0);
+}
+
 // Compute rowwise moments by parallel Welford algorithm and cascade sum to
 // improve numerical stability.
 // https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
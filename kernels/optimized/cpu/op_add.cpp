@@ -74,26 +74,22 @@ Tensor& opt_add_out(
             out.numel());
       });
       return out;
-    } else if (
-        a_type == b_type && a_type == out_type && a_type != ScalarType::Half &&
-        a_type != ScalarType::BFloat16) {
-      ET_SWITCH_REALB_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
-        ET_SWITCH_REALB_TYPES(b_type, ctx, op_name, CTYPE_B, [&]() {
-          CTYPE alpha_val;
-          ET_KERNEL_CHECK(
-              ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
-          CTYPE_B b_val = *b.const_data_ptr<CTYPE_B>();
-          CTYPE b_casted = static_cast<CTYPE>(b_val);
-
-          using Vec = at::vec::Vectorized<CTYPE>;
-          at::vec::map<CTYPE>(
-              [alpha_val, b_casted](Vec x) {
-                return x + Vec(alpha_val * b_casted);
-              },
-              out.mutable_data_ptr<CTYPE>(),
-              a.const_data_ptr<CTYPE>(),
-              out.numel());
-        });
+    } else if (a_type == b_type && a_type == out_type) {
+      ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
+        using CTYPE_VEC = executorch::vec::vec_compute_t<CTYPE>;
+        CTYPE_VEC alpha_val;
+        ET_KERNEL_CHECK(
+            ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
+        CTYPE_VEC b_casted = static_cast<CTYPE_VEC>(*b.const_data_ptr<CTYPE>());
+
+        using Vec = at::vec::Vectorized<CTYPE_VEC>;
+        at::vec::map<CTYPE>(
+            [alpha_val, b_casted](Vec x) {
+              return x + Vec(alpha_val * b_casted);
+            },
+            out.mutable_data_ptr<CTYPE>(),
+            a.const_data_ptr<CTYPE>(),
+            out.numel());
       });
       return out;
     }
@@ -131,15 +127,15 @@ Tensor& opt_add_scalar_out(
   // @lint-ignore CLANGTIDY facebook-hte-CArray
   static constexpr const char op_name[] = "add.Scalar_out";
 
-  if (a_type == common_type && a_type == out_type &&
-      a_type != ScalarType::Half && a_type != ScalarType::BFloat16) {
-    ET_SWITCH_REALB_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
-      CTYPE b_casted = utils::scalar_to<CTYPE>(b);
-      CTYPE alpha_val;
+  if (a_type == common_type && a_type == out_type) {
+    ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
+      using CTYPE_VEC = executorch::vec::vec_compute_t<CTYPE>;
+      CTYPE_VEC b_casted = utils::scalar_to<CTYPE_VEC>(b);
+      CTYPE_VEC alpha_val;
       ET_KERNEL_CHECK(
           ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
 
-      using Vec = at::vec::Vectorized<CTYPE>;
+      using Vec = at::vec::Vectorized<CTYPE_VEC>;
       at::vec::map<CTYPE>(
           [alpha_val, b_casted](Vec x) {
             return x + Vec(alpha_val * b_casted);
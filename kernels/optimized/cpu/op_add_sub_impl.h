@@ -64,8 +64,9 @@ Tensor& opt_add_sub_out_impl(
   }
 
   if (selected_optimized_path == ElementwiseOptimizedPath::kTreatAs1d) {
-    ET_SWITCH_REALB_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
-      CTYPE alpha_val;
+    ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
+      using CTYPE_VEC = executorch::vec::vec_compute_t<CTYPE>;
+      CTYPE_VEC alpha_val;
       ET_KERNEL_CHECK(
           ctx,
           torch::executor::native::utils::extract_scalar(alpha, &alpha_val),
@@ -73,7 +74,7 @@ Tensor& opt_add_sub_out_impl(
       if constexpr (is_sub) {
         alpha_val = -alpha_val;
       }
-      using Vec = at::vec::Vectorized<CTYPE>;
+      using Vec = at::vec::Vectorized<CTYPE_VEC>;
       at::vec::map2<CTYPE>(
           [alpha_val](Vec x, Vec y) { return x + Vec(alpha_val) * y; },
           out.mutable_data_ptr<CTYPE>(),
@@ -84,15 +85,16 @@ Tensor& opt_add_sub_out_impl(
   } else if (selected_optimized_path != ElementwiseOptimizedPath::kNone) {
     // Cannot apply the trick of -alpha here because alpha is Scalar without
     // support for - operator. At least not right now.
-    ET_SWITCH_REALB_TYPES(out_type, ctx, op_name, CTYPE, [&]() -> void {
-      CTYPE alpha_val;
+    ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, op_name, CTYPE, [&]() -> void {
+      using CTYPE_VEC = executorch::vec::vec_compute_t<CTYPE>;
+      CTYPE_VEC alpha_val;
       ET_KERNEL_CHECK_MSG(
           ctx,
           torch::executor::native::utils::extract_scalar(alpha, &alpha_val),
           InvalidArgument,
           ,
           "Failed to extract scalar alpha.");
-      using Vec = at::vec::Vectorized<CTYPE>;
+      using Vec = at::vec::Vectorized<CTYPE_VEC>;
       Vec alpha_val_vec(alpha_val);
       if constexpr (is_sub) {
         if (selected_optimized_path ==
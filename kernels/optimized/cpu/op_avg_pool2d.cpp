@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+
+#include <executorch/kernels/optimized/cpu/channels_last_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// `opt_avg_pool2d_out` pools channels last (NHWC) tensors directly: each
+// output pixel sums whole contiguous channel rows of its window. Contiguous
+// (NCHW) tensors are pooled one {H, W} plane at a time, in parallel over
+// planes, with each kernel position swept across a whole output row. Other
+// dim orders are handled by the portable kernel.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
+
+namespace {
+
+// Matches the portable kernel's accumulation order and divisor, so both give
+// the same results.
+template <typename CTYPE>
+void avg_pool2d_channels_last(
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool count_include_pad,
+    std::optional<int64_t> divisor_override,
+    Tensor& out) {
+  const int64_t N = in.size(0);
+  const int64_t C = in.size(1);
+  const int64_t H = in.size(2);
+  const int64_t W = in.size(3);
+  const int64_t OH = out.size(2);
+  const int64_t OW = out.size(3);
+
+  const int64_t k_H = val_at(kernel_size, 0);
+  const int64_t k_W = val_at(kernel_size, 1);
+  const int64_t s_H = val_at(stride, 0, /*default_value=*/k_H);
+  const int64_t s_W = val_at(stride, 1, /*default_value=*/k_W);
+  const int64_t p_H = val_at(padding, 0, /*default_value=*/0);
+  const int64_t p_W = val_at(padding, 1, /*default_value=*/0);
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      N * OH * OW,
+      channels_last_grain_size(C * k_H * k_W),
+      [&](const auto begin, const auto end) {
+        for (int64_t pixel = begin; pixel < end; ++pixel) {
+          const int64_t n = pixel / (OH * OW);
+          const int64_t oh = (pixel / OW) % OH;
+          const int64_t ow = pixel % OW;
+
+          int64_t ih0 = oh * s_H - p_H;
+          int64_t iw0 = ow * s_W - p_W;
+          int64_t ih1 = std::min(ih0 + k_H, H + p_H);
+          int64_t iw1 = std::min(iw0 + k_W, W + p_W);
+          const int64_t pool_size = (ih1 - ih0) * (iw1 - iw0);
+          ih0 = std::max<int64_t>(ih0, 0);
+          iw0 = std::max<int64_t>(iw0, 0);
+          ih1 = std::min(ih1, H);
+          iw1 = std::min(iw1, W);
+          CTYPE* const out_row = out_data + pixel * C;
+          if (ih0 >= ih1 || iw0 >= iw1) {
+            // Empty windows are zero, as in the contiguous path.
+            std::fill(out_row, out_row + C, static_cast<CTYPE>(0));
+            continue;
+          }
+
+          const CTYPE* const first_row =
+              in_data + ((n * H + ih0) * W + iw0) * C;
+          std::copy(first_row, first_row + C, out_row);
+          for (int64_t ih = ih0; ih < ih1; ++ih) {
+            for (int64_t iw = ih == ih0 ? iw0 + 1 : iw0; iw < iw1; ++iw) {
+              const CTYPE* const in_row = in_data + ((n * H + ih) * W + iw) * C;
+              for (int64_t c = 0; c < C; ++c) {
+                out_row[c] = in_row[c] + out_row[c];
+              }
+            }
+          }
+
+          const CTYPE divisor = static_cast<CTYPE>(
+              divisor_override.has_value()
+                  ? divisor_override.value()
+                  : (count_include_pad ? pool_size
+                                       : (ih1 - ih0) * (iw1 - iw0)));
+          for (int64_t c = 0; c < C; ++c) {
+            out_row[c] = out_row[c] / divisor;
+          }
+        }
+      });
+}
+
+// Matches the portable kernel's per-element accumulation order and divisor.
+// Each output row is zeroed and then, for each input row and kernel column
+// in window order, the matching input elements are added across the row's
+// valid output columns, which reads the input at a fixed stride.
+template <typename CTYPE>
+void avg_pool2d_contiguous(
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool count_include_pad,
+    std::optional<int64_t> divisor_override,
+    Tensor& out) {
+  const int64_t H = in.size(in.dim() - 2);
+  const int64_t W = in.size(in.dim() - 1);
+  const int64_t OH = out.size(out.dim() - 2);
+  const int64_t OW = out.size(out.dim() - 1);
+  const int64_t planes = getLeadingDims(out, out.dim() - 2);
+
+  const int64_t k_H = val_at(kernel_size, 0);
+  const int64_t k_W = val_at(kernel_size, 1);
+  const int64_t s_H = val_at(stride, 0, /*default_value=*/k_H);
+  const int64_t s_W = val_at(stride, 1, /*default_value=*/k_W);
+  const int64_t p_H = val_at(padding, 0, /*default_value=*/0);
+  const int64_t p_W = val_at(padding, 1, /*default_value=*/0);
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      planes,
+      channels_last_grain_size(OH * OW * k_H * k_W),
+      [&](const auto begin, const auto end) {
+        for (int64_t plane = begin; plane < end; ++plane) {
+          const CTYPE* const in_plane = in_data + plane * H * W;
+          for (int64_t oh = 0; oh < OH; ++oh) {
+            int64_t ih0 = oh * s_H - p_H;
+            int64_t ih1 = std::min(ih0 + k_H, H + p_H);
+            const int64_t pool_h = ih1 - ih0;
+            ih0 = std::max<int64_t>(ih0, 0);
+            ih1 = std::min(ih1, H);
+
+            CTYPE* const out_row = out_data + (plane * OH + oh) * OW;
+            std::fill(out_row, out_row + OW, static_cast<CTYPE>(0));
+            for (int64_t ih = ih0; ih < ih1; ++ih) {
+              const CTYPE* const in_row = in_plane + ih * W;
+              for (int64_t kw = 0; kw < k_W; ++kw) {
+                int64_t ow_end = 0;
+                const int64_t ow_begin =
+                    window_offset_valid_range(kw, s_W, p_W, W, OW, &ow_end);
+                const int64_t iw_offset = kw - p_W;
+                for (int64_t ow = ow_begin; ow < ow_end; ++ow) {
+                  out_row[ow] = in_row[ow * s_W + iw_offset] + out_row[ow];
+                }
+              }
+            }
+
+            for (int64_t ow = 0; ow < OW; ++ow) {
+              int64_t iw0 = ow * s_W - p_W;
+              int64_t iw1 = std::min(iw0 + k_W, W + p_W);
+              const int64_t pool_size = pool_h * (iw1 - iw0);
+              iw0 = std::max<int64_t>(iw0, 0);
+              iw1 = std::min(iw1, W);
+              if (ih0 >= ih1 || iw0 >= iw1) {
+                continue;
+              }
+              const CTYPE divisor = static_cast<CTYPE>(
+                  divisor_override.has_value()
+                      ? divisor_override.value()
+                      : (count_include_pad ? pool_size
+                                           : (ih1 - ih0) * (iw1 - iw0)));
+              out_row[ow] = out_row[ow] / divisor;
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+// avg_pool2d.out(Tensor self, int[2] kernel_size, int[2] stride=[],
+// int[2] padding=0, bool ceil_mode=False, bool count_include_pad=True,
+// int? divisor_override=None, *, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_avg_pool2d_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode,
+    bool count_include_pad,
+    std::optional<int64_t> divisor_override,
+    Tensor& out) {
+  const bool channels_last =
+      is_channels_last_4d(in) && is_channels_last_4d(out);
+  const bool contiguous = is_contiguous_tensor(in) && is_contiguous_tensor(out);
+  if (!channels_last && !contiguous) {
+    return avg_pool2d_out_impl(
+        ctx,
+        in,
+        kernel_size,
+        stride,
+        padding,
+        ceil_mode,
+        count_include_pad,
+        divisor_override,
+        out);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_avg_pool2d_args(
+          in,
+          kernel_size,
+          stride,
+          padding,
+          ceil_mode,
+          count_include_pad,
+          divisor_override,
+          out),
+      InvalidArgument,
+      out);
+
+  size_t output_ndim = 0;
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_avg_pool2d_out_target_size(
+      in, kernel_size, stride, padding, ceil_mode, output_sizes, &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  static constexpr const char op_name[] = "avg_pool2d.out";
+
+  ET_SWITCH_FLOATHBF16_TYPES_AND(
+      Long, in.scalar_type(), ctx, op_name, CTYPE, [&]() {
+        if (channels_last) {
+          avg_pool2d_channels_last<CTYPE>(
+              in,
+              kernel_size,
+              stride,
+              padding,
+              count_include_pad,
+              divisor_override,
+              out);
+        } else {
+          avg_pool2d_contiguous<CTYPE>(
+              in,
+              kernel_size,
+              stride,
+              padding,
+              count_include_pad,
+              divisor_override,
+              out);
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/strided_copy_util.h>
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+Tensor& opt_cat_out(
+    KernelRuntimeContext& ctx,
+    executorch::aten::ArrayRef<Tensor> tensors,
+    int64_t dim,
+    Tensor& out) {
+  if (dim < 0) {
+    dim += out.dim();
+  }
+
+  ET_KERNEL_CHECK(ctx, check_cat_args(tensors, dim, out), InvalidArgument, out);
+
+  Tensor::SizesType expected_out_size[kTensorDimensionLimit];
+  size_t expected_out_dim = 0;
+  get_cat_out_target_size(tensors, dim, expected_out_size, &expected_out_dim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {expected_out_size, expected_out_dim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  // Each input fills a contiguous part of every row of `out`, viewed as
+  // [outer, out.size(dim) * inner]. Empty inputs, which may not even have
+  // `dim`, contribute nothing.
+  size_t outer = 1;
+  size_t inner = 1;
+  internal::collapse_around_dim(out, dim, &outer, &inner);
+  const size_t out_row_size = out.size(dim) * inner;
+  const auto get_copy = [&](size_t i, size_t row_offset) {
+    const Tensor& in = tensors[i];
+    const size_t row_size = in.numel() == 0 ? 0 : in.size(dim) * inner;
+    return internal::StridedCopy{
+        static_cast<char*>(out.mutable_data_ptr()) +
+            row_offset * out.element_size(),
+        out_row_size,
+        in.const_data_ptr(),
+        row_size,
+        row_size == 0 ? 0 : outer,
+        row_size};
+  };
+
+  const auto out_type = out.scalar_type();
+  bool same_dtype = true;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    if (tensors[i].numel() > 0 && tensors[i].scalar_type() != out_type) {
+      same_dtype = false;
+    }
+  }
+  if (same_dtype) {
+    internal::parallel_strided_copy(
+        out.element_size(), tensors.size(), get_copy);
+    return out;
+  }
+
+  // TODO: The current support for complex dtype enforces that input and
+  // output tensors have the same dtype. Support mixed dtypes in the future.
+  ET_KERNEL_CHECK(
+      ctx, !executorch::runtime::isComplexType(out_type), InvalidArgument, out);
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  static constexpr const char op_name[] = "cat.out";
+
+  size_t row_offset = 0;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const internal::StridedCopy copy = get_copy(i, row_offset);
+    row_offset += copy.row_size;
+    if (copy.rows == 0) {
+      continue;
+    }
+    const auto in_type = tensors[i].scalar_type();
+    ET_SWITCH_REALHBBF16_TYPES(in_type, ctx, op_name, CTYPE_IN, [&] {
+      ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, op_name, CTYPE_OUT, [&] {
+        internal::convert_strided_copy<CTYPE_OUT, CTYPE_IN>(copy);
+      });
+    });
+  }
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
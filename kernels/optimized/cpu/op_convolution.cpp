@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <functional>
+
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <executorch/kernels/optimized/cpu/channels_last_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// `opt_convolution_out` computes 2D convolutions of float channels last
+// (NHWC) tensors directly, so that models exported with channels last dim
+// order don't need to convert to and from NCHW around each convolution. Each
+// output pixel is a set of dot products along the contiguous channels dim.
+// Other convolutions are handled by the portable kernel.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
+
+namespace {
+
+bool can_use_channels_last_conv(
+    const Tensor& in,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    bool transposed,
+    const Tensor& out) {
+  if (transposed || !is_channels_last_4d(in) || !is_channels_last_4d(out) ||
+      weight.dim() != 4) {
+    return false;
+  }
+  if (!is_channels_last_4d(weight) &&
+      !is_contiguous_dim_order(
+          weight.dim_order().data(), weight.dim_order().size())) {
+    return false;
+  }
+  return in.scalar_type() == ScalarType::Float &&
+      weight.scalar_type() == ScalarType::Float &&
+      out.scalar_type() == ScalarType::Float &&
+      (!bias.has_value() || bias.value().scalar_type() == ScalarType::Float);
+}
+
+float dot(const float* a, const float* b, int64_t size) {
+  using Vec = at::vec::Vectorized<float>;
+  int64_t i = 0;
+  float sum = 0;
+  if (size >= Vec::size()) {
+    Vec acc(0.0f);
+    for (; i + Vec::size() <= size; i += Vec::size()) {
+      acc = at::vec::fmadd(Vec::loadu(a + i), Vec::loadu(b + i), acc);
+    }
+    sum = at::vec::vec_reduce_all<float>(std::plus<Vec>(), acc);
+  }
+  for (; i < size; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+// Copies a contiguous {OC, IC, KH, KW} weight to {OC, KH, KW, IC} order.
+void pack_weight_channels_last(const Tensor& weight, float* packed) {
+  const float* const w_data = weight.const_data_ptr<float>();
+  const int64_t OC = weight.size(0);
+  const int64_t IC = weight.size(1);
+  const int64_t K = weight.size(2) * weight.size(3);
+  for (int64_t oc = 0; oc < OC; ++oc) {
+    for (int64_t ic = 0; ic < IC; ++ic) {
+      for (int64_t k = 0; k < K; ++k) {
+        packed[(oc * K + k) * IC + ic] = w_data[(oc * IC + ic) * K + k];
+      }
+    }
+  }
+}
+
+// Copies a depthwise {C, 1, KH, KW} weight to {KH, KW, C} order, so that
+// each kernel position applies to a contiguous run of channels.
+void pack_depthwise_weight(const Tensor& weight, float* packed) {
+  const float* const w_data = weight.const_data_ptr<float>();
+  const int64_t C = weight.size(0);
+  const int64_t K = weight.size(2) * weight.size(3);
+  for (int64_t c = 0; c < C; ++c) {
+    for (int64_t k = 0; k < K; ++k) {
+      packed[k * C + c] = w_data[c * K + k];
+    }
+  }
+}
+
+struct Conv2dParams {
+  int64_t N, C, H, W;
+  int64_t OC, OH, OW;
+  int64_t KH, KW;
+  int64_t stride_h, stride_w;
+  int64_t pad_h, pad_w;
+  int64_t dil_h, dil_w;
+  int64_t groups;
+};
+
+// `weight` is in {OC, KH, KW, IC / groups} order.
+void conv2d_channels_last(
+    const Conv2dParams& p,
+    const float* in_data,
+    const float* weight,
+    const float* bias,
+    float* out_data) {
+  const int64_t ic_per_group = p.C / p.groups;
+  const int64_t oc_per_group = p.OC / p.groups;
+  ::executorch::extension::parallel_for(
+      0,
+      p.N * p.OH * p.OW,
+      channels_last_grain_size(p.OC * p.KH * p.KW * ic_per_group),
+      [&](const auto begin, const auto end) {
+        for (int64_t pixel = begin; pixel < end; ++pixel) {
+          const int64_t n = pixel / (p.OH * p.OW);
+          const int64_t oh = (pixel / p.OW) % p.OH;
+          const int64_t ow = pixel % p.OW;
+          float* const out_row = out_data + pixel * p.OC;
+          for (int64_t oc = 0; oc < p.OC; ++oc) {
+            const int64_t ic_begin = (oc / oc_per_group) * ic_per_group;
+            float acc = bias == nullptr ? 0.0f : bias[oc];
+            for (int64_t kh = 0; kh < p.KH; ++kh) {
+              const int64_t ih = oh * p.stride_h - p.pad_h + kh * p.dil_h;
+              if (ih < 0 || ih >= p.H) {
+                continue;
+              }
+              for (int64_t kw = 0; kw < p.KW; ++kw) {
+                const int64_t iw = ow * p.stride_w - p.pad_w + kw * p.dil_w;
+                if (iw < 0 || iw >= p.W) {
+                  continue;
+                }
+                const float* const in_row =
+                    in_data + ((n * p.H + ih) * p.W + iw) * p.C;
+                acc += dot(
+                    in_row + ic_begin,
+                    weight + ((oc * p.KH + kh) * p.KW + kw) * ic_per_group,
+                    ic_per_group);
+              }
+            }
+            out_row[oc] = acc;
+          }
+        }
+      });
+}
+
+// Depthwise convolution, where each output channel only reads the input
+// channel with the same index. `weight` is in {KH, KW, C} order.
+void depthwise_conv2d_channels_last(
+    const Conv2dParams& p,
+    const float* in_data,
+    const float* weight,
+    const float* bias,
+    float* out_data) {
+  using Vec = at::vec::Vectorized<float>;
+  const int64_t C = p.C;
+  ::executorch::extension::parallel_for(
+      0,
+      p.N * p.OH * p.OW,
+      channels_last_grain_size(C * p.KH * p.KW),
+      [&](const auto begin, const auto end) {
+        for (int64_t pixel = begin; pixel < end; ++pixel) {
+          const int64_t n = pixel / (p.OH * p.OW);
+          const int64_t oh = (pixel / p.OW) % p.OH;
+          const int64_t ow = pixel % p.OW;
+          float* const out_row = out_data + pixel * C;
+          for (int64_t c = 0; c < C; ++c) {
+            out_row[c] = bias == nullptr ? 0.0f : bias[c];
+          }
+          for (int64_t kh = 0; kh < p.KH; ++kh) {
+            const int64_t ih = oh * p.stride_h - p.pad_h + kh * p.dil_h;
+            if (ih < 0 || ih >= p.H) {
+              continue;
+            }
+            for (int64_t kw = 0; kw < p.KW; ++kw) {
+              const int64_t iw = ow * p.stride_w - p.pad_w + kw * p.dil_w;
+              if (iw < 0 || iw >= p.W) {
+                continue;
+              }
+              const float* const in_row =
+                  in_data + ((n * p.H + ih) * p.W + iw) * C;
+              const float* const w_row = weight + (kh * p.KW + kw) * C;
+              int64_t c = 0;
+              for (; c + Vec::size() <= C; c += Vec::size()) {
+                at::vec::fmadd(
+                    Vec::loadu(in_row + c),
+                    Vec::loadu(w_row + c),
+                    Vec::loadu(out_row + c))
+                    .store(out_row + c);
+              }
+              for (; c < C; ++c) {
+                out_row[c] += in_row[c] * w_row[c];
+              }
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+// convolution.out(Tensor input, Tensor weight, Tensor? bias, int[] stride,
+// SymInt[] padding, int[] dilation, bool transposed, SymInt[] output_padding,
+// int groups, *, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_convolution_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    Tensor& out) {
+  if (!can_use_channels_last_conv(in, weight, bias, transposed, out)) {
+    return convolution_out_impl(
+        ctx,
+        in,
+        weight,
+        bias,
+        stride,
+        padding,
+        dilation,
+        transposed,
+        output_padding,
+        groups,
+        out);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_convolution_args(
+          in,
+          weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          transposed,
+          output_padding,
+          groups,
+          out),
+      InvalidArgument,
+      out);
+
+  size_t output_ndim = 0;
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_convolution_out_target_size(
+      in,
+      weight,
+      stride,
+      padding,
+      dilation,
+      transposed,
+      output_padding,
+      groups,
+      output_sizes,
+      &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, in.dim() - 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const Conv2dParams params{
+      in.size(0),
+      in.size(1),
+      in.size(2),
+      in.size(3),
+      out.size(1),
+      out.size(2),
+      out.size(3),
+      weight.size(2),
+      weight.size(3),
+      val_at(stride, 0),
+      val_at(stride, 1),
+      val_at(padding, 0, /*default_value=*/0),
+      val_at(padding, 1, /*default_value=*/0),
+      val_at(dilation, 0),
+      val_at(dilation, 1),
+      groups};
+  const bool depthwise = groups == params.C && params.OC == params.C;
+  const float* const bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<float>() : nullptr;
+
+  // A {C, 1, KH, KW} weight has the same layout in either dim order.
+  const float* weight_data = weight.const_data_ptr<float>();
+  if (depthwise || !is_channels_last_4d(weight)) {
+    Result<void*> temp = ctx.allocate_temp(weight.nbytes(), alignof(float));
+    if (!temp.ok()) {
+      // Without scratch memory to repack the weight, fall back to the
+      // portable kernel, which reads the weight in place.
+      return convolution_out_impl(
+          ctx,
+          in,
+          weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          transposed,
+          output_padding,
+          groups,
+          out);
+    }
+    float* const packed = static_cast<float*>(temp.get());
+    if (depthwise) {
+      pack_depthwise_weight(weight, packed);
+    } else {
+      pack_weight_channels_last(weight, packed);
+    }
+    weight_data = packed;
+  }
+
+  const float* const in_data = in.const_data_ptr<float>();
+  float* const out_data = out.mutable_data_ptr<float>();
+  if (depthwise) {
+    depthwise_conv2d_channels_last(
+        params, in_data, weight_data, bias_data, out_data);
+  } else {
+    conv2d_channels_last(params, in_data, weight_data, bias_data, out_data);
+  }
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
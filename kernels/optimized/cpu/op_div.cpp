@@ -62,46 +62,38 @@ Tensor& opt_div_out(
   ScalarType out_type = out.scalar_type();
 
   if (a.numel() == 1 || b.numel() == 1) {
-    if (a_type == b_type && a_type == out_type && a_type != ScalarType::Half &&
-        a_type != ScalarType::BFloat16) {
+    if (a_type == b_type && a_type == out_type) {
       const Tensor* tensor;
       const Tensor* scalar;
-      ScalarType tensor_type;
-      ScalarType scalar_type;
       if (a.numel() == 1) {
         tensor = &b;
-        tensor_type = b_type;
         scalar = &a;
-        scalar_type = a_type;
       } else {
         tensor = &a;
-        tensor_type = a_type;
         scalar = &b;
-        scalar_type = b_type;
       }
-      ET_SWITCH_REALB_TYPES(tensor_type, ctx, op_name, CTYPE, [&]() {
-        ET_SWITCH_REALB_TYPES(scalar_type, ctx, op_name, CTYPE_SCALAR, [&]() {
-          CTYPE_SCALAR scalar_val = *scalar->const_data_ptr<CTYPE_SCALAR>();
-          CTYPE scalar_casted = static_cast<CTYPE>(scalar_val);
-
-          using Vec = at::vec::Vectorized<CTYPE>;
-          if (a.numel() == 1) {
-            at::vec::map<CTYPE>(
-                [scalar_casted](Vec x) { return Vec(scalar_casted) / x; },
-                out.mutable_data_ptr<CTYPE>(),
-                tensor->const_data_ptr<CTYPE>(),
-                out.numel());
-          } else {
-            Vec inv_scalar_casted_vec(CTYPE(1) / scalar_casted);
-            at::vec::map<CTYPE>(
-                [inv_scalar_casted_vec](Vec x) {
-                  return x * inv_scalar_casted_vec;
-                },
-                out.mutable_data_ptr<CTYPE>(),
-                tensor->const_data_ptr<CTYPE>(),
-                out.numel());
-          }
-        });
+      ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, op_name, CTYPE, [&]() {
+        using CTYPE_VEC = executorch::vec::vec_compute_t<CTYPE>;
+        CTYPE_VEC scalar_casted =
+            static_cast<CTYPE_VEC>(*scalar->const_data_ptr<CTYPE>());
+
+        using Vec = at::vec::Vectorized<CTYPE_VEC>;
+        if (a.numel() == 1) {
+          at::vec::map<CTYPE>(
+              [scalar_casted](Vec x) { return Vec(scalar_casted) / x; },
+              out.mutable_data_ptr<CTYPE>(),
+              tensor->const_data_ptr<CTYPE>(),
+              out.numel());
+        } else {
+          Vec inv_scalar_casted_vec(CTYPE_VEC(1) / scalar_casted);
+          at::vec::map<CTYPE>(
+              [inv_scalar_casted_vec](Vec x) {
+                return x * inv_scalar_casted_vec;
+              },
+              out.mutable_data_ptr<CTYPE>(),
+              tensor->const_data_ptr<CTYPE>(),
+              out.numel());
+        }
       });
       return out;
     }
@@ -109,8 +101,8 @@ Tensor& opt_div_out(
 
   auto selected_optimized_path = select_optimized_path(a, b, out);
   if (selected_optimized_path == ElementwiseOptimizedPath::kTreatAs1d) {
-    ET_SWITCH_REALB_TYPES(out_type, ctx, op_name, CTYPE, [&]() {
-      using Vec = at::vec::Vectorized<CTYPE>;
+    ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, op_name, CTYPE, [&]() {
+      using Vec = at::vec::Vectorized<executorch::vec::vec_compute_t<CTYPE>>;
       at::vec::map2<CTYPE>(
           [](Vec x, Vec y) { return x / y; },
           out.mutable_data_ptr<CTYPE>(),
@@ -121,7 +113,7 @@ Tensor& opt_div_out(
   } else if (selected_optimized_path != ElementwiseOptimizedPath::kNone) {
     // Reason for using alpha is becasuse handle_broadcast_elementwise
     // is used for add and sub as well:
-    ET_SWITCH_REALB_TYPES(out_type, ctx, op_name, CTYPE, [&]() {
+    ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, op_name, CTYPE, [&]() {
       if (selected_optimized_path ==
               ElementwiseOptimizedPath::kBroadcast2dBy1dReverseArguments ||
           selected_optimized_path ==
@@ -165,7 +157,6 @@ Tensor& opt_div_scalar_out(
     const Scalar& b,
     Tensor& out) {
   ScalarType a_type = a.scalar_type();
-  ScalarType b_type = utils::get_scalar_dtype(b);
   ScalarType common_type = isFloatingType(a_type) ? a_type : ScalarType::Float;
   ScalarType out_type = out.scalar_type();
 
@@ -183,22 +174,18 @@ Tensor& opt_div_scalar_out(
   // @lint-ignore CLANGTIDY facebook-hte-CArray
   static constexpr const char op_name[] = "div.Scalar_out";
 
-  if (a_type == common_type && a_type == out_type &&
-      a_type != ScalarType::Half && a_type != ScalarType::BFloat16) {
-    ET_SWITCH_REAL_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
-      ET_SWITCH_REALB_TYPES(b_type, ctx, op_name, CTYPE_B, [&]() {
-        CTYPE_B b_val;
-        ET_EXTRACT_SCALAR(b, b_val);
-        CTYPE b_casted = static_cast<CTYPE>(b_val);
-
-        using Vec = at::vec::Vectorized<CTYPE>;
-        Vec inv_b_casted_vec(CTYPE(1) / b_casted);
-        at::vec::map<CTYPE>(
-            [inv_b_casted_vec](Vec x) { return x * inv_b_casted_vec; },
-            out.mutable_data_ptr<CTYPE>(),
-            a.const_data_ptr<CTYPE>(),
-            out.numel());
-      });
+  if (a_type == common_type && a_type == out_type) {
+    ET_SWITCH_FLOATHBF16_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
+      using CTYPE_VEC = executorch::vec::vec_compute_t<CTYPE>;
+      CTYPE_VEC b_casted = utils::scalar_to<CTYPE_VEC>(b);
+
+      using Vec = at::vec::Vectorized<CTYPE_VEC>;
+      Vec inv_b_casted_vec(CTYPE_VEC(1) / b_casted);
+      at::vec::map<CTYPE>(
+          [inv_b_casted_vec](Vec x) { return x * inv_b_casted_vec; },
+          out.mutable_data_ptr<CTYPE>(),
+          a.const_data_ptr<CTYPE>(),
+          out.numel());
     });
   } else {
     ScalarType compute_type = utils::get_compute_type(common_type);
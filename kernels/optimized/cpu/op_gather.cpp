@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/gather_scatter_util.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// `opt_gather_out` gathers from contiguous tensors in parallel over the
+// index's columns along `dim`. Within a column, elements are read along the
+// contiguous trailing dims, or, when those are empty, as a plain indexed load
+// loop that the compiler can turn into vector gathers. Other layouts are
+// handled by the portable kernel.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+
+namespace {
+
+bool can_use_parallel_gather(
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& out) {
+  if (in.dim() == 0 || dim < -in.dim() || dim >= in.dim()) {
+    return false;
+  }
+  if (dim < 0) {
+    dim += in.dim();
+  }
+  return index.scalar_type() == ScalarType::Long && out.dim() == in.dim() &&
+      is_contiguous_tensor(in) && is_contiguous_tensor(index) &&
+      is_contiguous_tensor(out) && has_index_trailing_sizes(index, in, dim);
+}
+
+template <typename CTYPE>
+void gather_parallel(
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    Tensor& out) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  const int64_t* const index_data = index.const_data_ptr<int64_t>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t size = index.size(dim);
+  const int64_t inner = getTrailingDims(index, dim);
+  parallel_for_index_columns(
+      getLeadingDims(index, dim),
+      size,
+      inner,
+      [&](const int64_t o, const int64_t i_begin, const int64_t i_end) {
+        const CTYPE* const in_slice =
+            in_data + index_leading_offset(index, in, dim, o);
+        const int64_t* const index_slice = index_data + o * size * inner;
+        CTYPE* const out_slice = out_data + o * size * inner;
+        for (int64_t k = 0; k < size; ++k) {
+          for (int64_t i = i_begin; i < i_end; ++i) {
+            const int64_t ix = k * inner + i;
+            out_slice[ix] = in_slice[index_slice[ix] * inner + i];
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_gather_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    bool sparse_grad,
+    Tensor& out) {
+  if (!can_use_parallel_gather(in, dim, index, out)) {
+    return gather_out_impl(ctx, in, dim, index, sparse_grad, out);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_gather_args(in, dim, index, sparse_grad, out),
+      InvalidArgument,
+      out);
+
+  if (dim < 0) {
+    dim += in.dim();
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, index.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  static constexpr auto name = "gather.out";
+
+  ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    gather_parallel<CTYPE>(in, dim, index, out);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/gather_scatter_util.h>
+#include <executorch/kernels/portable/cpu/util/advanced_index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// `opt_index_put_out` handles the common case of a single 1-D integer index
+// tensor, such as KV cache updates, with values of the exact indexed shape.
+// Each indexed slice along the trailing dims is then contiguous, and the
+// kernel writes those slices in parallel over the {leading, trailing} columns
+// of the input. A column is walked in index order by a single thread, so
+// repeated indices accumulate, or overwrite with the last value, just as in
+// the portable kernel, without atomics. Other cases are handled by the
+// portable kernel.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using TensorOptList =
+    executorch::aten::ArrayRef<executorch::aten::optional<Tensor>>;
+
+namespace {
+
+// Returns true if `indices` holds a single 1-D Long or Int index tensor, at
+// position `*dim`, and `values` has the shape of `in` with that dim resized
+// to the index length.
+bool can_use_parallel_index_put(
+    const Tensor& in,
+    TensorOptList indices,
+    const Tensor& values,
+    const Tensor& out,
+    size_t* dim) {
+  if (in.dim() == 0 || static_cast<ssize_t>(indices.size()) > in.dim() ||
+      values.dim() != in.dim() || out.dim() != in.dim() ||
+      values.scalar_type() != in.scalar_type()) {
+    return false;
+  }
+  bool found_index = false;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    if (indices[i].has_value()) {
+      if (found_index) {
+        return false;
+      }
+      found_index = true;
+      *dim = i;
+    }
+  }
+  if (!found_index) {
+    return false;
+  }
+  const Tensor& index = indices[*dim].value();
+  if (index.dim() != 1 ||
+      (index.scalar_type() != ScalarType::Long &&
+       index.scalar_type() != ScalarType::Int)) {
+    return false;
+  }
+  for (size_t d = 0; d < static_cast<size_t>(in.dim()); ++d) {
+    const auto expected = d == *dim ? index.size(0) : in.size(d);
+    if (values.size(d) != expected) {
+      return false;
+    }
+  }
+  return is_contiguous_tensor(in) && is_contiguous_tensor(values) &&
+      is_contiguous_tensor(out);
+}
+
+template <typename CTYPE_IX>
+bool check_index_bounds(const Tensor& index, int64_t dim_size) {
+  const CTYPE_IX* const index_data = index.const_data_ptr<CTYPE_IX>();
+  for (int64_t i = 0; i < index.numel(); ++i) {
+    const int64_t index_val = static_cast<int64_t>(index_data[i]);
+    ET_CHECK_OR_RETURN_FALSE(
+        index_val >= -dim_size && index_val < dim_size,
+        "Index %" PRId64
+        " is out of bounds for input dimension with size %" PRId64 ".",
+        index_val,
+        dim_size);
+  }
+  return true;
+}
+
+template <typename CTYPE, typename CTYPE_IX>
+void index_put_parallel(
+    const Tensor& index,
+    const Tensor& values,
+    const bool accumulate,
+    size_t dim,
+    Tensor& out) {
+  const CTYPE_IX* const index_data = index.const_data_ptr<CTYPE_IX>();
+  const CTYPE* const values_data = values.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t dim_size = out.size(dim);
+  const int64_t size = index.size(0);
+  const int64_t trailing = getTrailingDims(out, dim);
+  parallel_for_index_columns(
+      getLeadingDims(out, dim),
+      size,
+      trailing,
+      [&](const int64_t o, const int64_t t_begin, const int64_t t_end) {
+        const CTYPE* const values_slice = values_data + o * size * trailing;
+        CTYPE* const out_slice = out_data + o * dim_size * trailing;
+        for (int64_t k = 0; k < size; ++k) {
+          int64_t ix = static_cast<int64_t>(index_data[k]);
+          if (ix < 0) {
+            ix += dim_size;
+          }
+          const CTYPE* const src = values_slice + k * trailing;
+          CTYPE* const dst = out_slice + ix * trailing;
+          if (accumulate) {
+            for (int64_t t = t_begin; t < t_end; ++t) {
+              dst[t] += src[t];
+            }
+          } else {
+            std::copy(src + t_begin, src + t_end, dst + t_begin);
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_index_put_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    TensorOptList indices,
+    const Tensor& values,
+    const bool accumulate,
+    Tensor& out) {
+  size_t dim = 0;
+  if (!can_use_parallel_index_put(in, indices, values, out, &dim)) {
+    return index_put_out_impl(ctx, in, indices, values, accumulate, out);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx, check_index_args(in, indices, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  if (in.numel() == 0) {
+    return out;
+  }
+
+  const Tensor& index = indices[dim].value();
+  static constexpr auto name = "index_put.out";
+
+  ET_SWITCH_TWO_TYPES(
+      Long, Int, index.scalar_type(), ctx, name, CTYPE_IX, [&]() {
+        ET_KERNEL_CHECK(
+            ctx,
+            check_index_bounds<CTYPE_IX>(index, in.size(dim)),
+            InvalidArgument, );
+
+        memcpy(
+            out.mutable_data_ptr<char>(),
+            in.const_data_ptr<char>(),
+            in.nbytes());
+
+        ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+          index_put_parallel<CTYPE, CTYPE_IX>(
+              index, values, accumulate, dim, out);
+        });
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
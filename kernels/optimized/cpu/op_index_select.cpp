@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/gather_scatter_util.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// `opt_index_select_out` copies the selected contiguous slices of the input
+// in parallel, one `memcpy` per {leading index, selected index} pair. Other
+// layouts are handled by the portable kernel.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+Tensor& opt_index_select_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    Tensor& out) {
+  if (in.dim() == 0 || !is_contiguous_tensor(in) ||
+      !is_contiguous_tensor(out)) {
+    return index_select_out_impl(ctx, in, dim, index, out);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx, check_index_select_args(in, dim, index, out), InvalidArgument, out);
+
+  if (dim < 0) {
+    dim += in.dim();
+  }
+
+  size_t expected_ndim = 0;
+  Tensor::SizesType expected_size[kTensorDimensionLimit];
+  get_index_select_out_target_size(
+      in, dim, index, expected_size, &expected_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {expected_size, expected_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const int64_t leading_dims = getLeadingDims(in, dim);
+  const int64_t trailing_dims = getTrailingDims(in, dim);
+  const int64_t out_dim_length = out.size(dim);
+  const int64_t in_dim_length = in.size(dim);
+  if (leading_dims == 0 || trailing_dims == 0 || out_dim_length == 0) {
+    return out;
+  }
+
+  const size_t length_per_step = trailing_dims * in.element_size();
+  const char* const in_data = in.const_data_ptr<char>();
+  char* const out_data = out.mutable_data_ptr<char>();
+
+  ET_SWITCH_TWO_TYPES(
+      Long, Int, index.scalar_type(), ctx, "index_select.out", CTYPE, [&]() {
+        const CTYPE* const index_arr = index.const_data_ptr<CTYPE>();
+        ::executorch::extension::parallel_for(
+            0,
+            leading_dims * out_dim_length,
+            std::max<int64_t>(
+                1,
+                ::executorch::extension::internal::GRAIN_SIZE / trailing_dims),
+            [&](const auto begin, const auto end) {
+              for (int64_t step = begin; step < end; ++step) {
+                const int64_t i = step / out_dim_length;
+                const int64_t j = step % out_dim_length;
+                memcpy(
+                    out_data + step * length_per_step,
+                    in_data +
+                        (i * in_dim_length + index_arr[j]) * length_per_step,
+                    length_per_step);
+              }
+            });
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
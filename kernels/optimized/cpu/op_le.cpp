@@ -45,8 +45,8 @@ Tensor& opt_le_tensor_out(
   // Check for optimized broadcast paths
   auto selected_optimized_path = select_optimized_path(a, b, out);
   if (selected_optimized_path == ElementwiseOptimizedPath::kTreatAs1d) {
-    ET_SWITCH_REALB_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
-      using Vec = at::vec::Vectorized<CTYPE>;
+    ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
+      using Vec = at::vec::Vectorized<executorch::vec::vec_compute_t<CTYPE>>;
       at::vec::map2<CTYPE>(
           [](Vec x, Vec y) { return x.le(y); },
           out.mutable_data_ptr<CTYPE>(),
@@ -56,7 +56,7 @@ Tensor& opt_le_tensor_out(
     });
   } else if (selected_optimized_path != ElementwiseOptimizedPath::kNone) {
     // Handle optimized broadcast cases
-    ET_SWITCH_REALB_TYPES(out_type, ctx, op_name, CTYPE, [&]() {
+    ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, op_name, CTYPE, [&]() {
       auto le_lambda = [](auto x, auto y) { return x.le(y); };
       torch::executor::handle_broadcast_elementwise<CTYPE>(
           ctx, le_lambda, a, b, out, selected_optimized_path);
@@ -87,14 +87,14 @@ Tensor& opt_le_scalar_out(
   // @lint-ignore CLANGTIDY facebook-hte-CArray
   static constexpr const char op_name[] = "le.Scalar_out";
 
-  if (a_type == common_type && a_type == out_type &&
-      a_type != ScalarType::Half && a_type != ScalarType::BFloat16) {
-    ET_SWITCH_REALB_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
+  if (a_type == common_type && a_type == out_type) {
+    ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
       ET_SWITCH_REALB_TYPES(b_type, ctx, op_name, CTYPE_B, [&]() {
+        using CTYPE_VEC = executorch::vec::vec_compute_t<CTYPE>;
         CTYPE_B b_val = 0;
         ET_EXTRACT_SCALAR(b, b_val);
-        CTYPE b_casted = static_cast<CTYPE>(b_val);
-        using Vec = at::vec::Vectorized<CTYPE>;
+        CTYPE_VEC b_casted = static_cast<CTYPE_VEC>(b_val);
+        using Vec = at::vec::Vectorized<CTYPE_VEC>;
         at::vec::map<CTYPE>(
             [b_casted](Vec x) { return x.le(Vec(b_casted)); },
             out.mutable_data_ptr<CTYPE>(),
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <tuple>
+
+#include <executorch/kernels/optimized/cpu/channels_last_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// `opt_max_pool2d_with_indices_out` pools channels last (NHWC) tensors
+// directly: each output pixel compares whole contiguous channel rows of its
+// window, rather than walking the window once per channel with strided reads.
+// Contiguous (NCHW) tensors are pooled one {H, W} plane at a time, in parallel
+// over planes, with each kernel position compared across a whole output row.
+// Other dim orders are handled by the portable kernel.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
+
+namespace {
+
+// Matches the portable kernel: the first in-bounds element of the window
+// initializes the result, which later elements only replace if they compare
+// greater, and indices are flattened {H, W} offsets.
+template <typename CTYPE>
+void max_pool2d_channels_last(
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    Tensor& out,
+    Tensor& indices) {
+  const int64_t N = in.size(0);
+  const int64_t C = in.size(1);
+  const int64_t H = in.size(2);
+  const int64_t W = in.size(3);
+  const int64_t OH = out.size(2);
+  const int64_t OW = out.size(3);
+
+  const int64_t k_H = val_at(kernel_size, 0);
+  const int64_t k_W = val_at(kernel_size, 1);
+  const int64_t s_H = val_at(stride, 0, /*default_value=*/k_H);
+  const int64_t s_W = val_at(stride, 1, /*default_value=*/k_W);
+  const int64_t p_H = val_at(padding, 0, /*default_value=*/0);
+  const int64_t p_W = val_at(padding, 1, /*default_value=*/0);
+  const int64_t d_H = val_at(dilation, 0, /*default_value=*/1);
+  const int64_t d_W = val_at(dilation, 1, /*default_value=*/1);
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  int64_t* const indices_data = indices.mutable_data_ptr<int64_t>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      N * OH * OW,
+      channels_last_grain_size(C * k_H * k_W),
+      [&](const auto begin, const auto end) {
+        for (int64_t pixel = begin; pixel < end; ++pixel) {
+          const int64_t n = pixel / (OH * OW);
+          const int64_t oh = (pixel / OW) % OH;
+          const int64_t ow = pixel % OW;
+          CTYPE* const out_row = out_data + pixel * C;
+          int64_t* const indices_row = indices_data + pixel * C;
+
+          bool initialized = false;
+          for (int64_t kh = 0; kh < k_H; ++kh) {
+            const int64_t ih = oh * s_H - p_H + kh * d_H;
+            if (ih < 0 || ih >= H) {
+              continue;
+            }
+            for (int64_t kw = 0; kw < k_W; ++kw) {
+              const int64_t iw = ow * s_W - p_W + kw * d_W;
+              if (iw < 0 || iw >= W) {
+                continue;
+              }
+              const CTYPE* const in_row = in_data + ((n * H + ih) * W + iw) * C;
+              const int64_t idx = ih * W + iw;
+              if (!initialized) {
+                std::copy(in_row, in_row + C, out_row);
+                std::fill(indices_row, indices_row + C, idx);
+                initialized = true;
+                continue;
+              }
+              for (int64_t c = 0; c < C; ++c) {
+                if (in_row[c] > out_row[c]) {
+                  out_row[c] = in_row[c];
+                  indices_row[c] = idx;
+                }
+              }
+            }
+          }
+        }
+      });
+}
+
+// Matches the portable kernel in the same way as max_pool2d_channels_last().
+// Each output element is first set to its own first in-bounds window element,
+// and then every kernel position, in window order, is compared across the
+// output row's columns whose window holds it in bounds. Comparing the first
+// element against itself again doesn't change the result.
+template <typename CTYPE>
+void max_pool2d_contiguous(
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    Tensor& out,
+    Tensor& indices) {
+  const int64_t H = in.size(in.dim() - 2);
+  const int64_t W = in.size(in.dim() - 1);
+  const int64_t OH = out.size(out.dim() - 2);
+  const int64_t OW = out.size(out.dim() - 1);
+  const int64_t planes = getLeadingDims(out, out.dim() - 2);
+
+  const int64_t k_H = val_at(kernel_size, 0);
+  const int64_t k_W = val_at(kernel_size, 1);
+  const int64_t s_H = val_at(stride, 0, /*default_value=*/k_H);
+  const int64_t s_W = val_at(stride, 1, /*default_value=*/k_W);
+  const int64_t p_H = val_at(padding, 0, /*default_value=*/0);
+  const int64_t p_W = val_at(padding, 1, /*default_value=*/0);
+  const int64_t d_H = val_at(dilation, 0, /*default_value=*/1);
+  const int64_t d_W = val_at(dilation, 1, /*default_value=*/1);
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  int64_t* const indices_data = indices.mutable_data_ptr<int64_t>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      planes,
+      channels_last_grain_size(OH * OW * k_H * k_W),
+      [&](const auto begin, const auto end) {
+        for (int64_t plane = begin; plane < end; ++plane) {
+          const CTYPE* const in_plane = in_data + plane * H * W;
+          for (int64_t oh = 0; oh < OH; ++oh) {
+            CTYPE* const out_row = out_data + (plane * OH + oh) * OW;
+            int64_t* const indices_row = indices_data + (plane * OH + oh) * OW;
+
+            int64_t kh_first = 0;
+            while (kh_first < k_H) {
+              const int64_t ih = oh * s_H - p_H + kh_first * d_H;
+              if (ih >= 0 && ih < H) {
+                break;
+              }
+              ++kh_first;
+            }
+            if (kh_first == k_H) {
+              continue;
+            }
+
+            const int64_t ih_first = oh * s_H - p_H + kh_first * d_H;
+            for (int64_t ow = 0; ow < OW; ++ow) {
+              for (int64_t kw = 0; kw < k_W; ++kw) {
+                const int64_t iw = ow * s_W - p_W + kw * d_W;
+                if (iw >= 0 && iw < W) {
+                  out_row[ow] = in_plane[ih_first * W + iw];
+                  indices_row[ow] = ih_first * W + iw;
+                  break;
+                }
+              }
+            }
+
+            for (int64_t kh = kh_first; kh < k_H; ++kh) {
+              const int64_t ih = oh * s_H - p_H + kh * d_H;
+              if (ih < 0 || ih >= H) {
+                continue;
+              }
+              const CTYPE* const in_row = in_plane + ih * W;
+              for (int64_t kw = 0; kw < k_W; ++kw) {
+                int64_t ow_end = 0;
+                const int64_t ow_begin = window_offset_valid_range(
+                    kw * d_W, s_W, p_W, W, OW, &ow_end);
+                const int64_t iw_offset = kw * d_W - p_W;
+                for (int64_t ow = ow_begin; ow < ow_end; ++ow) {
+                  const int64_t iw = ow * s_W + iw_offset;
+                  if (in_row[iw] > out_row[ow]) {
+                    out_row[ow] = in_row[iw];
+                    indices_row[ow] = ih * W + iw;
+                  }
+                }
+              }
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+// max_pool2d_with_indices.out(Tensor self, int[2] kernel_size,
+// int[2] stride=[], int[2] padding=0, int[2] dilation=1,
+// bool ceil_mode=False, *, Tensor(a!) out, Tensor(b!) indices)
+// -> (Tensor(a!), Tensor(b!))
+std::tuple<Tensor&, Tensor&> opt_max_pool2d_with_indices_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode,
+    Tensor& out,
+    Tensor& indices) {
+  const bool channels_last = is_channels_last_4d(in) &&
+      is_channels_last_4d(out) && is_channels_last_4d(indices);
+  const bool contiguous = is_contiguous_tensor(in) &&
+      is_contiguous_tensor(out) && is_contiguous_tensor(indices);
+  if (!channels_last && !contiguous) {
+    return max_pool2d_with_indices_out_impl(
+        ctx,
+        in,
+        kernel_size,
+        stride,
+        padding,
+        dilation,
+        ceil_mode,
+        out,
+        indices);
+  }
+
+  std::tuple<Tensor&, Tensor&> ret_val(out, indices);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_max_pool2d_with_indices_args(
+          in, kernel_size, stride, padding, dilation, ceil_mode, out, indices),
+      InvalidArgument,
+      ret_val);
+
+  size_t output_ndim = 0;
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_max_pool2d_with_indices_out_target_size(
+      in,
+      kernel_size,
+      stride,
+      padding,
+      dilation,
+      ceil_mode,
+      output_sizes,
+      &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, 2),
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(indices, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_SWITCH_REALHBF16_TYPES(
+      in.scalar_type(), ctx, "max_pool2d_with_indices.out", CTYPE, [&]() {
+        if (channels_last) {
+          max_pool2d_channels_last<CTYPE>(
+              in, kernel_size, stride, padding, dilation, out, indices);
+        } else {
+          max_pool2d_contiguous<CTYPE>(
+              in, kernel_size, stride, padding, dilation, out, indices);
+        }
+      });
+
+  return ret_val;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -47,20 +47,17 @@ Tensor& opt_mul_out(
   static constexpr const char op_name[] = "mul.out";
 
   if (b.numel() == 1) {
-    if (a_type == b_type && a_type == out_type && a_type != ScalarType::Half &&
-        a_type != ScalarType::BFloat16) {
-      ET_SWITCH_REALB_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
-        ET_SWITCH_REALB_TYPES(b_type, ctx, op_name, CTYPE_B, [&]() {
-          CTYPE_B b_val = *b.const_data_ptr<CTYPE_B>();
-          CTYPE b_casted = static_cast<CTYPE>(b_val);
-
-          using Vec = at::vec::Vectorized<CTYPE>;
-          at::vec::map<CTYPE>(
-              [b_casted](Vec x) { return x * Vec(b_casted); },
-              out.mutable_data_ptr<CTYPE>(),
-              a.const_data_ptr<CTYPE>(),
-              out.numel());
-        });
+    if (a_type == b_type && a_type == out_type) {
+      ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
+        using CTYPE_VEC = executorch::vec::vec_compute_t<CTYPE>;
+        CTYPE_VEC b_casted = static_cast<CTYPE_VEC>(*b.const_data_ptr<CTYPE>());
+
+        using Vec = at::vec::Vectorized<CTYPE_VEC>;
+        at::vec::map<CTYPE>(
+            [b_casted](Vec x) { return x * Vec(b_casted); },
+            out.mutable_data_ptr<CTYPE>(),
+            a.const_data_ptr<CTYPE>(),
+            out.numel());
       });
       return out;
     }
@@ -84,8 +81,8 @@ Tensor& opt_mul_out(
             out.numel());
       });
     } else {
-      ET_SWITCH_REALB_TYPES(out_type, ctx, op_name, CTYPE, [&]() {
-        using Vec = at::vec::Vectorized<CTYPE>;
+      ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, op_name, CTYPE, [&]() {
+        using Vec = at::vec::Vectorized<executorch::vec::vec_compute_t<CTYPE>>;
         at::vec::map2<CTYPE>(
             [](Vec x, Vec y) { return x * y; },
             out.mutable_data_ptr<CTYPE>(),
@@ -105,7 +102,7 @@ Tensor& opt_mul_out(
             ctx, mul_lambda, a, b, out, selected_optimized_path);
       });
     } else {
-      ET_SWITCH_REALB_TYPES(out_type, ctx, op_name, CTYPE, [&]() {
+      ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, op_name, CTYPE, [&]() {
         auto mul_lambda = [](auto x, auto y) { return x * y; };
         torch::executor::handle_broadcast_elementwise<CTYPE>(
             ctx, mul_lambda, a, b, out, selected_optimized_path);
@@ -167,12 +164,12 @@ Tensor& opt_mul_scalar_out(
   // @lint-ignore CLANGTIDY facebook-hte-CArray
   static constexpr const char op_name[] = "mul.Scalar_out";
 
-  if (a_type == common_type && a_type == out_type &&
-      a_type != ScalarType::Half && a_type != ScalarType::BFloat16) {
-    ET_SWITCH_REALB_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
-      CTYPE b_casted = utils::scalar_to<CTYPE>(b);
+  if (a_type == common_type && a_type == out_type) {
+    ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
+      using CTYPE_VEC = executorch::vec::vec_compute_t<CTYPE>;
+      CTYPE_VEC b_casted = utils::scalar_to<CTYPE_VEC>(b);
 
-      using Vec = at::vec::Vectorized<CTYPE>;
+      using Vec = at::vec::Vectorized<CTYPE_VEC>;
       at::vec::map<CTYPE>(
           [b_casted](Vec x) { return x * Vec(b_casted); },
           out.mutable_data_ptr<CTYPE>(),
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <type_traits>
+
+#include <ATen/cpu/vec/vec.h>
+#include <executorch/kernels/optimized/cpu/channels_last_util.h>
+#include <executorch/kernels/portable/cpu/util/normalization_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// `opt_native_batch_norm_legit_no_training_out` normalizes channels last
+// (NHWC) tensors directly. Inference batch norm is a per-channel scale and
+// shift, which is applied along each contiguous row of channels. Other dim
+// orders are handled by the portable kernel.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+// Number of channels whose scale and shift are computed at a time.
+constexpr int64_t kChannelBlock = 256;
+
+// Double inputs are normalized in double, and all others in float.
+template <typename CTYPE>
+using acc_type =
+    std::conditional_t<std::is_same_v<CTYPE, double>, double, float>;
+
+// y[c] = x[c] * scale[c] + shift[c] for c in [0, size).
+template <typename CTYPE>
+void apply_scale_shift(
+    const CTYPE* x,
+    CTYPE* y,
+    const acc_type<CTYPE>* scale,
+    const acc_type<CTYPE>* shift,
+    int64_t size) {
+  using ACC = acc_type<CTYPE>;
+  int64_t c = 0;
+  if constexpr (std::is_same_v<CTYPE, float>) {
+    using Vec = at::vec::Vectorized<float>;
+    for (; c + Vec::size() <= size; c += Vec::size()) {
+      at::vec::fmadd(
+          Vec::loadu(x + c), Vec::loadu(scale + c), Vec::loadu(shift + c))
+          .store(y + c);
+    }
+  }
+  for (; c < size; ++c) {
+    y[c] = static_cast<CTYPE>(static_cast<ACC>(x[c]) * scale[c] + shift[c]);
+  }
+}
+
+template <typename CTYPE>
+void batch_norm_channels_last(
+    const Tensor& in,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    const Tensor& running_mean,
+    const Tensor& running_var,
+    double eps,
+    Tensor& out) {
+  using ACC = acc_type<CTYPE>;
+  const int64_t C = in.size(1);
+  const int64_t num_pixels = in.size(0) * in.size(2) * in.size(3);
+  if (C == 0 || num_pixels == 0) {
+    return;
+  }
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  const CTYPE* const mean_data = running_mean.const_data_ptr<CTYPE>();
+  const CTYPE* const var_data = running_var.const_data_ptr<CTYPE>();
+  const CTYPE* const weight_data =
+      weight.has_value() ? weight.value().const_data_ptr<CTYPE>() : nullptr;
+  const CTYPE* const bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE>() : nullptr;
+
+  ::executorch::extension::parallel_for(
+      0,
+      num_pixels,
+      channels_last_grain_size(C),
+      [&](const auto begin, const auto end) {
+        ACC scale[kChannelBlock];
+        ACC shift[kChannelBlock];
+        for (int64_t c0 = 0; c0 < C; c0 += kChannelBlock) {
+          const int64_t block = std::min(kChannelBlock, C - c0);
+          for (int64_t i = 0; i < block; ++i) {
+            const int64_t c = c0 + i;
+            const ACC invstd = static_cast<ACC>(
+                1.0 / std::sqrt(static_cast<double>(var_data[c]) + eps));
+            scale[i] = weight_data == nullptr
+                ? invstd
+                : invstd * static_cast<ACC>(weight_data[c]);
+            const ACC bias_val =
+                bias_data == nullptr ? ACC(0) : static_cast<ACC>(bias_data[c]);
+            shift[i] = bias_val - static_cast<ACC>(mean_data[c]) * scale[i];
+          }
+          for (int64_t pixel = begin; pixel < end; ++pixel) {
+            apply_scale_shift(
+                in_data + pixel * C + c0,
+                out_data + pixel * C + c0,
+                scale,
+                shift,
+                block);
+          }
+        }
+      });
+}
+
+} // namespace
+
+// _native_batch_norm_legit_no_training.out(Tensor input, Tensor? weight,
+// Tensor? bias, Tensor running_mean, Tensor running_var, float momentum,
+// float eps, *, Tensor(a!) out0, Tensor(b!) out1, Tensor(c!) out2)
+// -> (Tensor(a!), Tensor(b!), Tensor(c!))
+std::tuple<Tensor&, Tensor&, Tensor&>
+opt_native_batch_norm_legit_no_training_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    const Tensor& running_mean,
+    const Tensor& running_var,
+    double momentum,
+    double eps,
+    Tensor& out,
+    Tensor& mean_out,
+    Tensor& invstd_out) {
+  if (!is_channels_last_4d(in) || !is_channels_last_4d(out)) {
+    return _native_batch_norm_legit_no_training_out_impl(
+        ctx,
+        in,
+        weight,
+        bias,
+        running_mean,
+        running_var,
+        momentum,
+        eps,
+        out,
+        mean_out,
+        invstd_out);
+  }
+
+  std::tuple<Tensor&, Tensor&, Tensor&> ret_val(out, mean_out, invstd_out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, in.sizes()) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(mean_out, {0}) == Error::Ok, InvalidArgument, ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(invstd_out, {0}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_batch_norm_args(
+          in,
+          weight,
+          bias,
+          running_mean,
+          running_var,
+          momentum,
+          eps,
+          out,
+          mean_out,
+          invstd_out),
+      InvalidArgument,
+      ret_val);
+
+  static constexpr auto name = "native_batch_norm_legit_no_training.out";
+
+  ET_SWITCH_FLOATHBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&] {
+    batch_norm_channels_last<CTYPE>(
+        in, weight, bias, running_mean, running_var, eps, out);
+  });
+
+  return ret_val;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <executorch/kernels/optimized/cpu/channels_last_util.h>
+#include <executorch/kernels/portable/cpu/util/normalization_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// `opt_native_group_norm_out` normalizes channels last (NHWC) tensors
+// directly. A first pass computes the statistics of each {batch, group} from
+// the group's slice of every channel row, and a second pass normalizes whole
+// channel rows. Other dim orders are handled by the portable kernel.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+// Double inputs are normalized in double, and all others in float.
+template <typename CTYPE>
+using acc_type =
+    std::conditional_t<std::is_same_v<CTYPE, double>, double, float>;
+
+// Adds the sum and the sum of squares of x[0, size) to sum and sq_sum.
+template <typename CTYPE>
+void accumulate_moments(
+    const CTYPE* x,
+    int64_t size,
+    double& sum,
+    double& sq_sum) {
+  int64_t i = 0;
+  if constexpr (std::is_same_v<CTYPE, float>) {
+    using Vec = at::vec::Vectorized<float>;
+    if (size >= Vec::size()) {
+      Vec sum_vec(0.0f);
+      Vec sq_sum_vec(0.0f);
+      for (; i + Vec::size() <= size; i += Vec::size()) {
+        const Vec v = Vec::loadu(x + i);
+        sum_vec = sum_vec + v;
+        sq_sum_vec = at::vec::fmadd(v, v, sq_sum_vec);
+      }
+      sum += at::vec::vec_reduce_all<float>(std::plus<Vec>(), sum_vec);
+      sq_sum += at::vec::vec_reduce_all<float>(std::plus<Vec>(), sq_sum_vec);
+    }
+  }
+  for (; i < size; ++i) {
+    const double v = static_cast<double>(x[i]);
+    sum += v;
+    sq_sum += v * v;
+  }
+}
+
+// Normalizes the `size` channels of one group in one channel row.
+template <typename CTYPE>
+void normalize_group(
+    const CTYPE* x,
+    CTYPE* y,
+    const CTYPE* weight,
+    const CTYPE* bias,
+    acc_type<CTYPE> mean,
+    acc_type<CTYPE> rstd,
+    int64_t size) {
+  using ACC = acc_type<CTYPE>;
+  int64_t i = 0;
+  if constexpr (std::is_same_v<CTYPE, float>) {
+    using Vec = at::vec::Vectorized<float>;
+    const Vec mean_vec(mean);
+    const Vec rstd_vec(rstd);
+    for (; i + Vec::size() <= size; i += Vec::size()) {
+      Vec v = (Vec::loadu(x + i) - mean_vec) * rstd_vec;
+      if (weight != nullptr) {
+        v = v * Vec::loadu(weight + i);
+      }
+      if (bias != nullptr) {
+        v = v + Vec::loadu(bias + i);
+      }
+      v.store(y + i);
+    }
+  }
+  for (; i < size; ++i) {
+    ACC v = (static_cast<ACC>(x[i]) - mean) * rstd;
+    if (weight != nullptr) {
+      v *= static_cast<ACC>(weight[i]);
+    }
+    if (bias != nullptr) {
+      v += static_cast<ACC>(bias[i]);
+    }
+    y[i] = static_cast<CTYPE>(v);
+  }
+}
+
+template <typename CTYPE>
+void group_norm_channels_last(
+    const Tensor& input,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t G,
+    double eps,
+    Tensor& out,
+    Tensor& mean,
+    Tensor& rstd) {
+  using ACC = acc_type<CTYPE>;
+  const int64_t D = C / G;
+  if (N * G == 0) {
+    return;
+  }
+
+  CTYPE* const mean_data = mean.mutable_data_ptr<CTYPE>();
+  CTYPE* const rstd_data = rstd.mutable_data_ptr<CTYPE>();
+  if (HxW * D == 0) {
+    std::fill(mean_data, mean_data + N * G, static_cast<CTYPE>(0));
+    std::fill(rstd_data, rstd_data + N * G, static_cast<CTYPE>(NAN));
+    return;
+  }
+
+  const CTYPE* const in_data = input.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  const CTYPE* const weight_data =
+      weight.has_value() ? weight.value().const_data_ptr<CTYPE>() : nullptr;
+  const CTYPE* const bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE>() : nullptr;
+
+  ::executorch::extension::parallel_for(
+      0,
+      N * G,
+      channels_last_grain_size(HxW * D),
+      [&](const auto begin, const auto end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const CTYPE* const x = in_data + (i / G) * HxW * C + (i % G) * D;
+          double sum = 0;
+          double sq_sum = 0;
+          for (int64_t p = 0; p < HxW; ++p) {
+            accumulate_moments(x + p * C, D, sum, sq_sum);
+          }
+          const double count = static_cast<double>(HxW * D);
+          const double mean_value = sum / count;
+          const double variance =
+              std::max(sq_sum / count - mean_value * mean_value, 0.0);
+          mean_data[i] = static_cast<CTYPE>(mean_value);
+          rstd_data[i] = static_cast<CTYPE>(1.0 / std::sqrt(variance + eps));
+        }
+      });
+
+  ::executorch::extension::parallel_for(
+      0,
+      N * HxW,
+      channels_last_grain_size(C),
+      [&](const auto begin, const auto end) {
+        for (int64_t pixel = begin; pixel < end; ++pixel) {
+          const int64_t n = pixel / HxW;
+          for (int64_t g = 0; g < G; ++g) {
+            const int64_t c = g * D;
+            normalize_group(
+                in_data + pixel * C + c,
+                out_data + pixel * C + c,
+                weight_data == nullptr ? nullptr : weight_data + c,
+                bias_data == nullptr ? nullptr : bias_data + c,
+                static_cast<ACC>(mean_data[n * G + g]),
+                static_cast<ACC>(rstd_data[n * G + g]),
+                D);
+          }
+        }
+      });
+}
+
+} // namespace
+
+// native_group_norm.out(Tensor input, Tensor? weight, Tensor? bias, SymInt N,
+// SymInt C, SymInt HxW, int group, float eps, *, Tensor(a!) out0,
+// Tensor(b!) out1, Tensor(c!) out2) -> (Tensor(a!), Tensor(b!), Tensor(c!))
+std::tuple<Tensor&, Tensor&, Tensor&> opt_native_group_norm_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps,
+    Tensor& out,
+    Tensor& mean_out,
+    Tensor& rstd_out) {
+  if (!is_channels_last_4d(input) || !is_channels_last_4d(out)) {
+    return native_group_norm_out_impl(
+        ctx,
+        input,
+        weight,
+        bias,
+        N,
+        C,
+        HxW,
+        group,
+        eps,
+        out,
+        mean_out,
+        rstd_out);
+  }
+
+  std::tuple<Tensor&, Tensor&, Tensor&> ret_val(out, mean_out, rstd_out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_group_norm_args(
+          input, weight, bias, N, C, HxW, group, out, mean_out, rstd_out),
+      InvalidArgument,
+      ret_val);
+
+  Tensor::SizesType mean_rstd_sizes[kTensorDimensionLimit];
+  mean_rstd_sizes[0] = N;
+  mean_rstd_sizes[1] = group;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(mean_out, {mean_rstd_sizes, 2}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(rstd_out, {mean_rstd_sizes, 2}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      tensor_is_default_dim_order(mean_out) &&
+          tensor_is_default_dim_order(rstd_out),
+      InvalidArgument,
+      ret_val);
+
+  static constexpr auto name = "native_group_norm.out";
+
+  ET_SWITCH_FLOATHBF16_TYPES(input.scalar_type(), ctx, name, CTYPE, [&]() {
+    group_norm_channels_last<CTYPE>(
+        input,
+        weight,
+        bias,
+        N,
+        C,
+        HxW,
+        group,
+        eps,
+        out,
+        mean_out,
+        rstd_out);
+  });
+
+  return ret_val;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -29,10 +29,11 @@ void layer_norm(
     IntArrayRef normalized_shape,
     const optional<Tensor>& weight,
     const optional<Tensor>& bias,
-    CTYPE eps,
+    acc_t<CTYPE> eps,
     Tensor& out,
     Tensor& mean,
     Tensor& rstd) {
+  using ACC = acc_t<CTYPE>;
   const size_t dim = input.dim() - normalized_shape.size();
   const size_t dim_size = input.size(dim);
 
@@ -76,19 +77,22 @@ void layer_norm(
     const CTYPE* src_ptr = input_data + i * N;
     CTYPE* dst_ptr = out_data + i * N;
 
-    CTYPE mean_val;
-    CTYPE rstd_val;
+    ACC mean_val;
+    ACC rstd_val;
     std::tie(mean_val, rstd_val) = RowwiseMoments(src_ptr, N);
-    rstd_val = CTYPE(1) / std::sqrt(rstd_val + eps);
+    rstd_val = ACC(1) / std::sqrt(rstd_val + eps);
 
-    const CTYPE scale = rstd_val;
-    const CTYPE offset = -rstd_val * mean_val;
+    const ACC scale = rstd_val;
+    const ACC offset = -rstd_val * mean_val;
 
     if (gamma_null || beta_null) {
       for (size_t j = 0; j < N; ++j) {
-        const CTYPE gamma_v = gamma_null ? CTYPE(1) : gamma_data[j];
-        const CTYPE beta_v = beta_null ? CTYPE(0) : beta_data[j];
-        dst_ptr[j] = (src_ptr[j] * scale + offset) * gamma_v + beta_v;
+        const ACC gamma_v =
+            gamma_null ? ACC(1) : static_cast<ACC>(gamma_data[j]);
+        const ACC beta_v = beta_null ? ACC(0) : static_cast<ACC>(beta_data[j]);
+        dst_ptr[j] = static_cast<CTYPE>(
+            (static_cast<ACC>(src_ptr[j]) * scale + offset) * gamma_v +
+            beta_v);
       }
     } else {
       at::vec::map3<CTYPE>(
@@ -103,8 +107,8 @@ void layer_norm(
           N);
     }
 
-    mean_data[i] = mean_val;
-    rstd_data[i] = rstd_val;
+    mean_data[i] = static_cast<CTYPE>(mean_val);
+    rstd_data[i] = static_cast<CTYPE>(rstd_val);
   }
 }
 
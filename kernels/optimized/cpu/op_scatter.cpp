@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/gather_scatter_util.h>
+#include <executorch/kernels/portable/cpu/scalar_utils.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// `opt_scatter_src_out` and `opt_scatter_value_out` scatter into contiguous
+// tensors in parallel over the index's columns along `dim`. All the writes to
+// a given output element come from the same column, which a single thread
+// walks in index order, so when an index repeats, the last write wins just as
+// in the portable kernels. Other layouts are handled by the portable kernels.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+
+namespace {
+
+bool can_use_parallel_scatter(
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& out) {
+  if (in.dim() == 0 || dim < -in.dim() || dim >= in.dim()) {
+    return false;
+  }
+  if (dim < 0) {
+    dim += in.dim();
+  }
+  return index.scalar_type() == ScalarType::Long && out.dim() == in.dim() &&
+      is_contiguous_tensor(in) && is_contiguous_tensor(index) &&
+      is_contiguous_tensor(out) && has_index_trailing_sizes(index, in, dim);
+}
+
+// Scatters the elements of `src` or, if it is null, `value` into `out`,
+// which already holds a copy of the input.
+template <typename CTYPE>
+void scatter_parallel(
+    int64_t dim,
+    const Tensor& index,
+    const Tensor* src,
+    const CTYPE value,
+    Tensor& out) {
+  const int64_t* const index_data = index.const_data_ptr<int64_t>();
+  const CTYPE* const src_data =
+      src == nullptr ? nullptr : src->const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t size = index.size(dim);
+  const int64_t inner = getTrailingDims(index, dim);
+  parallel_for_index_columns(
+      getLeadingDims(index, dim),
+      size,
+      inner,
+      [&](const int64_t o, const int64_t i_begin, const int64_t i_end) {
+        const int64_t* const index_slice = index_data + o * size * inner;
+        CTYPE* const out_slice =
+            out_data + index_leading_offset(index, out, dim, o);
+        if (src_data != nullptr) {
+          const CTYPE* const src_slice =
+              src_data + index_leading_offset(index, *src, dim, o);
+          for (int64_t k = 0; k < size; ++k) {
+            for (int64_t i = i_begin; i < i_end; ++i) {
+              const int64_t ix = k * inner + i;
+              out_slice[index_slice[ix] * inner + i] = src_slice[ix];
+            }
+          }
+        } else {
+          for (int64_t k = 0; k < size; ++k) {
+            for (int64_t i = i_begin; i < i_end; ++i) {
+              const int64_t ix = k * inner + i;
+              out_slice[index_slice[ix] * inner + i] = value;
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_scatter_src_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& src,
+    Tensor& out) {
+  if (!can_use_parallel_scatter(in, dim, index, out) ||
+      !is_contiguous_tensor(src)) {
+    return scatter_src_out_impl(ctx, in, dim, index, src, out);
+  }
+  const int64_t norm_dim = dim < 0 ? dim + in.dim() : dim;
+  if (!has_index_trailing_sizes(index, src, norm_dim)) {
+    return scatter_src_out_impl(ctx, in, dim, index, src, out);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_scatter_src_args(in, dim, index, src, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  static constexpr auto name = "scatter.src_out";
+
+  ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    memcpy(
+        out.mutable_data_ptr<CTYPE>(), in.const_data_ptr<CTYPE>(), in.nbytes());
+    scatter_parallel<CTYPE>(norm_dim, index, &src, CTYPE(), out);
+  });
+
+  return out;
+}
+
+Tensor& opt_scatter_value_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    const Scalar& value,
+    Tensor& out) {
+  if (!can_use_parallel_scatter(in, dim, index, out)) {
+    return scatter_value_out_impl(ctx, in, dim, index, value, out);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_scatter_value_args(in, dim, index, value, out),
+      InvalidArgument,
+      out);
+
+  if (dim < 0) {
+    dim += in.dim();
+  }
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  static constexpr auto name = "scatter.value_out";
+
+  ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    auto opt_val = utils::internal::check_overflow_scalar_cast<CTYPE>(value);
+    ET_KERNEL_CHECK(ctx, opt_val.has_value(), InvalidArgument, );
+    const CTYPE val = opt_val.value();
+    memcpy(
+        out.mutable_data_ptr<CTYPE>(), in.const_data_ptr<CTYPE>(), in.nbytes());
+    scatter_parallel<CTYPE>(dim, index, nullptr, val, out);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
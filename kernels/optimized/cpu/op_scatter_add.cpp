@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/gather_scatter_util.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// `opt_scatter_add_out` scatters contiguous tensors in parallel over the
+// index's columns along `dim`. All the elements that add into a given output
+// element belong to the same column, which is accumulated in index order by a
+// single thread, so no atomics are needed and results match the portable
+// kernel bit for bit. Other layouts are handled by the portable kernel.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+
+namespace {
+
+bool can_use_parallel_scatter_add(
+    const Tensor& self,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& src,
+    const Tensor& out) {
+  if (self.dim() == 0 || dim < -self.dim() || dim >= self.dim()) {
+    return false;
+  }
+  if (dim < 0) {
+    dim += self.dim();
+  }
+  return index.scalar_type() == ScalarType::Long && out.dim() == self.dim() &&
+      is_contiguous_tensor(self) && is_contiguous_tensor(index) &&
+      is_contiguous_tensor(src) && is_contiguous_tensor(out) &&
+      has_index_trailing_sizes(index, self, dim) &&
+      has_index_trailing_sizes(index, src, dim);
+}
+
+template <typename CTYPE>
+void scatter_add_parallel(
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& src,
+    Tensor& out) {
+  const int64_t* const index_data = index.const_data_ptr<int64_t>();
+  const CTYPE* const src_data = src.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t size = index.size(dim);
+  const int64_t inner = getTrailingDims(index, dim);
+  parallel_for_index_columns(
+      getLeadingDims(index, dim),
+      size,
+      inner,
+      [&](const int64_t o, const int64_t i_begin, const int64_t i_end) {
+        const int64_t* const index_slice = index_data + o * size * inner;
+        const CTYPE* const src_slice =
+            src_data + index_leading_offset(index, src, dim, o);
+        CTYPE* const out_slice =
+            out_data + index_leading_offset(index, out, dim, o);
+        for (int64_t k = 0; k < size; ++k) {
+          for (int64_t i = i_begin; i < i_end; ++i) {
+            const int64_t ix = k * inner + i;
+            out_slice[index_slice[ix] * inner + i] += src_slice[ix];
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_scatter_add_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& self,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& src,
+    Tensor& out) {
+  if (!can_use_parallel_scatter_add(self, dim, index, src, out)) {
+    return scatter_add_out_impl(ctx, self, dim, index, src, out);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_scatter_add_args(self, dim, index, src, out),
+      InvalidArgument,
+      out);
+
+  if (dim < 0) {
+    dim += self.dim();
+  }
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, self.sizes()) == Error::Ok, InvalidArgument, out);
+
+  ET_SWITCH_REALHBBF16_TYPES(
+      self.scalar_type(), ctx, "scatter_add.out", CTYPE, [&]() {
+        memcpy(
+            out.mutable_data_ptr<CTYPE>(),
+            self.const_data_ptr<CTYPE>(),
+            self.nbytes());
+        scatter_add_parallel<CTYPE>(dim, index, src, out);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
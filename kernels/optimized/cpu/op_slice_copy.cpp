@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/strided_copy_util.h>
+#include <executorch/kernels/portable/cpu/util/slice_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+Tensor& opt_slice_copy_Tensor_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    std::optional<int64_t> start_val,
+    std::optional<int64_t> end_val,
+    int64_t step,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, check_slice_copy_args(in, dim, step, out), InvalidArgument, out);
+
+  if (dim < 0) {
+    dim += in.dim();
+  }
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  int64_t end = end_val.has_value() ? end_val.value() : in.size(dim);
+  int64_t start = start_val.has_value() ? start_val.value() : 0;
+  const int64_t length = adjust_slice_indices(in.size(dim), &start, &end, step);
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  Tensor::SizesType target_sizes[kTensorDimensionLimit];
+  size_t target_ndim = 0;
+  get_slice_copy_out_target_size(in, dim, length, target_sizes, &target_ndim);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {target_sizes, target_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  size_t outer = 1;
+  size_t inner = 1;
+  internal::collapse_around_dim(in, dim, &outer, &inner);
+  const size_t element_size = in.element_size();
+  const size_t in_row_size = in.size(dim) * inner;
+  const size_t out_row_size = length * inner;
+  const char* const in_data =
+      static_cast<const char*>(in.const_data_ptr()) +
+      start * inner * element_size;
+  char* const out_data = static_cast<char*>(out.mutable_data_ptr());
+
+  if (step == 1) {
+    // Each row of `in`, viewed as [outer, in.size(dim) * inner], contributes
+    // one contiguous run.
+    internal::parallel_strided_copy(
+        element_size, 1, [&](size_t, size_t) {
+          return internal::StridedCopy{
+              out_data,
+              out_row_size,
+              in_data,
+              in_row_size,
+              outer,
+              out_row_size};
+        });
+  } else {
+    // Each row gathers `length` runs of `inner` elements, `step` runs apart.
+    internal::parallel_strided_copy(
+        element_size, outer, [&](size_t i, size_t) {
+          return internal::StridedCopy{
+              out_data + i * out_row_size * element_size,
+              inner,
+              in_data + i * in_row_size * element_size,
+              step * inner,
+              static_cast<size_t>(length),
+              inner};
+        });
+  }
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
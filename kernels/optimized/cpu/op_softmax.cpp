@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// `_softmax_out` computes softmax with an online max/sum: a single pass over
+// the input tracks the running maximum and the sum of exponentials relative to
+// it, rescaling the sum whenever the maximum grows. A second pass writes the
+// normalized exponentials, so the input is read twice instead of three times.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+// Start from the lowest finite value rather than -inf, so that rescaling by
+// exp(old_max - new_max) never evaluates -inf - -inf for rows, or lanes, that
+// have only seen -inf so far.
+template <typename T>
+constexpr T kLowest = std::numeric_limits<T>::lowest();
+
+// Online max/sum of `size` elements, `stride` apart.
+template <typename CTYPE, typename ACC>
+void online_max_sum(
+    const CTYPE* in,
+    size_t size,
+    size_t stride,
+    ACC& max_out,
+    ACC& sum_out) {
+  ACC max_val = kLowest<ACC>;
+  ACC sum = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const ACC x = static_cast<ACC>(in[i * stride]);
+    if (x > max_val) {
+      sum = sum * std::exp(max_val - x) + 1;
+      max_val = x;
+    } else {
+      sum += std::exp(x - max_val);
+    }
+  }
+  max_out = max_val;
+  sum_out = sum;
+}
+
+// Softmax of `size` elements, `stride` apart.
+template <typename CTYPE>
+void softmax_strided(
+    const CTYPE* in,
+    CTYPE* out,
+    size_t size,
+    size_t stride) {
+  using ACC = std::conditional_t<std::is_same_v<CTYPE, double>, double, float>;
+  ACC max_val;
+  ACC sum;
+  online_max_sum(in, size, stride, max_val, sum);
+  const ACC inv_sum = ACC(1) / sum;
+  for (size_t i = 0; i < size; ++i) {
+    out[i * stride] = static_cast<CTYPE>(
+        std::exp(static_cast<ACC>(in[i * stride]) - max_val) * inv_sum);
+  }
+}
+
+// Softmax of a contiguous row. Each vector lane keeps its own running max and
+// sum, which are merged at the end of the pass.
+void softmax_lastdim_row(const float* in, float* out, int64_t size) {
+  using Vec = at::vec::Vectorized<float>;
+  constexpr int64_t kVecSize = Vec::size();
+
+  Vec max_vec(kLowest<float>);
+  Vec sum_vec(0.0f);
+  int64_t i = 0;
+  for (; i + kVecSize <= size; i += kVecSize) {
+    const Vec x = Vec::loadu(in + i);
+    const Vec new_max = at::vec::maximum(max_vec, x);
+    sum_vec = sum_vec * (max_vec - new_max).exp() + (x - new_max).exp();
+    max_vec = new_max;
+  }
+
+  float lane_max[kVecSize];
+  float lane_sum[kVecSize];
+  max_vec.store(lane_max);
+  sum_vec.store(lane_sum);
+  float max_val = kLowest<float>;
+  float sum = 0;
+  for (int64_t l = 0; l < kVecSize; ++l) {
+    max_val = std::max(max_val, lane_max[l]);
+  }
+  for (int64_t l = 0; l < kVecSize; ++l) {
+    sum += lane_sum[l] * std::exp(lane_max[l] - max_val);
+  }
+  float tail_max;
+  float tail_sum;
+  online_max_sum(in + i, size - i, 1, tail_max, tail_sum);
+  if (tail_max > max_val) {
+    sum = sum * std::exp(max_val - tail_max) + tail_sum;
+    max_val = tail_max;
+  } else {
+    sum += tail_sum * std::exp(tail_max - max_val);
+  }
+
+  const float inv_sum = 1.0f / sum;
+  at::vec::map(
+      [max_val, inv_sum](Vec x) {
+        return (x - Vec(max_val)).exp() * Vec(inv_sum);
+      },
+      out,
+      in,
+      size);
+}
+
+// Softmax over the middle dim of [outer, dim_size, inner], for `num_cols`
+// adjacent columns of the inner dim. Lanes map to columns, so there is nothing
+// to merge at the end.
+void softmax_inner_cols(
+    const float* in,
+    float* out,
+    int64_t dim_size,
+    int64_t inner_size,
+    int64_t num_cols) {
+  using Vec = at::vec::Vectorized<float>;
+  constexpr int64_t kVecSize = Vec::size();
+
+  int64_t c = 0;
+  for (; c + kVecSize <= num_cols; c += kVecSize) {
+    Vec max_vec(kLowest<float>);
+    Vec sum_vec(0.0f);
+    for (int64_t d = 0; d < dim_size; ++d) {
+      const Vec x = Vec::loadu(in + d * inner_size + c);
+      const Vec new_max = at::vec::maximum(max_vec, x);
+      sum_vec = sum_vec * (max_vec - new_max).exp() + (x - new_max).exp();
+      max_vec = new_max;
+    }
+    const Vec inv_sum = Vec(1.0f) / sum_vec;
+    for (int64_t d = 0; d < dim_size; ++d) {
+      const Vec x = Vec::loadu(in + d * inner_size + c);
+      ((x - max_vec).exp() * inv_sum).store(out + d * inner_size + c);
+    }
+  }
+  for (; c < num_cols; ++c) {
+    softmax_strided(in + c, out + c, dim_size, inner_size);
+  }
+}
+
+void softmax_float(const Tensor& in, int64_t dim, Tensor& out) {
+  const float* const in_data = in.const_data_ptr<float>();
+  float* const out_data = out.mutable_data_ptr<float>();
+
+  const int64_t dim_size = in.dim() == 0 ? 1 : in.size(dim);
+  const int64_t outer_size = in.dim() == 0 ? 1 : getLeadingDims(in, dim);
+  const int64_t inner_size = in.dim() == 0 ? 1 : getTrailingDims(in, dim);
+  if (dim_size == 0 || outer_size == 0 || inner_size == 0) {
+    return;
+  }
+
+  if (inner_size == 1) {
+    ::executorch::extension::parallel_for(
+        0,
+        outer_size,
+        std::max<int64_t>(
+            1, ::executorch::extension::internal::GRAIN_SIZE / dim_size),
+        [&](const auto begin, const auto end) {
+          for (int64_t i = begin; i < end; ++i) {
+            softmax_lastdim_row(
+                in_data + i * dim_size, out_data + i * dim_size, dim_size);
+          }
+        });
+    return;
+  }
+
+  // Split each outer slice into blocks of columns that keep a
+  // [dim_size, kColBlock] tile small enough to stay in cache between the two
+  // passes.
+  constexpr int64_t kColBlock = 64;
+  const int64_t num_col_blocks = (inner_size + kColBlock - 1) / kColBlock;
+  ::executorch::extension::parallel_for(
+      0,
+      outer_size * num_col_blocks,
+      std::max<int64_t>(
+          1,
+          ::executorch::extension::internal::GRAIN_SIZE /
+              (dim_size * kColBlock)),
+      [&](const auto begin, const auto end) {
+        for (int64_t item = begin; item < end; ++item) {
+          const int64_t o = item / num_col_blocks;
+          const int64_t c = (item % num_col_blocks) * kColBlock;
+          const int64_t offset = o * dim_size * inner_size + c;
+          softmax_inner_cols(
+              in_data + offset,
+              out_data + offset,
+              dim_size,
+              inner_size,
+              std::min(kColBlock, inner_size - c));
+        }
+      });
+}
+
+} // namespace
+
+// _softmax.out(Tensor self, int dim, bool half_to_float, *, Tensor(a!) out)
+// -> Tensor(a!)
+Tensor& opt_softmax_out(
+    KernelRuntimeContext& context,
+    const Tensor& self,
+    int64_t dim,
+    bool half_to_float,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      context,
+      check_softmax_args(self, dim, half_to_float, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      context,
+      resize_tensor(out, self.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      context, tensors_have_same_dim_order(self, out), InvalidArgument, out);
+
+  dim = dim < 0 ? dim + nonzero_dim(self) : dim;
+
+  if (self.scalar_type() == ScalarType::Float &&
+      tensor_is_default_dim_order(self)) {
+    softmax_float(self, dim, out);
+    return out;
+  }
+
+  ET_SWITCH_FLOATHBF16_TYPES(
+      self.scalar_type(), context, "_softmax.out", CTYPE, [&]() {
+        const CTYPE* const in_data = self.const_data_ptr<CTYPE>();
+        CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+        apply_over_dim(
+            [in_data, out_data](
+                const size_t size, const size_t stride, const size_t base) {
+              softmax_strided(in_data + base, out_data + base, size, stride);
+            },
+            self,
+            dim);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/strided_copy_util.h>
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using TensorList = executorch::aten::TensorList;
+
+void opt_split_with_sizes_copy_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    executorch::aten::ArrayRef<int64_t> split_sizes,
+    int64_t dim,
+    TensorList out) {
+  // Support python-style negative indexing. Note that this op does not accept 0
+  // dimensional input tensors.
+  if (dim < 0) {
+    dim += in.dim();
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_split_with_sizes_copy_args(in, split_sizes, dim, out),
+      InvalidArgument, );
+
+  // All output tensors must have the same dim order as the input
+  for (size_t i = 0; i < out.size(); ++i) {
+    ET_KERNEL_CHECK(
+        ctx, tensors_have_same_dim_order(in, out[i]), InvalidArgument, );
+  }
+
+  // If out is empty, then nothing needs to be done after checking the args.
+  // Valid args implies that in.size(dim) == 0 and split_sizes is also empty.
+  if (out.size() == 0) {
+    return;
+  }
+
+  Tensor::SizesType target_out_sizes[kTensorDimensionLimit];
+  const size_t target_out_ndim = in.dim();
+  for (size_t d = 0; d < in.dim(); ++d) {
+    target_out_sizes[d] = static_cast<Tensor::SizesType>(in.size(d));
+  }
+  for (size_t i = 0; i < split_sizes.size(); ++i) {
+    target_out_sizes[dim] = static_cast<Tensor::SizesType>(split_sizes[i]);
+    ET_KERNEL_CHECK(
+        ctx,
+        resize_tensor(out[i], {target_out_sizes, target_out_ndim}) == Error::Ok,
+        InvalidArgument, );
+  }
+
+  if (in.numel() == 0) {
+    return;
+  }
+
+  // Output i takes a contiguous part of every row of `in`, viewed as
+  // [outer, in.size(dim) * inner].
+  size_t outer = 1;
+  size_t inner = 1;
+  internal::collapse_around_dim(in, dim, &outer, &inner);
+  const size_t in_row_size = in.size(dim) * inner;
+  const auto get_copy = [&](size_t i, size_t row_offset) {
+    const size_t row_size = split_sizes[i] * inner;
+    return internal::StridedCopy{
+        out[i].mutable_data_ptr(),
+        row_size,
+        static_cast<const char*>(in.const_data_ptr()) +
+            row_offset * in.element_size(),
+        in_row_size,
+        row_size == 0 ? 0 : outer,
+        row_size};
+  };
+
+  const ScalarType in_type = in.scalar_type();
+  const ScalarType out_type = out[0].scalar_type();
+  if (in_type == out_type) {
+    internal::parallel_strided_copy(in.element_size(), out.size(), get_copy);
+    return;
+  }
+
+  ET_SWITCH_REALHBBF16_TYPES(in_type, ctx, __func__, CTYPE_IN, [&]() {
+    ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, __func__, CTYPE_OUT, [&]() {
+      size_t row_offset = 0;
+      for (size_t i = 0; i < out.size(); ++i) {
+        const internal::StridedCopy copy = get_copy(i, row_offset);
+        internal::convert_strided_copy<CTYPE_OUT, CTYPE_IN>(copy);
+        row_offset += copy.row_size;
+      }
+    });
+  });
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
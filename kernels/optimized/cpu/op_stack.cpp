@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/strided_copy_util.h>
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+Tensor& opt_stack_out(
+    KernelRuntimeContext& ctx,
+    executorch::aten::ArrayRef<Tensor> tensors,
+    int64_t dim,
+    Tensor& out) {
+  if (dim < 0) {
+    dim += out.dim();
+  }
+
+  ET_KERNEL_CHECK(
+      ctx, check_stack_args(tensors, dim, out), InvalidArgument, out);
+
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    ET_KERNEL_CHECK(
+        ctx,
+        tensors_have_same_dim_order(tensors[i], out),
+        InvalidArgument,
+        out);
+  }
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(out), InvalidArgument, out);
+
+  Tensor::SizesType expected_out_size[kTensorDimensionLimit];
+  size_t expected_out_dim = 0;
+  get_stack_out_target_size(tensors, dim, expected_out_size, &expected_out_dim);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {expected_out_size, expected_out_dim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  // Stacking is a cat along a new dim of size one: each input fills `inner`
+  // elements of every row of `out`.
+  size_t outer = 1;
+  size_t inner = 1;
+  internal::collapse_around_dim(out, dim, &outer, &inner);
+  const size_t out_row_size = tensors.size() * inner;
+  const auto get_copy = [&](size_t i, size_t row_offset) {
+    return internal::StridedCopy{
+        static_cast<char*>(out.mutable_data_ptr()) +
+            row_offset * out.element_size(),
+        out_row_size,
+        tensors[i].const_data_ptr(),
+        inner,
+        outer,
+        inner};
+  };
+
+  const auto out_type = out.scalar_type();
+  bool same_dtype = true;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    if (tensors[i].scalar_type() != out_type) {
+      same_dtype = false;
+    }
+  }
+  if (same_dtype) {
+    internal::parallel_strided_copy(
+        out.element_size(), tensors.size(), get_copy);
+    return out;
+  }
+
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const internal::StridedCopy copy = get_copy(i, i * inner);
+    const auto in_type = tensors[i].scalar_type();
+    ET_SWITCH_REALHBBF16_TYPES(in_type, ctx, "stack.out", CTYPE_IN, [&] {
+      ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "stack.out", CTYPE_OUT, [&] {
+        internal::convert_strided_copy<CTYPE_OUT, CTYPE_IN>(copy);
+      });
+    });
+  }
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
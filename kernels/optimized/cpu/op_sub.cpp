@@ -58,50 +58,42 @@ Tensor& opt_sub_out(
   static constexpr const char op_name[] = "sub.out";
 
   if (a.numel() == 1 || b.numel() == 1) {
-    if (a_type == b_type && a_type == out_type && a_type != ScalarType::Half &&
-        a_type != ScalarType::BFloat16) {
+    if (a_type == b_type && a_type == out_type) {
       const Tensor* tensor;
       const Tensor* scalar;
-      ScalarType tensor_type;
-      ScalarType scalar_type;
       if (a.numel() == 1) {
         tensor = &b;
-        tensor_type = b_type;
         scalar = &a;
-        scalar_type = a_type;
       } else {
         tensor = &a;
-        tensor_type = a_type;
         scalar = &b;
-        scalar_type = b_type;
       }
-      ET_SWITCH_REAL_TYPES(tensor_type, ctx, op_name, CTYPE, [&]() {
-        ET_SWITCH_REAL_TYPES(scalar_type, ctx, op_name, CTYPE_SCALAR, [&]() {
-          CTYPE alpha_val;
-          ET_KERNEL_CHECK(
-              ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
-          CTYPE_SCALAR scalar_val = *scalar->const_data_ptr<CTYPE_SCALAR>();
-          CTYPE scalar_casted = static_cast<CTYPE>(scalar_val);
-
-          using Vec = at::vec::Vectorized<CTYPE>;
-          if (a.numel() == 1) {
-            at::vec::map<CTYPE>(
-                [alpha_val, scalar_casted](Vec x) {
-                  return Vec(scalar_casted) - Vec(alpha_val) * x;
-                },
-                out.mutable_data_ptr<CTYPE>(),
-                tensor->const_data_ptr<CTYPE>(),
-                out.numel());
-          } else {
-            at::vec::map<CTYPE>(
-                [alpha_val, scalar_casted](Vec x) {
-                  return x - Vec(alpha_val * scalar_casted);
-                },
-                out.mutable_data_ptr<CTYPE>(),
-                tensor->const_data_ptr<CTYPE>(),
-                out.numel());
-          }
-        });
+      ET_SWITCH_REALHBF16_TYPES(out_type, ctx, op_name, CTYPE, [&]() {
+        using CTYPE_VEC = executorch::vec::vec_compute_t<CTYPE>;
+        CTYPE_VEC alpha_val;
+        ET_KERNEL_CHECK(
+            ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
+        CTYPE_VEC scalar_casted =
+            static_cast<CTYPE_VEC>(*scalar->const_data_ptr<CTYPE>());
+
+        using Vec = at::vec::Vectorized<CTYPE_VEC>;
+        if (a.numel() == 1) {
+          at::vec::map<CTYPE>(
+              [alpha_val, scalar_casted](Vec x) {
+                return Vec(scalar_casted) - Vec(alpha_val) * x;
+              },
+              out.mutable_data_ptr<CTYPE>(),
+              tensor->const_data_ptr<CTYPE>(),
+              out.numel());
+        } else {
+          at::vec::map<CTYPE>(
+              [alpha_val, scalar_casted](Vec x) {
+                return x - Vec(alpha_val * scalar_casted);
+              },
+              out.mutable_data_ptr<CTYPE>(),
+              tensor->const_data_ptr<CTYPE>(),
+              out.numel());
+        }
       });
       return out;
     }
@@ -139,15 +131,15 @@ Tensor& opt_sub_scalar_out(
   // @lint-ignore CLANGTIDY facebook-hte-CArray
   static constexpr const char op_name[] = "sub.Scalar_out";
 
-  if (a_type == common_type && a_type == out_type &&
-      a_type != ScalarType::Half && a_type != ScalarType::BFloat16) {
-    ET_SWITCH_REAL_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
-      CTYPE b_casted = utils::scalar_to<CTYPE>(b);
-      CTYPE alpha_val;
+  if (a_type == common_type && a_type == out_type) {
+    ET_SWITCH_REALHBF16_TYPES(a_type, ctx, op_name, CTYPE, [&]() {
+      using CTYPE_VEC = executorch::vec::vec_compute_t<CTYPE>;
+      CTYPE_VEC b_casted = utils::scalar_to<CTYPE_VEC>(b);
+      CTYPE_VEC alpha_val;
       ET_KERNEL_CHECK(
           ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
 
-      using Vec = at::vec::Vectorized<CTYPE>;
+      using Vec = at::vec::Vectorized<CTYPE_VEC>;
       at::vec::map<CTYPE>(
           [alpha_val, b_casted](Vec x) {
             return x - Vec(alpha_val * b_casted);
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/strided_copy_util.h>
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using TensorList = executorch::aten::TensorList;
+
+/**
+ * unbind_copy.int_out(Tensor input, int dim=0, *, Tensor(a!)[] out) -> ()
+ */
+void opt_unbind_copy_int_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    int64_t dim,
+    TensorList out) {
+  // Support python-style negative indexing.
+  if (dim < 0) {
+    dim += input.dim();
+  }
+
+  ET_KERNEL_CHECK(
+      ctx, check_unbind_copy_args(input, dim, out), InvalidArgument, );
+
+  for (size_t i = 0; i < out.size(); ++i) {
+    ET_KERNEL_CHECK(
+        ctx, tensors_have_same_dim_order(input, out[i]), InvalidArgument, );
+  }
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(input), InvalidArgument, );
+
+  if (input.numel() == 0) {
+    return;
+  }
+
+  // Output i takes `inner` elements from every row of `input`, viewed as
+  // [outer, input.size(dim) * inner].
+  size_t outer = 1;
+  size_t inner = 1;
+  internal::collapse_around_dim(input, dim, &outer, &inner);
+  const size_t in_row_size = input.size(dim) * inner;
+  const auto get_copy = [&](size_t i, size_t row_offset) {
+    return internal::StridedCopy{
+        out[i].mutable_data_ptr(),
+        inner,
+        static_cast<const char*>(input.const_data_ptr()) +
+            row_offset * input.element_size(),
+        in_row_size,
+        outer,
+        inner};
+  };
+
+  const ScalarType in_type = input.scalar_type();
+  const ScalarType out_type = out[0].scalar_type();
+  if (in_type == out_type) {
+    internal::parallel_strided_copy(
+        input.element_size(), out.size(), get_copy);
+    return;
+  }
+
+  ET_SWITCH_REALHBBF16_TYPES(
+      in_type, ctx, "unbind_copy.int_out", CTYPE_IN, [&]() {
+        ET_SWITCH_REALHBBF16_TYPES(
+            out_type, ctx, "unbind_copy.int_out", CTYPE_OUT, [&]() {
+              for (size_t i = 0; i < out.size(); ++i) {
+                internal::convert_strided_copy<CTYPE_OUT, CTYPE_IN>(
+                    get_copy(i, i * inner));
+              }
+            });
+      });
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
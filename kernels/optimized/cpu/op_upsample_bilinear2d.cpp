@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+
+#include <executorch/kernels/optimized/cpu/channels_last_util.h>
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// `opt_upsample_bilinear2d_vec_out` upsamples contiguous (NCHW) tensors in
+// parallel over the N * C planes. The source columns and weights of each
+// output column are computed once per block of columns, and those of each
+// output row once per row, so the inner loop over a row only gathers and
+// blends. Channels last (NHWC) tensors are upsampled in parallel over output
+// pixels, blending whole contiguous channel rows. Results match the portable
+// kernel, which uses the same index, weight and blending expressions.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+// Number of output columns whose source indices and weights are precomputed
+// at a time.
+constexpr int64_t kColumnBlock = 64;
+
+template <typename CTYPE>
+void upsample_bilinear2d_nchw(
+    const Tensor& in,
+    bool align_corners,
+    const float scale_h,
+    const float scale_w,
+    Tensor& out) {
+  const int64_t H = in.size(2);
+  const int64_t W = in.size(3);
+  const int64_t OH = out.size(2);
+  const int64_t OW = out.size(3);
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      out.size(0) * out.size(1),
+      channels_last_grain_size(OH * OW * 4),
+      [&](const auto begin, const auto end) {
+        int64_t in_w1[kColumnBlock];
+        int64_t in_w2[kColumnBlock];
+        float weight_w[kColumnBlock];
+        float inv_weight_w[kColumnBlock];
+        for (int64_t ow0 = 0; ow0 < OW; ow0 += kColumnBlock) {
+          const int64_t block = std::min(kColumnBlock, OW - ow0);
+          for (int64_t j = 0; j < block; ++j) {
+            compute_source_index_and_lambda(
+                in_w1[j],
+                in_w2[j],
+                weight_w[j],
+                inv_weight_w[j],
+                scale_w,
+                ow0 + j,
+                W,
+                OW,
+                align_corners);
+          }
+          for (int64_t plane = begin; plane < end; ++plane) {
+            const CTYPE* const in_plane = in_data + plane * H * W;
+            for (int64_t oh = 0; oh < OH; ++oh) {
+              int64_t in_h1, in_h2;
+              float weight_h, inv_weight_h;
+              compute_source_index_and_lambda(
+                  in_h1,
+                  in_h2,
+                  weight_h,
+                  inv_weight_h,
+                  scale_h,
+                  oh,
+                  H,
+                  OH,
+                  align_corners);
+
+              const CTYPE* const row1 = in_plane + in_h1 * W;
+              const CTYPE* const row2 = in_plane + in_h2 * W;
+              CTYPE* const out_row = out_data + (plane * OH + oh) * OW + ow0;
+              for (int64_t j = 0; j < block; ++j) {
+                const int64_t iw1 = in_w1[j];
+                const int64_t iw2 = in_w2[j];
+                const auto top =
+                    row1[iw1] * weight_w[j] + row1[iw2] * inv_weight_w[j];
+                const auto bottom =
+                    row2[iw1] * weight_w[j] + row2[iw2] * inv_weight_w[j];
+                out_row[j] = top * weight_h + bottom * inv_weight_h;
+              }
+            }
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void upsample_bilinear2d_nhwc(
+    const Tensor& in,
+    bool align_corners,
+    const float scale_h,
+    const float scale_w,
+    Tensor& out) {
+  const int64_t C = in.size(1);
+  const int64_t H = in.size(2);
+  const int64_t W = in.size(3);
+  const int64_t OH = out.size(2);
+  const int64_t OW = out.size(3);
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      out.size(0) * OH * OW,
+      channels_last_grain_size(C * 4),
+      [&](const auto begin, const auto end) {
+        for (int64_t pixel = begin; pixel < end; ++pixel) {
+          const int64_t n = pixel / (OH * OW);
+          const int64_t oh = (pixel / OW) % OH;
+          const int64_t ow = pixel % OW;
+
+          int64_t in_h1, in_h2;
+          float weight_h, inv_weight_h;
+          compute_source_index_and_lambda(
+              in_h1,
+              in_h2,
+              weight_h,
+              inv_weight_h,
+              scale_h,
+              oh,
+              H,
+              OH,
+              align_corners);
+
+          int64_t in_w1, in_w2;
+          float weight_w, inv_weight_w;
+          compute_source_index_and_lambda(
+              in_w1,
+              in_w2,
+              weight_w,
+              inv_weight_w,
+              scale_w,
+              ow,
+              W,
+              OW,
+              align_corners);
+
+          const CTYPE* const in_batch = in_data + n * H * W * C;
+          const CTYPE* const top_left = in_batch + (in_h1 * W + in_w1) * C;
+          const CTYPE* const top_right = in_batch + (in_h1 * W + in_w2) * C;
+          const CTYPE* const bottom_left = in_batch + (in_h2 * W + in_w1) * C;
+          const CTYPE* const bottom_right = in_batch + (in_h2 * W + in_w2) * C;
+          CTYPE* const out_row = out_data + pixel * C;
+          for (int64_t c = 0; c < C; ++c) {
+            const auto top =
+                top_left[c] * weight_w + top_right[c] * inv_weight_w;
+            const auto bottom =
+                bottom_left[c] * weight_w + bottom_right[c] * inv_weight_w;
+            out_row[c] = top * weight_h + bottom * inv_weight_h;
+          }
+        }
+      });
+}
+
+} // namespace
+
+// Signatures are auto-generated, so disable pass-by-value lint.
+// NOLINTBEGIN(facebook-hte-ConstantArgumentPassByValue,
+// facebook-hte-ParameterMightThrowOnCopy)
+Tensor& opt_upsample_bilinear2d_vec_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const executorch::aten::OptionalArrayRef<int64_t> output_size,
+    bool align_corners,
+    const executorch::aten::OptionalArrayRef<double> scale_factors,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_upsample_bilinear2d_args(
+          in, output_size, align_corners, scale_factors, out),
+      InvalidArgument,
+      out);
+
+  double scale_h, scale_w;
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_upsample_2d(
+          in, output_size, scale_factors, scale_h, scale_w, out) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor");
+
+  const float kernel_scale_h = area_pixel_compute_scale<double>(
+      in.sizes()[2], out.sizes()[2], align_corners, scale_h);
+  const float kernel_scale_w = area_pixel_compute_scale<double>(
+      in.sizes()[3], out.sizes()[3], align_corners, scale_w);
+
+  // The args checks only allow NCHW or NHWC tensors, with the same dim order
+  // for in and out.
+  const bool channels_last = is_channels_last_4d(in);
+
+  ET_SWITCH_REALHBF16_TYPES(
+      in.scalar_type(), ctx, "upsample_bilinear2d.out", CTYPE, [&]() {
+        if (channels_last) {
+          upsample_bilinear2d_nhwc<CTYPE>(
+              in, align_corners, kernel_scale_h, kernel_scale_w, out);
+        } else {
+          upsample_bilinear2d_nchw<CTYPE>(
+              in, align_corners, kernel_scale_h, kernel_scale_w, out);
+        }
+      });
+
+  return out;
+}
+// NOLINTEND(facebook-hte-ConstantArgumentPassByValue,
+// facebook-hte-ParameterMightThrowOnCopy)
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+
+#include <executorch/kernels/optimized/cpu/channels_last_util.h>
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// `opt_upsample_bilinear2d_aa_out` upsamples contiguous (NCHW) tensors in
+// parallel over the N * C planes. The anti-aliasing filter taps of each
+// output column are computed once per block of columns, and those of each
+// output row once per row, rather than once per output element. Channels
+// last (NHWC) tensors are upsampled in parallel over output pixels,
+// accumulating whole contiguous channel rows. Both accumulate each output
+// element in the same order as the portable kernel. Other dim orders are
+// handled by the portable kernel.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+// Number of output columns whose filter taps are precomputed at a time.
+constexpr int64_t kColumnBlock = 64;
+
+// compute_aa_weights_for_pixel() produces at most this many taps.
+constexpr int64_t kMaxTaps = 4;
+
+template <typename CTYPE>
+void upsample_bilinear2d_aa_nchw(
+    const Tensor& in,
+    const float scale_h,
+    const float scale_w,
+    Tensor& out) {
+  const int64_t H = in.size(2);
+  const int64_t W = in.size(3);
+  const int64_t OH = out.size(2);
+  const int64_t OW = out.size(3);
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      out.size(0) * out.size(1),
+      channels_last_grain_size(OH * OW * kMaxTaps * kMaxTaps),
+      [&](const auto begin, const auto end) {
+        int64_t w_indices[kColumnBlock][kMaxTaps];
+        float w_weights[kColumnBlock][kMaxTaps];
+        int64_t w_num_contributors[kColumnBlock];
+        for (int64_t ow0 = 0; ow0 < OW; ow0 += kColumnBlock) {
+          const int64_t block = std::min(kColumnBlock, OW - ow0);
+          for (int64_t j = 0; j < block; ++j) {
+            compute_aa_weights_for_pixel<float>(
+                ow0 + j,
+                scale_w,
+                W,
+                w_indices[j],
+                w_weights[j],
+                &w_num_contributors[j]);
+          }
+          for (int64_t plane = begin; plane < end; ++plane) {
+            const CTYPE* const in_plane = in_data + plane * H * W;
+            for (int64_t oh = 0; oh < OH; ++oh) {
+              int64_t h_indices[kMaxTaps];
+              float h_weights[kMaxTaps];
+              int64_t h_num_contributors;
+              compute_aa_weights_for_pixel<float>(
+                  oh, scale_h, H, h_indices, h_weights, &h_num_contributors);
+
+              CTYPE* const out_row = out_data + (plane * OH + oh) * OW + ow0;
+              for (int64_t j = 0; j < block; ++j) {
+                CTYPE value = 0;
+                for (int64_t ih_idx = 0; ih_idx < h_num_contributors;
+                     ++ih_idx) {
+                  const CTYPE* const in_row =
+                      in_plane + h_indices[ih_idx] * W;
+                  const float h_weight = h_weights[ih_idx];
+                  for (int64_t iw_idx = 0; iw_idx < w_num_contributors[j];
+                       ++iw_idx) {
+                    value += in_row[w_indices[j][iw_idx]] * h_weight *
+                        w_weights[j][iw_idx];
+                  }
+                }
+                out_row[j] = value;
+              }
+            }
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void upsample_bilinear2d_aa_nhwc(
+    const Tensor& in,
+    const float scale_h,
+    const float scale_w,
+    Tensor& out) {
+  const int64_t C = in.size(1);
+  const int64_t H = in.size(2);
+  const int64_t W = in.size(3);
+  const int64_t OH = out.size(2);
+  const int64_t OW = out.size(3);
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      out.size(0) * OH * OW,
+      channels_last_grain_size(C * kMaxTaps * kMaxTaps),
+      [&](const auto begin, const auto end) {
+        for (int64_t pixel = begin; pixel < end; ++pixel) {
+          const int64_t n = pixel / (OH * OW);
+          const int64_t oh = (pixel / OW) % OH;
+          const int64_t ow = pixel % OW;
+
+          int64_t h_indices[kMaxTaps];
+          float h_weights[kMaxTaps];
+          int64_t h_num_contributors;
+          compute_aa_weights_for_pixel<float>(
+              oh, scale_h, H, h_indices, h_weights, &h_num_contributors);
+
+          int64_t w_indices[kMaxTaps];
+          float w_weights[kMaxTaps];
+          int64_t w_num_contributors;
+          compute_aa_weights_for_pixel<float>(
+              ow, scale_w, W, w_indices, w_weights, &w_num_contributors);
+
+          const CTYPE* const in_batch = in_data + n * H * W * C;
+          CTYPE* const out_row = out_data + pixel * C;
+          std::fill(out_row, out_row + C, static_cast<CTYPE>(0));
+          for (int64_t ih_idx = 0; ih_idx < h_num_contributors; ++ih_idx) {
+            const float h_weight = h_weights[ih_idx];
+            for (int64_t iw_idx = 0; iw_idx < w_num_contributors; ++iw_idx) {
+              const float w_weight = w_weights[iw_idx];
+              const CTYPE* const in_row = in_batch +
+                  (h_indices[ih_idx] * W + w_indices[iw_idx]) * C;
+              for (int64_t c = 0; c < C; ++c) {
+                out_row[c] += in_row[c] * h_weight * w_weight;
+              }
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_upsample_bilinear2d_aa_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const executorch::aten::ArrayRef<int64_t> output_size,
+    bool align_corners,
+    const std::optional<double> scale_h,
+    const std::optional<double> scale_w,
+    Tensor& out) {
+  const bool channels_last =
+      is_channels_last_4d(in) && is_channels_last_4d(out);
+  const bool contiguous = is_contiguous_tensor(in) && is_contiguous_tensor(out);
+  if (!channels_last && !contiguous) {
+    return _upsample_bilinear2d_aa_out_impl(
+        ctx, in, output_size, align_corners, scale_h, scale_w, out);
+  }
+
+  ET_KERNEL_CHECK(ctx, in.dim() == 4, InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, out.dim() == 4, InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx, in.scalar_type() == out.scalar_type(), InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, output_size.size() == 2, InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx, output_size[0] > 0 && output_size[1] > 0, InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, out.size(0) == in.size(0), InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, out.size(1) == in.size(1), InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, out.size(2) == output_size[0], InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, out.size(3) == output_size[1], InvalidArgument, out);
+
+  // Same scales as the portable kernel.
+  double final_scale_h, final_scale_w;
+  if (scale_h.has_value() && scale_w.has_value()) {
+    final_scale_h = scale_h.value();
+    final_scale_w = scale_w.value();
+  } else {
+    final_scale_h =
+        static_cast<double>(output_size[0]) / static_cast<double>(in.size(2));
+    final_scale_w =
+        static_cast<double>(output_size[1]) / static_cast<double>(in.size(3));
+  }
+
+  const float kernel_scale_h = area_pixel_compute_scale<double>(
+      in.sizes()[2], out.sizes()[2], align_corners, final_scale_h);
+  const float kernel_scale_w = area_pixel_compute_scale<double>(
+      in.sizes()[3], out.sizes()[3], align_corners, final_scale_w);
+
+  ET_SWITCH_REALHBF16_TYPES(
+      in.scalar_type(), ctx, "_upsample_bilinear2d_aa.out", CTYPE, [&]() {
+        if (channels_last) {
+          upsample_bilinear2d_aa_nhwc<CTYPE>(
+              in, kernel_scale_h, kernel_scale_w, out);
+        } else {
+          upsample_bilinear2d_aa_nchw<CTYPE>(
+              in, kernel_scale_h, kernel_scale_w, out);
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
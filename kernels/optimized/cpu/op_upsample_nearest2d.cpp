@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+
+#include <executorch/kernels/optimized/cpu/channels_last_util.h>
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// `opt_upsample_nearest2d_vec_out` upsamples contiguous (NCHW) tensors in
+// parallel over the N * C planes. The source column of each output column is
+// computed once per block of columns rather than once per output element, so
+// the inner loop over a row is a plain gather. Channels last (NHWC) tensors
+// are upsampled in parallel over output pixels, copying whole contiguous
+// channel rows.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+// Number of output columns whose source indices are precomputed at a time.
+constexpr int64_t kColumnBlock = 64;
+
+template <typename CTYPE>
+void upsample_nearest2d_nchw(
+    const Tensor& in,
+    const float scale_h,
+    const float scale_w,
+    Tensor& out) {
+  const int64_t H = in.size(2);
+  const int64_t W = in.size(3);
+  const int64_t OH = out.size(2);
+  const int64_t OW = out.size(3);
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      out.size(0) * out.size(1),
+      channels_last_grain_size(OH * OW),
+      [&](const auto begin, const auto end) {
+        int64_t in_w[kColumnBlock];
+        for (int64_t ow0 = 0; ow0 < OW; ow0 += kColumnBlock) {
+          const int64_t block = std::min(kColumnBlock, OW - ow0);
+          for (int64_t j = 0; j < block; ++j) {
+            in_w[j] =
+                nearest_neighbor_compute_source_index(scale_w, ow0 + j, W);
+          }
+          for (int64_t plane = begin; plane < end; ++plane) {
+            for (int64_t oh = 0; oh < OH; ++oh) {
+              const int64_t in_h =
+                  nearest_neighbor_compute_source_index(scale_h, oh, H);
+              const CTYPE* const in_row = in_data + (plane * H + in_h) * W;
+              CTYPE* const out_row = out_data + (plane * OH + oh) * OW + ow0;
+              for (int64_t j = 0; j < block; ++j) {
+                out_row[j] = in_row[in_w[j]];
+              }
+            }
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void upsample_nearest2d_nhwc(
+    const Tensor& in,
+    const float scale_h,
+    const float scale_w,
+    Tensor& out) {
+  const int64_t C = in.size(1);
+  const int64_t H = in.size(2);
+  const int64_t W = in.size(3);
+  const int64_t OH = out.size(2);
+  const int64_t OW = out.size(3);
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      out.size(0) * OH * OW,
+      channels_last_grain_size(C),
+      [&](const auto begin, const auto end) {
+        for (int64_t pixel = begin; pixel < end; ++pixel) {
+          const int64_t n = pixel / (OH * OW);
+          const int64_t oh = (pixel / OW) % OH;
+          const int64_t ow = pixel % OW;
+          const int64_t in_h =
+              nearest_neighbor_compute_source_index(scale_h, oh, H);
+          const int64_t in_w =
+              nearest_neighbor_compute_source_index(scale_w, ow, W);
+          const CTYPE* const in_row =
+              in_data + ((n * H + in_h) * W + in_w) * C;
+          std::copy(in_row, in_row + C, out_data + pixel * C);
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_upsample_nearest2d_vec_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const executorch::aten::OptionalArrayRef<int64_t> output_size,
+    const executorch::aten::OptionalArrayRef<double> scale_factors,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_upsample_nearest2d_args(in, output_size, scale_factors, out),
+      InvalidArgument,
+      out);
+
+  double scale_h, scale_w;
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_upsample_2d(
+          in, output_size, scale_factors, scale_h, scale_w, out) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor");
+
+  const float kernel_scale_h = area_pixel_compute_scale<double>(
+      in.sizes()[2], out.sizes()[2], false, scale_h);
+  const float kernel_scale_w = area_pixel_compute_scale<double>(
+      in.sizes()[3], out.sizes()[3], false, scale_w);
+
+  // The args checks only allow NCHW or NHWC tensors, with the same dim order
+  // for in and out.
+  const bool channels_last = is_channels_last_4d(in);
+
+  ET_SWITCH_REALHBF16_TYPES(
+      in.scalar_type(), ctx, "upsample_nearest2d.out", CTYPE, [&]() {
+        if (channels_last) {
+          upsample_nearest2d_nhwc<CTYPE>(
+              in, kernel_scale_h, kernel_scale_w, out);
+        } else {
+          upsample_nearest2d_nchw<CTYPE>(
+              in, kernel_scale_h, kernel_scale_w, out);
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/permute_util.h>
+
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace torch::executor::internal {
+
+namespace {
+
+// A dimension of the output, and the strides (in elements) that step along it
+// in the input and output.
+struct PermutedDim {
+  int64_t size;
+  int64_t in_stride;
+  int64_t out_stride;
+};
+
+// Permuted dims with size-1 dims dropped, ordered from outermost to innermost
+// in the output, and merged wherever both tensors stay contiguous.
+struct PermutePlan {
+  PermutedDim dims[kTensorDimensionLimit];
+  size_t ndim = 0;
+};
+
+PermutePlan make_plan(
+    const executorch::aten::Tensor& in,
+    executorch::aten::ArrayRef<int64_t> dims,
+    const executorch::aten::Tensor& out) {
+  PermutePlan plan;
+  for (size_t d = 0; d < dims.size(); ++d) {
+    if (out.size(d) != 1) {
+      plan.dims[plan.ndim++] = PermutedDim{
+          out.size(d), in.strides()[dims[d]], out.strides()[d]};
+    }
+  }
+  // Order by output memory layout, so that channels-last and other dim orders
+  // take the same path as contiguous tensors.
+  std::stable_sort(
+      plan.dims,
+      plan.dims + plan.ndim,
+      [](const PermutedDim& a, const PermutedDim& b) {
+        return a.out_stride > b.out_stride;
+      });
+  size_t merged = 0;
+  for (size_t d = 1; d < plan.ndim; ++d) {
+    PermutedDim& outer = plan.dims[merged];
+    const PermutedDim& inner = plan.dims[d];
+    if (outer.in_stride == inner.in_stride * inner.size &&
+        outer.out_stride == inner.out_stride * inner.size) {
+      outer = PermutedDim{
+          outer.size * inner.size, inner.in_stride, inner.out_stride};
+    } else {
+      plan.dims[++merged] = inner;
+    }
+  }
+  if (plan.ndim > 0) {
+    plan.ndim = merged + 1;
+  }
+  return plan;
+}
+
+// Walks the first `ndim` dims of a plan in row-major order, tracking the
+// input and output offsets of the current position.
+class OuterIterator {
+ public:
+  OuterIterator(const PermutedDim* dims, size_t ndim, int64_t index)
+      : dims_(dims), ndim_(ndim) {
+    for (size_t d = ndim_; d-- > 0;) {
+      coord_[d] = index % dims_[d].size;
+      index /= dims_[d].size;
+      in_offset_ += coord_[d] * dims_[d].in_stride;
+      out_offset_ += coord_[d] * dims_[d].out_stride;
+    }
+  }
+
+  int64_t in_offset() const {
+    return in_offset_;
+  }
+
+  int64_t out_offset() const {
+    return out_offset_;
+  }
+
+  void next() {
+    for (size_t d = ndim_; d-- > 0;) {
+      in_offset_ += dims_[d].in_stride;
+      out_offset_ += dims_[d].out_stride;
+      if (++coord_[d] < dims_[d].size) {
+        return;
+      }
+      in_offset_ -= coord_[d] * dims_[d].in_stride;
+      out_offset_ -= coord_[d] * dims_[d].out_stride;
+      coord_[d] = 0;
+    }
+  }
+
+ private:
+  const PermutedDim* dims_;
+  size_t ndim_;
+  int64_t coord_[kTensorDimensionLimit] = {};
+  int64_t in_offset_ = 0;
+  int64_t out_offset_ = 0;
+};
+
+int64_t num_elements(const PermutedDim* dims, size_t ndim) {
+  int64_t n = 1;
+  for (size_t d = 0; d < ndim; ++d) {
+    n *= dims[d].size;
+  }
+  return n;
+}
+
+// Copies rows of `row_bytes` bytes that are contiguous in both tensors.
+void copy_rows(
+    const char* in,
+    char* out,
+    const PermutePlan& plan,
+    size_t element_size) {
+  const PermutedDim& row = plan.dims[plan.ndim - 1];
+  const size_t row_bytes = row.size * element_size;
+  const size_t outer_ndim = plan.ndim - 1;
+  const int64_t num_rows = num_elements(plan.dims, outer_ndim);
+  if (num_rows == 1) {
+    // Split one large copy into chunks that are big enough for memcpy to
+    // reach full bandwidth.
+    constexpr int64_t kChunkBytes = 1 << 16;
+    const int64_t num_chunks = (row_bytes + kChunkBytes - 1) / kChunkBytes;
+    ::executorch::extension::parallel_for(
+        0, num_chunks, 1, [&](const int64_t begin, const int64_t end) {
+          const size_t start = begin * kChunkBytes;
+          const size_t stop = std::min<size_t>(end * kChunkBytes, row_bytes);
+          std::memcpy(out + start, in + start, stop - start);
+        });
+    return;
+  }
+  const int64_t grain = std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          static_cast<int64_t>(row_bytes));
+  ::executorch::extension::parallel_for(
+      0, num_rows, grain, [&](const int64_t begin, const int64_t end) {
+        OuterIterator it(plan.dims, outer_ndim, begin);
+        for (int64_t r = begin; r < end; ++r, it.next()) {
+          std::memcpy(
+              out + it.out_offset() * element_size,
+              in + it.in_offset() * element_size,
+              row_bytes);
+        }
+      });
+}
+
+// Transposes a kBlock x kBlock tile. The fixed trip counts let the compiler
+// unroll and vectorize it.
+template <typename T, int64_t kBlock>
+inline void transpose_full_block(
+    const T* in,
+    int64_t in_stride,
+    T* out,
+    int64_t out_stride) {
+  for (int64_t i = 0; i < kBlock; ++i) {
+    for (int64_t j = 0; j < kBlock; ++j) {
+      out[i * out_stride + j] = in[j * in_stride + i];
+    }
+  }
+}
+
+template <typename T>
+inline void transpose_block(
+    const T* in,
+    int64_t in_stride,
+    T* out,
+    int64_t out_stride,
+    int64_t rows,
+    int64_t cols) {
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t j = 0; j < cols; ++j) {
+      out[i * out_stride + j] = in[j * in_stride + i];
+    }
+  }
+}
+
+// Copies out[.., i, .., j] = in[.., j * in_stride_j + i], where `i` walks the
+// input's innermost dim and `j` the output's innermost dim.
+template <typename T>
+void transpose_planes(
+    const T* in,
+    T* out,
+    const PermutePlan& plan,
+    size_t i_dim) {
+  constexpr int64_t kBlock = sizeof(T) >= 8 ? 8 : 16;
+  const PermutedDim& i_info = plan.dims[i_dim];
+  const PermutedDim& j_info = plan.dims[plan.ndim - 1];
+
+  // The dims other than i and j, in output order.
+  PermutedDim outer[kTensorDimensionLimit];
+  size_t outer_ndim = 0;
+  for (size_t d = 0; d + 1 < plan.ndim; ++d) {
+    if (d != i_dim) {
+      outer[outer_ndim++] = plan.dims[d];
+    }
+  }
+  const int64_t num_outer = num_elements(outer, outer_ndim);
+  const int64_t num_i_blocks = (i_info.size + kBlock - 1) / kBlock;
+  // Each work item is a strip of kBlock rows of one plane.
+  const int64_t grain = std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE / (kBlock * j_info.size));
+
+  ::executorch::extension::parallel_for(
+      0,
+      num_outer * num_i_blocks,
+      grain,
+      [&](const int64_t begin, const int64_t end) {
+        for (int64_t item = begin; item < end; ++item) {
+          const int64_t o = item / num_i_blocks;
+          const int64_t i0 = (item % num_i_blocks) * kBlock;
+          const int64_t rows = std::min(kBlock, i_info.size - i0);
+          OuterIterator it(outer, outer_ndim, o);
+          const T* in_strip = in + it.in_offset() + i0;
+          T* out_strip = out + it.out_offset() + i0 * i_info.out_stride;
+          for (int64_t j0 = 0; j0 < j_info.size; j0 += kBlock) {
+            const int64_t cols = std::min(kBlock, j_info.size - j0);
+            const T* in_block = in_strip + j0 * j_info.in_stride;
+            T* out_block = out_strip + j0;
+            if (rows == kBlock && cols == kBlock) {
+              transpose_full_block<T, kBlock>(
+                  in_block, j_info.in_stride, out_block, i_info.out_stride);
+            } else {
+              transpose_block<T>(
+                  in_block,
+                  j_info.in_stride,
+                  out_block,
+                  i_info.out_stride,
+                  rows,
+                  cols);
+            }
+          }
+        }
+      });
+}
+
+// Fallback that copies one element at a time.
+void copy_elements(
+    const char* in,
+    char* out,
+    const PermutePlan& plan,
+    size_t element_size) {
+  const int64_t numel = num_elements(plan.dims, plan.ndim);
+  ::executorch::extension::parallel_for(
+      0,
+      numel,
+      ::executorch::extension::internal::GRAIN_SIZE,
+      [&](const int64_t begin, const int64_t end) {
+        OuterIterator it(plan.dims, plan.ndim, begin);
+        for (int64_t i = begin; i < end; ++i, it.next()) {
+          std::memcpy(
+              out + it.out_offset() * element_size,
+              in + it.in_offset() * element_size,
+              element_size);
+        }
+      });
+}
+
+} // namespace
+
+void permute_tensor(
+    const executorch::aten::Tensor& in,
+    executorch::aten::ArrayRef<int64_t> dims,
+    executorch::aten::Tensor& out) {
+  if (out.numel() == 0) {
+    return;
+  }
+  const char* in_data = static_cast<const char*>(in.const_data_ptr());
+  char* out_data = static_cast<char*>(out.mutable_data_ptr());
+  const size_t element_size = in.element_size();
+  const PermutePlan plan = make_plan(in, dims, out);
+  if (plan.ndim == 0) {
+    std::memcpy(out_data, in_data, element_size);
+    return;
+  }
+
+  const PermutedDim& innermost = plan.dims[plan.ndim - 1];
+  if (innermost.in_stride == 1 && innermost.out_stride == 1) {
+    copy_rows(in_data, out_data, plan, element_size);
+    return;
+  }
+
+  size_t i_dim = plan.ndim;
+  for (size_t d = 0; d + 1 < plan.ndim; ++d) {
+    if (plan.dims[d].in_stride == 1) {
+      i_dim = d;
+    }
+  }
+  if (innermost.out_stride != 1 || i_dim == plan.ndim) {
+    copy_elements(in_data, out_data, plan, element_size);
+    return;
+  }
+  switch (element_size) {
+    case 1:
+      transpose_planes(
+          reinterpret_cast<const uint8_t*>(in_data),
+          reinterpret_cast<uint8_t*>(out_data),
+          plan,
+          i_dim);
+      break;
+    case 2:
+      transpose_planes(
+          reinterpret_cast<const uint16_t*>(in_data),
+          reinterpret_cast<uint16_t*>(out_data),
+          plan,
+          i_dim);
+      break;
+    case 4:
+      transpose_planes(
+          reinterpret_cast<const uint32_t*>(in_data),
+          reinterpret_cast<uint32_t*>(out_data),
+          plan,
+          i_dim);
+      break;
+    case 8:
+      transpose_planes(
+          reinterpret_cast<const uint64_t*>(in_data),
+          reinterpret_cast<uint64_t*>(out_data),
+          plan,
+          i_dim);
+      break;
+    default:
+      copy_elements(in_data, out_data, plan, element_size);
+      break;
+  }
+}
+
+} // namespace torch::executor::internal
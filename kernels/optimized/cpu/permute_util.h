@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+/**
+ * Copies `in` into `out` with its dimensions permuted, so that dimension i of
+ * `out` is dimension `dims[i]` of `in`. `dims` must be a permutation of
+ * [0, in.dim()) without negative entries, `out` must already have the
+ * permuted sizes, and both tensors must have the same dtype and be densely
+ * packed in their dim order.
+ *
+ * Dimensions of size one are dropped, and dimensions that stay adjacent in
+ * memory are merged, before copying:
+ * - If the innermost dimension of `out` is also innermost in `in`, rows are
+ *   copied with memcpy.
+ * - Otherwise the two innermost dimensions form a 2D transpose, which is
+ *   done in cache-sized tiles.
+ * The outer dimensions, and tiles, are spread across threads.
+ */
+void permute_tensor(
+    const executorch::aten::Tensor& in,
+    executorch::aten::ArrayRef<int64_t> dims,
+    executorch::aten::Tensor& out);
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
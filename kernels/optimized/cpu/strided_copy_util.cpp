@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/strided_copy_util.h>
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+namespace {
+
+// Larger than the last-level cache of the CPUs we target, so that a copy this
+// big would have evicted its own output before the next op reads it.
+constexpr size_t kStreamingThresholdBytes = 16 * 1024 * 1024;
+
+void copy_bytes(char* dst, const char* src, size_t size, bool streaming) {
+#if defined(__SSE2__)
+  constexpr size_t kVectorBytes = sizeof(__m128i);
+  if (streaming && size >= 4 * kVectorBytes) {
+    // Non-temporal stores need an aligned destination.
+    const size_t head =
+        (kVectorBytes - reinterpret_cast<uintptr_t>(dst) % kVectorBytes) %
+        kVectorBytes;
+    std::memcpy(dst, src, head);
+    size_t i = head;
+    for (; i + 4 * kVectorBytes <= size; i += 4 * kVectorBytes) {
+      const __m128i* in = reinterpret_cast<const __m128i*>(src + i);
+      __m128i* out = reinterpret_cast<__m128i*>(dst + i);
+      const __m128i v0 = _mm_loadu_si128(in);
+      const __m128i v1 = _mm_loadu_si128(in + 1);
+      const __m128i v2 = _mm_loadu_si128(in + 2);
+      const __m128i v3 = _mm_loadu_si128(in + 3);
+      _mm_stream_si128(out, v0);
+      _mm_stream_si128(out + 1, v1);
+      _mm_stream_si128(out + 2, v2);
+      _mm_stream_si128(out + 3, v3);
+    }
+    std::memcpy(dst + i, src + i, size - i);
+    return;
+  }
+#else
+  (void)streaming;
+#endif
+  std::memcpy(dst, src, size);
+}
+
+} // namespace
+
+void collapse_around_dim(
+    const executorch::aten::Tensor& t,
+    int64_t dim,
+    size_t* outer,
+    size_t* inner) {
+  *outer = 1;
+  *inner = 1;
+  bool after_dim = false;
+  for (size_t i = 0; i < t.dim(); ++i) {
+    const int64_t d = t.dim_order()[i];
+    if (d == dim) {
+      after_dim = true;
+    } else if (after_dim) {
+      *inner *= t.size(d);
+    } else {
+      *outer *= t.size(d);
+    }
+  }
+}
+
+bool use_streaming_stores(size_t total_bytes) {
+  return total_bytes >= kStreamingThresholdBytes;
+}
+
+void copy_chunk(
+    const StridedCopy& copy,
+    size_t element_size,
+    size_t begin,
+    size_t end,
+    bool streaming) {
+  char* const dst = static_cast<char*>(copy.dst);
+  const char* const src = static_cast<const char*>(copy.src);
+  const size_t row_bytes = copy.row_size * element_size;
+  if (copy.rows == 1 ||
+      (copy.src_stride == copy.row_size && copy.dst_stride == copy.row_size)) {
+    // The rows are back to back in both tensors.
+    copy_bytes(dst + begin, src + begin, end - begin, streaming);
+    return;
+  }
+  const size_t src_stride = copy.src_stride * element_size;
+  const size_t dst_stride = copy.dst_stride * element_size;
+  size_t row = begin / row_bytes;
+  size_t offset = begin % row_bytes;
+  while (begin < end) {
+    const size_t size = std::min(row_bytes - offset, end - begin);
+    copy_bytes(
+        dst + row * dst_stride + offset,
+        src + row * src_stride + offset,
+        size,
+        streaming);
+    begin += size;
+    ++row;
+    offset = 0;
+  }
+}
+
+void finish_streaming_stores() {
+#if defined(__SSE2__)
+  _mm_sfence();
+#endif
+}
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
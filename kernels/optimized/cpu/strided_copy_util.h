@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+/**
+ * Copies `rows` rows of `row_size` elements each. Row r is read from
+ * `src + r * src_stride` and written to `dst + r * dst_stride`. Sizes and
+ * strides are in elements.
+ */
+struct StridedCopy {
+  void* dst;
+  size_t dst_stride;
+  const void* src;
+  size_t src_stride;
+  size_t rows;
+  size_t row_size;
+};
+
+/**
+ * Views `t` as [outer, t.size(dim), inner] in memory, where `outer` and
+ * `inner` collapse the dims that come before and after `dim` in the dim order
+ * of `t`.
+ */
+void collapse_around_dim(
+    const executorch::aten::Tensor& t,
+    int64_t dim,
+    size_t* outer,
+    size_t* inner);
+
+/// Copies are split into chunks of this many bytes for parallelization.
+constexpr size_t kCopyChunkBytes = 64 * 1024;
+
+/**
+ * Whether a copy that writes `total_bytes` should use non-temporal stores.
+ * Stores that bypass the cache only pay off when the output is too large to
+ * still be cached by the time its consumer reads it.
+ */
+bool use_streaming_stores(size_t total_bytes);
+
+/// Copies bytes [begin, end) of `copy`, counting bytes row by row.
+void copy_chunk(
+    const StridedCopy& copy,
+    size_t element_size,
+    size_t begin,
+    size_t end,
+    bool streaming);
+
+/// Orders non-temporal stores made by this thread before later stores.
+void finish_streaming_stores();
+
+/**
+ * Runs `num_copies` StridedCopys of elements of `element_size` bytes as one
+ * parallel region. `get_copy(i, row_offset)` must return copy `i`, where
+ * `row_offset` is the sum of the `row_size`s of copies [0, i); this places
+ * copies that share rows side by side, as cat and split do, without a table
+ * of offsets. Copies may not overlap.
+ */
+template <typename GetCopy>
+void parallel_strided_copy(
+    size_t element_size,
+    size_t num_copies,
+    const GetCopy& get_copy) {
+  const auto num_chunks_of = [element_size](const StridedCopy& copy) {
+    const size_t bytes = copy.rows * copy.row_size * element_size;
+    return (bytes + kCopyChunkBytes - 1) / kCopyChunkBytes;
+  };
+
+  size_t num_chunks = 0;
+  size_t total_bytes = 0;
+  size_t row_offset = 0;
+  for (size_t i = 0; i < num_copies; ++i) {
+    const StridedCopy copy = get_copy(i, row_offset);
+    num_chunks += num_chunks_of(copy);
+    total_bytes += copy.rows * copy.row_size * element_size;
+    row_offset += copy.row_size;
+  }
+  if (num_chunks == 0) {
+    return;
+  }
+  const bool streaming = use_streaming_stores(total_bytes);
+
+  ::executorch::extension::parallel_for(
+      0, num_chunks, 1, [&](const int64_t begin, const int64_t end) {
+        // Walk to the copy that holds chunk `begin`.
+        size_t i = 0;
+        size_t offset = 0;
+        StridedCopy copy = get_copy(0, 0);
+        size_t first_chunk = 0;
+        size_t copy_chunks = num_chunks_of(copy);
+        for (size_t chunk = begin; chunk < static_cast<size_t>(end); ++chunk) {
+          while (chunk >= first_chunk + copy_chunks) {
+            first_chunk += copy_chunks;
+            offset += copy.row_size;
+            copy = get_copy(++i, offset);
+            copy_chunks = num_chunks_of(copy);
+          }
+          const size_t copy_bytes = copy.rows * copy.row_size * element_size;
+          const size_t chunk_begin = (chunk - first_chunk) * kCopyChunkBytes;
+          copy_chunk(
+              copy,
+              element_size,
+              chunk_begin,
+              std::min(chunk_begin + kCopyChunkBytes, copy_bytes),
+              streaming);
+        }
+        if (streaming) {
+          finish_streaming_stores();
+        }
+      });
+}
+
+/// Serial version of a StridedCopy that converts each element.
+template <typename CTYPE_OUT, typename CTYPE_IN>
+void convert_strided_copy(const StridedCopy& copy) {
+  CTYPE_OUT* const dst = static_cast<CTYPE_OUT*>(copy.dst);
+  const CTYPE_IN* const src = static_cast<const CTYPE_IN*>(copy.src);
+  for (size_t r = 0; r < copy.rows; ++r) {
+    for (size_t k = 0; k < copy.row_size; ++k) {
+      dst[r * copy.dst_stride + k] =
+          convert<CTYPE_OUT, CTYPE_IN>(src[r * copy.src_stride + k]);
+    }
+  }
+}
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
@@ -57,6 +57,30 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "channels_last_util",
+        srcs = [],
+        exported_headers = ["channels_last_util.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/...", "@EXECUTORCH_CLIENTS",],
+        exported_deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/util:dim_order_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "gather_scatter_util",
+        srcs = [],
+        exported_headers = ["gather_scatter_util.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/...", "@EXECUTORCH_CLIENTS",],
+        exported_deps = [
+            ":channels_last_util",
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    )
+
     runtime.cxx_library(
         name = "cpu_optimized",
         srcs = [],
@@ -76,6 +100,30 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "permute_util",
+        srcs = ["permute_util.cpp"],
+        exported_headers = ["permute_util.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/...", "@EXECUTORCH_CLIENTS",],
+        exported_deps = [
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "strided_copy_util",
+        srcs = ["strided_copy_util.cpp"],
+        exported_headers = ["strided_copy_util.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/...", "@EXECUTORCH_CLIENTS",],
+        exported_deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+    )
+
     # Used for dtype selective build. Collect source and header files.
     runtime.filegroup(
         name = "optimized_source_files",
@@ -46,3 +46,37 @@ void test_calc_moments() {
 TEST(MomentsUtilTest, CalculateMoments) {
   TEST_FORALL_FLOAT_CTYPES(test_calc_moments)
 }
+
+template <class CTYPE>
+void test_calc_moments_reduced_precision() {
+  using torch::executor::native::RowwiseMoments;
+
+  // Long enough to take the vectorized path for several chunks, and to have
+  // a scalar tail. Small integers are exact in Half and BFloat16, so the
+  // moments should match those computed in double up to float accumulation.
+  constexpr int64_t kSize = 1001;
+  std::vector<CTYPE> in(kSize);
+  double sum = 0;
+  for (int64_t i = 0; i < kSize; ++i) {
+    in[i] = static_cast<CTYPE>(i % 17);
+    sum += i % 17;
+  }
+  const double ref_mean = sum / kSize;
+  double sq_sum = 0;
+  for (int64_t i = 0; i < kSize; ++i) {
+    sq_sum += (i % 17 - ref_mean) * (i % 17 - ref_mean);
+  }
+  const double ref_variance = sq_sum / kSize;
+
+  float mean;
+  float variance;
+  std::tie(mean, variance) = RowwiseMoments(in.data(), kSize);
+
+  EXPECT_NEAR(mean, ref_mean, 1e-4);
+  EXPECT_NEAR(variance, ref_variance, 1e-3);
+}
+
+TEST(MomentsUtilTest, CalculateMomentsReducedPrecision) {
+  test_calc_moments_reduced_precision<c10::BFloat16>();
+  test_calc_moments_reduced_precision<c10::Half>();
+}
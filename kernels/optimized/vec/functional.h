@@ -9,8 +9,39 @@
 #pragma once
 
 #include <ATen/cpu/vec/vec.h>
+#include <c10/util/BFloat16-math.h>
+
+#include <type_traits>
 
 namespace executorch::vec {
+// Vectorized math on reduced precision floating point types (Half and
+// BFloat16) is done in float, the same way at::vec::map and friends do it:
+// each loaded vector is converted to two float vectors, the op is applied to
+// each, and the results are converted back when stored. Ops passed to the
+// functions below must then take and return Vectorized<vec_compute_t<T>>.
+template <typename scalar_t>
+using vec_compute_t = std::conditional_t<
+    c10::is_reduced_floating_point_v<scalar_t>,
+    float,
+    scalar_t>;
+
+namespace internal {
+template <typename scalar_t, typename Op>
+inline at::vec::Vectorized<scalar_t> apply_binary_vec_fun(
+    const Op& vec_fun,
+    const at::vec::Vectorized<scalar_t>& a,
+    const at::vec::Vectorized<scalar_t>& b) {
+  if constexpr (c10::is_reduced_floating_point_v<scalar_t>) {
+    auto [a0, a1] = at::vec::convert_to_float<scalar_t>(a);
+    auto [b0, b1] = at::vec::convert_to_float<scalar_t>(b);
+    return at::vec::convert_from_float<scalar_t>(
+        vec_fun(a0, b0), vec_fun(a1, b1));
+  } else {
+    return vec_fun(a, b);
+  }
+}
+} // namespace internal
+
 // This function implements broadcasting binary operation on two tensors
 // where lhs tensor is treated to be of shape [outer_size, broadcast_size, inner_size]
 // and rhs tensor is treated to be of shape [outer_size, 1, inner_size]
@@ -41,13 +72,13 @@ inline void broadcasting_map_3d_and_unsqueezed_3d(
       for (; inner_idx < inner_size - (inner_size % Vec::size()); inner_idx += Vec::size()) {
         Vec data_vec = Vec::loadu(lhs_outer_2 + inner_idx);
         Vec data_vec2 = Vec::loadu(rhs_outer + inner_idx);
-        Vec output_vec = vec_fun(data_vec, data_vec2);
+        Vec output_vec = internal::apply_binary_vec_fun<scalar_t>(vec_fun, data_vec, data_vec2);
         output_vec.store(output_data_row_2 + inner_idx);
       }
       if (inner_size - inner_idx > 0) {
         Vec data_vec = Vec::loadu(lhs_outer_2 + inner_idx, inner_size - inner_idx);
         Vec data_vec2 = Vec::loadu(rhs_outer + inner_idx, inner_size - inner_idx);
-        Vec output_vec = vec_fun(data_vec, data_vec2);
+        Vec output_vec = internal::apply_binary_vec_fun<scalar_t>(vec_fun, data_vec, data_vec2);
         output_vec.store(output_data_row_2 + inner_idx, inner_size - inner_idx);
       }
     }
@@ -92,12 +123,12 @@ inline void broadcasting_map_broadcast_last_dim(
     Vec data_vec2 = Vec(rhs[outer_idx]);
     for (; inner_idx < broadcast_size - (broadcast_size % Vec::size()); inner_idx += Vec::size()) {
       Vec data_vec = Vec::loadu(lhs_outer + inner_idx);
-      Vec output_vec = vec_fun(data_vec, data_vec2);
+      Vec output_vec = internal::apply_binary_vec_fun<scalar_t>(vec_fun, data_vec, data_vec2);
       output_vec.store(output_data_row + inner_idx);
     }
     if (broadcast_size - inner_idx > 0) {
       Vec data_vec = Vec::loadu(lhs_outer + inner_idx, broadcast_size - inner_idx);
-      Vec output_vec = vec_fun(data_vec, data_vec2);
+      Vec output_vec = internal::apply_binary_vec_fun<scalar_t>(vec_fun, data_vec, data_vec2);
       output_vec.store(output_data_row + inner_idx, broadcast_size - inner_idx);
     }
   }
@@ -8,6 +8,7 @@
 #include <c10/util/irange.h>
 #include <cmath>
 
+#include <executorch/kernels/portable/cpu/util/contiguous_reduce_util.h>
 #include <executorch/kernels/portable/cpu/util/math_util.h>
 #include <executorch/kernels/portable/cpu/util/reduce_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
@@ -50,6 +51,16 @@ Tensor& amin_out(
 
   ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, op_name, CTYPE, [&]() {
     CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+    if (reduces_contiguous_inner_dims(in, dim_list)) {
+      const bool success = parallel_min_contiguous_rows<CTYPE>(
+          in,
+          get_reduced_dim_product(in, dim_list),
+          [&](const size_t row, const CTYPE min_v) {
+            out_data[row] = min_v;
+          });
+      ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+      return;
+    }
     const bool success = parallel_for_each_reduce_over_dim_list_output_index(
         in, dim_list, out, [&](const auto begin, const auto end) {
           for (const auto out_ix : c10::irange(begin, end)) {
@@ -10,6 +10,7 @@
 #include <cmath>
 #include <tuple>
 
+#include <executorch/kernels/portable/cpu/util/contiguous_reduce_util.h>
 #include <executorch/kernels/portable/cpu/util/math_util.h>
 #include <executorch/kernels/portable/cpu/util/reduce_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
@@ -51,6 +52,17 @@ Tensor& argmin_out(
   ET_SWITCH_REALHBF16_TYPES(in.scalar_type(), ctx, op_name, CTYPE, [&] {
     int64_t* out_data = out.mutable_data_ptr<int64_t>();
 
+    if (in.numel() > 0 && reduces_contiguous_inner_dims(in, dim)) {
+      const bool success = parallel_argmin_contiguous_rows<CTYPE>(
+          in,
+          get_reduced_dim_product(in, dim),
+          [&](const size_t row, const int64_t index) {
+            out_data[row] = index;
+          });
+      ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+      return;
+    }
+
     const bool success = parallel_for_each_reduce_over_dim_output_index(
         in, dim, out, [&](const auto begin, const auto end) {
           for (const auto out_ix : c10::irange(begin, end)) {
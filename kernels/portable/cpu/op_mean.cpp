@@ -7,6 +7,7 @@
  */
 #include <c10/util/irange.h>
 
+#include <executorch/kernels/portable/cpu/util/contiguous_reduce_util.h>
 #include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
 #include <executorch/kernels/portable/cpu/util/reduce_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
@@ -55,6 +56,17 @@ Tensor& mean_dim_out(
     ET_SWITCH_FLOATHBF16_TYPES(out.scalar_type(), ctx, op_name, CTYPE_OUT, [&] {
       CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
       const size_t num = get_reduced_dim_product(in, dim_list);
+      if (plan.has_value() && reduces_contiguous_inner_dims(in, dim_list)) {
+        const bool success = parallel_sum_contiguous_rows<CTYPE_IN, CTYPE_OUT>(
+            in,
+            num,
+            [](const auto v, size_t /*row*/) { return v; },
+            [&](const size_t row, const auto sum) {
+              out_data[row] = sum / static_cast<float>(num);
+            });
+        ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+        return;
+      }
       const bool success = parallel_for_each_reduce_over_dim_list_output_index(
           in, dim_list, out, [&](const auto begin, const auto end) {
             for (const auto out_ix : c10::irange(begin, end)) {
@@ -10,6 +10,7 @@
 #include <cmath>
 
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
+#include <executorch/kernels/portable/cpu/util/contiguous_reduce_util.h>
 #include <executorch/kernels/portable/cpu/util/reduce_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <executorch/runtime/platform/assert.h>
@@ -32,6 +33,29 @@ void compute_variance(
     for (const auto out_ix : c10::irange(out.numel())) {
       out_data[out_ix] = NAN;
     }
+  } else if (in.numel() > 0 && reduces_contiguous_inner_dims(in, dim_list)) {
+    // The first pass stores each row's mean in out, which the second pass
+    // replaces with the variance.
+    bool success = parallel_sum_contiguous_rows<CTYPE_IN, CTYPE_OUT>(
+        in,
+        num,
+        [](const auto v, size_t /*row*/) { return v; },
+        [&](const size_t row, const auto sum) {
+          out_data[row] = sum / num;
+        });
+    success = success &&
+        parallel_sum_contiguous_rows<CTYPE_IN, CTYPE_OUT>(
+                  in,
+                  num,
+                  [out_data](const auto v, const size_t row) {
+                    using Value = std::decay_t<decltype(v)>;
+                    const Value deviation = v - Value(out_data[row]);
+                    return deviation * deviation;
+                  },
+                  [&](const size_t row, const auto sum2) {
+                    out_data[row] = sum2 / denominator;
+                  });
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
   } else if (in.numel() > 0) {
     MapReduceOverDimListPlan plan(in, dim_list);
     const bool success = parallel_for_each_reduce_over_dim_list_output_index(
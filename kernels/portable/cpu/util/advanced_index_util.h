@@ -127,5 +127,17 @@ std::pair<size_t, bool> get_in_ix(
     int32_t* dim_map,
     int32_t* ix_map);
 
+/**
+ * Implementation of the portable index_put.out op. The optimized kernel calls
+ * it for the indices its fast path doesn't cover.
+ */
+Tensor& index_put_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    TensorOptList indices,
+    const Tensor& values,
+    const bool accumulate,
+    Tensor& out);
+
 } // namespace executor
 } // namespace torch
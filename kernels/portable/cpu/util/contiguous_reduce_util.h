@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/portable/cpu/util/math_util.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#if defined(ET_USE_PYTORCH_HEADERS) && ET_USE_PYTORCH_HEADERS
+#include <ATen/cpu/vec/vec.h>
+#endif // ET_USE_PYTORCH_HEADERS
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @file
+ * Reductions over contiguous rows, for use when
+ * reduces_contiguous_inner_dims() holds. Each output element then reduces
+ * one row of `row_size` consecutive input elements, which lets the rows be
+ * reduced with Vectorized, and lets rows that are too few to keep the
+ * threads busy be split into chunks that are reduced in parallel and then
+ * combined. The chunking only depends on the shape, so results don't depend
+ * on the number of threads.
+ */
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+// The most partial results that one call keeps when splitting rows.
+constexpr size_t kMaxReducePartials = 64;
+
+// Sums are accumulated pairwise over blocks of this many elements, so their
+// rounding error grows with log(n) rather than n.
+constexpr size_t kPairwiseSumBlockSize = 256;
+
+// Half and BFloat16 sums accumulate in float.
+template <typename CTYPE>
+using sum_acc_type = std::conditional_t<
+    std::is_same_v<CTYPE, executorch::aten::Half> ||
+        std::is_same_v<CTYPE, executorch::aten::BFloat16>,
+    float,
+    CTYPE>;
+
+#if defined(ET_USE_PYTORCH_HEADERS) && ET_USE_PYTORCH_HEADERS
+// Can Vectorized be used to reduce CTYPE_IN elements in CTYPE_ACC, applying
+// MapOp to each?
+template <typename CTYPE_IN, typename CTYPE_ACC, typename MapOp>
+constexpr bool can_vectorize_reduce() {
+  using Vec = at::vec::Vectorized<CTYPE_ACC>;
+  if constexpr (
+      std::is_same_v<CTYPE_IN, CTYPE_ACC> &&
+      std::is_floating_point_v<CTYPE_ACC>) {
+    if constexpr (std::is_invocable_v<MapOp, Vec>) {
+      return std::is_same_v<std::invoke_result_t<MapOp, Vec>, Vec>;
+    }
+  }
+  return false;
+}
+#endif // ET_USE_PYTORCH_HEADERS
+
+/**
+ * Returns the sum of map_fun(x) over data[0, n), with x converted to
+ * CTYPE_ACC. See [NOTE: Generic lambdas] in elementwise_util.h; map_fun is
+ * applied to Vectorized<CTYPE_ACC> when it supports that.
+ */
+template <typename CTYPE_ACC, typename CTYPE_IN, typename MapOp>
+CTYPE_ACC pairwise_sum(const MapOp& map_fun, const CTYPE_IN* data, size_t n) {
+  if (n > kPairwiseSumBlockSize) {
+    // Split at a block boundary near the middle.
+    const size_t half = (n / 2 + kPairwiseSumBlockSize - 1) /
+        kPairwiseSumBlockSize * kPairwiseSumBlockSize;
+    return pairwise_sum<CTYPE_ACC>(map_fun, data, half) +
+        pairwise_sum<CTYPE_ACC>(map_fun, data + half, n - half);
+  }
+  size_t i = 0;
+  CTYPE_ACC acc = 0;
+#if defined(ET_USE_PYTORCH_HEADERS) && ET_USE_PYTORCH_HEADERS
+  if constexpr (can_vectorize_reduce<CTYPE_IN, CTYPE_ACC, MapOp>()) {
+    using Vec = at::vec::Vectorized<CTYPE_ACC>;
+    Vec acc_vec(CTYPE_ACC(0));
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      acc_vec = acc_vec + map_fun(Vec::loadu(data + i));
+    }
+    std::array<CTYPE_ACC, Vec::size()> lanes;
+    acc_vec.store(lanes.data());
+    for (const auto lane : lanes) {
+      acc = acc + lane;
+    }
+  }
+#endif // ET_USE_PYTORCH_HEADERS
+  for (; i < n; ++i) {
+    acc = acc + map_fun(static_cast<CTYPE_ACC>(data[i]));
+  }
+  return acc;
+}
+
+// Returns true if v is a new largest (kIsMax) or smallest value compared to
+// acc, where NaN beats everything and ties keep acc.
+template <bool kIsMax, typename CTYPE>
+bool replaces_extremum(const CTYPE acc, const CTYPE v) {
+  if (native::utils::isnan_override(acc)) {
+    return false;
+  }
+  return native::utils::isnan_override(v) || (kIsMax ? v > acc : v < acc);
+}
+
+template <bool kIsMax, typename CTYPE>
+CTYPE pick_extremum(const CTYPE acc, const CTYPE v) {
+  return replaces_extremum<kIsMax>(acc, v) ? v : acc;
+}
+
+/**
+ * Returns the largest (kIsMax) or smallest element of data[0, n), or NaN if
+ * any element is NaN. n must be positive.
+ */
+template <bool kIsMax, typename CTYPE>
+CTYPE contiguous_extremum(const CTYPE* data, size_t n) {
+  CTYPE result = data[0];
+  size_t i = 1;
+#if defined(ET_USE_PYTORCH_HEADERS) && ET_USE_PYTORCH_HEADERS
+  if constexpr (std::is_floating_point_v<CTYPE>) {
+    using Vec = at::vec::Vectorized<CTYPE>;
+    if (n >= Vec::size()) {
+      // at::vec::maximum and minimum propagate NaN.
+      Vec acc_vec = Vec::loadu(data);
+      for (i = Vec::size(); i + Vec::size() <= n; i += Vec::size()) {
+        const Vec v = Vec::loadu(data + i);
+        acc_vec = kIsMax ? at::vec::maximum(acc_vec, v)
+                         : at::vec::minimum(acc_vec, v);
+      }
+      std::array<CTYPE, Vec::size()> lanes;
+      acc_vec.store(lanes.data());
+      for (const auto lane : lanes) {
+        result = pick_extremum<kIsMax>(result, lane);
+      }
+    }
+  }
+#endif // ET_USE_PYTORCH_HEADERS
+  for (; i < n; ++i) {
+    result = pick_extremum<kIsMax>(result, data[i]);
+  }
+  return result;
+}
+
+/**
+ * Returns the largest (kIsMax) or smallest element of data[0, n) and the
+ * index of its first occurrence. NaN counts as the extremum. n must be
+ * positive.
+ */
+template <bool kIsMax, typename CTYPE>
+std::pair<CTYPE, int64_t> contiguous_arg_extremum(const CTYPE* data, size_t n) {
+  // Finding the value first lets that pass use Vectorized.
+  const CTYPE value = contiguous_extremum<kIsMax>(data, n);
+  const bool value_is_nan = native::utils::isnan_override(value);
+  for (const auto i : c10::irange(n)) {
+    if (value_is_nan ? native::utils::isnan_override(data[i])
+                     : data[i] == value) {
+      return {value, static_cast<int64_t>(i)};
+    }
+  }
+  return {value, 0};
+}
+
+/**
+ * Reduces `num_rows` rows of `row_size` elements in parallel.
+ * reduce_chunk(row, begin, end) returns the PARTIAL result for elements
+ * [begin, end) of a row, combine(a, b) combines the partial results of two
+ * adjacent chunks, a being the earlier one, and store(row, partial) consumes
+ * the result for a row. When there are few rows, each row is split into
+ * chunks of roughly GRAIN_SIZE or more elements that are reduced in parallel
+ * and then combined in order.
+ */
+template <
+    typename PARTIAL,
+    typename ReduceChunkOp,
+    typename CombineOp,
+    typename StoreOp>
+[[nodiscard]] bool parallel_reduce_contiguous_rows(
+    const size_t num_rows,
+    const size_t row_size,
+    const ReduceChunkOp& reduce_chunk,
+    const CombineOp& combine,
+    const StoreOp& store) {
+  if (num_rows == 0 || row_size == 0) {
+    return true;
+  }
+  const size_t grain_size = ::executorch::extension::internal::GRAIN_SIZE;
+  size_t chunks_per_row = num_rows > kMaxReducePartials
+      ? 1
+      : std::min(
+            kMaxReducePartials / num_rows,
+            (row_size + grain_size - 1) / grain_size);
+  if (chunks_per_row <= 1) {
+    return ::executorch::extension::parallel_for(
+        0,
+        num_rows,
+        std::max<size_t>(1, grain_size / row_size),
+        [&](const auto begin, const auto end) {
+          for (const auto row : c10::irange(begin, end)) {
+            store(row, reduce_chunk(row, 0, row_size));
+          }
+        });
+  }
+
+  const size_t chunk_size = (row_size + chunks_per_row - 1) / chunks_per_row;
+  // Rounding up the chunk size may leave fewer, but never empty, chunks.
+  chunks_per_row = (row_size + chunk_size - 1) / chunk_size;
+  std::array<PARTIAL, kMaxReducePartials> partials;
+  const bool success = ::executorch::extension::parallel_for(
+      0,
+      num_rows * chunks_per_row,
+      1,
+      [&](const auto begin, const auto end) {
+        for (const auto chunk : c10::irange(begin, end)) {
+          const size_t chunk_begin = (chunk % chunks_per_row) * chunk_size;
+          partials[chunk] = reduce_chunk(
+              chunk / chunks_per_row,
+              chunk_begin,
+              std::min(row_size, chunk_begin + chunk_size));
+        }
+      });
+  if (!success) {
+    return false;
+  }
+  for (const auto row : c10::irange(num_rows)) {
+    PARTIAL acc = partials[row * chunks_per_row];
+    for (const auto chunk : c10::irange(size_t(1), chunks_per_row)) {
+      acc = combine(acc, partials[row * chunks_per_row + chunk]);
+    }
+    store(row, acc);
+  }
+  return true;
+}
+
+template <bool kIsMax, typename CTYPE, typename StoreOp>
+[[nodiscard]] bool parallel_extremum_contiguous_rows(
+    const executorch::aten::Tensor& in,
+    const size_t row_size,
+    const StoreOp& store) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  return parallel_reduce_contiguous_rows<CTYPE>(
+      row_size == 0 ? 0 : in.numel() / row_size,
+      row_size,
+      [&](const size_t row, const size_t begin, const size_t end) {
+        return contiguous_extremum<kIsMax>(
+            in_data + row * row_size + begin, end - begin);
+      },
+      [](const CTYPE a, const CTYPE b) { return pick_extremum<kIsMax>(a, b); },
+      store);
+}
+
+template <bool kIsMax, typename CTYPE, typename StoreOp>
+[[nodiscard]] bool parallel_arg_extremum_contiguous_rows(
+    const executorch::aten::Tensor& in,
+    const size_t row_size,
+    const StoreOp& store) {
+  using Partial = std::pair<CTYPE, int64_t>;
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  return parallel_reduce_contiguous_rows<Partial>(
+      row_size == 0 ? 0 : in.numel() / row_size,
+      row_size,
+      [&](const size_t row, const size_t begin, const size_t end) {
+        auto result = contiguous_arg_extremum<kIsMax>(
+            in_data + row * row_size + begin, end - begin);
+        result.second += begin;
+        return result;
+      },
+      [](const Partial& a, const Partial& b) {
+        return replaces_extremum<kIsMax>(a.first, b.first) ? b : a;
+      },
+      [&](const size_t row, const Partial& result) {
+        store(row, result.second);
+      });
+}
+
+} // namespace internal
+
+/**
+ * Sums map_fun(x, row) over each contiguous row of `row_size` elements of
+ * `in` and calls store(row, sum). x is converted to the accumulation type,
+ * which is CTYPE_OUT, or float for Half and BFloat16, and map_fun may also be
+ * passed Vectorized values of that type (see [NOTE: Generic lambdas] in
+ * elementwise_util.h).
+ */
+template <
+    typename CTYPE_IN,
+    typename CTYPE_OUT,
+    typename MapOp,
+    typename StoreOp>
+[[nodiscard]] bool parallel_sum_contiguous_rows(
+    const executorch::aten::Tensor& in,
+    const size_t row_size,
+    const MapOp& map_fun,
+    const StoreOp& store) {
+  using CTYPE_ACC = internal::sum_acc_type<CTYPE_OUT>;
+  const CTYPE_IN* const in_data = in.const_data_ptr<CTYPE_IN>();
+  return internal::parallel_reduce_contiguous_rows<CTYPE_ACC>(
+      row_size == 0 ? 0 : in.numel() / row_size,
+      row_size,
+      [&](const size_t row, const size_t begin, const size_t end) {
+        return internal::pairwise_sum<CTYPE_ACC>(
+            [&](const auto v) { return map_fun(v, row); },
+            in_data + row * row_size + begin,
+            end - begin);
+      },
+      [](const CTYPE_ACC a, const CTYPE_ACC b) { return a + b; },
+      store);
+}
+
+/**
+ * Calls store(row, max) with the largest element of each contiguous row of
+ * `row_size` elements of `in`, or NaN if the row contains NaN.
+ */
+template <typename CTYPE, typename StoreOp>
+[[nodiscard]] bool parallel_max_contiguous_rows(
+    const executorch::aten::Tensor& in,
+    const size_t row_size,
+    const StoreOp& store) {
+  return internal::parallel_extremum_contiguous_rows</*kIsMax=*/true, CTYPE>(
+      in, row_size, store);
+}
+
+/**
+ * Calls store(row, min) with the smallest element of each contiguous row of
+ * `row_size` elements of `in`, or NaN if the row contains NaN.
+ */
+template <typename CTYPE, typename StoreOp>
+[[nodiscard]] bool parallel_min_contiguous_rows(
+    const executorch::aten::Tensor& in,
+    const size_t row_size,
+    const StoreOp& store) {
+  return internal::parallel_extremum_contiguous_rows</*kIsMax=*/false, CTYPE>(
+      in, row_size, store);
+}
+
+/**
+ * Calls store(row, index) with the index within each contiguous row of
+ * `row_size` elements of `in` of its first largest element, or of its first
+ * NaN.
+ */
+template <typename CTYPE, typename StoreOp>
+[[nodiscard]] bool parallel_argmax_contiguous_rows(
+    const executorch::aten::Tensor& in,
+    const size_t row_size,
+    const StoreOp& store) {
+  return internal::
+      parallel_arg_extremum_contiguous_rows</*kIsMax=*/true, CTYPE>(
+          in, row_size, store);
+}
+
+/**
+ * Calls store(row, index) with the index within each contiguous row of
+ * `row_size` elements of `in` of its first smallest element, or of its first
+ * NaN.
+ */
+template <typename CTYPE, typename StoreOp>
+[[nodiscard]] bool parallel_argmin_contiguous_rows(
+    const executorch::aten::Tensor& in,
+    const size_t row_size,
+    const StoreOp& store) {
+  return internal::
+      parallel_arg_extremum_contiguous_rows</*kIsMax=*/false, CTYPE>(
+          in, row_size, store);
+}
+
+} // namespace executor
+} // namespace torch
@@ -22,6 +22,7 @@
 #include <ATen/cpu/vec/vec.h>
 #endif // ET_USE_PYTORCH_HEADERS
 
+#include <algorithm>
 #include <array>
 #include <utility>
 
@@ -71,6 +72,213 @@ constexpr bool can_use_vectorized() {
 }
 #endif // ET_USE_PYTORCH_HEADERS
 
+/**
+ * Describes how the output and each input of an elementwise op are laid out
+ * when the output is viewed as [outer, rows, cols], where cols is the last
+ * dim, rows the second-to-last one and outer all the others. Every tensor
+ * either spans or is broadcast along each of those three dims, which covers
+ * the common scalar, row-vector (last-dim) and column-vector
+ * (second-to-last dim) broadcasts.
+ */
+template <size_t kNumInputs>
+struct BroadcastPattern {
+  ssize_t rows;
+  ssize_t cols;
+  // Element strides along [outer, rows, cols] of the output followed by each
+  // input; 0 along the dims that a tensor is broadcast.
+  std::array<std::array<ssize_t, 3>, kNumInputs + 1> strides;
+};
+
+// Computes the strides of t along the [outer, rows, cols] view of out, or
+// returns false if t can't be indexed that way.
+inline bool get_broadcast_pattern_strides(
+    const Tensor& t,
+    const Tensor& out,
+    std::array<ssize_t, 3>& strides) {
+  const auto sizes = t.sizes();
+  const auto t_strides = t.strides();
+  const ssize_t dim = t.dim();
+  const ssize_t out_dim = out.dim();
+  if (dim > out_dim) {
+    return false;
+  }
+  // Dims are counted from the last one, so that t's dims line up with the
+  // output's as broadcasting requires.
+  for (const auto i : c10::irange(2)) {
+    const ssize_t out_size = i < out_dim ? out.size(out_dim - 1 - i) : 1;
+    const ssize_t size = i < dim ? sizes[dim - 1 - i] : 1;
+    if (size == 1) {
+      strides[2 - i] = 0;
+    } else if (size == out_size) {
+      strides[2 - i] = t_strides[dim - 1 - i];
+    } else {
+      return false;
+    }
+  }
+  // The outer dims must be either all broadcast or all spanned, and in the
+  // latter case collapse into a single dim.
+  bool spans = false;
+  bool broadcasts = false;
+  ssize_t next_stride = 0;
+  strides[0] = 0;
+  for (ssize_t i = 2; i < out_dim; ++i) {
+    const ssize_t out_size = out.size(out_dim - 1 - i);
+    const ssize_t size = i < dim ? sizes[dim - 1 - i] : 1;
+    if (size == 1) {
+      broadcasts = broadcasts || out_size != 1;
+      continue;
+    }
+    if (size != out_size) {
+      return false;
+    }
+    const ssize_t stride = t_strides[dim - 1 - i];
+    if (!spans) {
+      strides[0] = stride;
+      spans = true;
+    } else if (stride != next_stride) {
+      return false;
+    }
+    next_stride = stride * size;
+  }
+  return !(spans && broadcasts);
+}
+
+// Classifies the broadcast pattern of inputs against out, or returns false if
+// they don't fit one of the patterns that BroadcastPattern describes.
+template <typename... Args>
+inline bool get_broadcast_pattern(
+    const Tensor& out,
+    BroadcastPattern<sizeof...(Args)>& pattern,
+    const Args&... inputs) {
+  if (out.numel() == 0) {
+    return false;
+  }
+  pattern.cols = out.dim() >= 1 ? out.size(out.dim() - 1) : 1;
+  pattern.rows = out.dim() >= 2 ? out.size(out.dim() - 2) : 1;
+  const std::array<const Tensor*, sizeof...(Args) + 1> tensors = {
+      &out, &inputs...};
+  for (const auto idx : c10::irange(tensors.size())) {
+    if (!get_broadcast_pattern_strides(
+            *tensors[idx], out, pattern.strides[idx])) {
+      return false;
+    }
+  }
+  // Rows are written, and loaded into vectors, contiguously.
+  if (pattern.cols > 1) {
+    if (pattern.strides[0][2] != 1) {
+      return false;
+    }
+    for (const auto idx : c10::irange(1, tensors.size())) {
+      if (pattern.strides[idx][2] > 1) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Applies compute_fun to columns [begin, end) of one row of the output.
+template <
+    typename CTYPE_COMPUTE,
+    typename CTYPE_OUT,
+    typename Op,
+    typename... Args>
+inline void apply_elementwise_fn_to_row(
+    const Op& compute_fun,
+    const std::array<const CTYPE_COMPUTE*, sizeof...(Args)>& row_ptrs,
+    const std::array<ssize_t, sizeof...(Args)>& col_strides,
+    CTYPE_OUT* const out_row,
+    ssize_t begin,
+    const ssize_t end) {
+  static constexpr auto kNumInputs = sizeof...(Args);
+#if defined(ET_USE_PYTORCH_HEADERS) && ET_USE_PYTORCH_HEADERS
+  if constexpr (can_use_vectorized<CTYPE_COMPUTE, Op, Args...>()) {
+    using Vec = at::vec::Vectorized<CTYPE_COMPUTE>;
+    // Inputs that are broadcast along the row load the same vector for
+    // every column.
+    std::array<Vec, kNumInputs> broadcast_vecs{};
+    for (const auto input_idx : c10::irange(kNumInputs)) {
+      if (col_strides[input_idx] == 0) {
+        broadcast_vecs[input_idx] = Vec(row_ptrs[input_idx][0]);
+      }
+    }
+    for (; begin + Vec::size() <= end; begin += Vec::size()) {
+      std::array<Vec, kNumInputs> loaded_vec_inputs{};
+      for (const auto input_idx : c10::irange(kNumInputs)) {
+        loaded_vec_inputs[input_idx] = col_strides[input_idx] == 0
+            ? broadcast_vecs[input_idx]
+            : Vec::loadu(&row_ptrs[input_idx][begin]);
+      }
+      std::apply(compute_fun, loaded_vec_inputs).store(&out_row[begin]);
+    }
+  }
+#endif // ET_USE_PYTORCH_HEADERS
+  for (const auto col : c10::irange(begin, end)) {
+    std::array<CTYPE_COMPUTE, kNumInputs> loaded_inputs{};
+    for (const auto input_idx : c10::irange(kNumInputs)) {
+      loaded_inputs[input_idx] =
+          row_ptrs[input_idx][col * col_strides[input_idx]];
+    }
+    out_row[col] = std::apply(compute_fun, loaded_inputs);
+  }
+}
+
+// Applies compute_fun over the output row by row, following the broadcast
+// pattern instead of mapping each output index back to the inputs.
+template <
+    typename CTYPE_COMPUTE,
+    typename CTYPE_OUT,
+    typename Op,
+    typename... Args>
+inline void apply_elementwise_fn_with_broadcast_pattern(
+    const Op& compute_fun,
+    const Tensor& out,
+    const BroadcastPattern<sizeof...(Args)>& pattern,
+    Args... inputs) {
+  static constexpr auto kNumInputs = sizeof...(inputs);
+  const std::array<const CTYPE_COMPUTE*, kNumInputs> inputs_data_ptrs = {
+      inputs.first->template const_data_ptr<CTYPE_COMPUTE>()...};
+  std::array<ssize_t, kNumInputs> col_strides{};
+  for (const auto input_idx : c10::irange(kNumInputs)) {
+    col_strides[input_idx] = pattern.strides[input_idx + 1][2];
+  }
+  CTYPE_OUT* const data_out = out.mutable_data_ptr<CTYPE_OUT>();
+
+  ::executorch::extension::parallel_for(
+      0,
+      out.numel(),
+      ::executorch::extension::internal::GRAIN_SIZE,
+      [&](const auto begin, const auto end) {
+        // Index of the current row across all outer dims.
+        ssize_t row = begin / pattern.cols;
+        ssize_t col = begin % pattern.cols;
+        ssize_t remaining = end - begin;
+        while (remaining > 0) {
+          const ssize_t outer_idx = row / pattern.rows;
+          const ssize_t row_idx = row % pattern.rows;
+          const auto row_offset = [&](const std::array<ssize_t, 3>& strides) {
+            return outer_idx * strides[0] + row_idx * strides[1];
+          };
+          std::array<const CTYPE_COMPUTE*, kNumInputs> row_ptrs{};
+          for (const auto input_idx : c10::irange(kNumInputs)) {
+            row_ptrs[input_idx] = inputs_data_ptrs[input_idx] +
+                row_offset(pattern.strides[input_idx + 1]);
+          }
+          const ssize_t col_end = std::min(pattern.cols, col + remaining);
+          apply_elementwise_fn_to_row<CTYPE_COMPUTE, CTYPE_OUT, Op, Args...>(
+              compute_fun,
+              row_ptrs,
+              col_strides,
+              data_out + row_offset(pattern.strides[0]),
+              col,
+              col_end);
+          remaining -= col_end - col;
+          col = 0;
+          ++row;
+        }
+      });
+}
+
 template <
     typename CTYPE_COMPUTE,
     typename CTYPE_OUT,
@@ -110,9 +318,11 @@ inline void dtype_specialized_elementwise_fn_impl(
 
             CTYPE_OUT* const data_out = out.mutable_data_ptr<CTYPE_OUT>();
 
-            const auto vectorized_begin =
-                begin + (Vec::size() - begin % Vec::size()) % Vec::size();
-            const auto vectorized_end = end - (end % Vec::size());
+            // Clamp, since [begin, end) may not contain a whole vector.
+            const auto vectorized_begin = std::min<decltype(end)>(
+                end, begin + (Vec::size() - begin % Vec::size()) % Vec::size());
+            const auto vectorized_end = std::max<decltype(end)>(
+                vectorized_begin, end - (end % Vec::size()));
             // Scalar prologue.
             for (const auto idx : c10::irange(begin, vectorized_begin)) {
           // In debug mode, always use Vectorized so that even
@@ -167,6 +377,15 @@ inline void dtype_specialized_elementwise_fn_impl(
   }
 #endif // ET_USE_PYTORCH_HEADERS
 
+  // Classify the broadcast once, so that common patterns get a row loop
+  // (vectorized if possible) rather than per-element index mapping.
+  BroadcastPattern<kNumInputs> pattern;
+  if (get_broadcast_pattern(out, pattern, *inputs.first...)) {
+    apply_elementwise_fn_with_broadcast_pattern<CTYPE_COMPUTE, CTYPE_OUT>(
+        compute_fun, out, pattern, inputs...);
+    return;
+  }
+
   ::executorch::extension::parallel_for(
       0,
       out.numel(),
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/fused_elementwise.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include <executorch/kernels/portable/cpu/util/elementwise_util.h>
+#include <executorch/runtime/kernel/operator_registry.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+
+using ::executorch::runtime::FusedElementwiseOp;
+using ::executorch::runtime::kFusedElementwiseArgsPerStep;
+using ::executorch::runtime::kFusedElementwiseKernelName;
+using ::executorch::runtime::kMaxFusedElementwiseOperands;
+using ::executorch::runtime::kMaxFusedElementwiseSteps;
+
+namespace {
+
+// The number of elements that each step processes at a time. The results of
+// all steps for one block fit in a few KiB of stack, so they stay in L1.
+constexpr int64_t kBlockSize = 64;
+
+struct FusedStep {
+  FusedElementwiseOp op;
+  int64_t lhs;
+  int64_t rhs;
+  float alpha;
+};
+
+struct FusedChain {
+  size_t n_operands;
+  size_t n_steps;
+  // Null for scalar operands.
+  std::array<const float*, kMaxFusedElementwiseOperands> operand_data;
+  std::array<float, kMaxFusedElementwiseOperands> operand_scalars;
+  std::array<FusedStep, kMaxFusedElementwiseSteps> steps;
+};
+
+bool is_unary(FusedElementwiseOp op) {
+  switch (op) {
+    case FusedElementwiseOp::Neg:
+    case FusedElementwiseOp::Relu:
+    case FusedElementwiseOp::Sigmoid:
+    case FusedElementwiseOp::Tanh:
+    case FusedElementwiseOp::Exp:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool to_float(const EValue& value, float& out) {
+  if (value.isInt()) {
+    out = static_cast<float>(value.toInt());
+  } else if (value.isDouble()) {
+    out = static_cast<float>(value.toDouble());
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool parse_fused_chain(Span<EValue*> args, FusedChain& chain) {
+  ET_CHECK_OR_RETURN_FALSE(
+      args.size() >= 3 && args[0]->isInt() && args[args.size() - 1]->isTensor(),
+      "Expected the operand count, operands, steps and an output tensor");
+  const int64_t n_operands = args[0]->toInt();
+  ET_CHECK_OR_RETURN_FALSE(
+      n_operands >= 1 &&
+          static_cast<size_t>(n_operands) <= kMaxFusedElementwiseOperands &&
+          static_cast<size_t>(n_operands) + 2 <= args.size(),
+      "Invalid operand count %" PRId64,
+      n_operands);
+  const size_t n_step_args = args.size() - 2 - n_operands;
+  const size_t n_steps = n_step_args / kFusedElementwiseArgsPerStep;
+  ET_CHECK_OR_RETURN_FALSE(
+      n_step_args % kFusedElementwiseArgsPerStep == 0 && n_steps >= 1 &&
+          n_steps <= kMaxFusedElementwiseSteps,
+      "Invalid number of step arguments %zu",
+      n_step_args);
+  chain.n_operands = n_operands;
+  chain.n_steps = n_steps;
+
+  const Tensor& out = args[args.size() - 1]->toTensor();
+  ET_CHECK_OR_RETURN_FALSE(
+      out.scalar_type() == ScalarType::Float, "Output must be Float");
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_contiguous(out));
+  for (size_t i = 0; i < chain.n_operands; ++i) {
+    const EValue& operand = *args[1 + i];
+    chain.operand_data[i] = nullptr;
+    chain.operand_scalars[i] = 0;
+    if (!operand.isTensor()) {
+      ET_CHECK_OR_RETURN_FALSE(
+          to_float(operand, chain.operand_scalars[i]),
+          "Operand %zu must be a tensor or a number",
+          i);
+      continue;
+    }
+    const Tensor& t = operand.toTensor();
+    ET_CHECK_OR_RETURN_FALSE(
+        t.scalar_type() == ScalarType::Float && t.numel() == out.numel(),
+        "Operand %zu must be a Float tensor with %zd elements",
+        i,
+        static_cast<ssize_t>(out.numel()));
+    ET_LOG_AND_RETURN_IF_FALSE(tensor_is_contiguous(t));
+    chain.operand_data[i] = t.const_data_ptr<float>();
+  }
+
+  for (size_t s = 0; s < n_steps; ++s) {
+    EValue* const* step_args =
+        args.data() + 1 + n_operands + s * kFusedElementwiseArgsPerStep;
+    ET_CHECK_OR_RETURN_FALSE(
+        step_args[0]->isInt() && step_args[1]->isInt() &&
+            step_args[2]->isInt(),
+        "Step %zu is malformed",
+        s);
+    const int64_t op = step_args[0]->toInt();
+    ET_CHECK_OR_RETURN_FALSE(
+        op >= 0 && op < static_cast<int64_t>(FusedElementwiseOp::NumOps),
+        "Unknown op %" PRId64 " in step %zu",
+        op,
+        s);
+    FusedStep& step = chain.steps[s];
+    step.op = static_cast<FusedElementwiseOp>(op);
+    step.lhs = step_args[1]->toInt();
+    step.rhs = step_args[2]->toInt();
+    // Steps can only read operands and the results of earlier steps.
+    const int64_t n_values = n_operands + s;
+    ET_CHECK_OR_RETURN_FALSE(
+        step.lhs >= 0 && step.lhs < n_values &&
+            (is_unary(step.op) ? step.rhs == -1
+                               : step.rhs >= 0 && step.rhs < n_values),
+        "Step %zu reads an invalid value",
+        s);
+    ET_CHECK_OR_RETURN_FALSE(
+        to_float(*step_args[3], step.alpha), "Step %zu has no alpha", s);
+  }
+  return true;
+}
+
+float relu(float x) {
+  return (std::isnan(x) || x >= 0) ? x : 0;
+}
+
+#if defined(ET_USE_PYTORCH_HEADERS) && ET_USE_PYTORCH_HEADERS
+at::vec::Vectorized<float> relu(at::vec::Vectorized<float> x) {
+  return at::vec::clamp_min(x, at::vec::Vectorized<float>(0));
+}
+#endif // ET_USE_PYTORCH_HEADERS
+
+// out[i] = op(inputs[i]...) for i < n. The op is a generic lambda, and uses
+// at::vec::Vectorized when it can, like utils::apply_*_elementwise_fn.
+template <typename Op, typename... Inputs>
+void map_block(const Op& op, float* out, int64_t n, const Inputs*... inputs) {
+  int64_t i = 0;
+#if defined(ET_USE_PYTORCH_HEADERS) && ET_USE_PYTORCH_HEADERS
+  if constexpr (native::utils::internal::
+                    can_use_vectorized<float, Op, Inputs...>()) {
+    using Vec = at::vec::Vectorized<float>;
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      op(Vec::loadu(inputs + i)...).store(out + i);
+    }
+  }
+#endif // ET_USE_PYTORCH_HEADERS
+  for (; i < n; ++i) {
+    out[i] = op(inputs[i]...);
+  }
+}
+
+// The lambdas follow the portable kernels of the ops that Method fuses, so
+// fusing does not change results.
+void run_step(
+    const FusedStep& step,
+    const float* a,
+    const float* b,
+    float* out,
+    int64_t n) {
+  const float alpha = step.alpha;
+  switch (step.op) {
+    case FusedElementwiseOp::Add:
+      map_block(
+          [alpha](const auto x, const auto y) {
+            return x + decltype(y)(alpha) * y;
+          },
+          out,
+          n,
+          a,
+          b);
+      break;
+    case FusedElementwiseOp::Sub:
+      map_block(
+          [alpha](const auto x, const auto y) {
+            return x - decltype(y)(alpha) * y;
+          },
+          out,
+          n,
+          a,
+          b);
+      break;
+    case FusedElementwiseOp::Mul:
+      map_block([](const auto x, const auto y) { return x * y; }, out, n, a, b);
+      break;
+    case FusedElementwiseOp::Div:
+      map_block([](const auto x, const auto y) { return x / y; }, out, n, a, b);
+      break;
+    case FusedElementwiseOp::Neg:
+      map_block([](const auto x) { return -x; }, out, n, a);
+      break;
+    case FusedElementwiseOp::Relu:
+      map_block([](const auto x) { return relu(x); }, out, n, a);
+      break;
+    case FusedElementwiseOp::Sigmoid:
+      map_block(
+          [](const auto x) {
+            const auto one = static_cast<decltype(x)>(1.0);
+            return one / (one + executorch::math::exp(-x));
+          },
+          out,
+          n,
+          a);
+      break;
+    case FusedElementwiseOp::Tanh:
+      map_block(
+          [](const auto x) { return executorch::math::tanh(x); }, out, n, a);
+      break;
+    case FusedElementwiseOp::Exp:
+      map_block(
+          [](const auto x) { return executorch::math::exp(x); }, out, n, a);
+      break;
+    default:
+      ET_DCHECK_MSG(
+          false, "Unknown op %" PRId64, static_cast<int64_t>(step.op));
+      break;
+  }
+}
+
+// Runs the chain over elements [begin, end) of the output, which must not be
+// longer than kBlockSize.
+void run_block(
+    const FusedChain& chain,
+    int64_t begin,
+    int64_t end,
+    float* out) {
+  float results[kMaxFusedElementwiseSteps][kBlockSize];
+  float scalars[kMaxFusedElementwiseOperands][kBlockSize];
+  const int64_t n = end - begin;
+  const auto value = [&](int64_t index) -> const float* {
+    if (static_cast<size_t>(index) >= chain.n_operands) {
+      return results[index - chain.n_operands];
+    }
+    if (chain.operand_data[index] != nullptr) {
+      return chain.operand_data[index] + begin;
+    }
+    std::fill(
+        scalars[index], scalars[index] + n, chain.operand_scalars[index]);
+    return scalars[index];
+  };
+  for (size_t s = 0; s < chain.n_steps; ++s) {
+    const FusedStep& step = chain.steps[s];
+    const float* const a = value(step.lhs);
+    const float* const b = step.rhs < 0 ? nullptr : value(step.rhs);
+    // The last step writes straight to the output.
+    float* const result = s + 1 == chain.n_steps ? out + begin : results[s];
+    run_step(step, a, b, result, n);
+  }
+}
+
+bool overlaps(const void* a, size_t a_size, const void* b, size_t b_size) {
+  const char* const a_begin = static_cast<const char*>(a);
+  const char* const b_begin = static_cast<const char*>(b);
+  return a_begin < b_begin + b_size && b_begin < a_begin + a_size;
+}
+
+} // namespace
+
+void fused_elementwise(KernelRuntimeContext& ctx, Span<EValue*> args) {
+  FusedChain chain;
+  ET_KERNEL_CHECK(ctx, parse_fused_chain(args, chain), InvalidArgument, );
+
+  Tensor& out = args[args.size() - 1]->toTensor();
+  const int64_t numel = out.numel();
+  if (numel == 0) {
+    return;
+  }
+
+  // Block i of the output only depends on block i of the operands, so an
+  // operand may share the output's memory, but must not be offset from it.
+  float* const out_data = out.mutable_data_ptr<float>();
+  bool out_overlaps_operand = false;
+  for (size_t i = 0; i < chain.n_operands; ++i) {
+    const float* const data = chain.operand_data[i];
+    if (data != nullptr && data != out_data &&
+        overlaps(data, out.nbytes(), out_data, out.nbytes())) {
+      out_overlaps_operand = true;
+    }
+  }
+  float* result = out_data;
+  if (out_overlaps_operand) {
+    Result<void*> temp = ctx.allocate_temp(out.nbytes(), alignof(float));
+    ET_KERNEL_CHECK(ctx, temp.ok(), MemoryAllocationFailed, );
+    result = static_cast<float*>(temp.get());
+  }
+
+  const int64_t num_blocks = (numel + kBlockSize - 1) / kBlockSize;
+  ::executorch::extension::parallel_for(
+      0,
+      num_blocks,
+      std::max<int64_t>(
+          1,
+          ::executorch::extension::internal::GRAIN_SIZE /
+              (kBlockSize * static_cast<int64_t>(chain.n_steps))),
+      [&](const auto begin, const auto end) {
+        for (int64_t block = begin; block < end; ++block) {
+          run_block(
+              chain,
+              block * kBlockSize,
+              std::min(numel, (block + 1) * kBlockSize),
+              result);
+        }
+      });
+
+  if (result != out_data) {
+    std::memcpy(out_data, result, out.nbytes());
+  }
+}
+
+Error register_fused_elementwise_kernel() {
+  for (const auto& kernel : ::executorch::runtime::get_registered_kernels()) {
+    if (std::strcmp(kernel.name_, kFusedElementwiseKernelName) == 0) {
+      return Error::Ok;
+    }
+  }
+  return ::executorch::runtime::register_kernel(
+      ::executorch::runtime::Kernel(
+          kFusedElementwiseKernelName, fused_elementwise));
+}
+
+} // namespace executor
+} // namespace torch
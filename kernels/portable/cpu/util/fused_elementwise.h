@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/fused_elementwise.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Runs a chain of elementwise ops that Method fused at init, over blocks of
+ * the output, so that the results of intermediate steps never leave the
+ * cache. See executorch/runtime/kernel/fused_elementwise.h for the layout of
+ * `args`.
+ */
+void fused_elementwise(KernelRuntimeContext& ctx, Span<EValue*> args);
+
+/**
+ * Registers fused_elementwise() as the kernel that runs fused chains, which
+ * makes methods loaded afterwards fuse consecutive elementwise kernel calls.
+ * Like other kernel registration, this is not thread-safe. Calling it again
+ * does nothing.
+ */
+Error register_fused_elementwise_kernel();
+
+} // namespace executor
+} // namespace torch
@@ -6,9 +6,12 @@
  * LICENSE file in the root directory of this source tree.
  */
 #include <c10/util/irange.h>
+#include <cstring>
 
+#include <executorch/kernels/portable/cpu/scalar_utils.h>
 #include <executorch/kernels/portable/cpu/util/index_util.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
 namespace executor {
@@ -271,5 +274,366 @@ bool check_select_scatter_args(
   return true;
 }
 
+namespace {
+
+template <typename CTYPE>
+void gather_helper(
+    const Tensor& in,
+    const Tensor& index,
+    Tensor& out,
+    int64_t dim) {
+  const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+  const int64_t* index_data = index.const_data_ptr<int64_t>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+  if (index.dim() == 0) {
+    out_data[0] = in_data[index_data[0]];
+    return;
+  }
+
+  for (const auto ix : c10::irange(index.numel())) {
+    size_t ix_coord[kTensorDimensionLimit];
+    indexToCoordinate(index, ix, ix_coord);
+
+    size_t in_coord[kTensorDimensionLimit];
+    for (const auto i : c10::irange(out.dim())) {
+      if (i == dim) {
+        in_coord[i] = index_data[ix];
+      } else {
+        in_coord[i] = ix_coord[i];
+      }
+    }
+
+    size_t in_ix = coordinateToIndex(in, in_coord);
+    size_t out_ix = coordinateToIndex(out, ix_coord);
+
+    out_data[out_ix] = in_data[in_ix];
+  }
+}
+
+} // namespace
+
+Tensor& gather_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    bool sparse_grad,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_gather_args(in, dim, index, sparse_grad, out),
+      InvalidArgument,
+      out);
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, index.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  static constexpr auto name = "gather.out";
+
+  ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    gather_helper<CTYPE>(in, index, out, dim);
+  });
+
+  return out;
+}
+
+Tensor& index_select_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, check_index_select_args(in, dim, index, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(in), InvalidArgument, out);
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  size_t expected_ndim = 0;
+  Tensor::SizesType expected_size[kTensorDimensionLimit];
+  get_index_select_out_target_size(
+      in, dim, index, expected_size, &expected_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {expected_size, expected_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (in.dim() == 0) {
+    memcpy(out.mutable_data_ptr(), in.const_data_ptr(), in.nbytes());
+    return out;
+  }
+
+  size_t leading_dims = getLeadingDims(in, dim);
+  size_t trailing_dims = getTrailingDims(in, dim);
+
+  if (leading_dims == 0 || trailing_dims == 0) {
+    return out;
+  }
+
+  size_t out_dim_length = out.size(dim);
+  size_t in_dim_length = in.size(dim);
+
+  size_t length_per_step = trailing_dims * in.element_size();
+
+  const char* input_data = in.const_data_ptr<char>();
+  char* out_data = out.mutable_data_ptr<char>();
+
+  ScalarType ix_type = index.scalar_type();
+
+  ET_SWITCH_TWO_TYPES(
+      Long, Int, ix_type, ctx, "index_select.out", CTYPE, [&]() {
+        const CTYPE* const index_arr = index.mutable_data_ptr<CTYPE>();
+        for (const auto i : c10::irange(leading_dims)) {
+          const char* src = input_data + i * in_dim_length * length_per_step;
+          char* dest = out_data + i * out_dim_length * length_per_step;
+          for (const auto j : c10::irange(out_dim_length)) {
+            const char* copy_src = src + index_arr[j] * length_per_step;
+            memcpy(dest, copy_src, length_per_step);
+            dest += length_per_step;
+          }
+        }
+      });
+
+  return out;
+}
+
+namespace {
+
+template <typename CTYPE>
+void scatter_src_helper(
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& src,
+    Tensor& out) {
+  const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+  const int64_t* index_data = index.const_data_ptr<int64_t>();
+  const CTYPE* src_data = src.const_data_ptr<CTYPE>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+  memcpy(out_data, in_data, in.nbytes());
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  for (const auto ix : c10::irange(index.numel())) {
+    // @lint-ignore CLANGTIDY facebook-hte-CArray
+    size_t ix_coord[kTensorDimensionLimit];
+    indexToCoordinate(index, ix, ix_coord);
+
+    size_t src_ix = coordinateToIndex(src, ix_coord);
+
+    // @lint-ignore CLANGTIDY facebook-hte-CArray
+    size_t out_coord[kTensorDimensionLimit];
+    for (const auto i : c10::irange(out.dim())) {
+      if (i == dim) {
+        out_coord[i] = index_data[ix];
+      } else {
+        out_coord[i] = ix_coord[i];
+      }
+    }
+    size_t out_ix = coordinateToIndex(out, out_coord);
+
+    out_data[out_ix] = src_data[src_ix];
+  }
+}
+
+template <typename CTYPE, typename CTYPE_VAL>
+void scatter_value_helper(
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    CTYPE_VAL val,
+    Tensor& out) {
+  const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+  const int64_t* index_data = index.const_data_ptr<int64_t>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+  memcpy(out_data, in_data, in.nbytes());
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  for (const auto ix : c10::irange(index.numel())) {
+    // @lint-ignore CLANGTIDY facebook-hte-CArray
+    size_t ix_coord[kTensorDimensionLimit];
+    indexToCoordinate(index, ix, ix_coord);
+
+    // @lint-ignore CLANGTIDY facebook-hte-CArray
+    size_t out_coord[kTensorDimensionLimit];
+    for (const auto i : c10::irange(out.dim())) {
+      if (i == dim) {
+        out_coord[i] = index_data[ix];
+      } else {
+        out_coord[i] = ix_coord[i];
+      }
+    }
+    size_t out_ix = coordinateToIndex(out, out_coord);
+
+    out_data[out_ix] = static_cast<CTYPE>(val);
+  }
+}
+
+} // namespace
+
+Tensor& scatter_src_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& src,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_scatter_src_args(in, dim, index, src, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  static constexpr auto name = "scatter.src_out";
+
+  ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    scatter_src_helper<CTYPE>(in, dim, index, src, out);
+  });
+
+  return out;
+}
+
+Tensor& scatter_value_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    const Scalar& value,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_scatter_value_args(in, dim, index, value, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  static constexpr auto name = "scatter.value_out";
+
+  ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    auto opt_val =
+        native::utils::internal::check_overflow_scalar_cast<CTYPE>(value);
+    ET_KERNEL_CHECK(ctx, opt_val.has_value(), InvalidArgument, );
+    auto val = opt_val.value();
+    scatter_value_helper<CTYPE>(in, dim, index, val, out);
+  });
+
+  return out;
+}
+
+namespace {
+
+template <typename CTYPE>
+void scatter_add_helper(
+    const CTYPE* src_data,
+    const int64_t* index_data,
+    CTYPE* out_data,
+    const Tensor& src,
+    const Tensor& index,
+    Tensor& out,
+    int64_t dim) {
+  for (const auto ix : c10::irange(index.numel())) {
+    size_t ix_coord[kTensorDimensionLimit];
+    indexToCoordinate(index, ix, ix_coord);
+
+    size_t src_ix = coordinateToIndex(src, ix_coord);
+
+    size_t out_coord[kTensorDimensionLimit];
+    for (const auto i : c10::irange(out.dim())) {
+      if (i == dim) {
+        out_coord[i] = index_data[ix];
+      } else {
+        out_coord[i] = ix_coord[i];
+      }
+    }
+    size_t out_ix = coordinateToIndex(out, out_coord);
+
+    out_data[out_ix] += src_data[src_ix];
+  }
+}
+
+} // namespace
+
+Tensor& scatter_add_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& self,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& src,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_scatter_add_args(self, dim, index, src, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(self, src, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensor_is_default_dim_order(index), InvalidArgument, out);
+
+  if (dim < 0) {
+    dim += nonzero_dim(self);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, self.sizes()) == Error::Ok, InvalidArgument, out);
+
+  ScalarType self_type = self.scalar_type();
+
+  ET_SWITCH_REALHBBF16_TYPES(self_type, ctx, "scatter_add.out", CTYPE, [&]() {
+    const CTYPE* self_data = self.const_data_ptr<CTYPE>();
+    const int64_t* index_data = index.const_data_ptr<int64_t>();
+    const CTYPE* src_data = src.const_data_ptr<CTYPE>();
+    CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+    memcpy(out_data, self_data, self.nbytes());
+
+    if (index.numel() != 0) {
+      if (self.dim() == 0) {
+        out_data[0] +=
+            static_cast<CTYPE>(nonempty_size(index, 0)) * src_data[0];
+      } else {
+        scatter_add_helper<CTYPE>(
+            src_data, index_data, out_data, src, index, out, dim);
+      }
+    }
+  });
+
+  return out;
+}
+
 } // namespace executor
 } // namespace torch
@@ -10,6 +10,7 @@
 
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
 namespace executor {
@@ -64,5 +65,47 @@ bool check_select_scatter_args(
     int64_t index,
     Tensor& output);
 
+// Implementations of the portable gather, index_select and scatter ops. The
+// optimized kernels call these for the inputs their fast paths don't cover.
+
+Tensor& gather_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    bool sparse_grad,
+    Tensor& out);
+
+Tensor& index_select_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    Tensor& out);
+
+Tensor& scatter_add_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& self,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& src,
+    Tensor& out);
+
+Tensor& scatter_src_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& src,
+    Tensor& out);
+
+Tensor& scatter_value_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    const Scalar& value,
+    Tensor& out);
+
 } // namespace executor
 } // namespace torch
@@ -384,6 +384,44 @@ void apply_kernel_2d_reduce_then_map_fn(
 // Operator specific utility functions
 //
 
+// Implementations of the portable pooling and convolution ops. The optimized
+// kernels call these for the dim orders their fast paths don't cover.
+
+Tensor& avg_pool2d_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode,
+    bool count_include_pad,
+    std::optional<int64_t> divisor_override,
+    Tensor& out);
+
+std::tuple<Tensor&, Tensor&> max_pool2d_with_indices_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode,
+    Tensor& out,
+    Tensor& indices);
+
+Tensor& convolution_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    Tensor& out);
+
 bool check_arange_args(double start, double end, double step, Tensor& out);
 
 bool check_avg_pool2d_args(
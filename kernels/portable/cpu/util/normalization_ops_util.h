@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <tuple>
+
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
@@ -52,5 +54,36 @@ bool check_group_norm_args(
     Tensor& mean_out,
     Tensor& rstd_out);
 
+// Implementations of the portable batch and group norm ops. The optimized
+// kernels call these for the dim orders their fast paths don't cover.
+
+std::tuple<Tensor&, Tensor&, Tensor&>
+_native_batch_norm_legit_no_training_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    const Tensor& running_mean,
+    const Tensor& running_var,
+    double momentum,
+    double eps,
+    Tensor& out,
+    Tensor& mean_out,
+    Tensor& invstd_out);
+
+std::tuple<Tensor&, Tensor&, Tensor&> native_group_norm_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps,
+    Tensor& out,
+    Tensor& mean_out,
+    Tensor& rstd_out);
+
 } // namespace executor
 } // namespace torch
@@ -204,6 +204,68 @@ size_t get_init_index(
   return init_ix;
 }
 
+namespace {
+
+// Returns true if `in` is laid out contiguously in its logical dim order. Dims
+// of size 1 may have any stride.
+bool is_contiguous_ignoring_size_1_dims(const Tensor& in) {
+  const auto strides = in.strides();
+  ssize_t expected_stride = 1;
+  for (ssize_t d = in.dim() - 1; d >= 0; --d) {
+    if (in.size(d) != 1 && strides[d] != expected_stride) {
+      return false;
+    }
+    expected_stride *= in.size(d);
+  }
+  return true;
+}
+
+} // namespace
+
+bool reduces_contiguous_inner_dims(
+    const Tensor& in,
+    const std::optional<int64_t>& dim) {
+  if (!is_contiguous_ignoring_size_1_dims(in)) {
+    return false;
+  }
+  if (!dim.has_value() || in.dim() == 0) {
+    return true;
+  }
+  // Only dims of size 1 may follow the reduced dim.
+  const ssize_t d = _normalize_non_neg_d(dim.value(), in.dim());
+  for (ssize_t i = d + 1; i < in.dim(); ++i) {
+    if (in.size(i) != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool reduces_contiguous_inner_dims(
+    const Tensor& in,
+    const std::optional<executorch::aten::ArrayRef<int64_t>>& dim_list) {
+  if (!is_contiguous_ignoring_size_1_dims(in)) {
+    return false;
+  }
+  if (!dim_list.has_value() || dim_list.value().size() == 0 ||
+      in.dim() == 0) {
+    return true;
+  }
+  // No kept dim may follow a reduced dim, ignoring dims of size 1.
+  bool seen_kept_dim = false;
+  for (ssize_t d = in.dim() - 1; d >= 0; --d) {
+    if (in.size(d) == 1) {
+      continue;
+    }
+    if (!check_dim_in_dim_list(d, in.dim(), dim_list.value())) {
+      seen_kept_dim = true;
+    } else if (seen_kept_dim) {
+      return false;
+    }
+  }
+  return true;
+}
+
 //
 // Resize out tensor of reduction op
 //
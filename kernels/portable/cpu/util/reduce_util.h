@@ -200,6 +200,34 @@ inline size_t get_init_index(
     const size_t out_ix) {
   return get_init_index(in, std::optional<int64_t>(dim), out_ix);
 }
+
+/**
+ * Returns true if reducing `in` over `dim` reduces contiguous runs of its
+ * elements: output element i then reduces elements [i * n, (i + 1) * n) of
+ * `in`, where n is get_reduced_dim_product(in, dim). This holds when `in` is
+ * contiguous and only dims of size 1 follow `dim`.
+ */
+bool reduces_contiguous_inner_dims(
+    const executorch::aten::Tensor& in,
+    const std::optional<int64_t>& dim);
+
+/**
+ * Returns true if reducing `in` over `dim_list` reduces contiguous runs of its
+ * elements, as above. This holds when `in` is contiguous and `dim_list` covers
+ * its innermost dims, ignoring dims of size 1.
+ */
+bool reduces_contiguous_inner_dims(
+    const executorch::aten::Tensor& in,
+    const std::optional<executorch::aten::ArrayRef<int64_t>>& dim_list);
+
+// Resolve ambiguity between the above two overloads -- ArrayRef and
+// optional are both implicitly constructible from int64_t.
+inline bool reduces_contiguous_inner_dims(
+    const executorch::aten::Tensor& in,
+    int64_t dim) {
+  return reduces_contiguous_inner_dims(in, std::optional<int64_t>(dim));
+}
+
 //
 // Iteration Functions
 //
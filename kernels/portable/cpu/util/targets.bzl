@@ -27,6 +27,7 @@ def define_common_targets():
             "//executorch/kernels/portable/cpu/util:repeat_util",
             "//executorch/kernels/portable/cpu/util:activation_ops_util",
             "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/kernels/portable/cpu/util:contiguous_reduce_util",
             "//executorch/kernels/portable/cpu/util:normalization_ops_util",
             "//executorch/kernels/portable/cpu/util:distance_util",
             "//executorch/kernels/portable/cpu/util:select_copy_util",
@@ -126,6 +127,25 @@ def define_common_targets():
         visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/optimized/cpu/...", "@EXECUTORCH_CLIENTS"],
     )
 
+    runtime.cxx_library(
+        name = "fused_elementwise",
+        srcs = ["fused_elementwise.cpp"],
+        exported_headers = [
+            "fused_elementwise.h",
+        ],
+        compiler_flags = ["-Wno-missing-prototypes"],
+        exported_deps = [
+            "//executorch/runtime/kernel:fused_elementwise",
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+        deps = [
+            ":elementwise_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/runtime/kernel:operator_registry",
+        ],
+        visibility = ["//executorch/...", "@EXECUTORCH_CLIENTS"],
+    )
+
     runtime.cxx_library(
         name = "advanced_index_util",
         srcs = ["advanced_index_util.cpp"],
@@ -178,6 +198,7 @@ def define_common_targets():
         ],
         compiler_flags = ["-Wno-missing-prototypes"],
         deps = [
+            ":dtype_util",
             "//executorch/runtime/kernel:kernel_includes",
         ],
         visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/optimized/cpu/..."],
@@ -218,6 +239,7 @@ def define_common_targets():
         ],
         compiler_flags = ["-Wno-missing-prototypes"],
         deps = [
+            "//executorch/kernels/portable/cpu:vec_ops",
             "//executorch/runtime/kernel:kernel_includes",
         ],
         visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/optimized/cpu/..."],
@@ -232,7 +254,7 @@ def define_common_targets():
             "//executorch/runtime/kernel:kernel_includes",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
         ],
-        visibility = ["//executorch/kernels/portable/cpu/..."],
+        visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/optimized/cpu/..."],
     )
 
     # Utility functions that can be used by operators that perform indexing
@@ -241,10 +263,11 @@ def define_common_targets():
         srcs = ["index_util.cpp"],
         exported_headers = ["index_util.h"],
         deps = [
+            "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/runtime/kernel:kernel_includes",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
         ],
-        visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/quantized/..."],
+        visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/optimized/cpu/...", "//executorch/kernels/quantized/..."],
     )
 
     # Utility functions that can be used by operators that repeat the same computation for each element in the tensor
@@ -293,7 +316,7 @@ def define_common_targets():
         deps = [
             "//executorch/runtime/kernel:kernel_includes",
         ],
-        visibility = ["//executorch/kernels/portable/cpu/..."],
+        visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/optimized/cpu/..."],
     )
 
     runtime.cxx_library(
@@ -316,7 +339,7 @@ def define_common_targets():
         deps = [
             "//executorch/runtime/kernel:kernel_includes",
         ],
-        visibility = ["//executorch/kernels/portable/cpu/..."],
+        visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/optimized/cpu/..."],
     )
 
     runtime.cxx_library(
@@ -342,6 +365,19 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "contiguous_reduce_util",
+        exported_headers = ["contiguous_reduce_util.h"],
+        exported_deps = [
+            ":math_util",
+            ":reduce_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+        visibility = ["//executorch/kernels/portable/cpu/...", "//executorch/kernels/optimized/cpu/..."],
+    )
+
     # Utility functions that can be used by operators that perform reduction
     for aten_mode in get_aten_mode_options():
         suffix = "_aten" if aten_mode else ""
@@ -359,6 +395,7 @@ def define_common_targets():
             exported_preprocessor_flags = ["-DUSE_ATEN_LIB"] if aten_mode else [],
             visibility = [
                 "//executorch/extension/llm/custom_ops/...",
+                "//executorch/kernels/optimized/cpu/...",
                 "//executorch/kernels/portable/cpu/...",
                 "//executorch/kernels/quantized/...",
                 "@EXECUTORCH_CLIENTS",
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/elementwise_util.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::testing::TensorFactory;
+using torch::executor::native::utils::SupportedTensorDtypes;
+
+namespace {
+
+static constexpr const char kSubOpName[] = "sub.out";
+static constexpr const char kFmaOpName[] = "fma.out";
+static constexpr const char kLtOpName[] = "lt.out";
+
+std::vector<float> sin_data(const std::vector<int32_t>& sizes) {
+  size_t numel = 1;
+  for (const auto size : sizes) {
+    numel *= size;
+  }
+  std::vector<float> data(numel);
+  for (size_t i = 0; i < numel; ++i) {
+    data[i] = std::sin(static_cast<float>(i) + 0.5f * sizes.size());
+  }
+  return data;
+}
+
+// Returns the index into a contiguous input of the given sizes that
+// broadcasting maps output index out_idx to.
+size_t broadcast_index(
+    const std::vector<int32_t>& in_sizes,
+    const std::vector<int32_t>& out_sizes,
+    size_t out_idx) {
+  size_t in_idx = 0;
+  size_t in_stride = 1;
+  const size_t offset = out_sizes.size() - in_sizes.size();
+  for (size_t d = out_sizes.size(); d-- > 0;) {
+    const size_t coord = out_idx % out_sizes[d];
+    out_idx /= out_sizes[d];
+    if (d < offset) {
+      continue;
+    }
+    const size_t in_size = in_sizes[d - offset];
+    in_idx += (in_size == 1 ? 0 : coord) * in_stride;
+    in_stride *= in_size;
+  }
+  return in_idx;
+}
+
+class ElementwiseUtilTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  // Checks a - b against a reference for inputs of the given sizes.
+  void test_sub(
+      const std::vector<int32_t>& a_sizes,
+      const std::vector<int32_t>& b_sizes,
+      const std::vector<int32_t>& out_sizes) {
+    TensorFactory<ScalarType::Float> tf;
+    const auto a_data = sin_data(a_sizes);
+    const auto b_data = sin_data(b_sizes);
+    Tensor out = tf.zeros(out_sizes);
+    std::vector<float> expected(out.numel());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      expected[i] = a_data[broadcast_index(a_sizes, out_sizes, i)] -
+          b_data[broadcast_index(b_sizes, out_sizes, i)];
+    }
+
+    KernelRuntimeContext ctx;
+    torch::executor::native::utils::apply_bitensor_elementwise_fn<
+        float,
+        kSubOpName,
+        SupportedTensorDtypes::SAME_AS_COMMON>(
+        [](const auto a, const auto b) { return a - b; },
+        ctx,
+        tf.make(a_sizes, a_data),
+        SupportedTensorDtypes::REALHBBF16,
+        tf.make(b_sizes, b_data),
+        SupportedTensorDtypes::REALHBBF16,
+        out);
+    ASSERT_EQ(ctx.failure_state(), executorch::runtime::Error::Ok);
+    EXPECT_TENSOR_EQ(out, tf.make(out_sizes, expected));
+  }
+};
+
+} // namespace
+
+TEST_F(ElementwiseUtilTest, NoBroadcast) {
+  test_sub({3, 5, 19}, {3, 5, 19}, {3, 5, 19});
+  test_sub({5, 19}, {1, 5, 19}, {1, 5, 19});
+}
+
+TEST_F(ElementwiseUtilTest, ScalarBroadcast) {
+  test_sub({3, 5, 19}, {1}, {3, 5, 19});
+  test_sub({}, {77}, {77});
+}
+
+TEST_F(ElementwiseUtilTest, RowVectorBroadcast) {
+  test_sub({3, 5, 19}, {19}, {3, 5, 19});
+  test_sub({1, 1, 19}, {4, 7, 19}, {4, 7, 19});
+  test_sub({3, 1, 19}, {3, 5, 19}, {3, 5, 19});
+}
+
+TEST_F(ElementwiseUtilTest, ColumnVectorBroadcast) {
+  test_sub({3, 5, 19}, {5, 1}, {3, 5, 19});
+  test_sub({3, 5, 1}, {3, 5, 19}, {3, 5, 19});
+  test_sub({40, 1}, {40, 3}, {40, 3});
+}
+
+TEST_F(ElementwiseUtilTest, OuterBroadcast) {
+  test_sub({1, 5, 19}, {3, 5, 19}, {3, 5, 19});
+  test_sub({3, 1, 1}, {3, 5, 19}, {3, 5, 19});
+}
+
+TEST_F(ElementwiseUtilTest, BothInputsBroadcast) {
+  test_sub({6, 1}, {1, 19}, {6, 19});
+  test_sub({3, 1, 19}, {1, 5, 1}, {3, 5, 19});
+}
+
+TEST_F(ElementwiseUtilTest, OtherBroadcastsFallBack) {
+  // Outer dims that are only partly broadcast go through the general path.
+  test_sub({2, 1, 5, 19}, {2, 3, 5, 19}, {2, 3, 5, 19});
+  test_sub({4, 1, 1, 3}, {2, 5, 3}, {4, 2, 5, 3});
+}
+
+TEST_F(ElementwiseUtilTest, TernaryBroadcast) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<int32_t> a_sizes = {3, 5, 19};
+  const std::vector<int32_t> b_sizes = {5, 1};
+  const std::vector<int32_t> c_sizes = {19};
+  const auto a_data = sin_data(a_sizes);
+  const auto b_data = sin_data(b_sizes);
+  const auto c_data = sin_data(c_sizes);
+  std::vector<float> expected(3 * 5 * 19);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = a_data[i] * b_data[broadcast_index(b_sizes, a_sizes, i)] +
+        c_data[broadcast_index(c_sizes, a_sizes, i)];
+  }
+
+  Tensor out = tf.zeros(a_sizes);
+  KernelRuntimeContext ctx;
+  torch::executor::native::utils::apply_tritensor_elementwise_fn<
+      float,
+      kFmaOpName,
+      SupportedTensorDtypes::SAME_AS_COMMON>(
+      [](const auto a, const auto b, const auto c) { return a * b + c; },
+      ctx,
+      tf.make(a_sizes, a_data),
+      SupportedTensorDtypes::REALHBBF16,
+      tf.make(b_sizes, b_data),
+      SupportedTensorDtypes::REALHBBF16,
+      tf.make(c_sizes, c_data),
+      SupportedTensorDtypes::REALHBBF16,
+      out);
+  ASSERT_EQ(ctx.failure_state(), executorch::runtime::Error::Ok);
+  EXPECT_TENSOR_CLOSE(out, tf.make(a_sizes, expected));
+}
+
+TEST_F(ElementwiseUtilTest, NonVectorizedBroadcast) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Bool> tf_bool;
+
+  // A comparison returns bool, so it can't use Vectorized.
+  Tensor out = tf_bool.zeros({2, 3});
+  KernelRuntimeContext ctx;
+  torch::executor::native::utils::apply_bitensor_elementwise_fn<
+      float,
+      kLtOpName,
+      SupportedTensorDtypes::BOOL>(
+      [](const float a, const float b) { return a < b; },
+      ctx,
+      tf.make({2, 3}, {0, 1, 2, 3, 4, 5}),
+      SupportedTensorDtypes::REALHBBF16,
+      tf.make({3}, {1, 3, 6}),
+      SupportedTensorDtypes::REALHBBF16,
+      out);
+  ASSERT_EQ(ctx.failure_state(), executorch::runtime::Error::Ok);
+  EXPECT_TENSOR_EQ(
+      out, tf_bool.make({2, 3}, {true, true, true, false, false, true}));
+}
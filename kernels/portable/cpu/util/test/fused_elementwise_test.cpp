@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/fused_elementwise.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/kernel/operator_registry.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::EValue;
+using executorch::runtime::FusedElementwiseOp;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::MemoryAllocator;
+using executorch::runtime::Span;
+using executorch::runtime::testing::TensorFactory;
+using torch::executor::fused_elementwise;
+
+namespace {
+
+// Builds the arguments of a fused chain.
+class FusedChainArgs {
+ public:
+  explicit FusedChainArgs(std::vector<EValue> operands)
+      : operands_(std::move(operands)) {
+    // Keep the EValues from moving, since args_ points at them.
+    ints_.reserve(64);
+  }
+
+  FusedChainArgs&
+  step(FusedElementwiseOp op, int64_t lhs, int64_t rhs = -1, double alpha = 1) {
+    ints_.emplace_back(static_cast<int64_t>(op));
+    ints_.emplace_back(lhs);
+    ints_.emplace_back(rhs);
+    ints_.emplace_back(alpha);
+    return *this;
+  }
+
+  Span<EValue*> args(Tensor& out) {
+    out_ = EValue(out);
+    n_operands_ = EValue(static_cast<int64_t>(operands_.size()));
+    args_.clear();
+    args_.push_back(&n_operands_);
+    for (auto& operand : operands_) {
+      args_.push_back(&operand);
+    }
+    for (auto& value : ints_) {
+      args_.push_back(&value);
+    }
+    args_.push_back(&out_);
+    return {args_.data(), args_.size()};
+  }
+
+ private:
+  std::vector<EValue> operands_;
+  std::vector<EValue> ints_;
+  std::vector<EValue*> args_;
+  EValue n_operands_;
+  EValue out_;
+};
+
+std::vector<float> iota_data(size_t n, float scale) {
+  std::vector<float> data(n);
+  for (size_t i = 0; i < n; ++i) {
+    data[i] = std::sin(static_cast<float>(i)) * scale;
+  }
+  return data;
+}
+
+class FusedElementwiseTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Kernel failures log, which needs the PAL.
+    executorch::runtime::runtime_init();
+  }
+};
+
+} // namespace
+
+TEST_F(FusedElementwiseTest, MatchesUnfusedOps) {
+  TensorFactory<ScalarType::Float> tf;
+  // Not a multiple of the block size.
+  constexpr int32_t kSize = 150;
+  const auto x = iota_data(kSize, 2);
+  const auto y = iota_data(kSize, 3);
+  const auto z = iota_data(kSize, 0.5);
+
+  // sigmoid(((x - 2 * y) * 0.5) + z) * x
+  std::vector<float> expected(kSize);
+  for (int32_t i = 0; i < kSize; ++i) {
+    float v = x[i] - 2.0f * y[i];
+    v = v * 0.5f;
+    v = v + 1.0f * z[i];
+    v = 1.0f / (1.0f + std::exp(-v));
+    expected[i] = v * x[i];
+  }
+
+  FusedChainArgs chain(
+      {EValue(tf.make({kSize}, x)),
+       EValue(tf.make({kSize}, y)),
+       EValue(0.5),
+       EValue(tf.make({kSize}, z))});
+  // Operands are values 0-3, and the result of step s is value 4 + s.
+  chain.step(FusedElementwiseOp::Sub, 0, 1, 2)
+      .step(FusedElementwiseOp::Mul, 4, 2)
+      .step(FusedElementwiseOp::Add, 5, 3)
+      .step(FusedElementwiseOp::Sigmoid, 6)
+      .step(FusedElementwiseOp::Mul, 7, 0);
+  Tensor out = tf.zeros({kSize});
+  KernelRuntimeContext ctx;
+  fused_elementwise(ctx, chain.args(out));
+  ASSERT_EQ(ctx.failure_state(), Error::Ok);
+  EXPECT_TENSOR_CLOSE(out, tf.make({kSize}, expected));
+}
+
+TEST_F(FusedElementwiseTest, UnaryOps) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<float> x = {-2, -0.5, 0, 0.5, 2, NAN};
+
+  std::vector<float> expected(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    float v = -(x[i] / 4);
+    v = (std::isnan(v) || v >= 0) ? v : 0;
+    expected[i] = std::tanh(std::exp(v));
+  }
+
+  FusedChainArgs chain({EValue(tf.make({2, 3}, x)), EValue(int64_t(4))});
+  chain.step(FusedElementwiseOp::Div, 0, 1)
+      .step(FusedElementwiseOp::Neg, 2)
+      .step(FusedElementwiseOp::Relu, 3)
+      .step(FusedElementwiseOp::Exp, 4)
+      .step(FusedElementwiseOp::Tanh, 5);
+  Tensor out = tf.zeros({2, 3});
+  KernelRuntimeContext ctx;
+  fused_elementwise(ctx, chain.args(out));
+  ASSERT_EQ(ctx.failure_state(), Error::Ok);
+  EXPECT_TENSOR_CLOSE(out, tf.make({2, 3}, expected));
+}
+
+TEST_F(FusedElementwiseTest, OutputOffsetIntoOperand) {
+  TensorFactory<ScalarType::Float> tf;
+  constexpr int32_t kSize = 200;
+  constexpr int32_t kOffset = 3;
+  std::vector<float> buffer = iota_data(kSize + kOffset, 1);
+  std::vector<float> expected(kSize);
+  for (int32_t i = 0; i < kSize; ++i) {
+    expected[i] = buffer[i] * buffer[i] + 1;
+  }
+
+  // The output starts a few elements into the operand, as the memory plan
+  // may lay them out when the operand is dead by the end of the chain.
+  int32_t sizes[1] = {kSize};
+  uint8_t dim_order[1] = {0};
+  int32_t strides[1] = {1};
+  executorch::aten::TensorImpl in_impl(
+      ScalarType::Float, 1, sizes, buffer.data(), dim_order, strides);
+  executorch::aten::TensorImpl out_impl(
+      ScalarType::Float, 1, sizes, buffer.data() + kOffset, dim_order, strides);
+  Tensor out(&out_impl);
+
+  FusedChainArgs chain({EValue(Tensor(&in_impl)), EValue(1.0)});
+  chain.step(FusedElementwiseOp::Mul, 0, 0)
+      .step(FusedElementwiseOp::Add, 2, 1);
+
+  std::vector<uint8_t> temp(kSize * sizeof(float) + 64);
+  MemoryAllocator temp_allocator(temp.size(), temp.data());
+  KernelRuntimeContext ctx(nullptr, &temp_allocator);
+  fused_elementwise(ctx, chain.args(out));
+  ASSERT_EQ(ctx.failure_state(), Error::Ok);
+  EXPECT_TENSOR_CLOSE(out, tf.make({kSize}, expected));
+}
+
+TEST_F(FusedElementwiseTest, RejectsMalformedChains) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor out = tf.zeros({2});
+
+  // Step 0 reads its own result.
+  FusedChainArgs reads_ahead({EValue(tf.ones({2}))});
+  reads_ahead.step(FusedElementwiseOp::Add, 0, 1);
+  KernelRuntimeContext ctx;
+  fused_elementwise(ctx, reads_ahead.args(out));
+  EXPECT_EQ(ctx.failure_state(), Error::InvalidArgument);
+
+  // Operands must have as many elements as the output.
+  FusedChainArgs wrong_size({EValue(tf.ones({3}))});
+  wrong_size.step(FusedElementwiseOp::Exp, 0);
+  KernelRuntimeContext ctx2;
+  fused_elementwise(ctx2, wrong_size.args(out));
+  EXPECT_EQ(ctx2.failure_state(), Error::InvalidArgument);
+
+  // Unary ops have no second input.
+  FusedChainArgs unary_rhs({EValue(tf.ones({2}))});
+  unary_rhs.step(FusedElementwiseOp::Exp, 0, 0);
+  KernelRuntimeContext ctx3;
+  fused_elementwise(ctx3, unary_rhs.args(out));
+  EXPECT_EQ(ctx3.failure_state(), Error::InvalidArgument);
+}
+
+TEST_F(FusedElementwiseTest, RegistersOnce) {
+  EXPECT_EQ(torch::executor::register_fused_elementwise_kernel(), Error::Ok);
+  EXPECT_EQ(torch::executor::register_fused_elementwise_kernel(), Error::Ok);
+  EXPECT_TRUE(executorch::runtime::registry_has_op_function(
+      executorch::runtime::kFusedElementwiseKernelName));
+}
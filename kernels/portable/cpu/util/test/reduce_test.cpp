@@ -6,14 +6,20 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/portable/cpu/util/contiguous_reduce_util.h>
 #include <executorch/kernels/portable/cpu/util/reduce_util.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/platform/runtime.h>
 #include <executorch/test/utils/DeathTest.h>
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <limits>
+#include <vector>
+
 using namespace ::testing;
 using executorch::aten::ArrayRef;
 using executorch::aten::ScalarType;
@@ -23,6 +29,7 @@ using std::optional;
 using torch::executor::apply_over_dim;
 using torch::executor::apply_over_dim_list;
 using torch::executor::get_out_numel;
+using torch::executor::reduces_contiguous_inner_dims;
 
 void _apply_over_dim(const Tensor& in, const optional<int64_t>& dim) {
   int64_t* in_data = in.mutable_data_ptr<int64_t>();
@@ -581,3 +588,84 @@ TEST(ReduceUtilTest, ApplyOverDimListInvalid) {
   ET_EXPECT_DEATH(
       apply_over_dim_list([](size_t in_ix) { return; }, in, dim_list, 0), "");
 }
+
+TEST(ReduceUtilTest, ReducesContiguousInnerDims) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor in = tf.zeros({2, 3, 1, 4});
+
+  EXPECT_TRUE(reduces_contiguous_inner_dims(in, 3));
+  EXPECT_TRUE(reduces_contiguous_inner_dims(in, -1));
+  EXPECT_FALSE(reduces_contiguous_inner_dims(in, 1));
+  EXPECT_TRUE(reduces_contiguous_inner_dims(in, optional<int64_t>()));
+
+  int64_t dims_13[2] = {1, 3};
+  EXPECT_TRUE(reduces_contiguous_inner_dims(
+      in, optional<ArrayRef<int64_t>>(ArrayRef<int64_t>{dims_13, 2})));
+  int64_t dims_02[2] = {0, 2};
+  EXPECT_FALSE(reduces_contiguous_inner_dims(
+      in, optional<ArrayRef<int64_t>>(ArrayRef<int64_t>{dims_02, 2})));
+  EXPECT_TRUE(reduces_contiguous_inner_dims(
+      in, optional<ArrayRef<int64_t>>(ArrayRef<int64_t>{})));
+
+  // Trailing dims of size 1 don't break contiguity.
+  Tensor in_trailing = tf.zeros({2, 5, 1});
+  EXPECT_TRUE(reduces_contiguous_inner_dims(in_trailing, 1));
+
+  Tensor in_channels_last = tf.full_channels_last({2, 3, 4, 5}, 0);
+  EXPECT_FALSE(reduces_contiguous_inner_dims(in_channels_last, 3));
+}
+
+TEST(ReduceUtilTest, ParallelSumContiguousRows) {
+  executorch::runtime::runtime_init();
+  TensorFactory<ScalarType::Float> tf;
+
+  // Few long rows are split into chunks that are summed separately.
+  const std::vector<int32_t> sizes = {3, 100000};
+  std::vector<float> data(3 * 100000);
+  std::vector<double> expected(3, 0);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = std::sin(static_cast<float>(i));
+    expected[i / 100000] += data[i];
+  }
+  Tensor in = tf.make(sizes, data);
+
+  std::vector<float> sums(3);
+  const bool success =
+      torch::executor::parallel_sum_contiguous_rows<float, float>(
+          in,
+          100000,
+          [](const auto v, size_t) { return v; },
+          [&](size_t row, float sum) { sums[row] = sum; });
+  EXPECT_TRUE(success);
+  for (size_t row = 0; row < 3; ++row) {
+    EXPECT_NEAR(sums[row], expected[row], 1e-3);
+  }
+}
+
+TEST(ReduceUtilTest, ParallelExtremumContiguousRows) {
+  executorch::runtime::runtime_init();
+  TensorFactory<ScalarType::Float> tf;
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+
+  Tensor in = tf.make(
+      {3, 4},
+      {1, 5, 5, 2, //
+       -3, nan, 7, nan, //
+       4, -2, 4, -2});
+
+  std::vector<float> maxes(3);
+  EXPECT_TRUE(torch::executor::parallel_max_contiguous_rows<float>(
+      in, 4, [&](size_t row, float v) { maxes[row] = v; }));
+  EXPECT_EQ(maxes[0], 5);
+  EXPECT_TRUE(std::isnan(maxes[1]));
+  EXPECT_EQ(maxes[2], 4);
+
+  std::vector<int64_t> indices(3);
+  EXPECT_TRUE(torch::executor::parallel_argmax_contiguous_rows<float>(
+      in, 4, [&](size_t row, int64_t ix) { indices[row] = ix; }));
+  EXPECT_EQ(indices, (std::vector<int64_t>{1, 1, 0}));
+
+  EXPECT_TRUE(torch::executor::parallel_argmin_contiguous_rows<float>(
+      in, 4, [&](size_t row, int64_t ix) { indices[row] = ix; }));
+  EXPECT_EQ(indices, (std::vector<int64_t>{0, 1, 1}));
+}
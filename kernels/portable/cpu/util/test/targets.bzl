@@ -23,13 +23,38 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "elementwise_util_test",
+        srcs = ["elementwise_util_test.cpp"],
+        deps = [
+            "//executorch/kernels/portable/cpu/util:elementwise_util",
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "fused_elementwise_test",
+        srcs = ["fused_elementwise_test.cpp"],
+        deps = [
+            "//executorch/kernels/portable/cpu/util:fused_elementwise",
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/runtime/kernel:operator_registry",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
     runtime.cxx_test(
         name = "reduce_test",
         srcs = ["reduce_test.cpp"],
         deps = [
             "//executorch/runtime/core/exec_aten:lib",
             "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/portable/cpu/util:contiguous_reduce_util",
             "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/runtime/platform:platform",
         ],
     )
 
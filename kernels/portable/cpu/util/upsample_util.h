@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
@@ -145,5 +148,106 @@ inline int64_t nearest_neighbor_compute_source_index(
   return src_index;
 }
 
+// Anti-aliasing filter matching PyTorch's implementation exactly
+template <typename T>
+inline T bilinear_aa_filter(T x) {
+  x = std::abs(x);
+  return (x < static_cast<T>(1.0)) ? (static_cast<T>(1.0) - x)
+                                   : static_cast<T>(0.0);
+}
+
+// Compute anti-aliasing weights exactly matching PyTorch's algorithm
+template <typename T>
+inline void compute_aa_weights_for_pixel(
+    int64_t output_idx,
+    T scale,
+    int64_t input_size,
+    int64_t* indices,
+    T* weights,
+    int64_t* num_contributors) {
+  // Use the provided scale directly instead of recalculating
+
+  // PyTorch's center calculation for anti-aliasing
+  // Always uses scale * (i + 0.5) for anti-aliasing, regardless of
+  // align_corners
+  const T center = scale * (output_idx + static_cast<T>(0.5));
+
+  // PyTorch's support calculation for bilinear anti-aliasing
+  // interp_size = 2 for bilinear, so base support = 1.0
+  const T support = (scale >= static_cast<T>(1.0))
+      ? (static_cast<T>(1.0) * scale)
+      : static_cast<T>(1.0);
+
+  // PyTorch's exact range calculation
+  const int64_t xmin = std::max(
+      static_cast<int64_t>(center - support + static_cast<T>(0.5)),
+      static_cast<int64_t>(0));
+  const int64_t xmax = std::min(
+      static_cast<int64_t>(center + support + static_cast<T>(0.5)), input_size);
+
+  *num_contributors = std::min(xmax - xmin, static_cast<int64_t>(4));
+
+  // Ensure we have at least one contributor
+  if (*num_contributors <= 0) {
+    *num_contributors = 1;
+    indices[0] = std::max(
+        static_cast<int64_t>(0),
+        std::min(static_cast<int64_t>(center), input_size - 1));
+    weights[0] = static_cast<T>(1.0);
+    // Clear unused weight slots
+    for (int64_t j = 1; j < 4; ++j) {
+      weights[j] = static_cast<T>(0.0);
+    }
+    return;
+  }
+
+  // PyTorch's weight computation
+  T total_weight = static_cast<T>(0.0);
+  const T invscale = (scale >= static_cast<T>(1.0))
+      ? (static_cast<T>(1.0) / scale)
+      : static_cast<T>(1.0);
+
+  for (int64_t j = 0; j < *num_contributors; ++j) {
+    int64_t x = xmin + j;
+    // PyTorch's exact weight formula: (j + xmin - center + 0.5) * invscale
+    T arg = (static_cast<T>(j) + static_cast<T>(xmin) - center +
+             static_cast<T>(0.5)) *
+        invscale;
+    T weight = bilinear_aa_filter<T>(arg);
+    indices[j] = x;
+    weights[j] = weight;
+    total_weight += weight;
+  }
+
+  // Normalize weights to sum to 1 (PyTorch does this)
+  if (total_weight > static_cast<T>(0.0)) {
+    for (int64_t j = 0; j < *num_contributors; ++j) {
+      weights[j] /= total_weight;
+    }
+  } else {
+    // Fallback: if total weight is 0, set equal weights
+    T equal_weight = static_cast<T>(1.0) / static_cast<T>(*num_contributors);
+    for (int64_t j = 0; j < *num_contributors; ++j) {
+      weights[j] = equal_weight;
+    }
+  }
+
+  // Clear unused weight slots
+  for (int64_t j = *num_contributors; j < 4; ++j) {
+    weights[j] = static_cast<T>(0.0);
+  }
+}
+
+// Implementation of the portable _upsample_bilinear2d_aa.out op. The
+// optimized kernel calls it for the dim orders its fast path doesn't cover.
+Tensor& _upsample_bilinear2d_aa_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const executorch::aten::ArrayRef<int64_t> output_size,
+    bool align_corners,
+    const std::optional<double> scale_h,
+    const std::optional<double> scale_w,
+    Tensor& out);
+
 } // namespace executor
 } // namespace torch
@@ -1116,3 +1116,46 @@ TEST_F(OpAvgPool2DOutTest, SanityCheck4DCeilModeNoIncludePadding) {
   ET_FORALL_FLOATHBF16_TYPES(TEST_ENTRY)
 #undef TEST_ENTRY
 }
+
+TEST_F(OpAvgPool2DOutTest, ChannelsLastMatchesContiguous) {
+  if (!torch::executor::testing::SupportedFeatures::get()
+           ->op_avg_pool2d_channels_last) {
+    GTEST_SKIP() << "Channels last dim order is not supported";
+  }
+  torch::executor::testing::TensorFactory<ScalarType::Float> tf;
+
+  std::vector<float> data(2 * 11 * 7 * 6);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>((i * 37) % 101) - 50.0f;
+  }
+  executorch::aten::Tensor self = tf.make({2, 11, 7, 6}, data);
+
+  int64_t kernel_size[2] = {3, 2};
+  int64_t stride[2] = {2, 2};
+  int64_t padding[2] = {1, 1};
+
+  for (const bool count_include_pad : {true, false}) {
+    executorch::aten::Tensor expected = tf.zeros({2, 11, 4, 4});
+    op_avg_pool2d_out(
+        self,
+        kernel_size,
+        stride,
+        padding,
+        /*ceil_mode=*/false,
+        count_include_pad,
+        /*divisor_override=*/std::nullopt,
+        expected);
+
+    executorch::aten::Tensor out = tf.full_channels_last({2, 11, 4, 4}, 0);
+    op_avg_pool2d_out(
+        tf.channels_last_like(self),
+        kernel_size,
+        stride,
+        padding,
+        /*ceil_mode=*/false,
+        count_include_pad,
+        /*divisor_override=*/std::nullopt,
+        out);
+    EXPECT_TENSOR_CLOSE(out, tf.channels_last_like(expected));
+  }
+}
@@ -784,3 +784,94 @@ TEST_F(OpConvCorrectnessTest, BFloat16TypeSmokeTest) {
       out);
   EXPECT_TENSOR_CLOSE(out, expected);
 }
+
+class OpConvChannelsLastTest : public OpConvOutTest {
+ protected:
+  // Returns a deterministic tensor with varied values.
+  Tensor make_test_tensor(
+      TensorFactory<ScalarType::Float>& tf,
+      const std::vector<int32_t>& sizes) {
+    int64_t numel = 1;
+    for (const auto size : sizes) {
+      numel *= size;
+    }
+    std::vector<float> data(numel);
+    for (int64_t i = 0; i < numel; ++i) {
+      data[i] = static_cast<float>((i * 37) % 101) / 20.0f - 2.5f;
+    }
+    return tf.make(sizes, data);
+  }
+
+  // Runs a 2D convolution on contiguous and channels last copies of the
+  // same inputs, and checks that both give the same result.
+  void test_matches_contiguous(
+      const std::vector<int32_t>& in_sizes,
+      const std::vector<int32_t>& weight_sizes,
+      const std::vector<int32_t>& out_sizes,
+      int64_t stride,
+      int64_t padding,
+      int64_t dilation,
+      int64_t groups,
+      bool channels_last_weight) {
+    TensorFactory<ScalarType::Float> tf;
+
+    Tensor input = make_test_tensor(tf, in_sizes);
+    Tensor weight = make_test_tensor(tf, weight_sizes);
+    optional<Tensor> bias(make_test_tensor(tf, {weight_sizes[0]}));
+    Tensor expected = tf.zeros(out_sizes);
+    int64_t output_padding = 0;
+
+    op_convolution_out(
+        input,
+        weight,
+        bias,
+        {&stride, 1},
+        {&padding, 1},
+        {&dilation, 1},
+        false,
+        {&output_padding, 1},
+        groups,
+        expected);
+
+    Tensor input_cl = tf.channels_last_like(input);
+    Tensor weight_cl =
+        channels_last_weight ? tf.channels_last_like(weight) : weight;
+    Tensor out_cl = tf.full_channels_last(out_sizes, 0);
+    op_convolution_out(
+        input_cl,
+        weight_cl,
+        bias,
+        {&stride, 1},
+        {&padding, 1},
+        {&dilation, 1},
+        false,
+        {&output_padding, 1},
+        groups,
+        out_cl);
+
+    // The channels last kernel accumulates in a different order.
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        out_cl, tf.channels_last_like(expected), 1e-4, 1e-4);
+  }
+};
+
+TEST_F(OpConvChannelsLastTest, ChannelsLastWeight) {
+  // Enough input channels to fill whole vectors.
+  test_matches_contiguous(
+      {2, 19, 7, 6}, {5, 19, 3, 3}, {2, 5, 4, 3}, 2, 1, 1, 1, true);
+}
+
+TEST_F(OpConvChannelsLastTest, ContiguousWeightWithDilation) {
+  test_matches_contiguous(
+      {1, 11, 8, 8}, {6, 11, 3, 2}, {1, 6, 4, 6}, 1, 0, 2, 1, false);
+}
+
+TEST_F(OpConvChannelsLastTest, Grouped) {
+  test_matches_contiguous(
+      {1, 12, 5, 5}, {6, 4, 3, 3}, {1, 6, 5, 5}, 1, 1, 1, 3, true);
+}
+
+TEST_F(OpConvChannelsLastTest, Depthwise) {
+  test_matches_contiguous(
+      {2, 20, 6, 5}, {20, 1, 3, 3}, {2, 20, 3, 3}, 2, 1, 1, 20, true);
+}
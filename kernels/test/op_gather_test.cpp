@@ -227,6 +227,40 @@ TEST_F(OpGatherOutTest, InfinityAndNANTest) {
   // clang-format on
 }
 
+TEST_F(OpGatherOutTest, IndexSmallerThanInputInLeadingDims) {
+  TensorFactory<ScalarType::Long> tf_index;
+  TensorFactory<ScalarType::Float> tf_data;
+
+  // clang-format off
+  Tensor self = tf_data.make(
+      /*sizes=*/{3, 4, 2},
+      {
+         0,  1,  2,  3,  4,  5,  6,  7,
+         8,  9, 10, 11, 12, 13, 14, 15,
+        16, 17, 18, 19, 20, 21, 22, 23
+      });
+  Tensor index = tf_index.make(
+      /*sizes=*/{2, 3, 2},
+      {
+        3, 0,  1, 1,  2, 3,
+        0, 2,  3, 3,  1, 0
+      });
+  // clang-format on
+  Tensor out = tf_data.zeros({2, 3, 2});
+
+  op_gather_out(self, 1, index, /*sparse_grad=*/false, out);
+  // clang-format off
+  EXPECT_TENSOR_EQ(
+      out,
+      tf_data.make(
+          {2, 3, 2},
+          {
+            6,  1,  2,  3,  4,  7,
+            8, 13, 14, 15, 10,  9
+          }));
+  // clang-format on
+}
+
 TEST_F(OpGatherOutTest, InvalidDimensionsDies) {
 #define TEST_ENTRY(CTYPE, DTYPE) \
   test_gather_out_invalid_dim<ScalarType::DTYPE>();
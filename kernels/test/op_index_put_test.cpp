@@ -987,6 +987,76 @@ TEST_F(OpIndexPutOutTest, NonLinearIndices) {
   EXPECT_TENSOR_EQ(ret, expected);
 }
 
+TEST_F(OpIndexPutOutTest, PutSingleIndexWithRepeatsAlongMiddleDim) {
+  TensorFactory<ScalarType::Double> tf;
+  TensorFactory<ScalarType::Long> tfl;
+  // clang-format off
+  Tensor x = tf.make(
+      {2, 3, 2},
+      {
+          // [0, :, :]
+          1.,  2., // [0, 0, :]
+          3.,  4., // [0, 1, :]
+          5.,  6., // [0, 2, :]
+
+          // [1, :, :]
+          7.,  8., // [1, 0, :]
+          9., 10., // [1, 1, :]
+         11., 12., // [1, 2, :]
+      });
+  // clang-format on
+
+  // Indices 2 and -1 both select x[:, 2, :].
+  optional<Tensor> indices[] = {
+      optional<Tensor>(), optional<Tensor>(tfl.make({3}, {2, -1, 0}))};
+
+  // clang-format off
+  Tensor values = tf.make(
+      {2, 3, 2},
+      {
+          // [0, :, :]
+          10.,  20.,
+          30.,  40.,
+          50.,  60.,
+
+          // [1, :, :]
+         -10., -20.,
+         -30., -40.,
+         -50., -60.,
+      });
+
+  Tensor expected = tf.make(
+      {2, 3, 2},
+      {
+          // [0, :, :]
+          50.,  60., // [0, 0, :]
+           3.,   4., // [0, 1, :]
+          30.,  40., // [0, 2, :]
+
+          // [1, :, :]
+         -50., -60., // [1, 0, :]
+           9.,  10., // [1, 1, :]
+         -30., -40., // [1, 2, :]
+      });
+
+  Tensor expected_accum = tf.make(
+      {2, 3, 2},
+      {
+          // [0, :, :]
+          51.,  62., // [0, 0, :]
+           3.,   4., // [0, 1, :]
+          45.,  66., // [0, 2, :]
+
+          // [1, :, :]
+         -43., -52., // [1, 0, :]
+           9.,  10., // [1, 1, :]
+         -29., -48., // [1, 2, :]
+      });
+  // clang-format on
+
+  run_test_cases(x, /*indices=*/indices, values, expected, expected_accum);
+}
+
 //
 // Dynamic Shape Tests
 //
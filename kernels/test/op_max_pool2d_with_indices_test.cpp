@@ -387,3 +387,48 @@ TEST_F(OpMaxPool2DWithIndicesOutTest, CeilMode) {
       self, kernel_size, stride, padding, dilation, ceil_mode, out, indices);
   EXPECT_TENSOR_CLOSE(out, out_expected);
 }
+
+TEST_F(OpMaxPool2DWithIndicesOutTest, ChannelsLastMatchesContiguous) {
+  torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Float>
+      tf;
+  torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Long>
+      tfLong;
+
+  std::vector<float> data(2 * 11 * 7 * 6);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>((i * 37) % 101) - 50.0f;
+  }
+  executorch::aten::Tensor self = tf.make({2, 11, 7, 6}, data);
+
+  int64_t kernel_size[2] = {3, 2};
+  int64_t stride[2] = {2, 2};
+  int64_t padding[2] = {1, 1};
+  int64_t dilation[2] = {1, 2};
+
+  executorch::aten::Tensor expected = tf.zeros({2, 11, 4, 3});
+  executorch::aten::Tensor expected_indices = tfLong.zeros({2, 11, 4, 3});
+  op_max_pool2d_with_indices_out(
+      self,
+      kernel_size,
+      stride,
+      padding,
+      dilation,
+      /*ceil_mode=*/false,
+      expected,
+      expected_indices);
+
+  executorch::aten::Tensor out = tf.full_channels_last({2, 11, 4, 3}, 0);
+  executorch::aten::Tensor indices =
+      tfLong.full_channels_last({2, 11, 4, 3}, 0);
+  op_max_pool2d_with_indices_out(
+      tf.channels_last_like(self),
+      kernel_size,
+      stride,
+      padding,
+      dilation,
+      /*ceil_mode=*/false,
+      out,
+      indices);
+  EXPECT_TENSOR_CLOSE(out, tf.channels_last_like(expected));
+  EXPECT_TENSOR_EQ(indices, tfLong.channels_last_like(expected_indices));
+}
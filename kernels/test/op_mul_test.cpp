@@ -135,6 +135,47 @@ class OpMulOutTest : public OperatorTest {
     EXPECT_TENSOR_CLOSE(out, tf.make(sizes1, /*data=*/{1.1, 2.2, 4.4, 8.8}));
   }
 
+  // Multiplies inputs longer than a vector register, same shaped and
+  // broadcast, and checks the results against products computed in float.
+  template <ScalarType DTYPE>
+  void test_reduced_precision_matches_float() {
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+    TensorFactory<DTYPE> tf;
+
+    const std::vector<int32_t> a_sizes = {3, 67};
+    const std::vector<std::vector<int32_t>> b_sizeses = {
+        {3, 67}, {3, 1}, {67}, {1}};
+    std::vector<float> a_data(3 * 67);
+    for (size_t i = 0; i < a_data.size(); ++i) {
+      a_data[i] = static_cast<float>(static_cast<int>(i % 13) - 6) / 4;
+    }
+    const Tensor a =
+        tf.make(a_sizes, std::vector<CTYPE>(a_data.begin(), a_data.end()));
+    for (const auto& b_sizes : b_sizeses) {
+      const int32_t b_rows = b_sizes.size() == 2 ? b_sizes[0] : 1;
+      const int32_t b_cols = b_sizes.back();
+      std::vector<float> b_data(b_rows * b_cols);
+      for (size_t i = 0; i < b_data.size(); ++i) {
+        b_data[i] = static_cast<float>(static_cast<int>(i % 7) - 3) / 2;
+      }
+      std::vector<CTYPE> expected(a_data.size());
+      for (int32_t r = 0; r < 3; ++r) {
+        for (int32_t c = 0; c < 67; ++c) {
+          const float b_val =
+              b_data[(b_rows == 1 ? 0 : r) * b_cols + (b_cols == 1 ? 0 : c)];
+          expected[r * 67 + c] = static_cast<CTYPE>(a_data[r * 67 + c] * b_val);
+        }
+      }
+
+      Tensor out = tf.zeros(a_sizes);
+      op_mul_out(
+          a,
+          tf.make(b_sizes, std::vector<CTYPE>(b_data.begin(), b_data.end())),
+          out);
+      EXPECT_TENSOR_CLOSE(out, tf.make(a_sizes, expected));
+    }
+  }
+
   template <ScalarType DTYPE>
   void test_broadcast_a2b() {
     TensorFactory<DTYPE> tf_a;
@@ -395,6 +436,11 @@ TEST_F(OpMulOutTest, BFloat16Tensors) {
   test_floating_point_mul_out<ScalarType::BFloat16>();
 }
 
+TEST_F(OpMulOutTest, ReducedPrecisionMatchesFloat) {
+  test_reduced_precision_matches_float<ScalarType::Half>();
+  test_reduced_precision_matches_float<ScalarType::BFloat16>();
+}
+
 TEST_F(OpMulOutTest, BoolTensors) {
   TensorFactory<ScalarType::Bool> tf;
 
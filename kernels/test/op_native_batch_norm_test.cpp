@@ -989,6 +989,64 @@ TEST_F(
   EXPECT_TENSOR_CLOSE(out2, out2_expected);
 }
 
+TEST_F(
+    OpNativeBatchNormLegitNoTrainingOutTest,
+    ChannelsLastMatchesContiguous) {
+  if (!torch::executor::testing::SupportedFeatures::get()
+           ->op_native_batch_norm_channels_last) {
+    GTEST_SKIP() << "Channels last dim order is not supported";
+  }
+  torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Float>
+      tfFloat;
+
+  // More channels than the optimized kernel handles at a time.
+  constexpr int32_t C = 300;
+  std::vector<float> input_data(2 * C * 3 * 2);
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] = static_cast<float>((i * 37) % 101) / 10.0f - 5.0f;
+  }
+  std::vector<float> channel_data(C);
+  for (size_t i = 0; i < channel_data.size(); ++i) {
+    channel_data[i] = static_cast<float>((i * 13) % 17) / 4.0f + 0.5f;
+  }
+  executorch::aten::Tensor input = tfFloat.make({2, C, 3, 2}, input_data);
+  std::optional<executorch::aten::Tensor> weight(
+      tfFloat.make({C}, channel_data));
+  std::optional<executorch::aten::Tensor> bias(tfFloat.full({C}, -1.5));
+  executorch::aten::Tensor running_mean = tfFloat.full({C}, 0.25);
+  executorch::aten::Tensor running_var = tfFloat.make({C}, channel_data);
+
+  executorch::aten::Tensor expected = tfFloat.zeros({2, C, 3, 2});
+  executorch::aten::Tensor out1 = tfFloat.zeros({0});
+  executorch::aten::Tensor out2 = tfFloat.zeros({0});
+  op_native_batch_norm_legit_no_training_out(
+      input,
+      weight,
+      bias,
+      running_mean,
+      running_var,
+      /*momentum=*/0.1,
+      /*eps=*/1e-5,
+      expected,
+      out1,
+      out2);
+
+  executorch::aten::Tensor out0 = tfFloat.full_channels_last({2, C, 3, 2}, 0);
+  op_native_batch_norm_legit_no_training_out(
+      tfFloat.channels_last_like(input),
+      weight,
+      bias,
+      running_mean,
+      running_var,
+      /*momentum=*/0.1,
+      /*eps=*/1e-5,
+      out0,
+      out1,
+      out2);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out0, tfFloat.channels_last_like(expected), 1e-4, 1e-4);
+}
+
 TEST_F(OpNativeBatchNormLegitOutTest, SampleAtomicTest2D) {
   torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Float>
       tfFloat;
@@ -336,3 +336,68 @@ TEST_F(OpNativeGroupNormTest, IntTensorsDies) {
   // Cannot be represented by a type other than float.
   run_int_test_cases<ScalarType::Int>();
 }
+
+TEST_F(OpNativeGroupNormTest, ChannelsLastMatchesContiguous) {
+  if (!torch::executor::testing::SupportedFeatures::get()
+           ->op_native_group_norm_channels_last) {
+    GTEST_SKIP() << "Channels last dim order is not supported";
+  }
+  TensorFactory<ScalarType::Float> tf;
+
+  constexpr int32_t N = 2;
+  constexpr int32_t C = 24;
+  constexpr int32_t H = 3;
+  constexpr int32_t W = 5;
+  std::vector<float> input_data(N * C * H * W);
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] = static_cast<float>((i * 37) % 101) / 10.0f - 5.0f;
+  }
+  std::vector<float> weight_data(C);
+  std::vector<float> bias_data(C);
+  for (int32_t c = 0; c < C; ++c) {
+    weight_data[c] = static_cast<float>(c % 5) / 2.0f - 1.0f;
+    bias_data[c] = static_cast<float>(c % 7) / 4.0f;
+  }
+  Tensor in = tf.make({N, C, H, W}, input_data);
+  optional<Tensor> weight = tf.make({C}, weight_data);
+  optional<Tensor> bias = tf.make({C}, bias_data);
+
+  // Groups of 8 channels fill whole vectors, and groups of 3 don't.
+  for (const int32_t group : {3, 8}) {
+    Tensor expected = tf.zeros({N, C, H, W});
+    Tensor expected_mean = tf.zeros({N, group});
+    Tensor expected_rstd = tf.zeros({N, group});
+    op_native_group_norm_out(
+        in,
+        weight,
+        bias,
+        N,
+        C,
+        H * W,
+        group,
+        1e-5,
+        expected,
+        expected_mean,
+        expected_rstd);
+
+    Tensor out = tf.full_channels_last({N, C, H, W}, 0);
+    Tensor mean = tf.zeros({N, group});
+    Tensor rstd = tf.zeros({N, group});
+    op_native_group_norm_out(
+        tf.channels_last_like(in),
+        weight,
+        bias,
+        N,
+        C,
+        H * W,
+        group,
+        1e-5,
+        out,
+        mean,
+        rstd);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        out, tf.channels_last_like(expected), 1e-4, 1e-4);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(mean, expected_mean, 1e-4, 1e-4);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(rstd, expected_rstd, 1e-4, 1e-4);
+  }
+}
@@ -107,6 +107,74 @@ class OpNativeLayerNormTest : public OperatorTest {
     }
   }
 
+  // Normalizes rows longer than a vector register, and checks the results
+  // against normalizing the same values in float.
+  template <ScalarType DTYPE>
+  void test_reduced_precision_matches_float() {
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+    TensorFactory<DTYPE> tf;
+    TensorFactory<ScalarType::Float> tf_float;
+
+    const std::vector<int32_t> sizes = {2, 150};
+    const std::vector<int32_t> normalized_sizes = {150};
+    std::vector<float> in_data(2 * 150);
+    for (size_t i = 0; i < in_data.size(); ++i) {
+      in_data[i] = static_cast<float>(static_cast<int>(i * 7 % 31) - 15) / 8;
+    }
+    std::vector<float> weight_data(150);
+    std::vector<float> bias_data(150);
+    for (size_t i = 0; i < weight_data.size(); ++i) {
+      weight_data[i] = static_cast<float>(i % 5 + 1) / 4;
+      bias_data[i] = static_cast<float>(static_cast<int>(i % 3) - 1) / 2;
+    }
+    const std::vector<int64_t> normalized_shape_vec = {150};
+    const IntArrayRef normalized_shape(
+        normalized_shape_vec.data(), normalized_shape_vec.size());
+
+    Tensor out = tf.zeros(sizes);
+    Tensor mean = tf.zeros({2, 1});
+    Tensor rstd = tf.zeros({2, 1});
+    op_native_layer_norm_out(
+        tf.make(sizes, std::vector<CTYPE>(in_data.begin(), in_data.end())),
+        normalized_shape,
+        tf.make(
+            normalized_sizes,
+            std::vector<CTYPE>(weight_data.begin(), weight_data.end())),
+        tf.make(
+            normalized_sizes,
+            std::vector<CTYPE>(bias_data.begin(), bias_data.end())),
+        1e-5,
+        out,
+        mean,
+        rstd);
+
+    Tensor out_float = tf_float.zeros(sizes);
+    Tensor mean_float = tf_float.zeros({2, 1});
+    Tensor rstd_float = tf_float.zeros({2, 1});
+    op_native_layer_norm_out(
+        tf_float.make(sizes, in_data),
+        normalized_shape,
+        tf_float.make(normalized_sizes, weight_data),
+        tf_float.make(normalized_sizes, bias_data),
+        1e-5,
+        out_float,
+        mean_float,
+        rstd_float);
+
+    const auto to_ctype = [&tf](const Tensor& t) {
+      const float* data = t.const_data_ptr<float>();
+      return tf.make(
+          std::vector<int32_t>(t.sizes().begin(), t.sizes().end()),
+          std::vector<CTYPE>(data, data + t.numel()));
+    };
+    const double atol = DTYPE == ScalarType::BFloat16
+        ? executorch::runtime::testing::internal::kDefaultBFloat16Atol
+        : executorch::runtime::testing::internal::kDefaultHalfAtol;
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, to_ctype(out_float), 1e-2, atol);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(mean, to_ctype(mean_float), 1e-2, atol);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(rstd, to_ctype(rstd_float), 1e-2, atol);
+  }
+
   // Test cases that are compatible with float and double.
   template <ScalarType DTYPE>
   void run_floating_point_test_cases() {
@@ -405,6 +473,11 @@ TEST_F(OpNativeLayerNormTest, FloatTensors) {
   run_floating_point_test_cases<ScalarType::BFloat16>();
 }
 
+TEST_F(OpNativeLayerNormTest, ReducedPrecisionMatchesFloat) {
+  test_reduced_precision_matches_float<ScalarType::Half>();
+  test_reduced_precision_matches_float<ScalarType::BFloat16>();
+}
+
 TEST_F(OpNativeLayerNormTest, IntTensorsDies) {
   // Cannot be represented by a type other than float.
   run_int_test_cases<ScalarType::Int>();
@@ -301,6 +301,38 @@ TEST_F(OpPermuteCopyTest, FiveDPermute) {
   // clang-format on
 }
 
+TEST_F(OpPermuteCopyTest, LargeTransposeWithPartialTiles) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Large enough to span several tiles, with sizes that are not multiples of
+  // the tile size.
+  const std::vector<int32_t> sizes = {3, 37, 2, 21};
+  const std::vector<int32_t> out_sizes = {3, 21, 2, 37};
+  const std::vector<int64_t> new_dim = {0, 3, 2, 1};
+
+  std::vector<float> in_data(3 * 37 * 2 * 21);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<float>(i);
+  }
+  std::vector<float> expected(in_data.size());
+  for (int32_t a = 0; a < 3; ++a) {
+    for (int32_t b = 0; b < 37; ++b) {
+      for (int32_t c = 0; c < 2; ++c) {
+        for (int32_t d = 0; d < 21; ++d) {
+          expected[((a * 21 + d) * 2 + c) * 37 + b] =
+              in_data[((a * 37 + b) * 2 + c) * 21 + d];
+        }
+      }
+    }
+  }
+
+  Tensor t = tf.make(sizes, in_data);
+  Tensor out = tf.zeros(out_sizes);
+  op_permute_copy_out(
+      t, ArrayRef<int64_t>(new_dim.data(), new_dim.size()), out);
+  EXPECT_TENSOR_EQ(out, tf.make(out_sizes, expected));
+}
+
 TEST_F(OpPermuteCopyTest, AllDimensionsSizeOne) {
   TensorFactory<ScalarType::Int> tf;
 
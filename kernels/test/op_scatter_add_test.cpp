@@ -316,6 +316,40 @@ TEST_F(OpScatterAddOutTest, InfinityAndNANTest) {
   // clang-format on
 }
 
+TEST_F(OpScatterAddOutTest, RepeatedIndicesAccumulate) {
+  TensorFactory<ScalarType::Long> tf_index;
+  TensorFactory<ScalarType::Float> tf_data;
+
+  Tensor self = tf_data.ones({2, 3, 2});
+  // clang-format off
+  Tensor index = tf_index.make(
+      /*sizes=*/{2, 4, 2},
+      {
+        0, 2,  0, 2,  1, 0,  0, 2,
+        2, 2,  2, 1,  1, 1,  0, 0
+      });
+  Tensor src = tf_data.make(
+      /*sizes=*/{2, 4, 2},
+      {
+        0,  1,  2,  3,  4,  5,  6,  7,
+        8,  9, 10, 11, 12, 13, 14, 15
+      });
+  // clang-format on
+  Tensor out = tf_data.zeros({2, 3, 2});
+
+  op_scatter_add_out(self, 1, index, src, out);
+  // clang-format off
+  EXPECT_TENSOR_EQ(
+      out,
+      tf_data.make(
+          {2, 3, 2},
+          {
+             9,  6,  5,  1,  1, 12,
+            15, 16, 13, 25, 19, 10
+          }));
+  // clang-format on
+}
+
 TEST_F(OpScatterAddOutTest, InvalidDimensionsDies) {
 #define TEST_ENTRY(CTYPE, DTYPE) \
   test_scatter_add_out_invalid_dim<ScalarType::DTYPE>();
@@ -386,6 +386,20 @@ TEST_F(OpScatterSrcOutTest, AllValidInputOutputSupport) {
 #undef TEST_ENTRY
 }
 
+TEST_F(OpScatterSrcOutTest, IndexSmallerThanSelfAlongDim) {
+  TensorFactory<ScalarType::Long> tf_index;
+  TensorFactory<ScalarType::Float> tf_data;
+
+  Tensor self = tf_data.zeros({2, 3, 2});
+  Tensor index = tf_index.make({2, 2, 2}, {2, 0, 0, 1, 1, 2, 0, 0});
+  Tensor src = tf_data.make({2, 2, 2}, {1, 2, 3, 4, 5, 6, 7, 8});
+  Tensor out = tf_data.ones({2, 3, 2});
+
+  op_scatter_src_out(self, 1, index, src, out);
+  EXPECT_TENSOR_EQ(
+      out, tf_data.make({2, 3, 2}, {3, 2, 0, 4, 1, 0, 7, 8, 5, 0, 0, 6}));
+}
+
 TEST_F(OpScatterSrcOutTest, InvalidDimensionsDies) {
 #define TEST_ENTRY(CTYPE, DTYPE) \
   test_scatter_src_out_invalid_dim<ScalarType::DTYPE>();
@@ -427,6 +441,19 @@ TEST_F(OpScatterValueOutTest, InfinityAndNANTest) {
   // clang-format on
 }
 
+TEST_F(OpScatterValueOutTest, IndexSmallerThanSelfAlongDim) {
+  TensorFactory<ScalarType::Long> tf_index;
+  TensorFactory<ScalarType::Float> tf_data;
+
+  Tensor self = tf_data.zeros({2, 3, 2});
+  Tensor index = tf_index.make({2, 2, 2}, {2, 0, 0, 1, 1, 2, 0, 0});
+  Tensor out = tf_data.ones({2, 3, 2});
+
+  op_scatter_value_out(self, 1, index, 9, out);
+  EXPECT_TENSOR_EQ(
+      out, tf_data.make({2, 3, 2}, {9, 9, 0, 9, 9, 0, 9, 9, 9, 0, 0, 9}));
+}
+
 TEST_F(OpScatterValueOutTest, InvalidDimensionsDies) {
 #define TEST_ENTRY(CTYPE, DTYPE) \
   test_scatter_value_out_invalid_dim<ScalarType::DTYPE>();
@@ -671,3 +671,50 @@ TEST_F(OpUpsampleBilinear2dAAOutTest, TestSpecificInputCase) {
     EXPECT_FALSE(std::isinf(out_data[i]));
   }
 }
+
+TEST_F(OpUpsampleBilinear2dAAOutTest, TestWideRowChannelsLastMatchesNCHW) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Wide enough for kernels that process output columns in blocks.
+  Tensor input = tf.zeros({1, 3, 4, 100});
+  Tensor input_cl = tf.zeros_channels_last({1, 3, 4, 100});
+  auto in_data = input.mutable_data_ptr<float>();
+  auto in_cl_data = input_cl.mutable_data_ptr<float>();
+  for (int c = 0; c < 3; c++) {
+    for (int hw = 0; hw < 400; hw++) {
+      const float value = static_cast<float>((c * 37 + hw * 11) % 23);
+      in_data[c * 400 + hw] = value;
+      in_cl_data[hw * 3 + c] = value;
+    }
+  }
+
+  Tensor out = tf.zeros({1, 3, 3, 70});
+  Tensor out_cl = tf.zeros_channels_last({1, 3, 3, 70});
+
+  int64_t output_size_data[2] = {3, 70};
+  ArrayRef<int64_t> output_size(output_size_data, 2);
+
+  op_upsample_bilinear2d_aa_out(
+      input,
+      output_size,
+      /*align_corners=*/false,
+      std::nullopt,
+      std::nullopt,
+      out);
+  op_upsample_bilinear2d_aa_out(
+      input_cl,
+      output_size,
+      /*align_corners=*/false,
+      std::nullopt,
+      std::nullopt,
+      out_cl);
+
+  // Both layouts should accumulate each output element identically.
+  auto out_data = out.const_data_ptr<float>();
+  auto out_cl_data = out_cl.const_data_ptr<float>();
+  for (int c = 0; c < 3; c++) {
+    for (int hw = 0; hw < 210; hw++) {
+      EXPECT_EQ(out_data[c * 210 + hw], out_cl_data[hw * 3 + c]);
+    }
+  }
+}
@@ -445,3 +445,34 @@ TEST_F(OpUpsampleNearest2dTest, SmokeTestChannelsLast) {
 
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+TEST_F(OpUpsampleNearest2dTest, WideRowMultiChannel) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Wide enough for kernels that process output columns in blocks.
+  const auto input = tf.zeros({1, 2, 1, 50});
+  auto input_ptr = input.mutable_data_ptr<float>();
+  for (auto i = 0; i < input.numel(); i++) {
+    input_ptr[i] = static_cast<float>(i);
+  }
+  std::array<int64_t, 2> output_size = {2, 150};
+  auto out = tf.zeros({1, 2, 2, 150});
+
+  op_upsample_nearest2d_out(
+      input,
+      OptionalArrayRef<int64_t>({output_size.data(), output_size.size()}),
+      {},
+      out);
+
+  auto expected = tf.zeros({1, 2, 2, 150});
+  auto expected_ptr = expected.mutable_data_ptr<float>();
+  for (auto c = 0; c < 2; c++) {
+    for (auto h = 0; h < 2; h++) {
+      for (auto w = 0; w < 150; w++) {
+        expected_ptr[(c * 2 + h) * 150 + w] = input_ptr[c * 50 + w / 3];
+      }
+    }
+  }
+
+  EXPECT_TENSOR_EQ(out, expected);
+}
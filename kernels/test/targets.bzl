@@ -196,19 +196,19 @@ def define_common_targets():
     _common_op_test("op_atan_test", ["aten", "portable"])
     _common_op_test("op_atan2_test", ["aten", "portable"])
     _common_op_test("op_atanh_test", ["aten", "portable"])
-    _common_op_test("op_avg_pool2d_test", ["aten", "portable"])
+    _common_op_test("op_avg_pool2d_test", ["aten", "portable", "optimized"])
     _common_op_test("op_bitwise_and_test", ["aten", "portable"])
     _common_op_test("op_bitwise_not_test", ["aten", "portable"])
     _common_op_test("op_bitwise_or_test", ["aten", "portable"])
     _common_op_test("op_bitwise_xor_test", ["aten", "portable"])
     _common_op_test("op_bmm_test", ["aten", "portable", "optimized"])
-    _common_op_test("op_cat_test", ["aten", "portable"])
+    _common_op_test("op_cat_test", ["aten", "portable", "optimized"])
     _common_op_test("op_cdist_forward_test", ["aten", "portable"])
     _common_op_test("op_ceil_test", ["aten", "portable"])
     _common_op_test("op_clamp_test", ["aten", "portable"])
     _common_op_test("op_clone_test", ["aten", "portable"])
     _common_op_test("op_constant_pad_nd_test", ["aten", "portable"])
-    _common_op_test("op_convolution_test", ["aten", "portable"])
+    _common_op_test("op_convolution_test", ["aten", "portable", "optimized"])
     _common_op_test("op_convolution_backward_test", ["aten", "portable"])
     _common_op_test("op_copy_test", ["aten", "portable"])
     _common_op_test("op_cos_test", ["aten", "portable"])
@@ -234,14 +234,14 @@ def define_common_targets():
     _common_op_test("op_fmod_test", ["aten", "portable"])
     _common_op_test("op_full_like_test", ["aten", "portable"])
     _common_op_test("op_full_test", ["aten", "portable"])
-    _common_op_test("op_gather_test", ["aten", "portable"])
+    _common_op_test("op_gather_test", ["aten", "portable", "optimized"])
     _common_op_test("op_ge_test", ["aten", "portable"])
     _common_op_test("op_gelu_test", ["aten", "portable", "optimized"])
     _common_op_test("op_glu_test", ["aten", "portable"])
     _common_op_test("op_gt_test", ["aten", "portable"])
     _common_op_test("op_hardtanh_test", ["aten", "portable"])
-    _common_op_test("op_index_put_test", ["aten", "portable"])
-    _common_op_test("op_index_select_test", ["aten", "portable"])
+    _common_op_test("op_index_put_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_index_select_test", ["aten", "portable", "optimized"])
     _common_op_test("op_index_test", ["aten", "portable"])
     _common_op_test("op_isinf_test", ["aten", "portable"])
     _common_op_test("op_isnan_test", ["aten", "portable"])
@@ -264,7 +264,7 @@ def define_common_targets():
     _common_op_test("op_masked_scatter_test", ["aten", "portable"])
     _common_op_test("op_masked_select_test", ["aten", "portable"])
     _common_op_test("op_max_test", ["aten", "portable"])
-    _common_op_test("op_max_pool2d_with_indices_test", ["aten", "portable"])
+    _common_op_test("op_max_pool2d_with_indices_test", ["aten", "portable", "optimized"])
     _common_op_test("op_max_pool2d_with_indices_backward_test", ["aten", "portable"])
     _common_op_test("op_maximum_test", ["aten", "portable"])
     _common_op_test("op_mean_test", ["aten", "portable"])
@@ -273,16 +273,16 @@ def define_common_targets():
     _common_op_test("op_mm_test", ["aten", "portable", "optimized"])
     _common_op_test("op_mul_test", ["aten", "portable", "optimized"])
     _common_op_test("op_narrow_copy_test", ["aten", "portable"])
-    _common_op_test("op_native_batch_norm_test", ["aten", "portable"])
+    _common_op_test("op_native_batch_norm_test", ["aten", "portable", "optimized"])
     _common_op_test("op_native_dropout_test", ["aten", "portable"])
-    _common_op_test("op_native_group_norm_test", ["aten", "portable"])
+    _common_op_test("op_native_group_norm_test", ["aten", "portable", "optimized"])
     _common_op_test("op_native_layer_norm_test", ["aten", "portable", "optimized"])
     _common_op_test("op_ne_test", ["aten", "portable"])
     _common_op_test("op_neg_test", ["aten", "portable"])
     _common_op_test("op_nonzero_test", ["aten", "portable"])
     _common_op_test("op_ones_test", ["aten", "portable"])
     _common_op_test("op_pdist_forward_test", ["aten", "portable"])
-    _common_op_test("op_permute_copy_test", ["aten", "portable"])
+    _common_op_test("op_permute_copy_test", ["aten", "portable", "optimized"])
     _common_op_test("op_pixel_shuffle_test", ["aten", "portable"])
     _common_op_test("op_pixel_unshuffle_test", ["aten", "portable"])
     _common_op_test("op_pow_test", ["aten", "portable"])
@@ -305,8 +305,8 @@ def define_common_targets():
     _common_op_test("op_rsqrt_test", ["aten", "portable"])
     _common_op_test("op_rsub_test", ["aten", "portable"])
     _common_op_test("op_scalar_tensor_test", ["aten", "portable"])
-    _common_op_test("op_scatter_test", ["aten", "portable"])
-    _common_op_test("op_scatter_add_test", ["aten", "portable"])
+    _common_op_test("op_scatter_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_scatter_add_test", ["aten", "portable", "optimized"])
     _common_op_test("op_select_scatter_test", ["aten", "portable"])
     _common_op_test("op_select_copy_test", ["aten", "portable"])
     _common_op_test("op_sigmoid_test", ["aten", "portable"])
@@ -314,29 +314,29 @@ def define_common_targets():
     _common_op_test("op_sin_test", ["aten", "portable"])
     _common_op_test("op_sinh_test", ["aten", "portable"])
     _common_op_test("op_slice_scatter_test", ["aten", "portable"])
-    _common_op_test("op_slice_copy_test", ["aten", "portable"])
-    _common_op_test("op_softmax_test", ["aten", "portable"])
+    _common_op_test("op_slice_copy_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_softmax_test", ["aten", "portable", "optimized"])
     _common_op_test("op_split_copy_test", ["aten", "portable"])
-    _common_op_test("op_split_with_sizes_copy_test", ["aten", "portable"])
+    _common_op_test("op_split_with_sizes_copy_test", ["aten", "portable", "optimized"])
     _common_op_test("op_sqrt_test", ["aten", "portable"])
     _common_op_test("op_squeeze_copy_test", ["aten", "portable"])
-    _common_op_test("op_stack_test", ["aten", "portable"])
+    _common_op_test("op_stack_test", ["aten", "portable", "optimized"])
     _common_op_test("op_sub_test", ["aten", "portable", "optimized"])
     _common_op_test("op_sum_test", ["aten", "portable"])
-    _common_op_test("op_t_copy_test", ["aten", "portable"])
+    _common_op_test("op_t_copy_test", ["aten", "portable", "optimized"])
     _common_op_test("op_tan_test", ["aten", "portable"])
     _common_op_test("op_tanh_test", ["aten", "portable"])
     _common_op_test("op_to_copy_test", ["aten", "portable"])
     _common_op_test("op_topk_test", ["aten", "portable"])
-    _common_op_test("op_transpose_copy_test", ["aten", "portable"])
+    _common_op_test("op_transpose_copy_test", ["aten", "portable", "optimized"])
     _common_op_test("op_tril_test", ["aten", "portable"])
     _common_op_test("op_trunc_test", ["aten", "portable"])
-    _common_op_test("op_unbind_copy_test", ["aten", "portable"])
+    _common_op_test("op_unbind_copy_test", ["aten", "portable", "optimized"])
     _common_op_test("op_unfold_copy_test", ["aten", "portable"])
     _common_op_test("op_unsqueeze_copy_test", ["aten", "portable"])
-    _common_op_test("op_upsample_bilinear2d_test", ["aten", "portable"])
-    _common_op_test("op_upsample_bilinear2d_aa_test", ["portable"])
-    _common_op_test("op_upsample_nearest2d_test", ["aten", "portable"])
+    _common_op_test("op_upsample_bilinear2d_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_upsample_bilinear2d_aa_test", ["portable", "optimized"])
+    _common_op_test("op_upsample_nearest2d_test", ["aten", "portable", "optimized"])
     _common_op_test("op_var_test", ["aten", "portable"])
     _common_op_test("op_view_as_real_copy_test", ["aten", "portable"])
     _common_op_test("op_view_copy_test", ["aten", "portable"])
@@ -13,6 +13,10 @@ namespace runtime {
 template <>
 executorch::aten::ArrayRef<std::optional<executorch::aten::Tensor>>
 BoxedEvalueList<std::optional<executorch::aten::Tensor>>::get() const {
+  if (is_cached()) {
+    return executorch::aten::ArrayRef<std::optional<executorch::aten::Tensor>>{
+        unwrapped_vals_, wrapped_vals_.size()};
+  }
   for (typename executorch::aten::ArrayRef<
            std::optional<executorch::aten::Tensor>>::size_type i = 0;
        i < wrapped_vals_.size();
@@ -24,6 +28,7 @@ BoxedEvalueList<std::optional<executorch::aten::Tensor>>::get() const {
           wrapped_vals_[i]->to<std::optional<executorch::aten::Tensor>>();
     }
   }
+  mark_cached();
   return executorch::aten::ArrayRef<std::optional<executorch::aten::Tensor>>{
       unwrapped_vals_, wrapped_vals_.size()};
 }
@@ -69,11 +69,37 @@ class BoxedEvalueList {
    */
   executorch::aten::ArrayRef<T> get() const;
 
+  /*
+   * Lets get() reuse the list it last constructed for as long as *epoch stays
+   * unchanged. The owner of the wrapped values must change *epoch whenever
+   * one of them may be re-bound to a different value. Pass nullptr to
+   * construct the list on every call, which is the default.
+   */
+  void set_cache_epoch(const uint32_t* epoch) {
+    epoch_ = epoch;
+    cached_ = false;
+  }
+
  private:
+  bool is_cached() const {
+    return cached_ && *epoch_ == cached_epoch_;
+  }
+
+  void mark_cached() const {
+    if (epoch_ != nullptr) {
+      cached_ = true;
+      cached_epoch_ = *epoch_;
+    }
+  }
+
   // Source of truth for the list
   executorch::aten::ArrayRef<EValue*> wrapped_vals_;
   // Same size as wrapped_vals
   mutable T* unwrapped_vals_;
+  // Version of the wrapped values that unwrapped_vals_ was constructed from.
+  const uint32_t* epoch_ = nullptr;
+  mutable uint32_t cached_epoch_ = 0;
+  mutable bool cached_ = false;
 };
 
 template <>
@@ -536,12 +562,17 @@ EVALUE_DEFINE_TO(
 
 template <typename T>
 executorch::aten::ArrayRef<T> BoxedEvalueList<T>::get() const {
+  if (is_cached()) {
+    return executorch::aten::ArrayRef<T>{
+        unwrapped_vals_, wrapped_vals_.size()};
+  }
   for (typename executorch::aten::ArrayRef<T>::size_type i = 0;
        i < wrapped_vals_.size();
        i++) {
     ET_CHECK(wrapped_vals_[i] != nullptr);
     unwrapped_vals_[i] = wrapped_vals_[i]->template to<T>();
   }
+  mark_cached();
   return executorch::aten::ArrayRef<T>{unwrapped_vals_, wrapped_vals_.size()};
 }
 
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Measures how long kernels spend unboxing Tensor lists, with and without
+ * the unboxed list being cached between calls.
+ *
+ * Every simulated execution runs a number of list consumers (e.g. cat or
+ * index) over the same lists, and re-binds one value in between executions,
+ * which is what a MoveCall does.
+ *
+ * Usage: boxed_evalue_list_benchmark [executions]
+ */
+
+#include <executorch/runtime/core/evalue.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::BoxedEvalueList;
+using executorch::runtime::EValue;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+constexpr int kListsPerExecution = 32;
+
+double run(size_t list_size, int executions, bool cached) {
+  TensorFactory<ScalarType::Float> tf;
+  std::vector<EValue> values;
+  values.reserve(list_size);
+  for (size_t i = 0; i < list_size; ++i) {
+    values.emplace_back(tf.ones({2, 2}));
+  }
+  std::vector<EValue*> wrapped;
+  for (auto& value : values) {
+    wrapped.push_back(&value);
+  }
+  std::vector<Tensor> unwrapped(list_size, tf.zeros({1}));
+  BoxedEvalueList<Tensor> list(
+      wrapped.data(), unwrapped.data(), static_cast<int>(list_size));
+  uint32_t epoch = 0;
+  if (cached) {
+    list.set_cache_epoch(&epoch);
+  }
+  const EValue list_value(&list);
+
+  int64_t checksum = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int e = 0; e < executions; ++e) {
+    values[0] = EValue(values[0].toTensor());
+    ++epoch;
+    for (int k = 0; k < kListsPerExecution; ++k) {
+      checksum += list_value.toTensorList().back().numel();
+    }
+  }
+  const auto end = std::chrono::steady_clock::now();
+  if (checksum == 0) {
+    std::printf("unexpected checksum\n");
+  }
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+      (static_cast<double>(executions) * kListsPerExecution);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  executorch::runtime::runtime_init();
+  const int executions = argc > 1 ? std::atoi(argv[1]) : 10000;
+
+  std::printf(
+      "%10s %16s %16s\n", "list size", "uncached ns/get", "cached ns/get");
+  for (size_t list_size : {2, 8, 32, 128}) {
+    const double uncached = run(list_size, executions, false);
+    const double cached = run(list_size, executions, true);
+    std::printf("%10zu %16.1f %16.1f\n", list_size, uncached, cached);
+  }
+  return 0;
+}
@@ -214,6 +214,60 @@ TEST_F(EValueTest, BoxedEvalueList) {
   EXPECT_EQ(unwrapped[2], 3);
 }
 
+TEST_F(EValueTest, BoxedEvalueListWithoutEpochFollowsValues) {
+  EValue values[2] = {EValue((int64_t)1), EValue((int64_t)2)};
+  EValue* values_p[2] = {&values[0], &values[1]};
+  int64_t storage[2] = {0, 0};
+  BoxedEvalueList<int64_t> x{values_p, storage, 2};
+  EXPECT_EQ(x.get()[1], 2);
+
+  values[1] = EValue((int64_t)5);
+  EXPECT_EQ(x.get()[1], 5);
+}
+
+TEST_F(EValueTest, BoxedEvalueListCachesUntilEpochChanges) {
+  TensorFactory<ScalarType::Float> tf;
+  EValue values[2] = {EValue(tf.ones({2})), EValue(tf.zeros({3}))};
+  EValue* values_p[2] = {&values[0], &values[1]};
+  executorch::aten::Tensor storage[2] = {tf.zeros({1}), tf.zeros({1})};
+  BoxedEvalueList<executorch::aten::Tensor> x{values_p, storage, 2};
+  uint32_t epoch = 0;
+  x.set_cache_epoch(&epoch);
+
+  EXPECT_EQ(x.get()[1].numel(), 3);
+
+  // Re-binding a value isn't noticed until the epoch changes.
+  values[1] = EValue(tf.zeros({4}));
+  EXPECT_EQ(x.get()[1].numel(), 3);
+  ++epoch;
+  EXPECT_EQ(x.get()[1].numel(), 4);
+
+  // Without an epoch, every call unboxes the list again.
+  x.set_cache_epoch(nullptr);
+  values[0] = EValue(tf.zeros({5}));
+  EXPECT_EQ(x.get()[0].numel(), 5);
+}
+
+TEST_F(EValueTest, BoxedOptionalTensorListCachesUntilEpochChanges) {
+  TensorFactory<ScalarType::Float> tf;
+  EValue values[1] = {EValue()};
+  EValue* values_p[2] = {&values[0], nullptr};
+  std::optional<executorch::aten::Tensor> storage[2];
+  BoxedEvalueList<std::optional<executorch::aten::Tensor>> x{
+      values_p, storage, 2};
+  uint32_t epoch = 0;
+  x.set_cache_epoch(&epoch);
+
+  EXPECT_FALSE(x.get()[0].has_value());
+  EXPECT_FALSE(x.get()[1].has_value());
+
+  values[0] = EValue(tf.ones({2}));
+  EXPECT_FALSE(x.get()[0].has_value());
+  ++epoch;
+  ASSERT_TRUE(x.get()[0].has_value());
+  EXPECT_EQ(x.get()[0]->numel(), 2);
+}
+
 TEST_F(EValueTest, toOptionalTensorList) {
   // create list, empty evalue ctor gets tag::None
   EValue values[2] = {EValue(), EValue()};
@@ -128,3 +128,13 @@ def define_common_targets():
                 "//executorch/runtime/core:evalue" + aten_suffix,
             ],
         )
+
+    runtime.cxx_binary(
+        name = "boxed_evalue_list_benchmark",
+        srcs = ["boxed_evalue_list_benchmark.cpp"],
+        deps = [
+            "//executorch/runtime/core:evalue",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/instruction_uses.h>
+
+namespace executorch {
+namespace ET_RUNTIME_NAMESPACE {
+namespace internal {
+
+const flatbuffers::Vector<int32_t>* tensor_list_items(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    int32_t value_index) {
+  const auto values = plan->values();
+  if (values == nullptr || value_index < 0 ||
+      static_cast<size_t>(value_index) >= values->size()) {
+    return nullptr;
+  }
+  const auto value = values->Get(value_index);
+  if (value->val_type() != executorch_flatbuffer::KernelTypes::TensorList) {
+    return nullptr;
+  }
+  return value->val_as_TensorList()->items();
+}
+
+bool refers_to(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    int32_t arg,
+    int32_t value_index) {
+  if (arg == value_index) {
+    return true;
+  }
+  const auto items = tensor_list_items(plan, arg);
+  if (items != nullptr) {
+    for (const auto item : *items) {
+      if (item == value_index) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+ValueUse instruction_use(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const executorch_flatbuffer::Instruction* instruction,
+    int32_t value_index) {
+  switch (instruction->instr_args_type()) {
+    case executorch_flatbuffer::InstructionArguments::KernelCall: {
+      const auto args = instruction->instr_args_as_KernelCall()->args();
+      if (args == nullptr || args->size() == 0) {
+        return ValueUse::None;
+      }
+      const auto last = args->Get(args->size() - 1);
+      if (refers_to(plan, last, value_index)) {
+        const bool in_place = args->size() > 1 && args->Get(0) == last;
+        return in_place ? ValueUse::Update : ValueUse::Write;
+      }
+      for (size_t i = 0; i + 1 < args->size(); ++i) {
+        if (refers_to(plan, args->Get(i), value_index)) {
+          return ValueUse::Read;
+        }
+      }
+      return ValueUse::None;
+    }
+    case executorch_flatbuffer::InstructionArguments::DelegateCall: {
+      const auto args = instruction->instr_args_as_DelegateCall()->args();
+      if (args != nullptr) {
+        for (const auto arg : *args) {
+          if (refers_to(plan, arg, value_index)) {
+            return ValueUse::Delegate;
+          }
+        }
+      }
+      return ValueUse::None;
+    }
+    case executorch_flatbuffer::InstructionArguments::MoveCall: {
+      const auto move_call = instruction->instr_args_as_MoveCall();
+      if (move_call->move_to() == value_index) {
+        return ValueUse::Write;
+      }
+      return move_call->move_from() == value_index ? ValueUse::Read
+                                                   : ValueUse::None;
+    }
+    default:
+      return ValueUse::None;
+  }
+}
+
+} // namespace internal
+} // namespace ET_RUNTIME_NAMESPACE
+} // namespace executorch
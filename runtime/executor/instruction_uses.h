@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/schema/program_generated.h>
+
+namespace executorch {
+namespace ET_RUNTIME_NAMESPACE {
+namespace internal {
+
+using Instructions = flatbuffers::Vector<
+    flatbuffers::Offset<executorch_flatbuffer::Instruction>>;
+
+/// The items of the value at `value_index` if it is a TensorList, else null.
+const flatbuffers::Vector<int32_t>* tensor_list_items(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    int32_t value_index);
+
+/// Whether the instruction argument `arg` is the value at `value_index` or a
+/// TensorList that holds it.
+bool refers_to(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    int32_t arg,
+    int32_t value_index);
+
+enum class ValueUse {
+  None,
+  /// Only read.
+  Read,
+  /// Read and written in place.
+  Update,
+  /// Written without being read.
+  Write,
+  /// Passed to a delegate, which may read or write it.
+  Delegate,
+};
+
+/**
+ * How an instruction uses a value. The emitter appends the output of a
+ * kernel, or a TensorList of its outputs, as its last argument. Kernels that
+ * write their first argument in place return it as their output.
+ */
+ValueUse instruction_use(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const executorch_flatbuffer::Instruction* instruction,
+    int32_t value_index);
+
+/// Whether an instruction may write a value: as a kernel output, in place, as
+/// a delegate argument, or as the destination of a move.
+inline bool instruction_writes(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const executorch_flatbuffer::Instruction* instruction,
+    int32_t value_index) {
+  const ValueUse use = instruction_use(plan, instruction, value_index);
+  return use == ValueUse::Update || use == ValueUse::Write ||
+      use == ValueUse::Delegate;
+}
+
+/**
+ * Calls `fn` with the index of every value that instruction_writes() is true
+ * for. A value may be passed more than once.
+ */
+template <typename Fn>
+void for_each_written_value(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const executorch_flatbuffer::Instruction* instruction,
+    Fn fn) {
+  auto write = [&](int32_t arg) {
+    fn(arg);
+    const auto items = tensor_list_items(plan, arg);
+    if (items != nullptr) {
+      for (const auto item : *items) {
+        fn(item);
+      }
+    }
+  };
+  switch (instruction->instr_args_type()) {
+    case executorch_flatbuffer::InstructionArguments::KernelCall: {
+      const auto args = instruction->instr_args_as_KernelCall()->args();
+      if (args != nullptr && args->size() > 0) {
+        write(args->Get(args->size() - 1));
+      }
+      break;
+    }
+    case executorch_flatbuffer::InstructionArguments::DelegateCall: {
+      const auto args = instruction->instr_args_as_DelegateCall()->args();
+      if (args != nullptr) {
+        for (const auto arg : *args) {
+          write(arg);
+        }
+      }
+      break;
+    }
+    case executorch_flatbuffer::InstructionArguments::MoveCall:
+      fn(instruction->instr_args_as_MoveCall()->move_to());
+      break;
+    default:
+      break;
+  }
+}
+
+} // namespace internal
+} // namespace ET_RUNTIME_NAMESPACE
+} // namespace executorch
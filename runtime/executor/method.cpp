@@ -9,24 +9,29 @@
 #include <executorch/runtime/executor/method.h>
 
 #include <c10/util/irange.h>
+#include <algorithm>
 #include <array>
 #include <cinttypes> // @donotremove
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/event_tracer_hooks.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/core/named_data_map.h>
 #include <executorch/runtime/core/span.h>
+#include <executorch/runtime/executor/instruction_uses.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/merged_data_map.h>
 #include <executorch/runtime/executor/platform_memory_allocator.h>
 #include <executorch/runtime/executor/program.h>
 #include <executorch/runtime/executor/tensor_parser.h>
+#include <executorch/runtime/kernel/fused_elementwise.h>
 #include <executorch/runtime/kernel/kernel_runtime_context.h>
 #include <executorch/runtime/kernel/operator_registry.h>
 #include <executorch/runtime/platform/assert.h>
+#include <executorch/runtime/platform/clock.h>
 #include <executorch/runtime/platform/compiler.h>
 #include <executorch/runtime/platform/log.h>
 #include <executorch/runtime/platform/profiler.h>
@@ -291,6 +296,151 @@ Result<bool> parse_cond_value(const EValue& cond_value) {
   return true;
 }
 
+// Per-value state used by Method::fold_constant_instructions().
+enum : uint8_t {
+  // The value is the same in every execution: a scalar, or a tensor with
+  // data from the program, that nothing writes.
+  kValueConstant = 1 << 0,
+  // The value is a method input or output.
+  kValueMethodIO = 1 << 1,
+  // An instruction writes the value.
+  kValueWritten = 1 << 2,
+  // More than one instruction writes the value.
+  kValueWrittenTwice = 1 << 3,
+};
+
+// Kernels that Method::fold_constant_instructions() may run once at init.
+// Each computes its outputs from its arguments alone. Anything else, e.g. a
+// random op or a custom op with side effects, runs in every execution.
+constexpr const char* kFoldableOps[] = {
+    "aten::_to_copy",
+    "aten::add",
+    "aten::cat",
+    "aten::clone",
+    "aten::div",
+    "aten::expand_copy",
+    "aten::mul",
+    "aten::permute_copy",
+    "aten::select_copy",
+    "aten::slice_copy",
+    "aten::split_with_sizes_copy",
+    "aten::squeeze_copy",
+    "aten::sub",
+    "aten::t_copy",
+    "aten::transpose_copy",
+    "aten::unbind_copy",
+    "aten::unsqueeze_copy",
+    "aten::view_copy",
+    "dim_order_ops::_to_dim_order_copy",
+    "quantized_decomposed::dequantize_per_channel",
+    "quantized_decomposed::dequantize_per_tensor",
+};
+
+bool is_foldable_op(const char* name) {
+  for (const char* foldable : kFoldableOps) {
+    if (std::strcmp(name, foldable) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Replaces kernel calls that were folded or fused at init.
+void noop_kernel(KernelRuntimeContext&, Span<EValue*>) {}
+
+// Returns true if every value in `items` has `flag` set. Negative items are
+// the None entries of optional lists.
+template <typename T>
+bool all_items_have_flag(
+    const flatbuffers::Vector<T>* items,
+    const uint8_t* state,
+    size_t n_value,
+    uint8_t flag) {
+  if (items == nullptr) {
+    return false;
+  }
+  for (const auto item : *items) {
+    if (item >= 0 &&
+        (static_cast<size_t>(item) >= n_value || !(state[item] & flag))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// A kernel call that Method::fuse_elementwise_instructions() can fuse. Its
+// arguments are the inputs, then alpha if the op has one, then the output.
+struct FusibleOp {
+  const char* name;
+  const char* overload;
+  FusedElementwiseOp op;
+  size_t n_inputs;
+  bool has_alpha;
+};
+
+constexpr FusibleOp kFusibleOps[] = {
+    {"aten::add", "out", FusedElementwiseOp::Add, 2, true},
+    {"aten::add", "Scalar_out", FusedElementwiseOp::Add, 2, true},
+    {"aten::sub", "out", FusedElementwiseOp::Sub, 2, true},
+    {"aten::sub", "Scalar_out", FusedElementwiseOp::Sub, 2, true},
+    {"aten::mul", "out", FusedElementwiseOp::Mul, 2, false},
+    {"aten::mul", "Scalar_out", FusedElementwiseOp::Mul, 2, false},
+    {"aten::div", "out", FusedElementwiseOp::Div, 2, false},
+    {"aten::div", "Scalar_out", FusedElementwiseOp::Div, 2, false},
+    {"aten::neg", "out", FusedElementwiseOp::Neg, 1, false},
+    {"aten::relu", "out", FusedElementwiseOp::Relu, 1, false},
+    {"aten::sigmoid", "out", FusedElementwiseOp::Sigmoid, 1, false},
+    {"aten::tanh", "out", FusedElementwiseOp::Tanh, 1, false},
+    {"aten::exp", "out", FusedElementwiseOp::Exp, 1, false},
+};
+
+const FusibleOp* find_fusible_op(const executorch_flatbuffer::Operator* op) {
+  if (op == nullptr || op->name() == nullptr || op->overload() == nullptr) {
+    return nullptr;
+  }
+  for (const auto& fusible_op : kFusibleOps) {
+    if (std::strcmp(op->name()->c_str(), fusible_op.name) == 0 &&
+        std::strcmp(op->overload()->c_str(), fusible_op.overload) == 0) {
+      return &fusible_op;
+    }
+  }
+  return nullptr;
+}
+
+// Returns true if `value` is a contiguous Float tensor whose shape is fixed
+// at `sizes`, which the fused elementwise kernel can read or write directly.
+bool is_fusible_tensor(
+    const EValue& value,
+    const executorch_flatbuffer::EValue* s_value,
+    executorch::aten::ArrayRef<executorch::aten::SizesType> sizes) {
+  if (!value.isTensor() ||
+      s_value->val_type() != executorch_flatbuffer::KernelTypes::Tensor) {
+    return false;
+  }
+  const auto& t = value.toTensor();
+  const auto* s_tensor = s_value->val_as_Tensor();
+  if (t.scalar_type() != executorch::aten::ScalarType::Float ||
+      s_tensor->shape_dynamism() !=
+          executorch_flatbuffer::TensorShapeDynamism::STATIC ||
+      static_cast<size_t>(t.dim()) != sizes.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (t.size(i) != sizes[i]) {
+      return false;
+    }
+  }
+  const auto* dim_order = s_tensor->dim_order();
+  if (dim_order != nullptr) {
+    for (size_t i = 0; i < dim_order->size(); ++i) {
+      if (dim_order->Get(i) != i) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 } // namespace
 
 Result<size_t> Method::get_num_external_constants() {
@@ -412,6 +562,12 @@ Error Method::parse_values(const NamedDataMap* external_data_map) {
   if (values_ == nullptr) {
     return Error::MemoryAllocationFailed;
   }
+  values_epoch_ =
+      memory_manager_->method_allocator()->allocateInstance<uint32_t>();
+  if (values_epoch_ == nullptr) {
+    return Error::MemoryAllocationFailed;
+  }
+  *values_epoch_ = 0;
   const size_t n_input = inputs_size();
   if (n_input > 0) {
     input_set_ =
@@ -610,6 +766,9 @@ Error Method::parse_values(const NamedDataMap* external_data_map) {
                 ->allocateInstance<BoxedEvalueList<executorch::aten::Tensor>>();
         auto boxed_tensor_list = new (boxed_tensor_list_mem)
             BoxedEvalueList<executorch::aten::Tensor>(std::move(tensors.get()));
+        // Kernels don't re-bind Tensor values, so the unboxed list can be
+        // reused until a MoveCall or delegate might have.
+        boxed_tensor_list->set_cache_epoch(values_epoch_);
         new (&values_[i]) EValue(boxed_tensor_list);
       } break;
       case executorch_flatbuffer::KernelTypes::OptionalTensorList: {
@@ -641,6 +800,7 @@ Error Method::parse_values(const NamedDataMap* external_data_map) {
         auto boxed_optional_tensor_list = new (boxed_optional_tensor_list_mem)
             BoxedEvalueList<std::optional<executorch::aten::Tensor>>(
                 std::move(tensors.get()));
+        boxed_optional_tensor_list->set_cache_epoch(values_epoch_);
         new (&values_[i]) EValue(boxed_optional_tensor_list);
       } break;
       default:
@@ -806,7 +966,8 @@ Result<Method> Method::load(
     const Program* program,
     MemoryManager* memory_manager,
     EventTracer* event_tracer,
-    const NamedDataMap* external_data_map) {
+    const NamedDataMap* external_data_map,
+    bool fold_constants) {
   MemoryAllocator* temp_allocator = memory_manager->temp_allocator();
   if (temp_allocator == nullptr) {
     PlatformMemoryAllocator* platform_allocator =
@@ -820,7 +981,7 @@ Result<Method> Method::load(
   }
   Method method(program, memory_manager, event_tracer, temp_allocator);
   ET_LOG(Debug, "Loading method: %s.", s_plan->name()->c_str());
-  Error err = method.init(s_plan, external_data_map);
+  Error err = method.init(s_plan, external_data_map, fold_constants);
   if (err != Error::Ok) {
     return err;
   } else {
@@ -831,7 +992,8 @@ Result<Method> Method::load(
 
 Error Method::init(
     executorch_flatbuffer::ExecutionPlan* s_plan,
-    const NamedDataMap* external_data_map) {
+    const NamedDataMap* external_data_map,
+    bool fold_constants) {
   EXECUTORCH_SCOPE_PROF("Method::init");
   internal::EventTracerProfileMethodScope event_tracer_profile_scope =
       internal::EventTracerProfileMethodScope(event_tracer_, "Method::init");
@@ -1056,12 +1218,504 @@ Error Method::init(
     }
   }
 
+  if (fold_constants) {
+    fold_constant_instructions();
+  }
+  fuse_elementwise_instructions();
+
   step_state_ = StepState{0, 0};
 
   init_state_ = InitializationState::Initialized;
   return Error::Ok;
 }
 
+void Method::fold_constant_instructions() {
+  // Folding is an optimization, so any problem here leaves the instructions
+  // to run during execution as usual.
+  uint8_t* state = temp_allocator_->allocateList<uint8_t>(n_value_);
+  if (state == nullptr) {
+    return;
+  }
+  std::memset(state, 0, n_value_);
+  const auto* s_values = serialization_plan_->values();
+  auto in_range = [this](int64_t index) {
+    return index >= 0 && static_cast<size_t>(index) < n_value_;
+  };
+
+  // Inputs and outputs change between executions.
+  for (const auto* io : {serialization_plan_->inputs(),
+                         serialization_plan_->outputs()}) {
+    if (io != nullptr) {
+      for (const auto index : *io) {
+        if (in_range(index)) {
+          state[index] |= kValueMethodIO;
+        }
+      }
+    }
+  }
+
+  // Find every value that an instruction may write, including the arguments
+  // of delegates and the items of out lists.
+  for (size_t i = 0; i < n_chains_; ++i) {
+    for (const auto* instruction : *chains_[i].s_chain_->instructions()) {
+      if (instruction->instr_args_type() ==
+          executorch_flatbuffer::InstructionArguments::JumpFalseCall) {
+        // Instructions may run any number of times, so their order says
+        // nothing about which values are set.
+        temp_allocator_->reset();
+        return;
+      }
+      internal::for_each_written_value(
+          serialization_plan_, instruction, [&](int32_t index) {
+            if (in_range(index)) {
+              state[index] |= (state[index] & kValueWritten)
+                  ? kValueWrittenTwice
+                  : kValueWritten;
+            }
+          });
+    }
+  }
+
+  // Values that nothing writes are constant if the program provides them:
+  // scalars, and tensors with data but no planned memory.
+  constexpr uint8_t kVariable =
+      kValueMethodIO | kValueWritten | kValueWrittenTwice;
+  for (size_t i = 0; i < n_value_; ++i) {
+    const EValue& value = values_[i];
+    if (state[i] & kVariable) {
+      continue;
+    }
+    if (value.isTensor()) {
+      const auto* s_tensor = s_values->Get(i)->val_as_Tensor();
+      if (s_tensor->allocation_info() == nullptr &&
+          value.toTensor().const_data_ptr() != nullptr) {
+        state[i] |= kValueConstant;
+      }
+    } else if (
+        value.isNone() || value.isInt() || value.isDouble() ||
+        value.isBool() || value.isString() || value.isDoubleList() ||
+        value.isBoolList()) {
+      state[i] |= kValueConstant;
+    }
+  }
+  // Lists of constants are constant.
+  for (size_t i = 0; i < n_value_; ++i) {
+    if (state[i] & kVariable) {
+      continue;
+    }
+    const auto* s_value = s_values->Get(i);
+    bool constant = false;
+    switch (s_value->val_type()) {
+      case executorch_flatbuffer::KernelTypes::IntList:
+        constant = all_items_have_flag(
+            s_value->val_as_IntList()->items(),
+            state,
+            n_value_,
+            kValueConstant);
+        break;
+      case executorch_flatbuffer::KernelTypes::TensorList:
+        constant = all_items_have_flag(
+            s_value->val_as_TensorList()->items(),
+            state,
+            n_value_,
+            kValueConstant);
+        break;
+      case executorch_flatbuffer::KernelTypes::OptionalTensorList:
+        constant = all_items_have_flag(
+            s_value->val_as_OptionalTensorList()->items(),
+            state,
+            n_value_,
+            kValueConstant);
+        break;
+      default:
+        break;
+    }
+    if (constant) {
+      state[i] |= kValueConstant;
+    }
+  }
+
+  // The output of a kernel call is its trailing argument, or the tensors of
+  // its trailing list. Out variants also pass it, or a list of the same
+  // tensors, as their out argument.
+  auto is_output = [&](int32_t index, int32_t out) {
+    if (index == out) {
+      return true;
+    }
+    const auto* items =
+        internal::tensor_list_items(serialization_plan_, index);
+    if (items == nullptr ||
+        internal::tensor_list_items(serialization_plan_, out) == nullptr) {
+      return false;
+    }
+    for (const auto item : *items) {
+      if (!internal::refers_to(serialization_plan_, out, item)) {
+        return false;
+      }
+    }
+    return true;
+  };
+  // An output can only be computed once if nothing else writes it, and its
+  // planned memory is scratch space rather than state that persists between
+  // executions or is shared with other methods.
+  const MethodMeta meta = method_meta();
+  auto is_foldable_output = [&](int32_t index) {
+    if (!in_range(index) || (state[index] & kVariable) != kValueWritten ||
+        !values_[index].isTensor()) {
+      return false;
+    }
+    const auto* allocation =
+        s_values->Get(index)->val_as_Tensor()->allocation_info();
+    if (allocation == nullptr || allocation->memory_id() == 0) {
+      return false;
+    }
+    Result<bool> holds_state =
+        meta.memory_planned_buffer_holds_state(allocation->memory_id() - 1);
+    return holds_state.ok() && !holds_state.get();
+  };
+
+  // Fold the allowlisted kernel calls whose arguments are all constant,
+  // apart from their outputs.
+  auto method_allocator = memory_manager_->method_allocator();
+  const auto* ops = serialization_plan_->operators();
+  size_t folded_instructions = 0;
+  uint64_t folding_ticks = 0;
+  for (size_t i = 0; i < n_chains_; ++i) {
+    Chain& chain = chains_[i];
+    const auto* instructions = chain.s_chain_->instructions();
+    for (size_t instr_idx = 0; instr_idx < instructions->size(); ++instr_idx) {
+      const auto* instruction = instructions->Get(instr_idx);
+      if (instruction->instr_args_type() !=
+          executorch_flatbuffer::InstructionArguments::KernelCall) {
+        continue;
+      }
+      const auto* kernel_call = instruction->instr_args_as_KernelCall();
+      const auto* s_args = kernel_call->args();
+      if (s_args == nullptr || s_args->size() == 0 ||
+          !is_foldable_op(ops->Get(kernel_call->op_index())->name()->c_str())) {
+        continue;
+      }
+      const int32_t out = s_args->Get(s_args->size() - 1);
+      bool foldable = in_range(out) && !(state[out] & kValueMethodIO);
+      for (size_t j = 0; j < s_args->size() && foldable; ++j) {
+        const int32_t index = s_args->Get(j);
+        foldable = is_output(index, out) ||
+            (in_range(index) && (state[index] & kValueConstant));
+      }
+      const auto* out_items =
+          internal::tensor_list_items(serialization_plan_, out);
+      if (out_items != nullptr) {
+        for (size_t j = 0; j < out_items->size() && foldable; ++j) {
+          foldable = is_foldable_output(out_items->Get(j));
+        }
+      } else {
+        foldable = foldable && is_foldable_output(out);
+      }
+
+      // Give the output tensors buffers of their own, since the memory plan
+      // reuses their planned memory for other values.
+      auto give_own_buffer = [&](int32_t index) {
+        const auto& t = values_[index].toTensor();
+        const size_t nbytes = t.nbytes();
+        void* data = nbytes > 0 ? method_allocator->allocate(nbytes) : nullptr;
+        return nbytes == 0 ||
+            (data != nullptr &&
+             internal::set_tensor_data(t, data, nbytes) == Error::Ok);
+      };
+      if (out_items != nullptr) {
+        for (size_t j = 0; j < out_items->size() && foldable; ++j) {
+          foldable = give_own_buffer(out_items->Get(j));
+        }
+      } else if (foldable) {
+        foldable = give_own_buffer(out);
+      }
+      if (!foldable) {
+        continue;
+      }
+
+      KernelRuntimeContext context(event_tracer_, temp_allocator_);
+      auto args = chain.argument_lists_[instr_idx];
+      const et_timestamp_t start = et_pal_current_ticks();
+      chain.kernels_[instr_idx](context, args);
+      folding_ticks += et_pal_current_ticks() - start;
+      if (context.failure_state() != Error::Ok) {
+        // Let execute() run it again and report the failure.
+        continue;
+      }
+      chain.kernels_[instr_idx] = noop_kernel;
+      ++folded_instructions;
+    }
+  }
+  temp_allocator_->reset();
+
+  constant_folding_stats_ =
+      ConstantFoldingStats{folded_instructions, ticks_to_ns(folding_ticks)};
+  if (folded_instructions > 0) {
+    ET_LOG(
+        Info,
+        "Folded %" ET_PRIsize_t " constant instructions of %s in %.3f ms",
+        folded_instructions,
+        serialization_plan_->name()->c_str(),
+        constant_folding_stats_.folding_time_ns / 1e6);
+  }
+}
+
+void Method::fuse_elementwise_instructions() {
+  // Programs opt in by registering the kernel that runs fused chains.
+  OpFunction fused_kernel = nullptr;
+  for (const auto& kernel : get_registered_kernels()) {
+    if (std::strcmp(kernel.name_, kFusedElementwiseKernelName) == 0) {
+      fused_kernel = kernel.op_;
+      break;
+    }
+  }
+  if (fused_kernel == nullptr) {
+    return;
+  }
+
+  // Count how often each value is referenced. The output of a call can only
+  // be fused away if the next call is the only other reference to it.
+  // Method inputs and outputs count as referenced elsewhere.
+  uint8_t* refs = temp_allocator_->allocateList<uint8_t>(n_value_);
+  if (refs == nullptr) {
+    return;
+  }
+  std::memset(refs, 0, n_value_);
+  const auto* s_values = serialization_plan_->values();
+  auto add_ref = [&](int64_t index) {
+    if (index >= 0 && static_cast<size_t>(index) < n_value_ &&
+        refs[index] < UINT8_MAX) {
+      ++refs[index];
+    }
+  };
+  for (const auto* io :
+       {serialization_plan_->inputs(), serialization_plan_->outputs()}) {
+    if (io != nullptr) {
+      for (const auto index : *io) {
+        add_ref(index);
+        add_ref(index);
+      }
+    }
+  }
+  for (size_t i = 0; i < n_chains_; ++i) {
+    const auto* instructions = chains_[i].s_chain_->instructions();
+    for (size_t instr_idx = 0; instr_idx < instructions->size();
+         ++instr_idx) {
+      const auto* instruction = instructions->Get(instr_idx);
+      switch (instruction->instr_args_type()) {
+        case executorch_flatbuffer::InstructionArguments::KernelCall:
+        case executorch_flatbuffer::InstructionArguments::DelegateCall:
+          for (const EValue* arg : chains_[i].argument_lists_[instr_idx]) {
+            const size_t index = arg - values_;
+            add_ref(index);
+            // Kernels like cat read the tensors of a list.
+            const auto* s_value = s_values->Get(index);
+            const flatbuffers::Vector<int32_t>* items = nullptr;
+            if (s_value->val_type() ==
+                executorch_flatbuffer::KernelTypes::TensorList) {
+              items = s_value->val_as_TensorList()->items();
+            } else if (
+                s_value->val_type() ==
+                executorch_flatbuffer::KernelTypes::OptionalTensorList) {
+              items = s_value->val_as_OptionalTensorList()->items();
+            }
+            if (items != nullptr) {
+              for (const auto item : *items) {
+                add_ref(item);
+              }
+            }
+          }
+          break;
+        case executorch_flatbuffer::InstructionArguments::MoveCall:
+          add_ref(instruction->instr_args_as_MoveCall()->move_from());
+          add_ref(instruction->instr_args_as_MoveCall()->move_to());
+          break;
+        case executorch_flatbuffer::InstructionArguments::FreeCall:
+          add_ref(instruction->instr_args_as_FreeCall()->value_index());
+          break;
+        case executorch_flatbuffer::InstructionArguments::JumpFalseCall:
+          // Jumps may skip or repeat part of a chain of calls.
+          temp_allocator_->reset();
+          return;
+        default:
+          break;
+      }
+    }
+  }
+
+  const auto* ops = serialization_plan_->operators();
+  auto method_allocator = memory_manager_->method_allocator();
+  size_t fused_chains = 0;
+  size_t fused_instructions = 0;
+  for (size_t i = 0; i < n_chains_; ++i) {
+    Chain& chain = chains_[i];
+    const auto* instructions = chain.s_chain_->instructions();
+
+    // Returns the op of instruction `instr_idx` if the fused kernel can run
+    // it, or null.
+    auto fusible_op = [&](size_t instr_idx) -> const FusibleOp* {
+      const auto* instruction = instructions->Get(instr_idx);
+      if (instruction->instr_args_type() !=
+              executorch_flatbuffer::InstructionArguments::KernelCall ||
+          chain.kernels_[instr_idx] == noop_kernel) {
+        return nullptr;
+      }
+      const auto* op = find_fusible_op(
+          ops->Get(instruction->instr_args_as_KernelCall()->op_index()));
+      const auto args = chain.argument_lists_[instr_idx];
+      if (op == nullptr ||
+          args.size() != op->n_inputs + (op->has_alpha ? 1 : 0) + 1) {
+        return nullptr;
+      }
+      EValue* const out = args[args.size() - 1];
+      if (!out->isTensor()) {
+        return nullptr;
+      }
+      const auto sizes = out->toTensor().sizes();
+      for (size_t j = 0; j < args.size() - 1; ++j) {
+        const EValue& arg = *args[j];
+        // The first input must be a tensor, and alpha a number. The second
+        // input can be either.
+        const bool is_number = arg.isInt() || arg.isDouble();
+        const bool fusible = j >= op->n_inputs
+            ? is_number
+            : (j > 0 && is_number) ||
+                is_fusible_tensor(
+                    arg, s_values->Get(args[j] - values_), sizes);
+        if (!fusible) {
+          return nullptr;
+        }
+      }
+      if (!is_fusible_tensor(*out, s_values->Get(out - values_), sizes)) {
+        return nullptr;
+      }
+      return op;
+    };
+
+    size_t begin = 0;
+    while (begin < instructions->size()) {
+      const FusibleOp* steps[kMaxFusedElementwiseSteps];
+      steps[0] = fusible_op(begin);
+      if (steps[0] == nullptr) {
+        ++begin;
+        continue;
+      }
+      // Extend the chain while the next call reads the previous output, and
+      // nothing else does.
+      size_t end = begin + 1;
+      while (end < instructions->size() &&
+             end - begin < kMaxFusedElementwiseSteps) {
+        const FusibleOp* op = fusible_op(end);
+        if (op == nullptr) {
+          break;
+        }
+        const auto prev_args = chain.argument_lists_[end - 1];
+        const EValue* const prev_out = prev_args[prev_args.size() - 1];
+        const auto args = chain.argument_lists_[end];
+        size_t reads = 0;
+        for (size_t j = 0; j < op->n_inputs; ++j) {
+          reads += args[j] == prev_out ? 1 : 0;
+        }
+        if (reads == 0 || refs[prev_out - values_] != reads + 1) {
+          break;
+        }
+        steps[end - begin] = op;
+        ++end;
+      }
+      const size_t n_steps = end - begin;
+      if (n_steps < 2) {
+        begin = end;
+        continue;
+      }
+
+      // Collect the operands, i.e. the inputs that are not the output of the
+      // previous step.
+      EValue* operands[kMaxFusedElementwiseOperands];
+      size_t n_operands = 0;
+      auto is_prev_out = [&](size_t s, const EValue* value) {
+        if (s == 0) {
+          return false;
+        }
+        const auto prev_args = chain.argument_lists_[begin + s - 1];
+        return value == prev_args[prev_args.size() - 1];
+      };
+      for (size_t s = 0; s < n_steps; ++s) {
+        const auto args = chain.argument_lists_[begin + s];
+        for (size_t j = 0; j < steps[s]->n_inputs; ++j) {
+          if (!is_prev_out(s, args[j]) &&
+              std::find(operands, operands + n_operands, args[j]) ==
+                  operands + n_operands) {
+            operands[n_operands++] = args[j];
+          }
+        }
+      }
+      auto value_index = [&](size_t s, const EValue* value) -> int64_t {
+        if (is_prev_out(s, value)) {
+          return n_operands + s - 1;
+        }
+        return std::find(operands, operands + n_operands, value) - operands;
+      };
+
+      // See executorch/runtime/kernel/fused_elementwise.h for the layout.
+      const size_t n_args =
+          1 + n_operands + n_steps * kFusedElementwiseArgsPerStep + 1;
+      EValue** fused_args = method_allocator->allocateList<EValue*>(n_args);
+      // The operand count, three ints per step, and the default alpha.
+      EValue* ints =
+          method_allocator->allocateList<EValue>(1 + 3 * n_steps + 1);
+      if (fused_args == nullptr || ints == nullptr) {
+        // Leave the rest of the chain unfused.
+        break;
+      }
+      EValue* const default_alpha = new (&ints[3 * n_steps + 1]) EValue(1.0);
+      size_t arg = 0;
+      fused_args[arg++] =
+          new (&ints[0]) EValue(static_cast<int64_t>(n_operands));
+      for (size_t j = 0; j < n_operands; ++j) {
+        fused_args[arg++] = operands[j];
+      }
+      for (size_t s = 0; s < n_steps; ++s) {
+        const auto args = chain.argument_lists_[begin + s];
+        const FusibleOp& op = *steps[s];
+        EValue* const step_ints = &ints[1 + 3 * s];
+        fused_args[arg++] =
+            new (&step_ints[0]) EValue(static_cast<int64_t>(op.op));
+        fused_args[arg++] =
+            new (&step_ints[1]) EValue(value_index(s, args[0]));
+        fused_args[arg++] = new (&step_ints[2]) EValue(
+            op.n_inputs > 1 ? value_index(s, args[1]) : int64_t(-1));
+        fused_args[arg++] = op.has_alpha ? args[op.n_inputs] : default_alpha;
+      }
+      const auto last_args = chain.argument_lists_[end - 1];
+      fused_args[arg++] = last_args[last_args.size() - 1];
+
+      // The fused call runs in place of the first call of the chain, and
+      // the rest do nothing.
+      chain.argument_lists_[begin] = InstructionArgs(fused_args, n_args);
+      chain.kernels_[begin] = fused_kernel;
+      for (size_t s = 1; s < n_steps; ++s) {
+        chain.kernels_[begin + s] = noop_kernel;
+      }
+      ++fused_chains;
+      fused_instructions += n_steps;
+      begin = end;
+    }
+  }
+  temp_allocator_->reset();
+
+  elementwise_fusion_stats_ =
+      ElementwiseFusionStats{fused_chains, fused_instructions};
+  if (fused_chains > 0) {
+    ET_LOG(
+        Info,
+        "Fused %" ET_PRIsize_t " elementwise instructions of %s into %"
+        ET_PRIsize_t " kernel calls",
+        fused_instructions,
+        serialization_plan_->name()->c_str(),
+        fused_chains);
+  }
+}
+
 ET_NODISCARD Error
 Method::set_input(const EValue& input_evalue, size_t input_idx) {
   ET_CHECK_OR_RETURN_ERROR(
@@ -1131,6 +1785,7 @@ Method::set_input(const EValue& input_evalue, size_t input_idx) {
         input_idx,
         executorch::runtime::toString(t_dst.scalar_type()),
         executorch::runtime::toString(t_src.scalar_type()));
+    restore_aliased_input(input_idx);
     // Reset the shape for the Method's input as the size of forwarded input
     // tensor for shape dynamism. Also is a safety check if need memcpy.
     ET_CHECK_OK_OR_RETURN_ERROR(
@@ -1237,6 +1892,156 @@ Method::set_inputs(const executorch::aten::ArrayRef<EValue>& input_evalues) {
   return Error::Ok;
 }
 
+ET_NODISCARD Result<executorch::aten::Tensor> Method::planned_input_buffer(
+    size_t input_idx,
+    executorch::aten::ArrayRef<executorch::aten::SizesType> sizes) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Input can not be set until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
+      InvalidState,
+      "Inputs can not be set mid execution.");
+  ET_CHECK_OR_RETURN_ERROR(
+      input_idx < inputs_size(),
+      InvalidArgument,
+      "Input index (%" ET_PRIsize_t
+      ") must be less than the number of inputs in method (%" ET_PRIsize_t ").",
+      input_idx,
+      inputs_size());
+  const auto& e = get_value(get_input_index(input_idx));
+  ET_CHECK_OR_RETURN_ERROR(
+      e.isTensor(),
+      InvalidArgument,
+      "Input %" ET_PRIsize_t " is not a tensor.",
+      input_idx);
+  auto tensor_meta = this->method_meta().input_tensor_meta(input_idx);
+  ET_CHECK_OK_OR_RETURN_ERROR(tensor_meta.error());
+  ET_CHECK_OR_RETURN_ERROR(
+      tensor_meta->is_memory_planned(),
+      InvalidArgument,
+      "Input %" ET_PRIsize_t " has no planned buffer; use set_input().",
+      input_idx);
+
+  restore_aliased_input(input_idx);
+  const auto& t = e.toTensor();
+  ET_CHECK_OK_OR_RETURN_ERROR(
+      resize_tensor(t, sizes),
+      "Error resizing tensor at input %" ET_PRIsize_t,
+      input_idx);
+  input_set_[input_idx] = true;
+  return t;
+}
+
+ET_NODISCARD Error
+Method::alias_input(const EValue& input_evalue, size_t input_idx) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Input can not be set until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      input_idx < inputs_size(),
+      InvalidArgument,
+      "Input index (%" ET_PRIsize_t
+      ") must be less than the number of inputs in method (%" ET_PRIsize_t ").",
+      input_idx,
+      inputs_size());
+  const auto& e = get_value(get_input_index(input_idx));
+  if (!e.isTensor() || !input_evalue.isTensor() ||
+      input_evalue.toTensor().numel() == 0) {
+    return set_input(input_evalue, input_idx);
+  }
+
+  if (input_aliasing_ == nullptr) {
+    const size_t n_input = inputs_size();
+    input_aliasing_ =
+        memory_manager_->method_allocator()->allocateList<InputAliasing>(
+            n_input);
+    ET_CHECK_OR_RETURN_ERROR(
+        input_aliasing_ != nullptr,
+        MemoryAllocationFailed,
+        "Failed to allocate input aliasing state");
+    for (size_t i = 0; i < n_input; ++i) {
+      input_aliasing_[i] = InputAliasing{nullptr, input_is_read_only(i)};
+    }
+  }
+  auto tensor_meta = this->method_meta().input_tensor_meta(input_idx);
+  ET_CHECK_OK_OR_RETURN_ERROR(tensor_meta.error());
+  if (!tensor_meta->is_memory_planned() ||
+      !input_aliasing_[input_idx].read_only) {
+    return set_input(input_evalue, input_idx);
+  }
+
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
+      InvalidState,
+      "Inputs can not be set mid execution.");
+  restore_aliased_input(input_idx);
+  const auto& t_dst = e.toTensor();
+  const auto& t_src = input_evalue.toTensor();
+  ET_CHECK_OR_RETURN_ERROR(
+      t_dst.scalar_type() == t_src.scalar_type(),
+      InvalidArgument,
+      "Input %" ET_PRIsize_t
+      " has unexpected scalar type: expected %s but was %s.",
+      input_idx,
+      executorch::runtime::toString(t_dst.scalar_type()),
+      executorch::runtime::toString(t_src.scalar_type()));
+  ET_CHECK_OK_OR_RETURN_ERROR(
+      resize_tensor(t_dst, t_src.sizes()),
+      "Error resizing tensor at input %" ET_PRIsize_t,
+      input_idx);
+  void* planned_data = t_dst.mutable_data_ptr();
+  ET_CHECK_OK_OR_RETURN_ERROR(
+      internal::share_tensor_data(t_dst, t_src),
+      "Error sharing tensor data at input %" ET_PRIsize_t,
+      input_idx);
+  input_aliasing_[input_idx].planned_data = planned_data;
+  input_set_[input_idx] = true;
+  return Error::Ok;
+}
+
+bool Method::input_is_read_only(size_t input_idx) const {
+  const auto value_index = static_cast<int32_t>(get_input_index(input_idx));
+  const auto* outputs = serialization_plan_->outputs();
+  if (outputs != nullptr) {
+    for (const auto output : *outputs) {
+      if (output == value_index) {
+        return false;
+      }
+    }
+  }
+  for (size_t i = 0; i < n_chains_; ++i) {
+    const auto* instructions = chains_[i].s_chain_->instructions();
+    if (instructions == nullptr) {
+      continue;
+    }
+    for (const auto* instruction : *instructions) {
+      if (internal::instruction_writes(
+              serialization_plan_, instruction, value_index)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void Method::restore_aliased_input(size_t input_idx) {
+  if (input_aliasing_ == nullptr ||
+      input_aliasing_[input_idx].planned_data == nullptr) {
+    return;
+  }
+  const auto& t = get_value(get_input_index(input_idx)).toTensor();
+  // The planned buffer fits the largest size the input can be resized to.
+  ET_UNUSED Error err = internal::set_tensor_data(
+      t, input_aliasing_[input_idx].planned_data, t.nbytes());
+  ET_DCHECK(err == Error::Ok);
+  input_aliasing_[input_idx].planned_data = nullptr;
+  // The planned buffer does not hold the aliased data.
+  input_set_[input_idx] = false;
+}
+
 ET_NODISCARD Error
 Method::set_output_data_ptr(void* buffer, size_t size, size_t output_idx) {
   // Check method state
@@ -1417,6 +2222,8 @@ Error Method::execute_instruction() {
       err = delegates_[delegate_idx].Execute(
           backend_execution_context,
           chain.argument_lists_[step_state_.instr_idx]);
+      // Delegates may replace their output values.
+      invalidate_boxed_lists();
       if (err != Error::Ok) {
         ET_LOG(
             Error,
@@ -1467,6 +2274,7 @@ Error Method::execute_instruction() {
       // at init time.
       auto move_call = instruction->instr_args_as_MoveCall();
       mutable_value(move_call->move_to()) = get_value(move_call->move_from());
+      invalidate_boxed_lists();
     } break;
     case executorch_flatbuffer::InstructionArguments::FreeCall: {
       EXECUTORCH_SCOPE_PROF("FREE_CALL");
@@ -1501,6 +2309,11 @@ Error Method::reset_execution() {
       InvalidState,
       "Cannot reset until EndOfMethod has been reached.");
   step_state_ = StepState{0, 0};
+  if (input_aliasing_ != nullptr) {
+    for (size_t i = 0; i < inputs_size(); ++i) {
+      restore_aliased_input(i);
+    }
+  }
   return Error::Ok;
 }
 
@@ -1682,6 +2495,7 @@ EValue& Method::mutable_input(size_t i) {
   // Accessing inputs this way is deprecated.
   // We assume the users to be responsible to set the inputs they get.
   input_set_[i] = true;
+  invalidate_boxed_lists();
   return mutable_value(get_input_index(i));
 }
 
@@ -1715,6 +2529,73 @@ Result<executorch::aten::Tensor> Method::get_attribute(std::string_view name) {
   return Error::NotFound;
 }
 
+namespace {
+/// Returns the name of a serialized value if it is a named tensor whose data
+/// lives in planned memory, nullptr otherwise.
+const char* get_mutable_buffer_fqn(
+    const executorch_flatbuffer::EValue* serialization_value) {
+  if (serialization_value->val_type() !=
+      executorch_flatbuffer::KernelTypes::Tensor) {
+    return nullptr;
+  }
+  const auto s_tensor = static_cast<const executorch_flatbuffer::Tensor*>(
+      serialization_value->val());
+  if (s_tensor->allocation_info() == nullptr ||
+      s_tensor->extra_tensor_info() == nullptr ||
+      s_tensor->extra_tensor_info()->fully_qualified_name() == nullptr) {
+    return nullptr;
+  }
+  return s_tensor->extra_tensor_info()->fully_qualified_name()->c_str();
+}
+} // namespace
+
+size_t Method::mutable_buffers_size() const {
+  auto flatbuffer_values = serialization_plan_->values();
+  size_t count = 0;
+  for (size_t i = 0; i < flatbuffer_values->size(); ++i) {
+    if (get_mutable_buffer_fqn(flatbuffer_values->Get(i)) != nullptr) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+Result<const char*> Method::get_mutable_buffer_name(size_t i) const {
+  auto flatbuffer_values = serialization_plan_->values();
+  size_t count = 0;
+  for (size_t j = 0; j < flatbuffer_values->size(); ++j) {
+    const char* name = get_mutable_buffer_fqn(flatbuffer_values->Get(j));
+    if (name != nullptr && count++ == i) {
+      return name;
+    }
+  }
+  ET_LOG(
+      Error,
+      "Mutable buffer index %" ET_PRIsize_t " >= %" ET_PRIsize_t,
+      i,
+      count);
+  return Error::InvalidArgument;
+}
+
+Error Method::get_mutable_buffer_names(const char** names, size_t length)
+    const {
+  auto flatbuffer_values = serialization_plan_->values();
+  size_t count = 0;
+  for (size_t i = 0; i < flatbuffer_values->size(); ++i) {
+    const char* name = get_mutable_buffer_fqn(flatbuffer_values->Get(i));
+    if (name == nullptr) {
+      continue;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        count < length,
+        InvalidArgument,
+        "The given array is not large enough to hold all mutable buffer "
+        "names.");
+    names[count++] = name;
+  }
+  return Error::Ok;
+}
+
 size_t Method::outputs_size() const {
   const auto* outputs = serialization_plan_->outputs();
   return outputs == nullptr ? 0 : outputs->size();
@@ -1734,6 +2615,7 @@ const EValue& Method::get_output(size_t i) const {
 }
 
 EValue& Method::mutable_output(size_t i) {
+  invalidate_boxed_lists();
   return mutable_value(get_output_index(i));
 }
 
@@ -74,10 +74,14 @@ class Method final {
         n_value_(rhs.n_value_),
         values_(rhs.values_),
         input_set_(rhs.input_set_),
+        input_aliasing_(rhs.input_aliasing_),
+        values_epoch_(rhs.values_epoch_),
         n_delegate_(rhs.n_delegate_),
         delegates_(rhs.delegates_),
         n_chains_(rhs.n_chains_),
         chains_(rhs.chains_),
+        constant_folding_stats_(rhs.constant_folding_stats_),
+        elementwise_fusion_stats_(rhs.elementwise_fusion_stats_),
         merged_data_map_(std::move(rhs.merged_data_map_)),
         external_constants_(rhs.external_constants_),
         n_external_constants_(rhs.n_external_constants_),
@@ -87,6 +91,8 @@ class Method final {
     rhs.n_value_ = 0;
     rhs.values_ = nullptr;
     rhs.input_set_ = nullptr;
+    rhs.input_aliasing_ = nullptr;
+    rhs.values_epoch_ = nullptr;
     rhs.n_delegate_ = 0;
     rhs.delegates_ = nullptr;
 
@@ -141,6 +147,46 @@ class Method final {
   ET_NODISCARD Error
   set_inputs(const executorch::aten::ArrayRef<EValue>& input_evalues);
 
+  /**
+   * Returns the memory-planned buffer of a tensor input, resized to `sizes`,
+   * and marks the input as set. Callers can decode or preprocess straight into
+   * the returned tensor's data instead of copying it in with set_input().
+   *
+   * The returned tensor aliases the method's planned memory. Its data is only
+   * valid until the next call that sets this input, and is overwritten while
+   * the method executes if the memory plan reuses the buffer.
+   *
+   * @param[in] input_idx Zero-based index of the input. Must be a tensor whose
+   *     data is memory-planned.
+   * @param[in] sizes The sizes of the input for this execution. Must be within
+   *     the bounds the method was exported with.
+   *
+   * @returns The input tensor on success, or an error.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Result<executorch::aten::Tensor>
+  planned_input_buffer(
+      size_t input_idx,
+      executorch::aten::ArrayRef<executorch::aten::SizesType> sizes);
+
+  /**
+   * Like set_input(), but if the input is a memory-planned tensor that the
+   * method only reads, points the input at the data of `input_evalue` instead
+   * of copying it into planned memory. The tensor data must then outlive the
+   * execution; the alias is dropped, and the input has to be set again, when
+   * the execution finishes with reset_execution() or execute().
+   *
+   * An input is only read if it is not a method output, and is never the
+   * trailing (out) argument of a kernel or delegate call or the destination
+   * of a move. Other inputs are copied as set_input() does.
+   *
+   * @param[in] input_evalue The value to set the input to.
+   * @param[in] input_idx Zero-based index of the input to set.
+   *
+   * @returns Error::Ok on success, non-Ok on failure.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error
+  alias_input(const EValue& input_evalue, size_t input_idx);
+
   /**
    * Sets the data buffer of the specified method output to the provided value.
    *
@@ -214,6 +260,41 @@ class Method final {
   ET_NODISCARD Result<executorch::aten::Tensor> get_attribute(
       std::string_view name);
 
+  /**
+   * EXPERIMENTAL: Returns the number of named tensors that receive their data
+   * from planned memory, i.e. mutable buffers such as KV caches. Their
+   * contents can be read and written through `get_attribute()`.
+   */
+  ET_EXPERIMENTAL size_t mutable_buffers_size() const;
+
+  /**
+   * EXPERIMENTAL: Retrieves the fully qualified name of a mutable buffer.
+   *
+   * @param[in] i The index of the mutable buffer, in the range
+   *     [0, mutable_buffers_size()).
+   *
+   * @returns The name on success, Error::InvalidArgument if the index is out
+   * of range.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Result<const char*> get_mutable_buffer_name(
+      size_t i) const;
+
+  /**
+   * EXPERIMENTAL: Retrieves the fully qualified names of all mutable buffers
+   * in one pass. Prefer this to calling `get_mutable_buffer_name()` for each
+   * index, which looks the buffer up from the start every time.
+   *
+   * @param[in] names The array to copy the names into. The first
+   *     `mutable_buffers_size()` elements will be set to the names of the
+   *     mutable buffers in index order.
+   * @param[in] length The size of the `names` array in elements. Must be
+   *     greater than or equal to `mutable_buffers_size()`.
+   *
+   * @returns Error::Ok on success, non-Ok on failure.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error
+  get_mutable_buffer_names(const char** names, size_t length) const;
+
   /**
    * Execute the method.
    *
@@ -255,6 +336,42 @@ class Method final {
    */
   MethodMeta method_meta() const;
 
+  /// Describes the kernel calls that init() folded.
+  struct ConstantFoldingStats {
+    /// The number of kernel calls whose inputs were all program constants,
+    /// and that init() ran once instead of on every execution.
+    size_t folded_instructions;
+    /// The time spent running them at init, which is roughly the time every
+    /// execution saves.
+    uint64_t folding_time_ns;
+  };
+
+  /**
+   * Returns how many kernel calls init() folded, and how long they took.
+   * Folding only happens when the method is loaded with
+   * Program::ConstantFolding::Enabled.
+   */
+  ET_EXPERIMENTAL ConstantFoldingStats constant_folding_stats() const {
+    return constant_folding_stats_;
+  }
+
+  /// Describes the chains of elementwise kernel calls that init() fused.
+  struct ElementwiseFusionStats {
+    /// The number of fused chains, each of which runs as one kernel call.
+    size_t fused_chains;
+    /// The number of kernel calls that the fused chains replaced.
+    size_t fused_instructions;
+  };
+
+  /**
+   * Returns how many elementwise kernel calls init() fused. Fusion only
+   * happens when the fused elementwise kernel is registered; see
+   * executorch/runtime/kernel/fused_elementwise.h.
+   */
+  ET_EXPERIMENTAL ElementwiseFusionStats elementwise_fusion_stats() const {
+    return elementwise_fusion_stats_;
+  }
+
   /**
    * Returns the number of inputs the Method expects.
    */
@@ -321,10 +438,14 @@ class Method final {
         n_value_(0),
         values_(nullptr),
         input_set_(nullptr),
+        input_aliasing_(nullptr),
+        values_epoch_(nullptr),
         n_delegate_(0),
         delegates_(nullptr),
         n_chains_(0),
         chains_(nullptr),
+        constant_folding_stats_(),
+        elementwise_fusion_stats_(),
         merged_data_map_(nullptr),
         external_constants_(nullptr),
         n_external_constants_(0),
@@ -336,7 +457,8 @@ class Method final {
       const Program* program,
       MemoryManager* memory_manager,
       EventTracer* event_tracer,
-      const NamedDataMap* named_data_map);
+      const NamedDataMap* named_data_map,
+      bool fold_constants);
 
   /**
    * Initialize the method from its serialized representation.
@@ -345,7 +467,8 @@ class Method final {
    */
   ET_NODISCARD Error init(
       executorch_flatbuffer::ExecutionPlan* s_plan,
-      const NamedDataMap* named_data_map);
+      const NamedDataMap* named_data_map,
+      bool fold_constants);
 
   /// Returns true if the Method was successfully initialized.
   inline bool initialized() const {
@@ -357,9 +480,33 @@ class Method final {
   size_t get_input_index(size_t i) const;
   size_t get_output_index(size_t i) const;
 
+  // Tells the tensor lists in values_ that a value may have been re-bound, so
+  // they have to be unboxed again.
+  void invalidate_boxed_lists() {
+    if (values_epoch_ != nullptr) {
+      ++*values_epoch_;
+    }
+  }
+
   // Executes a single instruction using the state in step_state_
   ET_NODISCARD Error execute_instruction();
 
+  // Runs the allowlisted kernel calls whose inputs are all program constants
+  // once, into buffers from the method allocator, and stops execute() from
+  // running them again.
+  void fold_constant_instructions();
+
+  // Replaces chains of consecutive elementwise kernel calls, where each call
+  // is the only reader of the previous one's output, with a single call to
+  // the fused elementwise kernel, if it is registered.
+  void fuse_elementwise_instructions();
+
+  // Returns true if the method never writes to input `input_idx`.
+  bool input_is_read_only(size_t input_idx) const;
+
+  // Points an input that alias_input() aliased back at its planned memory.
+  void restore_aliased_input(size_t input_idx);
+
   StepState step_state_;
   const Program* program_;
   MemoryManager* memory_manager_;
@@ -370,12 +517,25 @@ class Method final {
   size_t n_value_;
   EValue* values_;
   bool* input_set_;
+  // Aliasing state of each input, allocated by the first alias_input() call.
+  struct InputAliasing {
+    // The planned data of the input while it is aliased, or null.
+    void* planned_data;
+    // Whether the method never writes to the input.
+    bool read_only;
+  };
+  InputAliasing* input_aliasing_;
+  // Changes whenever a Tensor value may be re-bound. Lives in the method
+  // allocator so that the lists that watch it don't dangle when moved.
+  uint32_t* values_epoch_;
 
   size_t n_delegate_;
   BackendDelegate* delegates_;
 
   size_t n_chains_;
   Chain* chains_;
+  ConstantFoldingStats constant_folding_stats_;
+  ElementwiseFusionStats elementwise_fusion_stats_;
 
   internal::MergedDataMap* merged_data_map_;
   NamedData* external_constants_;
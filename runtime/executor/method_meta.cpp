@@ -13,6 +13,7 @@
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/core/span.h>
 #include <executorch/runtime/core/tag.h>
+#include <executorch/runtime/executor/instruction_uses.h>
 #include <executorch/runtime/executor/method_meta.h>
 #include <executorch/schema/program_generated.h>
 
@@ -84,6 +85,135 @@ Result<size_t> calculate_nbytes(
   return total_bytes;
 }
 
+using internal::instruction_use;
+using internal::Instructions;
+using internal::refers_to;
+using internal::tensor_list_items;
+using internal::ValueUse;
+
+// Whether a value is a tensor in the planned buffer `memory_id` that is not
+// set through the inputs of the method.
+bool is_planned_in(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    int32_t value_index,
+    uint32_t memory_id) {
+  const auto values = plan->values();
+  if (value_index < 0 || static_cast<size_t>(value_index) >= values->size()) {
+    return false;
+  }
+  const auto value = values->Get(value_index);
+  if (value->val_type() != executorch_flatbuffer::KernelTypes::Tensor) {
+    return false;
+  }
+  const auto allocation_info = value->val_as_Tensor()->allocation_info();
+  if (allocation_info == nullptr || allocation_info->memory_id() != memory_id) {
+    return false;
+  }
+  const auto inputs = plan->inputs();
+  if (inputs != nullptr) {
+    for (const auto input : *inputs) {
+      if (input == value_index) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Whether the instruction at `index` may read what an earlier execution left
+// in the value, if it is in the planned buffer `memory_id`. That is the case
+// when no earlier instruction writes it. Values passed to a delegate first
+// are taken to be its outputs, unless they are later written in place, like
+// the mutable buffers exir writes back with copy_.
+bool reads_state(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const Instructions* instructions,
+    size_t index,
+    int32_t value_index,
+    uint32_t memory_id,
+    bool in_place) {
+  if (!is_planned_in(plan, value_index, memory_id)) {
+    return false;
+  }
+  for (size_t i = index; i-- > 0;) {
+    switch (instruction_use(plan, instructions->Get(i), value_index)) {
+      case ValueUse::Write:
+        return false;
+      case ValueUse::Read:
+      case ValueUse::Update:
+      case ValueUse::Delegate:
+        // An earlier read was already checked. In-place writes look further
+        // back, for a delegate that only read the value.
+        if (!in_place) {
+          return false;
+        }
+        break;
+      case ValueUse::None:
+        break;
+    }
+  }
+  return true;
+}
+
+// Whether the instruction at `index` reads state from the planned buffer
+// `memory_id`.
+bool instruction_reads_state(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const Instructions* instructions,
+    size_t index,
+    uint32_t memory_id) {
+  const auto instruction = instructions->Get(index);
+  switch (instruction->instr_args_type()) {
+    case executorch_flatbuffer::InstructionArguments::KernelCall: {
+      const auto args = instruction->instr_args_as_KernelCall()->args();
+      if (args == nullptr || args->size() < 2) {
+        return false;
+      }
+      const auto last = args->Get(args->size() - 1);
+      for (size_t i = 0; i + 1 < args->size(); ++i) {
+        const auto arg = args->Get(i);
+        const bool in_place = i == 0 && arg == last;
+        if (!in_place && refers_to(plan, last, arg)) {
+          // An out argument.
+          continue;
+        }
+        if (reads_state(plan, instructions, index, arg, memory_id, in_place)) {
+          return true;
+        }
+        const auto items = tensor_list_items(plan, arg);
+        if (items == nullptr || arg == last) {
+          continue;
+        }
+        for (const auto item : *items) {
+          if (!refers_to(plan, last, item) &&
+              reads_state(plan, instructions, index, item, memory_id, false)) {
+            return true;
+          }
+        }
+      }
+      return false;
+    }
+    case executorch_flatbuffer::InstructionArguments::MoveCall:
+      return reads_state(
+          plan,
+          instructions,
+          index,
+          instruction->instr_args_as_MoveCall()->move_from(),
+          memory_id,
+          false);
+    default:
+      return false;
+  }
+}
+
+// Whether a planned tensor is a mutable buffer emitted with a name or initial
+// contents.
+bool is_named_or_initialized(const executorch_flatbuffer::Tensor* tensor) {
+  return tensor->data_buffer_idx() > 0 ||
+      (tensor->extra_tensor_info() != nullptr &&
+       tensor->extra_tensor_info()->fully_qualified_name() != nullptr);
+}
+
 } // namespace
 
 /*static*/ Result<TensorInfo> TensorInfo::create(
@@ -325,6 +455,106 @@ Result<int64_t> MethodMeta::memory_planned_buffer_size(size_t index) const {
   return s_plan_->non_const_buffer_sizes()->Get(index + 1);
 }
 
+Result<bool> MethodMeta::memory_planned_buffer_holds_state(
+    size_t index) const {
+  auto num_buffers = this->num_memory_planned_buffers();
+  ET_CHECK_OR_RETURN_ERROR(
+      index < num_buffers,
+      InvalidArgument,
+      "index %zu out of range. num_buffers: %zu",
+      index,
+      num_buffers);
+  // Memory ids count the hidden buffer at index zero.
+  const uint32_t memory_id = static_cast<uint32_t>(index + 1);
+  // Mutable buffers emitted with a name or initial contents.
+  auto values = s_plan_->values();
+  for (size_t i = 0; i < values->size(); ++i) {
+    auto value = values->Get(i);
+    if (value->val_type() != executorch_flatbuffer::KernelTypes::Tensor) {
+      continue;
+    }
+    auto tensor_value = value->val_as_Tensor();
+    if (tensor_value->allocation_info() == nullptr ||
+        tensor_value->allocation_info()->memory_id() != memory_id) {
+      continue;
+    }
+    if (is_named_or_initialized(tensor_value)) {
+      return true;
+    }
+  }
+  // Unnamed mutable buffers, found by how the method uses them.
+  const auto chains = s_plan_->chains();
+  if (chains == nullptr) {
+    return false;
+  }
+  for (const auto chain : *chains) {
+    const auto instructions = chain->instructions();
+    if (instructions == nullptr) {
+      continue;
+    }
+    for (size_t i = 0; i < instructions->size(); ++i) {
+      if (instruction_reads_state(s_plan_, instructions, i, memory_id)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+Result<bool> MethodMeta::memory_planned_buffer_holds_only_state(
+    size_t index) const {
+  auto num_buffers = this->num_memory_planned_buffers();
+  ET_CHECK_OR_RETURN_ERROR(
+      index < num_buffers,
+      InvalidArgument,
+      "index %zu out of range. num_buffers: %zu",
+      index,
+      num_buffers);
+  // Memory ids count the hidden buffer at index zero.
+  const uint32_t memory_id = static_cast<uint32_t>(index + 1);
+  const auto values = s_plan_->values();
+  const auto inputs = s_plan_->inputs();
+  const auto chains = s_plan_->chains();
+  for (size_t i = 0; i < values->size(); ++i) {
+    auto value = values->Get(i);
+    if (value->val_type() != executorch_flatbuffer::KernelTypes::Tensor) {
+      continue;
+    }
+    auto tensor_value = value->val_as_Tensor();
+    if (tensor_value->allocation_info() == nullptr ||
+        tensor_value->allocation_info()->memory_id() != memory_id ||
+        is_named_or_initialized(tensor_value)) {
+      continue;
+    }
+    const int32_t value_index = static_cast<int32_t>(i);
+    if (inputs != nullptr) {
+      for (const auto input : *inputs) {
+        if (input == value_index) {
+          return false;
+        }
+      }
+    }
+    // exir only writes mutable buffers in place. Anything that a kernel
+    // writes out of place, or that is handed to a delegate, is scratch.
+    if (chains == nullptr) {
+      continue;
+    }
+    for (const auto chain : *chains) {
+      const auto instructions = chain->instructions();
+      if (instructions == nullptr) {
+        continue;
+      }
+      for (const auto instruction : *instructions) {
+        const ValueUse use = instruction_use(s_plan_, instruction, value_index);
+        if (use == ValueUse::Write || use == ValueUse::Delegate) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
 bool MethodMeta::uses_backend(const char* backend_name) const {
   ET_CHECK_MSG(backend_name, "backend name is null");
   const auto delegates = s_plan_->delegates();
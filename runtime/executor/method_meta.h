@@ -234,6 +234,34 @@ class MethodMeta final {
    */
   Result<int64_t> memory_planned_buffer_size(size_t index) const;
 
+  /**
+   * Check whether a memory-planned buffer holds state, such as mutable
+   * buffers, whose contents must persist between executions. That is the
+   * case when it holds named or initialized tensors, or tensors that the
+   * method reads before writing them or writes in place, whether or not the
+   * program was exported with the names of its mutable buffers.
+   *
+   * @param[in] index The index of the buffer to look up.
+   * @returns Whether the buffer holds state on success, or an error on
+   * failure.
+   */
+  ET_EXPERIMENTAL Result<bool> memory_planned_buffer_holds_state(
+      size_t index) const;
+
+  /**
+   * Check whether a memory-planned buffer holds nothing but state, such as
+   * the buffer that programs exported with share_mutable_buffers keep the
+   * mutable buffers of all their methods in. Buffers that hold inputs or
+   * activations, as in programs exported without it, do not. A buffer that
+   * the method does not use, or only reads, counts as holding only state.
+   *
+   * @param[in] index The index of the buffer to look up.
+   * @returns Whether the buffer only holds state on success, or an error on
+   * failure.
+   */
+  ET_EXPERIMENTAL Result<bool> memory_planned_buffer_holds_only_state(
+      size_t index) const;
+
   /**
    * Check to see if a backend is used in this method.
    *
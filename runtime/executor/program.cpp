@@ -14,6 +14,7 @@
 #include <executorch/runtime/core/event_tracer_hooks.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/segment_compression.h>
 #include <executorch/runtime/platform/profiler.h>
 #include <executorch/schema/extended_header.h>
 #include <executorch/schema/program_generated.h>
@@ -227,12 +228,18 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
 
     const executorch_flatbuffer::DataSegment* data_segment =
         segments->Get(constant_segment->segment_index());
-    Result<FreeableBuffer> constant_segment_data = loader->load(
-        segment_base_offset + data_segment->offset(),
-        data_segment->size(),
-        DataLoader::SegmentInfo(
-            DataLoader::SegmentInfo::Type::Constant,
-            constant_segment->segment_index()));
+    Result<FreeableBuffer> constant_segment_data =
+        runtime::internal::load_segment(
+            loader,
+            segment_base_offset + data_segment->offset(),
+            data_segment->size(),
+            static_cast<runtime::internal::SegmentCompression>(
+                data_segment->compression()),
+            data_segment->uncompressed_size(),
+            data_segment->compression_block_size(),
+            DataLoader::SegmentInfo(
+                DataLoader::SegmentInfo::Type::Constant,
+                constant_segment->segment_index()));
     if (!constant_segment_data.ok()) {
       return constant_segment_data.error();
     }
@@ -298,7 +305,8 @@ Result<Method> Program::load_method(
     const char* method_name,
     MemoryManager* memory_manager,
     EventTracer* event_tracer,
-    const NamedDataMap* named_data_map) const {
+    const NamedDataMap* named_data_map,
+    ConstantFolding constant_folding) const {
   EXECUTORCH_SCOPE_PROF("Program::load_method");
   internal::event_tracer_create_event_block(event_tracer, "Default");
   internal::EventTracerProfileMethodScope event_tracer_scope =
@@ -316,7 +324,12 @@ Result<Method> Program::load_method(
     return plan.error();
   }
   return Method::load(
-      plan.get(), this, memory_manager, event_tracer, named_data_map);
+      plan.get(),
+      this,
+      memory_manager,
+      event_tracer,
+      named_data_map,
+      constant_folding == ConstantFolding::Enabled);
 }
 
 Result<MethodMeta> Program::method_meta(const char* method_name) const {
@@ -485,8 +498,15 @@ Result<FreeableBuffer> Program::LoadSegment(
   // Could fail if offset and size are out of bound for the data, or if this
   // is reading from a file and fails, or for many other reasons depending on
   // the implementation of the loader.
-  return loader_->load(
-      segment_base_offset_ + segment->offset(), segment->size(), segment_info);
+  return runtime::internal::load_segment(
+      loader_,
+      segment_base_offset_ + segment->offset(),
+      segment->size(),
+      static_cast<runtime::internal::SegmentCompression>(
+          segment->compression()),
+      segment->uncompressed_size(),
+      segment->compression_block_size(),
+      segment_info);
 }
 
 Error Program::load_mutable_subsegment_into(
@@ -553,6 +573,13 @@ Error Program::load_mutable_subsegment_into(
   auto segment =
       internal_program_->segments()->Get(segment_offsets->segment_index());
 
+  // Subsegments are read in place, which compressed segments don't allow.
+  if (segment->compression() !=
+      executorch_flatbuffer::SegmentCompression::NONE) {
+    ET_LOG(Error, "Mutable data segments must not be compressed");
+    return Error::NotSupported;
+  }
+
   // Check size
   if (offset + size > segment->size()) {
     ET_LOG(
@@ -69,6 +69,23 @@ class Program final {
     InternalConsistency,
   };
 
+  /**
+   * Whether Program::load_method() folds constant kernel calls.
+   */
+  enum class ConstantFolding : uint8_t {
+    /**
+     * Run every kernel call in every execution.
+     */
+    Disabled,
+    /**
+     * Run allowlisted kernel calls whose inputs are all program constants
+     * once, when the method is loaded, instead of in every execution. Their
+     * outputs take extra memory from the method allocator. See
+     * Method::constant_folding_stats().
+     */
+    Enabled,
+  };
+
   /**
    * Loads a Program from the provided loader. The Program will hold a pointer
    * to the loader, which must outlive the returned Program instance.
@@ -135,6 +152,8 @@ class Program final {
    * @param[in] event_tracer The event tracer to use for this method run.
    * @param[in] named_data_map An optional map of {name, blob} used to resolve
    *     data that is external to the PTE, if any.
+   * @param[in] constant_folding Whether to run kernel calls whose inputs are
+   *     all program constants once, while loading the method.
    *
    * @returns The loaded method on success, or an error on failure.
    */
@@ -142,7 +161,8 @@ class Program final {
       const char* method_name,
       MemoryManager* memory_manager,
       EventTracer* event_tracer = nullptr,
-      const NamedDataMap* named_data_map = nullptr) const;
+      const NamedDataMap* named_data_map = nullptr,
+      ConstantFolding constant_folding = ConstantFolding::Disabled) const;
 
   /**
    * Gathers metadata for the named method.
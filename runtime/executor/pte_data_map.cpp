@@ -7,12 +7,28 @@
  */
 
 #include <executorch/runtime/executor/pte_data_map.h>
+#include <executorch/runtime/executor/segment_compression.h>
 #include <executorch/schema/program_generated.h>
 
 namespace executorch {
 namespace ET_RUNTIME_NAMESPACE {
 namespace internal {
 
+namespace {
+
+// Compares flatbuffer string `a` with `b`, like std::string_view::compare().
+template <typename String>
+int compare_key(const String* a, executorch::aten::string_view b) {
+  const size_t size = a->size() < b.size() ? a->size() : b.size();
+  const int result = memcmp(a->data(), b.data(), size);
+  if (result != 0) {
+    return result;
+  }
+  return a->size() < b.size() ? -1 : (a->size() > b.size() ? 1 : 0);
+}
+
+} // namespace
+
 /* static */ Result<PteDataMap> PteDataMap::create(
     DataLoader* loader,
     size_t segment_base_offset,
@@ -22,12 +38,42 @@ namespace internal {
       loader != nullptr && named_data != nullptr && segments != nullptr,
       InvalidArgument,
       "PteDataMap loader, named_data or segments is null; most likely the program does not have any named_data segments");
-  return PteDataMap(loader, segment_base_offset, named_data, segments);
+  bool keys_sorted = true;
+  for (uint32_t i = 0; i < named_data->size() && keys_sorted; i++) {
+    const auto* item = named_data->Get(i);
+    if (item == nullptr || item->key() == nullptr) {
+      // Let the linear search report the malformed entry.
+      keys_sorted = false;
+    } else if (i > 0) {
+      const auto* prev_key = named_data->Get(i - 1)->key();
+      keys_sorted = compare_key(
+                        prev_key,
+                        executorch::aten::string_view(
+                            item->key()->data(), item->key()->size())) < 0;
+    }
+  }
+  return PteDataMap(
+      loader, segment_base_offset, named_data, segments, keys_sorted);
 }
 
-ET_NODISCARD
-Result<FreeableBuffer> PteDataMap::get_data(
-    executorch::aten::string_view key) const {
+Result<uint32_t> PteDataMap::find(executorch::aten::string_view key) const {
+  if (keys_sorted_) {
+    uint32_t low = 0;
+    uint32_t high = named_data_->size();
+    while (low < high) {
+      const uint32_t mid = low + (high - low) / 2;
+      const int order = compare_key(named_data_->Get(mid)->key(), key);
+      if (order == 0) {
+        return mid;
+      }
+      if (order < 0) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return Error::NotFound;
+  }
   for (uint32_t i = 0; i < named_data_->size(); i++) {
     const auto* named_data_item = named_data_->Get(i);
     ET_CHECK_OR_RETURN_ERROR(
@@ -40,29 +86,43 @@ Result<FreeableBuffer> PteDataMap::get_data(
     const auto* named_data_key = named_data_item->key();
     if (named_data_key->size() == key.size() &&
         memcmp(named_data_key->data(), key.data(), key.size()) == 0) {
-      // Get the segment index.
-      size_t segment_index = named_data_item->segment_index();
-
-      // Get the segment offset and size.
-      ET_CHECK_OR_RETURN_ERROR(
-          segment_index < segments_->size(),
-          InvalidArgument,
-          "Segment index %zu for key %.*s is out of range for segments size %u",
-          segment_index,
-          static_cast<int>(key.size()),
-          key.data(),
-          segments_->size());
-      size_t segment_offset = segments_->Get(segment_index)->offset();
-      size_t segment_size = segments_->Get(segment_index)->size();
-      return loader_->load(
-          /*offset=*/segment_base_offset_ + segment_offset,
-          segment_size,
-          DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant));
+      return i;
     }
   }
   return Error::NotFound;
 }
 
+ET_NODISCARD
+Result<FreeableBuffer> PteDataMap::get_data(
+    executorch::aten::string_view key) const {
+  Result<uint32_t> index = find(key);
+  if (!index.ok()) {
+    return index.error();
+  }
+  // Get the segment index.
+  size_t segment_index = named_data_->Get(index.get())->segment_index();
+
+  // Get the segment offset and size.
+  ET_CHECK_OR_RETURN_ERROR(
+      segment_index < segments_->size(),
+      InvalidArgument,
+      "Segment index %zu for key %.*s is out of range for segments size %u",
+      segment_index,
+      static_cast<int>(key.size()),
+      key.data(),
+      segments_->size());
+  const auto* segment = segments_->Get(segment_index);
+  return runtime::internal::load_segment(
+      loader_,
+      /*offset=*/segment_base_offset_ + segment->offset(),
+      segment->size(),
+      static_cast<runtime::internal::SegmentCompression>(
+          segment->compression()),
+      segment->uncompressed_size(),
+      segment->compression_block_size(),
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant));
+}
+
 ET_NODISCARD Result<uint32_t> PteDataMap::get_num_keys() const {
   return named_data_->size();
 }
@@ -123,11 +123,16 @@ class PteDataMap final : public NamedDataMap {
       DataLoader* loader,
       size_t segment_base_offset,
       const flatbuffers::FlatbufferNamedData* named_data,
-      const flatbuffers::FlatbufferDataSegment* segments)
+      const flatbuffers::FlatbufferDataSegment* segments,
+      bool keys_sorted)
       : loader_(loader),
         segment_base_offset_(segment_base_offset),
         named_data_(named_data),
-        segments_(segments) {}
+        segments_(segments),
+        keys_sorted_(keys_sorted) {}
+
+  // Returns the index of the named data with the given key.
+  Result<uint32_t> find(executorch::aten::string_view key) const;
 
   // Not copyable or assignable.
   PteDataMap(const PteDataMap& rhs) = delete;
@@ -145,6 +150,10 @@ class PteDataMap final : public NamedDataMap {
 
   // Segments, to retrieve offset and size for the loader.
   const flatbuffers::FlatbufferDataSegment* segments_;
+
+  // Whether named_data_ is sorted by key, so that it can be binary searched.
+  // Programs serialized by exir are; older ones are searched linearly.
+  bool keys_sorted_;
 };
 
 } // namespace internal
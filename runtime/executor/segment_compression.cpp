@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/segment_compression.h>
+
+#include <cinttypes>
+#include <cstring>
+
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/platform.h>
+
+namespace executorch {
+namespace runtime {
+namespace internal {
+
+namespace {
+
+constexpr size_t kMinMatchLength = 4;
+
+/// Interprets the 8 bytes at `data` as a little-endian uint64_t.
+uint64_t GetUInt64LE(const uint8_t* data) {
+  return (uint64_t)data[0] | ((uint64_t)data[1] << 8) |
+      ((uint64_t)data[2] << 16) | ((uint64_t)data[3] << 24) |
+      ((uint64_t)data[4] << 32) | ((uint64_t)data[5] << 40) |
+      ((uint64_t)data[6] << 48) | ((uint64_t)data[7] << 56);
+}
+
+/**
+ * Adds the extra length bytes that follow a length nibble of 15 to `length`.
+ * Returns false if the input ends early or the length exceeds `limit`.
+ */
+bool read_extra_length(
+    const uint8_t*& in,
+    const uint8_t* in_end,
+    size_t limit,
+    size_t& length) {
+  uint8_t byte = 0;
+  do {
+    if (in == in_end || length > limit) {
+      return false;
+    }
+    byte = *in++;
+    length += byte;
+  } while (byte == 255);
+  return length <= limit;
+}
+
+/// Decodes one LZ4 block, which must fill `out` exactly.
+Error lz4_decompress_block(
+    const uint8_t* in,
+    size_t in_size,
+    uint8_t* out,
+    size_t out_size) {
+  const uint8_t* const in_end = in + in_size;
+  uint8_t* const out_begin = out;
+  uint8_t* const out_end = out + out_size;
+  while (in < in_end) {
+    const uint8_t token = *in++;
+
+    size_t literal_length = token >> 4;
+    if (literal_length == 15) {
+      ET_CHECK_OR_RETURN_ERROR(
+          read_extra_length(in, in_end, out_size, literal_length),
+          InvalidProgram,
+          "Malformed literal length in compressed block");
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        literal_length <= static_cast<size_t>(in_end - in) &&
+            literal_length <= static_cast<size_t>(out_end - out),
+        InvalidProgram,
+        "Literals overflow compressed block");
+    std::memcpy(out, in, literal_length);
+    in += literal_length;
+    out += literal_length;
+    if (in == in_end) {
+      // The last sequence has no match.
+      break;
+    }
+
+    ET_CHECK_OR_RETURN_ERROR(
+        in_end - in >= 2, InvalidProgram, "Truncated match offset");
+    const size_t offset = in[0] | (in[1] << 8);
+    in += 2;
+    ET_CHECK_OR_RETURN_ERROR(
+        offset > 0 && offset <= static_cast<size_t>(out - out_begin),
+        InvalidProgram,
+        "Match offset %zu out of range",
+        offset);
+
+    size_t match_length = token & 15;
+    if (match_length == 15) {
+      ET_CHECK_OR_RETURN_ERROR(
+          read_extra_length(in, in_end, out_size, match_length),
+          InvalidProgram,
+          "Malformed match length in compressed block");
+    }
+    match_length += kMinMatchLength;
+    ET_CHECK_OR_RETURN_ERROR(
+        match_length <= static_cast<size_t>(out_end - out),
+        InvalidProgram,
+        "Match overflows compressed block");
+    const uint8_t* match = out - offset;
+    if (offset >= match_length) {
+      std::memcpy(out, match, match_length);
+      out += match_length;
+    } else {
+      // Overlapping copy that repeats the last `offset` bytes.
+      for (size_t i = 0; i < match_length; ++i) {
+        *out++ = *match++;
+      }
+    }
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      out == out_end,
+      InvalidProgram,
+      "Compressed block decodes to %zu bytes, expected %zu",
+      static_cast<size_t>(out - out_begin),
+      out_size);
+  return Error::Ok;
+}
+
+void free_decompressed_segment(void* context, void*, size_t) {
+  pal_free(context);
+}
+
+} // namespace
+
+Error decompress_segment_blocks(
+    const CompressedSegment& segment,
+    void* out,
+    size_t begin_block,
+    size_t end_block) {
+  const size_t num_blocks = segment.num_blocks();
+  ET_CHECK_OR_RETURN_ERROR(
+      begin_block <= end_block && end_block <= num_blocks,
+      InvalidArgument,
+      "Block range [%zu, %zu) out of range for %zu blocks",
+      begin_block,
+      end_block,
+      num_blocks);
+  const size_t table_size = num_blocks * sizeof(uint64_t);
+  ET_CHECK_OR_RETURN_ERROR(
+      segment.size >= table_size,
+      InvalidProgram,
+      "Compressed segment of %zu bytes too small for %zu blocks",
+      segment.size,
+      num_blocks);
+  const auto* table = static_cast<const uint8_t*>(segment.data);
+  const uint8_t* blocks = table + table_size;
+  const uint64_t blocks_size = segment.size - table_size;
+
+  for (size_t i = begin_block; i < end_block; ++i) {
+    const uint64_t begin =
+        i == 0 ? 0 : GetUInt64LE(table + (i - 1) * sizeof(uint64_t));
+    const uint64_t end = GetUInt64LE(table + i * sizeof(uint64_t));
+    ET_CHECK_OR_RETURN_ERROR(
+        begin <= end && end <= blocks_size,
+        InvalidProgram,
+        "Compressed block %zu [%" PRIu64 ", %" PRIu64
+        ") out of range for %" PRIu64 " bytes",
+        i,
+        begin,
+        end,
+        blocks_size);
+    const size_t out_offset = i * segment.block_size;
+    const size_t out_size = i + 1 < num_blocks
+        ? segment.block_size
+        : segment.uncompressed_size - out_offset;
+    auto* block_out = static_cast<uint8_t*>(out) + out_offset;
+    if (end - begin == out_size) {
+      // Stored raw, as compression didn't make it smaller.
+      std::memcpy(block_out, blocks + begin, out_size);
+      continue;
+    }
+    Error err = lz4_decompress_block(
+        blocks + begin, static_cast<size_t>(end - begin), block_out, out_size);
+    if (err != Error::Ok) {
+      ET_LOG(Error, "Failed to decompress block %zu", i);
+      return err;
+    }
+  }
+  return Error::Ok;
+}
+
+Result<FreeableBuffer> load_segment(
+    DataLoader* loader,
+    size_t offset,
+    size_t size,
+    SegmentCompression compression,
+    size_t uncompressed_size,
+    size_t block_size,
+    const DataLoader::SegmentInfo& segment_info) {
+  if (compression == SegmentCompression::None) {
+    return loader->load(offset, size, segment_info);
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      compression == SegmentCompression::Lz4Blocks,
+      NotSupported,
+      "Unsupported segment compression %d",
+      static_cast<int>(compression));
+  ET_CHECK_OR_RETURN_ERROR(
+      block_size > 0 || uncompressed_size == 0,
+      InvalidProgram,
+      "Compressed segment has no block size");
+
+  Result<FreeableBuffer> compressed = loader->load(offset, size, segment_info);
+  if (!compressed.ok()) {
+    return compressed.error();
+  }
+
+  // The returned buffer owns this allocation, so it outlives any
+  // MemoryAllocator the runtime could borrow it from.
+  void* allocation =
+      pal_allocate(uncompressed_size + kDecompressedSegmentAlignment);
+  ET_CHECK_OR_RETURN_ERROR(
+      allocation != nullptr,
+      MemoryAllocationFailed,
+      "Failed to allocate %zu bytes for a decompressed segment",
+      uncompressed_size);
+  const uintptr_t address = reinterpret_cast<uintptr_t>(allocation);
+  auto* data = reinterpret_cast<void*>(
+      (address + kDecompressedSegmentAlignment - 1) &
+      ~(kDecompressedSegmentAlignment - 1));
+
+  const CompressedSegment segment{
+      compressed->data(), compressed->size(), uncompressed_size, block_size};
+  Error err =
+      decompress_segment_blocks(segment, data, 0, segment.num_blocks());
+  compressed->Free();
+  if (err != Error::Ok) {
+    pal_free(allocation);
+    return err;
+  }
+  return FreeableBuffer(
+      data, uncompressed_size, free_decompressed_segment, allocation);
+}
+
+} // namespace internal
+} // namespace runtime
+} // namespace executorch
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace runtime {
+namespace internal {
+
+/**
+ * How the data of a segment is stored. Values match the SegmentCompression
+ * enums of program.fbs and flat_tensor.fbs.
+ */
+enum class SegmentCompression : uint8_t {
+  /// The segment holds the data as is.
+  None = 0,
+  /**
+   * The data is split into blocks of `block_size` bytes (the last one may be
+   * shorter) that are compressed independently with the LZ4 block format, so
+   * they can be decompressed in parallel. The segment starts with one
+   * little-endian uint64 per block: the offset of the end of the block,
+   * relative to the end of this table. A block whose compressed size equals
+   * its uncompressed size is stored raw.
+   */
+  Lz4Blocks = 1,
+};
+
+/// Alignment of the buffers that hold decompressed segment data.
+constexpr size_t kDecompressedSegmentAlignment = 64;
+
+/**
+ * A compressed segment that has been read into memory.
+ */
+struct CompressedSegment {
+  /// The segment data, as stored in the file.
+  const void* data;
+  /// The size of `data` in bytes.
+  size_t size;
+  /// The size of the data after decompression.
+  size_t uncompressed_size;
+  /// The uncompressed size of every block but the last one.
+  size_t block_size;
+
+  /// @returns The number of independently compressed blocks.
+  size_t num_blocks() const {
+    return block_size == 0 ? 0
+                           : (uncompressed_size + block_size - 1) / block_size;
+  }
+};
+
+/**
+ * Decompresses the blocks [begin_block, end_block) of a Lz4Blocks segment.
+ * Distinct block ranges may be decompressed concurrently.
+ *
+ * @param[in] segment The compressed segment.
+ * @param[out] out Receives the decompressed data. Must hold
+ *     `segment.uncompressed_size` bytes; block `i` is written at
+ *     `i * segment.block_size`.
+ * @param[in] begin_block The first block to decompress.
+ * @param[in] end_block One past the last block to decompress.
+ *
+ * @returns Error::InvalidProgram if the segment data is malformed.
+ */
+ET_NODISCARD Error decompress_segment_blocks(
+    const CompressedSegment& segment,
+    void* out,
+    size_t begin_block,
+    size_t end_block);
+
+/**
+ * Loads a segment through `loader`, decompressing it if needed.
+ *
+ * Uncompressed segments are returned as the loader provides them. Compressed
+ * segments are decompressed on the calling thread into a buffer aligned to
+ * kDecompressedSegmentAlignment, which the returned FreeableBuffer owns.
+ *
+ * @param[in] loader The loader to read the segment from.
+ * @param[in] offset The offset of the segment in the loader's data.
+ * @param[in] size The size of the segment as stored.
+ * @param[in] compression How the segment is stored.
+ * @param[in] uncompressed_size The size of the data after decompression.
+ * @param[in] block_size The uncompressed size of each compressed block.
+ * @param[in] segment_info Passed to the loader.
+ */
+ET_NODISCARD Result<FreeableBuffer> load_segment(
+    DataLoader* loader,
+    size_t offset,
+    size_t size,
+    SegmentCompression compression,
+    size_t uncompressed_size,
+    size_t block_size,
+    const DataLoader::SegmentInfo& segment_info);
+
+} // namespace internal
+} // namespace runtime
+} // namespace executorch
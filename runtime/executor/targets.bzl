@@ -43,6 +43,27 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "segment_compression",
+        srcs = [
+            "segment_compression.cpp",
+        ],
+        exported_headers = [
+            "segment_compression.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+        visibility = [
+            "//executorch/extension/flat_tensor/...",
+            "//executorch/runtime/executor/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
 
     for aten_mode in get_aten_mode_options():
         aten_suffix = "_aten" if aten_mode else ""
@@ -65,6 +86,8 @@ def define_common_targets():
                 "//executorch/runtime/core/exec_aten/util:scalar_type_util" + aten_suffix,
             ],
             deps = [
+                ":segment_compression",
+                "//executorch/runtime/kernel:fused_elementwise",
                 "//executorch/schema:program",
             ],
             exported_preprocessor_flags = [] if runtime.is_oss else ["-DEXECUTORCH_INTERNAL_FLATBUFFERS=1"],
@@ -98,6 +121,7 @@ def define_common_targets():
                 "tensor_parser{}.cpp".format(aten_suffix if aten_mode else "_portable"),
             ],
             headers = [
+                "instruction_uses.h",
                 "platform_memory_allocator.h",
             ],
             exported_headers = [
@@ -129,6 +153,7 @@ def define_common_targets():
                 "//executorch/schema:extended_header",
             ],
             deps = [
+                ":segment_compression",
                 "//executorch/schema:program",
                 "//executorch/runtime/core/exec_aten/util:tensor_dimension_limit"
             ],
@@ -627,6 +627,37 @@ TEST_P(BackendIntegrationTest, GetMethodNameDuringExecuteSuccess) {
   ASSERT_EQ(err, Error::Ok);
 }
 
+TEST_P(BackendIntegrationTest, AliasInputCopiesDelegateArgs) {
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  float data[4] = {1.f, 2.f, 3.f, 4.f};
+  int32_t sizes[2] = {2, 2};
+  uint8_t dim_order[2] = {0, 1};
+  int32_t strides[2] = {2, 1};
+  executorch::aten::TensorImpl impl(
+      executorch::aten::ScalarType::Float,
+      2,
+      sizes,
+      data,
+      dim_order,
+      strides);
+
+  // A delegate may write any of its arguments, so the input is copied into
+  // its planned memory instead of being aliased.
+  ASSERT_EQ(
+      method->alias_input(EValue(executorch::aten::Tensor(&impl)), 0),
+      Error::Ok);
+  const auto input = method->get_input(0).toTensor();
+  EXPECT_NE(input.const_data_ptr(), data);
+  EXPECT_FLOAT_EQ(input.const_data_ptr<float>()[3], 4.f);
+}
+
 // TODO: Add more tests for the runtime-to-backend interface. E.g.:
 // - Errors during init() or execute() result in runtime init/execution failures
 // - Correct values are passed to init()/execute()
@@ -74,6 +74,9 @@ class MethodMetaTest : public ::testing::Test {
   void SetUp() override {
     load_program(std::getenv("ET_MODULE_ADD_PATH"), "add");
     load_program(std::getenv("ET_MODULE_STATEFUL_PATH"), "stateful");
+    load_program(std::getenv("ET_MODULE_METHOD_STATE_PATH"), "method_state");
+    load_program(
+        std::getenv("ET_MODULE_METHOD_STATE_NAMED_PATH"), "method_state_named");
   }
 
  private:
@@ -192,6 +195,31 @@ TEST_F(MethodMetaTest, MethodMetaAttribute) {
   ASSERT_EQ(bad_access.error(), Error::InvalidArgument);
 }
 
+TEST_F(MethodMetaTest, MemoryPlannedBufferHoldsState) {
+  Result<MethodMeta> add = programs_["add"]->method_meta("forward");
+  ASSERT_EQ(add.error(), Error::Ok);
+
+  // The planned buffer only holds inputs and activations.
+  EXPECT_EQ(add->memory_planned_buffer_holds_state(0).get(), false);
+  EXPECT_EQ(
+      add->memory_planned_buffer_holds_state(1).error(),
+      Error::InvalidArgument);
+
+  // Mutable buffers are found with and without their names.
+  for (const char* program : {"method_state", "method_state_named"}) {
+    Result<MethodMeta> forward = programs_[program]->method_meta("forward");
+    ASSERT_EQ(forward.error(), Error::Ok);
+    EXPECT_EQ(forward->memory_planned_buffer_holds_state(0).get(), true);
+    // The state shares its buffer with the inputs and activations.
+    EXPECT_EQ(forward->memory_planned_buffer_holds_only_state(0).get(), false);
+
+    Result<MethodMeta> scale = programs_[program]->method_meta("scale");
+    ASSERT_EQ(scale.error(), Error::Ok);
+    EXPECT_EQ(scale->memory_planned_buffer_holds_state(0).get(), false);
+    EXPECT_EQ(scale->memory_planned_buffer_holds_only_state(0).get(), false);
+  }
+}
+
 TEST_F(MethodMetaTest, TensorInfoSizeOverflow) {
   // Create sizes that will cause overflow when multiplied
   std::vector<int32_t> overflow_sizes = {
@@ -13,6 +13,7 @@
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
 #include <executorch/extension/runner_util/inputs.h>
+#include <executorch/kernels/portable/cpu/util/fused_elementwise.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/program.h>
@@ -80,6 +81,8 @@ class MethodTest : public ::testing::Test {
     load_program(
         std::getenv("ET_MODULE_DYNAMIC_CAT_UNALLOCATED_IO_PATH"), "cat");
     load_program(std::getenv("ET_MODULE_ADD_MUL_PATH"), "add_mul");
+    load_program(
+        std::getenv("ET_MODULE_CONSTANT_SUBGRAPH_PATH"), "constant_subgraph");
     load_program(std::getenv("ET_MODULE_STATEFUL_PATH"), "stateful");
     load_program(
         std::getenv("DEPRECATED_ET_MODULE_LINEAR_CONSTANT_BUFFER_PATH"),
@@ -219,6 +222,101 @@ TEST_F(MethodTest, SetPrimInputTest) {
   EXPECT_EQ(err, Error::Ok);
 }
 
+TEST_F(MethodTest, PlannedInputBufferTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // Write x and y straight into their planned buffers.
+  executorch::aten::SizesType sizes[2] = {2, 2};
+  for (size_t i = 0; i < 2; ++i) {
+    Result<executorch::aten::Tensor> input =
+        method->planned_input_buffer(i, {sizes, 2});
+    ASSERT_EQ(input.error(), Error::Ok);
+    EXPECT_EQ(input->numel(), 4);
+    EXPECT_EQ(
+        input->const_data_ptr(),
+        method->get_input(i).toTensor().const_data_ptr());
+    for (size_t j = 0; j < 4; ++j) {
+      input->mutable_data_ptr<float>()[j] = static_cast<float>(i + 1);
+    }
+  }
+  ASSERT_EQ(method->set_input(EValue(1.0), 2), Error::Ok);
+
+  // alpha is not a tensor.
+  EXPECT_EQ(
+      method->planned_input_buffer(2, {sizes, 2}).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      method->planned_input_buffer(3, {sizes, 2}).error(),
+      Error::InvalidArgument);
+
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto output = method->get_output(0).toTensor();
+  for (size_t j = 0; j < 4; ++j) {
+    EXPECT_FLOAT_EQ(output.const_data_ptr<float>()[j], 3.f);
+  }
+}
+
+TEST_F(MethodTest, AliasInputTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  const void* planned_x = method->get_input(0).toTensor().const_data_ptr();
+
+  float x_data[4] = {1.f, 2.f, 3.f, 4.f};
+  float y_data[4] = {10.f, 20.f, 30.f, 40.f};
+  int32_t sizes[2] = {2, 2};
+  uint8_t dim_order[2] = {0, 1};
+  int32_t strides[2] = {2, 1};
+  executorch::aten::TensorImpl x_impl(
+      executorch::aten::ScalarType::Float,
+      2,
+      sizes,
+      x_data,
+      dim_order,
+      strides);
+  executorch::aten::TensorImpl y_impl(
+      executorch::aten::ScalarType::Float,
+      2,
+      sizes,
+      y_data,
+      dim_order,
+      strides);
+
+  // x is only read by the add kernel, so it is aliased instead of copied.
+  ASSERT_EQ(
+      method->alias_input(EValue(executorch::aten::Tensor(&x_impl)), 0),
+      Error::Ok);
+  EXPECT_EQ(method->get_input(0).toTensor().const_data_ptr(), x_data);
+  ASSERT_EQ(
+      method->alias_input(EValue(executorch::aten::Tensor(&y_impl)), 1),
+      Error::Ok);
+  // Non-tensor inputs fall back to set_input().
+  ASSERT_EQ(method->alias_input(EValue(1.0), 2), Error::Ok);
+  EXPECT_EQ(method->alias_input(EValue(3.0), 2), Error::InvalidArgument);
+
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto output = method->get_output(0).toTensor();
+  for (size_t j = 0; j < 4; ++j) {
+    EXPECT_FLOAT_EQ(output.const_data_ptr<float>()[j], 11.f * (j + 1));
+  }
+
+  // Resetting drops the aliases and requires the inputs to be set again.
+  ASSERT_EQ(method->reset_execution(), Error::Ok);
+  EXPECT_EQ(method->get_input(0).toTensor().const_data_ptr(), planned_x);
+  EXPECT_EQ(method->execute(), Error::InvalidArgument);
+
+  // set_input() also drops the alias.
+  ASSERT_EQ(
+      method->alias_input(EValue(executorch::aten::Tensor(&x_impl)), 0),
+      Error::Ok);
+  ASSERT_EQ(
+      method->set_input(EValue(executorch::aten::Tensor(&x_impl)), 0),
+      Error::Ok);
+  EXPECT_EQ(method->get_input(0).toTensor().const_data_ptr(), planned_x);
+}
+
 TEST_F(MethodTest, MethodMetaTest) {
   ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
   Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
@@ -337,6 +435,109 @@ TEST_F(MethodTest, ConstantSegmentTest) {
   ASSERT_EQ(err, Error::Ok);
 }
 
+TEST_F(MethodTest, ConstantFoldingTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+
+  // Folding is opt-in.
+  Result<Method> unfolded =
+      programs_["constant_subgraph"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(unfolded.error(), Error::Ok);
+  EXPECT_EQ(unfolded->constant_folding_stats().folded_instructions, 0);
+
+  Result<Method> method = programs_["constant_subgraph"]->load_method(
+      "forward",
+      &mmm.get(),
+      /*event_tracer=*/nullptr,
+      /*named_data_map=*/nullptr,
+      Program::ConstantFolding::Enabled);
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // mul(a, b) only depends on constants, and add(x, ab) on the input.
+  EXPECT_EQ(method->constant_folding_stats().folded_instructions, 1);
+
+  float x_data[4] = {1.f, 2.f, 3.f, 4.f};
+  int32_t sizes[2] = {2, 2};
+  uint8_t dim_order[2] = {0, 1};
+  int32_t strides[2] = {2, 1};
+  executorch::aten::TensorImpl impl(
+      executorch::aten::ScalarType::Float,
+      2,
+      sizes,
+      x_data,
+      dim_order,
+      strides);
+
+  // The folded value survives the memory plan reusing its planned buffer.
+  for (int run = 0; run < 2; ++run) {
+    ASSERT_EQ(
+        method->set_input(EValue(executorch::aten::Tensor(&impl)), 0),
+        Error::Ok);
+    ASSERT_EQ(method->execute(), Error::Ok);
+    const auto output = method->get_output(0).toTensor();
+    for (size_t i = 0; i < 4; ++i) {
+      EXPECT_FLOAT_EQ(output.const_data_ptr<float>()[i], x_data[i] + 6.f);
+    }
+  }
+
+  // Nothing in add(x, y, alpha) is constant.
+  Result<Method> add = programs_["add"]->load_method(
+      "forward",
+      &mmm.get(),
+      /*event_tracer=*/nullptr,
+      /*named_data_map=*/nullptr,
+      Program::ConstantFolding::Enabled);
+  ASSERT_EQ(add.error(), Error::Ok);
+  EXPECT_EQ(add->constant_folding_stats().folded_instructions, 0);
+
+  // state.add_(1) reads a mutable buffer, so it runs in every execution.
+  Result<Method> stateful = programs_["stateful"]->load_method(
+      "forward",
+      &mmm.get(),
+      /*event_tracer=*/nullptr,
+      /*named_data_map=*/nullptr,
+      Program::ConstantFolding::Enabled);
+  ASSERT_EQ(stateful.error(), Error::Ok);
+  EXPECT_EQ(stateful->constant_folding_stats().folded_instructions, 0);
+}
+
+TEST_F(MethodTest, ElementwiseFusionTest) {
+  ASSERT_EQ(torch::executor::register_fused_elementwise_kernel(), Error::Ok);
+
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["add_mul"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // add(mul(a, x), b) runs as one fused call.
+  EXPECT_EQ(method->elementwise_fusion_stats().fused_chains, 1);
+  EXPECT_EQ(method->elementwise_fusion_stats().fused_instructions, 2);
+
+  float x_data[4] = {1.f, 2.f, 3.f, 4.f};
+  int32_t sizes[2] = {2, 2};
+  uint8_t dim_order[2] = {0, 1};
+  int32_t strides[2] = {2, 1};
+  executorch::aten::TensorImpl impl(
+      executorch::aten::ScalarType::Float,
+      2,
+      sizes,
+      x_data,
+      dim_order,
+      strides);
+  ASSERT_EQ(
+      method->set_input(EValue(executorch::aten::Tensor(&impl)), 0),
+      Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto output = method->get_output(0).toTensor();
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_FLOAT_EQ(output.const_data_ptr<float>()[i], 3.f * x_data[i] + 2.f);
+  }
+
+  // A single call has nothing to fuse with.
+  Result<Method> add = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(add.error(), Error::Ok);
+  EXPECT_EQ(add->elementwise_fusion_stats().fused_chains, 0);
+}
+
 TEST_F(MethodTest, ConstantBufferTest) {
   // Execute model with constants stored in the program flatbuffer.
   ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
@@ -275,3 +275,52 @@ TEST_F(PteDataMapTest, ReloadAndFree) {
   // Free data_reload0.
   data0_reload->Free();
 }
+
+TEST_F(PteDataMapTest, UnsortedKeys) {
+  // Older PTEs don't sort named data by key; lookups must still work.
+  flatbuffers::FlatBufferBuilder builder;
+  std::array<const flatbuffers::Offset<executorch_flatbuffer::NamedData>, 3>
+      named_data_arr = {
+          executorch_flatbuffer::CreateNamedDataDirect(
+              builder, "key2", /*segment_index=*/0),
+          executorch_flatbuffer::CreateNamedDataDirect(
+              builder, "key0", /*segment_index=*/0),
+          executorch_flatbuffer::CreateNamedDataDirect(
+              builder, "key1", /*segment_index=*/1),
+      };
+  const auto named_data =
+      builder.CreateVector(named_data_arr.data(), named_data_arr.size());
+  std::array<const flatbuffers::Offset<executorch_flatbuffer::DataSegment>, 2>
+      segment_arr = {// @lint-ignore CLANGTIDY facebook-hte-BadArgumentComment
+                     executorch_flatbuffer::CreateDataSegment(
+                         builder, /*offset=*/0, /*size=*/kSegmentSizes[0]),
+                     // @lint-ignore CLANGTIDY facebook-hte-BadArgumentComment
+                     executorch_flatbuffer::CreateDataSegment(
+                         builder,
+                         /*offset=*/kSegmentOffsets[1],
+                         /*size=*/kSegmentSizes[1])};
+  const auto segments =
+      builder.CreateVector(segment_arr.data(), segment_arr.size());
+  builder.Finish(executorch_flatbuffer::CreateProgram(
+      builder, 0, 0, 0, 0, segments, 0, 0, named_data));
+  const auto* program =
+      executorch_flatbuffer::GetProgram(builder.GetBufferPointer());
+
+  Result<PteDataMap> data_map = PteDataMap::create(
+      data_map_loader_.get(), 0, program->named_data(), program->segments());
+  ASSERT_TRUE(data_map.ok());
+
+  Result<FreeableBuffer> data1 = data_map->get_data("key1");
+  ASSERT_EQ(data1.error(), Error::Ok);
+  EXPECT_EQ(data1.get().size(), kSegmentSizes[1]);
+  data1->Free();
+
+  for (const char* key : {"key0", "key2"}) {
+    Result<FreeableBuffer> data = data_map->get_data(key);
+    ASSERT_EQ(data.error(), Error::Ok);
+    EXPECT_EQ(data.get().size(), kSegmentSizes[0]);
+    data->Free();
+  }
+
+  EXPECT_EQ(data_map->get_data("key3").error(), Error::NotFound);
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/segment_compression.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::BufferDataLoader;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+using executorch::runtime::internal::CompressedSegment;
+using executorch::runtime::internal::decompress_segment_blocks;
+using executorch::runtime::internal::kDecompressedSegmentAlignment;
+using executorch::runtime::internal::load_segment;
+using executorch::runtime::internal::SegmentCompression;
+
+namespace {
+
+// "abc", then a match of 12 bytes at offset 3 that overlaps its own output,
+// then the trailing literals "defgh".
+const std::vector<uint8_t> kLz4Block = {
+    0x38, 'a', 'b', 'c', 0x03, 0x00, 0x50, 'd', 'e', 'f', 'g', 'h'};
+const std::string kLz4BlockData = "abcabcabcabcabcdefgh";
+
+void append_uint64_le(std::vector<uint8_t>& out, uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+// Builds an Lz4Blocks segment from already compressed blocks.
+std::vector<uint8_t> make_segment(
+    const std::vector<std::vector<uint8_t>>& blocks) {
+  std::vector<uint8_t> segment;
+  uint64_t end = 0;
+  for (const auto& block : blocks) {
+    end += block.size();
+    append_uint64_le(segment, end);
+  }
+  for (const auto& block : blocks) {
+    segment.insert(segment.end(), block.begin(), block.end());
+  }
+  return segment;
+}
+
+std::string to_string(const std::vector<uint8_t>& data) {
+  return std::string(data.begin(), data.end());
+}
+
+} // namespace
+
+class SegmentCompressionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(SegmentCompressionTest, DecompressesLz4Block) {
+  const auto segment = make_segment({kLz4Block});
+  std::vector<uint8_t> out(kLz4BlockData.size());
+  const CompressedSegment compressed{
+      segment.data(), segment.size(), out.size(), out.size()};
+  EXPECT_EQ(compressed.num_blocks(), 1);
+  ASSERT_EQ(
+      decompress_segment_blocks(compressed, out.data(), 0, 1), Error::Ok);
+  EXPECT_EQ(to_string(out), kLz4BlockData);
+}
+
+TEST_F(SegmentCompressionTest, DecompressesLongLengths) {
+  // 300 literals and a 275 byte match, which both need extra length bytes.
+  std::vector<uint8_t> block = {0xff, 255, 30};
+  std::string expected;
+  for (int i = 0; i < 300; ++i) {
+    block.push_back('a' + i % 26);
+    expected.push_back('a' + i % 26);
+  }
+  block.insert(block.end(), {0x01, 0x00, 255, 1});
+  expected.append(275, expected.back());
+  block.insert(block.end(), {0x50, 'v', 'w', 'x', 'y', 'z'});
+  expected.append("vwxyz");
+
+  const auto segment = make_segment({block});
+  std::vector<uint8_t> out(expected.size());
+  const CompressedSegment compressed{
+      segment.data(), segment.size(), out.size(), out.size()};
+  ASSERT_EQ(
+      decompress_segment_blocks(compressed, out.data(), 0, 1), Error::Ok);
+  EXPECT_EQ(to_string(out), expected);
+}
+
+TEST_F(SegmentCompressionTest, DecompressesRawBlocksAndRanges) {
+  // The last block is stored raw, as its size matches its uncompressed size.
+  const std::vector<uint8_t> raw = {'1', '2', '3', '4', '5', '6', '7'};
+  const auto segment = make_segment({kLz4Block, kLz4Block, raw});
+  const size_t block_size = kLz4BlockData.size();
+  std::vector<uint8_t> out(2 * block_size + raw.size(), 0);
+  const CompressedSegment compressed{
+      segment.data(), segment.size(), out.size(), block_size};
+  EXPECT_EQ(compressed.num_blocks(), 3);
+
+  // Blocks can be decompressed independently.
+  ASSERT_EQ(
+      decompress_segment_blocks(compressed, out.data(), 2, 3), Error::Ok);
+  EXPECT_EQ(out[0], 0);
+  EXPECT_EQ(to_string(out).substr(2 * block_size), "1234567");
+  ASSERT_EQ(
+      decompress_segment_blocks(compressed, out.data(), 0, 2), Error::Ok);
+  EXPECT_EQ(
+      to_string(out), kLz4BlockData + kLz4BlockData + std::string("1234567"));
+
+  EXPECT_EQ(
+      decompress_segment_blocks(compressed, out.data(), 2, 4),
+      Error::InvalidArgument);
+}
+
+TEST_F(SegmentCompressionTest, RejectsMalformedBlocks) {
+  const size_t size = kLz4BlockData.size();
+  std::vector<uint8_t> out(size);
+  auto decompress = [&](const std::vector<uint8_t>& block) {
+    const auto segment = make_segment({block});
+    return decompress_segment_blocks(
+        CompressedSegment{segment.data(), segment.size(), size, size},
+        out.data(),
+        0,
+        1);
+  };
+
+  // Offset of zero.
+  auto block = kLz4Block;
+  block[4] = 0;
+  EXPECT_EQ(decompress(block), Error::InvalidProgram);
+
+  // Offset before the start of the output.
+  block = kLz4Block;
+  block[4] = 4;
+  EXPECT_EQ(decompress(block), Error::InvalidProgram);
+
+  // Truncated offset.
+  block.assign(kLz4Block.begin(), kLz4Block.begin() + 5);
+  EXPECT_EQ(decompress(block), Error::InvalidProgram);
+
+  // Literals past the end of the block.
+  block = kLz4Block;
+  block[6] = 0x90;
+  EXPECT_EQ(decompress(block), Error::InvalidProgram);
+
+  // Decodes to fewer bytes than expected.
+  block = kLz4Block;
+  block.pop_back();
+  block[6] = 0x40;
+  EXPECT_EQ(decompress(block), Error::InvalidProgram);
+
+  // Block table pointing past the end of the segment.
+  auto segment = make_segment({kLz4Block});
+  segment[0] = 0xff;
+  EXPECT_EQ(
+      decompress_segment_blocks(
+          CompressedSegment{segment.data(), segment.size(), size, size},
+          out.data(),
+          0,
+          1),
+      Error::InvalidProgram);
+
+  // Segment too small to hold the block table.
+  EXPECT_EQ(
+      decompress_segment_blocks(
+          CompressedSegment{segment.data(), 4, size, size}, out.data(), 0, 1),
+      Error::InvalidProgram);
+}
+
+TEST_F(SegmentCompressionTest, LoadSegment) {
+  const std::vector<uint8_t> raw = {'1', '2', '3'};
+  auto segment = make_segment({kLz4Block, raw});
+  const size_t compressed_offset = 8;
+  std::vector<uint8_t> file(compressed_offset, 0xaa);
+  file.insert(file.end(), segment.begin(), segment.end());
+  BufferDataLoader loader(file.data(), file.size());
+  const auto info =
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant);
+
+  // Uncompressed segments come straight from the loader.
+  Result<FreeableBuffer> plain = load_segment(
+      &loader, 0, compressed_offset, SegmentCompression::None, 0, 0, info);
+  ASSERT_EQ(plain.error(), Error::Ok);
+  EXPECT_EQ(plain->data(), file.data());
+  EXPECT_EQ(plain->size(), compressed_offset);
+
+  const size_t uncompressed_size = kLz4BlockData.size() + raw.size();
+  Result<FreeableBuffer> decompressed = load_segment(
+      &loader,
+      compressed_offset,
+      segment.size(),
+      SegmentCompression::Lz4Blocks,
+      uncompressed_size,
+      kLz4BlockData.size(),
+      info);
+  ASSERT_EQ(decompressed.error(), Error::Ok);
+  EXPECT_EQ(decompressed->size(), uncompressed_size);
+  EXPECT_EQ(
+      reinterpret_cast<uintptr_t>(decompressed->data()) %
+          kDecompressedSegmentAlignment,
+      0);
+  EXPECT_EQ(
+      std::string(
+          static_cast<const char*>(decompressed->data()), uncompressed_size),
+      kLz4BlockData + std::string("123"));
+  decompressed->Free();
+
+  // Unknown compression.
+  EXPECT_EQ(
+      load_segment(
+          &loader,
+          compressed_offset,
+          segment.size(),
+          static_cast<SegmentCompression>(7),
+          uncompressed_size,
+          kLz4BlockData.size(),
+          info)
+          .error(),
+      Error::NotSupported);
+
+  // Corrupt data.
+  file[compressed_offset + 2 * 8 + 4] = 0;
+  EXPECT_EQ(
+      load_segment(
+          &loader,
+          compressed_offset,
+          segment.size(),
+          SegmentCompression::Lz4Blocks,
+          uncompressed_size,
+          kLz4BlockData.size(),
+          info)
+          .error(),
+      Error::InvalidProgram);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file
+ * The contract between Method, which fuses chains of elementwise kernel calls
+ * at init, and the kernel that runs each fused chain.
+ *
+ * Method only fuses chains when a kernel named kFusedElementwiseKernelName is
+ * registered, so linking and registering that kernel (see
+ * kernels/portable/cpu/util/fused_elementwise.h) is how a program opts in.
+ *
+ * A fused chain is a list of steps. Each step applies one FusedElementwiseOp
+ * to up to two earlier values, which are either operands of the chain or
+ * results of earlier steps, and the result of the last step is written to the
+ * output tensor. The kernel receives its arguments as:
+ *
+ *   args[0]: Int, the number of operands N.
+ *   args[1..N]: the operands, each a Float tensor with as many elements as the
+ *       output, or an Int/Double scalar. Value index i < N refers to operand
+ *       i, and index N + s to the result of step s.
+ *   Then, kFusedElementwiseArgsPerStep arguments per step:
+ *       Int: the FusedElementwiseOp.
+ *       Int: the value index of the first input.
+ *       Int: the value index of the second input, or -1 for unary ops.
+ *       Int/Double: alpha, which scales the second input of Add and Sub.
+ *   args[args.size() - 1]: the Float output tensor.
+ */
+
+namespace executorch {
+namespace runtime {
+
+/// The name of the kernel that runs a fused chain of elementwise ops.
+constexpr const char* kFusedElementwiseKernelName =
+    "executorch::fused_elementwise";
+
+/// The elementwise ops that a fused chain can contain. The values are part of
+/// the contract above, so new ops must be added at the end.
+enum class FusedElementwiseOp : int64_t {
+  Add = 0, // a + alpha * b
+  Sub = 1, // a - alpha * b
+  Mul = 2, // a * b
+  Div = 3, // a / b
+  Neg = 4, // -a
+  Relu = 5, // max(a, 0)
+  Sigmoid = 6, // 1 / (1 + exp(-a))
+  Tanh = 7, // tanh(a)
+  Exp = 8, // exp(a)
+  NumOps = 9,
+};
+
+/// The number of kernel arguments that describe each step.
+constexpr size_t kFusedElementwiseArgsPerStep = 4;
+
+/// The longest chain the kernel accepts. Longer chains are split.
+constexpr size_t kMaxFusedElementwiseSteps = 8;
+
+/// The most operands the kernel accepts. Every step after the first adds at
+/// most one operand.
+constexpr size_t kMaxFusedElementwiseOperands = kMaxFusedElementwiseSteps + 1;
+
+} // namespace runtime
+} // namespace executorch
@@ -53,6 +53,16 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "fused_elementwise",
+        exported_headers = ["fused_elementwise.h"],
+        visibility = [
+            "//executorch/kernels/...",
+            "//executorch/runtime/executor/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
     for aten_mode in get_aten_mode_options():
         aten_suffix = "_aten" if aten_mode else ""
 
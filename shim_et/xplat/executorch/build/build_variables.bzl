@@ -33,6 +33,7 @@ EXECUTORCH_SRCS = [
 ]
 
 PROGRAM_NO_PRIM_OPS_SRCS = [
+    "instruction_uses.cpp",
     "method.cpp",
     "method_meta.cpp",
     "program.cpp",
@@ -57,6 +58,7 @@ EXECUTORCH_CORE_SRCS = sorted([
     "runtime/core/tensor_layout.cpp",
     "runtime/executor/tensor_parser_portable.cpp",
     "runtime/executor/pte_data_map.cpp",
+    "runtime/executor/segment_compression.cpp",
     "runtime/kernel/operator_registry.cpp",
     "schema/extended_header.cpp",
 ] + ["runtime/executor/" + x for x in PROGRAM_NO_PRIM_OPS_SRCS] + ["runtime/platform/" + x for x in PLATFORM_SRCS])
@@ -245,6 +247,7 @@ KERNELS_UTIL_ALL_DEPS_SRCS = [
     "kernels/portable/cpu/util/delinearize_index.cpp",
     "kernels/portable/cpu/util/distance_util.cpp",
     "kernels/portable/cpu/util/dtype_util.cpp",
+    "kernels/portable/cpu/util/fused_elementwise.cpp",
     "kernels/portable/cpu/util/index_util.cpp",
     "kernels/portable/cpu/util/kernel_ops_util.cpp",
     "kernels/portable/cpu/util/matmul_ops_util.cpp",
@@ -260,21 +263,45 @@ KERNELS_UTIL_ALL_DEPS_SRCS = [
 OPTIMIZED_KERNELS_SRCS = [
     "kernels/optimized/cpu/binary_ops.cpp",
     "kernels/optimized/cpu/op_add.cpp",
+    "kernels/optimized/cpu/op_avg_pool2d.cpp",
     "kernels/optimized/cpu/op_bmm.cpp",
+    "kernels/optimized/cpu/op_cat.cpp",
+    "kernels/optimized/cpu/op_convolution.cpp",
     "kernels/optimized/cpu/op_div.cpp",
     "kernels/optimized/cpu/op_elu.cpp",
     "kernels/optimized/cpu/op_exp.cpp",
     "kernels/optimized/cpu/op_fft_c2r.cpp",
     "kernels/optimized/cpu/op_fft_r2c.cpp",
+    "kernels/optimized/cpu/op_gather.cpp",
     "kernels/optimized/cpu/op_gelu.cpp",
+    "kernels/optimized/cpu/op_index_put.cpp",
+    "kernels/optimized/cpu/op_index_select.cpp",
     "kernels/optimized/cpu/op_le.cpp",
     "kernels/optimized/cpu/op_linear.cpp",
     "kernels/optimized/cpu/op_log_softmax.cpp",
+    "kernels/optimized/cpu/op_max_pool2d_with_indices.cpp",
     "kernels/optimized/cpu/op_mm.cpp",
     "kernels/optimized/cpu/op_mul.cpp",
+    "kernels/optimized/cpu/op_native_batch_norm.cpp",
+    "kernels/optimized/cpu/op_native_group_norm.cpp",
     "kernels/optimized/cpu/op_native_layer_norm.cpp",
+    "kernels/optimized/cpu/op_permute_copy.cpp",
+    "kernels/optimized/cpu/op_scatter.cpp",
+    "kernels/optimized/cpu/op_scatter_add.cpp",
+    "kernels/optimized/cpu/op_slice_copy.cpp",
+    "kernels/optimized/cpu/op_softmax.cpp",
+    "kernels/optimized/cpu/op_split_with_sizes_copy.cpp",
+    "kernels/optimized/cpu/op_stack.cpp",
     "kernels/optimized/cpu/op_sub.cpp",
+    "kernels/optimized/cpu/op_t_copy.cpp",
+    "kernels/optimized/cpu/op_transpose_copy.cpp",
+    "kernels/optimized/cpu/op_unbind_copy.cpp",
+    "kernels/optimized/cpu/op_upsample_bilinear2d.cpp",
+    "kernels/optimized/cpu/op_upsample_bilinear2d_aa.cpp",
+    "kernels/optimized/cpu/op_upsample_nearest2d.cpp",
     "kernels/optimized/cpu/op_where.cpp",
+    "kernels/optimized/cpu/permute_util.cpp",
+    "kernels/optimized/cpu/strided_copy_util.cpp",
 ]
 
 QUANTIZED_KERNELS_SRCS = [
@@ -303,20 +330,34 @@ OPTIMIZED_NATIVE_CPU_OPS_SRCS = [
     "kernels/optimized/cpu/binary_ops.cpp",
     "kernels/optimized/cpu/op_add.cpp",
     "kernels/optimized/cpu/op_bmm.cpp",
+    "kernels/optimized/cpu/op_cat.cpp",
     "kernels/optimized/cpu/op_div.cpp",
     "kernels/optimized/cpu/op_elu.cpp",
     "kernels/optimized/cpu/op_exp.cpp",
     "kernels/optimized/cpu/op_fft_c2r.cpp",
     "kernels/optimized/cpu/op_fft_r2c.cpp",
+    "kernels/optimized/cpu/op_gather.cpp",
     "kernels/optimized/cpu/op_gelu.cpp",
+    "kernels/optimized/cpu/op_index_put.cpp",
+    "kernels/optimized/cpu/op_index_select.cpp",
     "kernels/optimized/cpu/op_le.cpp",
     "kernels/optimized/cpu/op_linear.cpp",
     "kernels/optimized/cpu/op_log_softmax.cpp",
     "kernels/optimized/cpu/op_mm.cpp",
     "kernels/optimized/cpu/op_mul.cpp",
     "kernels/optimized/cpu/op_native_layer_norm.cpp",
+    "kernels/optimized/cpu/op_permute_copy.cpp",
+    "kernels/optimized/cpu/op_slice_copy.cpp",
+    "kernels/optimized/cpu/op_softmax.cpp",
+    "kernels/optimized/cpu/op_split_with_sizes_copy.cpp",
+    "kernels/optimized/cpu/op_stack.cpp",
     "kernels/optimized/cpu/op_sub.cpp",
+    "kernels/optimized/cpu/op_t_copy.cpp",
+    "kernels/optimized/cpu/op_transpose_copy.cpp",
+    "kernels/optimized/cpu/op_unbind_copy.cpp",
     "kernels/optimized/cpu/op_where.cpp",
+    "kernels/optimized/cpu/permute_util.cpp",
+    "kernels/optimized/cpu/strided_copy_util.cpp",
 ]
 
 TEST_BACKEND_COMPILER_LIB_SRCS = [
@@ -337,11 +378,16 @@ EXTENSION_FLAT_TENSOR_SRCS = [
     "extension/flat_tensor/serialize/flat_tensor_header.cpp",
 ]
 
+EXTENSION_FLAT_TENSOR_SERIALIZE_SRCS = [
+    "extension/flat_tensor/serialize/serialize.cpp",
+]
+
 EXTENSION_MODULE_SRCS = [
     "extension/module/module.cpp",
 ]
 
 EXTENSION_NAMED_DATA_MAP_SRCS = [
+    "extension/named_data_map/gguf_data_map.cpp",
     "extension/named_data_map/merged_data_map.cpp",
 ]
 
@@ -351,9 +397,13 @@ EXTENSION_RUNNER_UTIL_SRCS = [
 ]
 
 EXTENSION_LLM_RUNNER_SRCS = [
+    "extension/llm/runner/batched_decoder_runner.cpp",
+    "extension/llm/runner/continuous_batching_runner.cpp",
     "extension/llm/runner/llm_runner_helper.cpp",
     "extension/llm/runner/multimodal_prefiller.cpp",
     "extension/llm/runner/multimodal_runner.cpp",
+    "extension/llm/runner/session_state.cpp",
+    "extension/llm/runner/speculative_token_generator.cpp",
     "extension/llm/runner/text_decoder_runner.cpp",
     "extension/llm/runner/text_llm_runner.cpp",
     "extension/llm/runner/text_prefiller.cpp",
@@ -363,6 +413,7 @@ EXTENSION_LLM_RUNNER_SRCS = [
 EXTENSION_TENSOR_SRCS = [
     "extension/tensor/tensor_ptr.cpp",
     "extension/tensor/tensor_ptr_maker.cpp",
+    "extension/tensor/tensor_ptr_pool.cpp",
 ]
 
 THREADPOOL_SRCS = [
@@ -486,6 +537,7 @@ VULKAN_SCHEMA_SRCS = [
 EXTENSION_LLM_CUSTOM_OPS_BUCK_SRCS = [
     "op_fallback.cpp",
     "op_fast_hadamard_transform.cpp",
+    "op_rms_norm.cpp",
     "op_sdpa.cpp",
     "op_update_cache.cpp",
 ]
@@ -159,6 +159,14 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_avg_pool2d",
+        deps = [
+            ":channels_last_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
     op_target(
         name = "op_bmm",
         deps = [
@@ -166,6 +174,22 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/kernels/portable/cpu/util:matmul_ops_util",
         ],
     ),
+    op_target(
+        name = "op_cat",
+        deps = [
+            ":strided_copy_util",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_convolution",
+        deps = [
+            ":channels_last_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+        ],
+    ),
     op_target(
         name = "op_div",
         # A bug in instruction selection in clang 19 for android seems to trigger some
@@ -200,6 +224,7 @@ OPTIMIZED_ATEN_OPS = (
     op_target(
         name = "op_exp",
         deps = [
+            "//executorch/kernels/optimized:libvec",
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
@@ -219,6 +244,14 @@ OPTIMIZED_ATEN_OPS = (
         ],
         deps = [":fft_utils"],
     ),
+    op_target(
+        name = "op_gather",
+        deps = [
+            ":gather_scatter_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
+    ),
     op_target(
         name = "op_gelu",
         deps = [
@@ -226,6 +259,22 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_index_put",
+        deps = [
+            ":gather_scatter_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:advanced_index_util",
+        ],
+    ),
+    op_target(
+        name = "op_index_select",
+        deps = [
+            ":gather_scatter_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
+    ),
     op_target(
         name = "op_le",
         deps = [
@@ -252,6 +301,14 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_max_pool2d_with_indices",
+        deps = [
+            ":channels_last_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
     op_target(
         name = "op_mm",
         deps = [
@@ -271,6 +328,24 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_native_batch_norm",
+        deps = [
+            ":channels_last_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:normalization_ops_util",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+        ],
+    ),
+    op_target(
+        name = "op_native_group_norm",
+        deps = [
+            ":channels_last_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:normalization_ops_util",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+        ],
+    ),
     op_target(
         name = "op_native_layer_norm",
         deps = [
@@ -279,6 +354,60 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_permute_copy",
+        deps = [
+            ":permute_util",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_scatter",
+        deps = [
+            ":gather_scatter_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu:scalar_utils",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
+    ),
+    op_target(
+        name = "op_scatter_add",
+        deps = [
+            ":gather_scatter_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
+    ),
+    op_target(
+        name = "op_slice_copy",
+        deps = [
+            ":strided_copy_util",
+            "//executorch/kernels/portable/cpu/util:slice_util",
+        ],
+    ),
+    op_target(
+        name = "op_softmax",
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:activation_ops_util",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+        ],
+    ),
+    op_target(
+        name = "op_split_with_sizes_copy",
+        deps = [
+            ":strided_copy_util",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_stack",
+        deps = [
+            ":strided_copy_util",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
     op_target(
         name = "op_sub",
         deps = [
@@ -291,6 +420,51 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_t_copy",
+        deps = [
+            ":permute_util",
+            "//executorch/kernels/portable/cpu/util:transpose_util",
+        ],
+    ),
+    op_target(
+        name = "op_transpose_copy",
+        deps = [
+            ":permute_util",
+            "//executorch/kernels/portable/cpu/util:transpose_util",
+        ],
+    ),
+    op_target(
+        name = "op_unbind_copy",
+        deps = [
+            ":strided_copy_util",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_upsample_bilinear2d",
+        deps = [
+            ":channels_last_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+        ],
+    ),
+    op_target(
+        name = "op_upsample_bilinear2d_aa",
+        deps = [
+            ":channels_last_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+        ],
+    ),
+    op_target(
+        name = "op_upsample_nearest2d",
+        deps = [
+            ":channels_last_util",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+        ],
+    ),
     op_target(
         name = "op_where",
         deps = [
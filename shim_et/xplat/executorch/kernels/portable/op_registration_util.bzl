@@ -247,6 +247,7 @@ ATEN_OPS = (
             "//executorch/runtime/core/exec_aten/util:scalar_type_util",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
             "//executorch/kernels/portable/cpu/util:math_util",
+            "//executorch/kernels/portable/cpu/util:contiguous_reduce_util",
             "//executorch/kernels/portable/cpu/util:reduce_util",
         ],
     ),
@@ -257,6 +258,7 @@ ATEN_OPS = (
             "//executorch/runtime/core/exec_aten/util:tensor_util",
             "//executorch/kernels/portable/cpu/util:index_util",
             "//executorch/kernels/portable/cpu/util:math_util",
+            "//executorch/kernels/portable/cpu/util:contiguous_reduce_util",
             "//executorch/kernels/portable/cpu/util:reduce_util",
         ],
     ),
@@ -281,6 +283,7 @@ ATEN_OPS = (
         name = "op_argmax",
         deps = [
             "//executorch/kernels/portable/cpu/util:math_util",
+            "//executorch/kernels/portable/cpu/util:contiguous_reduce_util",
             "//executorch/kernels/portable/cpu/util:reduce_util",
         ],
     ),
@@ -288,6 +291,7 @@ ATEN_OPS = (
         name = "op_argmin",
         deps = [
             "//executorch/kernels/portable/cpu/util:math_util",
+            "//executorch/kernels/portable/cpu/util:contiguous_reduce_util",
             "//executorch/kernels/portable/cpu/util:reduce_util",
         ],
     ),
@@ -842,6 +846,7 @@ ATEN_OPS = (
             "//executorch/runtime/core/exec_aten/util:scalar_type_util",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
             "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/kernels/portable/cpu/util:contiguous_reduce_util",
             "//executorch/kernels/portable/cpu/util:reduce_util",
         ],
     ),
@@ -1217,6 +1222,7 @@ ATEN_OPS = (
         deps = [
             "//executorch/runtime/core/exec_aten/util:scalar_type_util",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
+            "//executorch/kernels/portable/cpu/util:contiguous_reduce_util",
             "//executorch/kernels/portable/cpu/util:reduce_util",
         ],
     ),
@@ -1306,6 +1312,7 @@ ATEN_OPS = (
             ":scalar_utils",
             "//executorch/runtime/core/exec_aten/util:scalar_type_util",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
+            "//executorch/kernels/portable/cpu/util:contiguous_reduce_util",
             "//executorch/kernels/portable/cpu/util:reduce_util",
         ],
     ),
@@ -72,6 +72,7 @@ class ExportedModule:
         external_constants: bool = False,
         export_state_names: bool = False,
         share_mutable_buffers: bool = False,
+        emit_mutable_buffer_names: bool = False,
     ) -> "ExportedModule":
         """
         Creates a new ExportedModule for the specified module class.
@@ -210,7 +211,8 @@ class ExportedModule:
                 memory_planning_pass=memory_planning_pass,
                 to_out_var_pass=ToOutVarPass(ignore_to_out_var_failure),
                 external_constants=external_constants,
-                emit_mutable_buffer_names=export_state_names,
+                emit_mutable_buffer_names=export_state_names
+                or emit_mutable_buffer_names,
             )
         )
 
@@ -146,6 +146,21 @@ class ModuleAddMul(torch.nn.Module):
         return (torch.ones(2, 2, dtype=torch.float),)
 
 
+class ModuleConstantSubgraph(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.a = 3 * torch.ones(2, 2, dtype=torch.float)
+        self.b = 2 * torch.ones(2, 2, dtype=torch.float)
+
+    def forward(self, x: torch.Tensor):
+        # Only depends on constants, so the runtime can fold it at init.
+        ab = torch.mul(self.a, self.b)
+        return torch.add(x, ab)
+
+    def get_random_inputs(self):
+        return (torch.ones(2, 2, dtype=torch.float),)
+
+
 # Used for program-data-separation.
 class ModuleLinear(torch.nn.Module):
     def __init__(self):
@@ -298,6 +313,44 @@ class ModuleSharedState(torch.nn.Module):
         return True
 
 
+class ModuleSharedStateNamed(ModuleSharedState):
+    @staticmethod
+    def emit_mutable_buffer_names():
+        return True
+
+
+class ModuleMethodState(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.register_buffer("state", torch.zeros(1))
+
+    def forward(self, x):
+        self.state.add_(1)
+        return x + self.state
+
+    def scale(self, x):
+        return x * 2 + 1
+
+    def get_random_inputs(self):
+        return (torch.ones(1),)
+
+    def get_random_inputs_per_method(self):
+        return {
+            "forward": (torch.ones(1),),
+            "scale": (torch.ones(16),),
+        }
+
+    @staticmethod
+    def get_method_names_to_export() -> List[str]:
+        return ["forward", "scale"]
+
+
+class ModuleMethodStateNamed(ModuleMethodState):
+    @staticmethod
+    def emit_mutable_buffer_names():
+        return True
+
+
 #
 # Main logic.
 #
@@ -317,6 +370,7 @@ def export_module_to_program(
     export_joint = False
     export_state_names = False
     share_mutable_buffers = False
+    emit_mutable_buffer_names = False
     if hasattr(module_class, "export_joint"):
         # pyre-ignore[16]: pyre just cant figure it out
         export_joint = module_class.export_joint()
@@ -331,6 +385,9 @@ def export_module_to_program(
     if hasattr(module_class, "share_mutable_buffers"):
         # pyre-ignore[16]: pyre just cant figure it out
         share_mutable_buffers = module_class.share_mutable_buffers()
+    if hasattr(module_class, "emit_mutable_buffer_names"):
+        # pyre-ignore[16]: pyre just cant figure it out
+        emit_mutable_buffer_names = module_class.emit_mutable_buffer_names()
     module = ExportedModule.export(
         module_class,
         methods,
@@ -338,6 +395,7 @@ def export_module_to_program(
         external_constants=external_constants,
         export_state_names=export_state_names,
         share_mutable_buffers=share_mutable_buffers,
+        emit_mutable_buffer_names=emit_mutable_buffer_names,
         **export_kwargs,
     )
     return module.executorch_program
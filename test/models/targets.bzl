@@ -63,6 +63,7 @@ def define_common_targets():
         "ModuleAddHalf",
         "ModuleAddMul",
         "ModuleBasic",
+        "ModuleConstantSubgraph",
         "ModuleKVCacheCachePos",
         "ModuleKVCacheInputPos",
         "ModuleMultipleEntry",
@@ -72,6 +73,9 @@ def define_common_targets():
         "ModuleSimpleTrain",
         "ModuleStateful",
         "ModuleSharedState",
+        "ModuleSharedStateNamed",
+        "ModuleMethodState",
+        "ModuleMethodStateNamed",
     ]
 
     # Generates Executorch .pte program files for various modules at build time.
@@ -398,6 +398,7 @@ function(executorch_load_build_variables)
       EXTENSION_DATA_LOADER_SRCS
       EXTENSION_EVALUE_UTIL_SRCS
       EXTENSION_FLAT_TENSOR_SRCS
+      EXTENSION_FLAT_TENSOR_SERIALIZE_SRCS
       EXTENSION_MODULE_SRCS
       EXTENSION_NAMED_DATA_MAP_SRCS
       EXTENSION_RUNNER_UTIL_SRCS
@@ -431,6 +432,7 @@ function(executorch_load_build_variables)
       _extension_data_loader__srcs
       _extension_evalue_util__srcs
       _extension_flat_tensor__srcs
+      _extension_flat_tensor_serialize__srcs
       _extension_module__srcs
       _extension_named_data_map__srcs
       _extension_runner_util__srcs
@@ -59,6 +59,7 @@ set(optional_lib_list
     bundled_program
     extension_data_loader
     extension_flat_tensor
+    extension_flat_tensor_serialize
     coreml_util
     coreml_inmemoryfs
     coremldelegate